@@ -0,0 +1,17 @@
+@echo off
+
+if not exist "build/" ( mkdir "build" )
+pushd "build"
+
+set CompilerFlags=-Oi -O2 -Zi -nologo /FC -DOCEAN_WINDOWS=1 -DOCEAN_COMPILER_MSVC=1 -DOCEAN_DEBUG=0
+set LinkerFlags=-DEBUG -nologo -subsystem:console user32.lib gdi32.lib
+
+echo Compiling Benchmarks...
+cl /c "../source/win32_ocean_benchmark.cpp" %CompilerFlags%
+
+echo Linking...
+link "win32_ocean_benchmark.obj" %LinkerFlags% /OUT:OceanBenchmark.exe
+
+popd
+
+"build/OceanBenchmark.exe"
@@ -46,6 +46,30 @@ CopyMem(void *Destination, void *Source, memory_size Size)
     }
 }
 
+void
+MoveMem(void *Destination, void *Source, memory_size Size)
+{
+    u8 *Dst = (u8 *)Destination;
+    u8 *Src = (u8 *)Source;
+    if (Dst < Src)
+    {
+        while (Size--)
+        {
+            *Dst++ = *Src++;
+        }
+    }
+    else
+    {
+        // NOTE(traian): The destination might overlap the end of the source, so copy backwards.
+        Dst += Size;
+        Src += Size;
+        while (Size--)
+        {
+            *--Dst = *--Src;
+        }
+    }
+}
+
 void
 SetMemory(void *Destination, u8 Value, memory_size Size)
 {
@@ -447,7 +471,7 @@ WidgetPainter_ClearPanel(bitmap *OffscreenBitmap, editor_state *EditorState, u32
 }
 
 internal u8
-GetDigitsCount(u32 Number)
+GetDigitsCount(u64 Number)
 {
     u8 Result = 1;
     if (Number > 0)
@@ -472,6 +496,12 @@ WidgetPainter_StatusBarText(bitmap *OffscreenBitmap, editor_state *EditorState,
     WidgetPainter_ClearStatusBar(OffscreenBitmap, Settings, StatusBarSurface);
 
     char *FileName = Panel->FileName ? Panel->FileName : "*unsaved*";
+    find_in_files *Search = &EditorState->FindInFiles;
+    b32 IsFindInFilesResults = Panel->IsReadOnly && (PanelIndex == Search->ResultsPanelIndex);
+    if (IsFindInFilesResults)
+    {
+        FileName = Search->Directory;
+    }
 
     font *Font = GetFontFromID(EditorState, FontID_Interface);
     u32 TextHeight = Font->Ascent + Font->Descent;
@@ -481,7 +511,7 @@ WidgetPainter_StatusBarText(bitmap *OffscreenBitmap, editor_state *EditorState,
     Offset.X = StatusBarSurface.Offset.X + 8;
     Offset.Y = StatusBarSurface.Offset.Y + TextPadding;
 
-    char Whitespace[16] = {};
+    char Whitespace[24] = {};
     u32 WhitespaceCount = GetDigitsCount(Panel->LineCount + 1) - GetDigitsCount(Panel->Caret.Position.Line + 1);
     SetMemory(Whitespace, ' ', WhitespaceCount);
 
@@ -491,9 +521,93 @@ WidgetPainter_StatusBarText(bitmap *OffscreenBitmap, editor_state *EditorState,
         DirtyMark[0] = '*';
     }
 
-    char TitleBuffer[256] = {};
-    int Count = sprintf_s(TitleBuffer, sizeof(TitleBuffer), "%s%s - L#%d%s C#%d",
-                          FileName, DirtyMark,
+    char LoadMark[40] = {};
+    if (Panel->HasLoadFailed)
+    {
+        sprintf_s(LoadMark, sizeof(LoadMark), " (read failed, read-only)");
+    }
+
+    // NOTE(traian): After a save, the number of bytes it actually wrote is displayed until the next edit. A save
+    // that was refused because of the characters that don't fit the encoding of the document is displayed until the
+    // next save, with the command that saves the document as UTF-8 instead.
+    char SaveMark[128] = {};
+    text_save_stats *SaveStats = &Panel->Save.Stats;
+    if (Panel->Save.IsActive)
+    {
+        sprintf_s(SaveMark, sizeof(SaveMark), " (saving)");
+    }
+    else if (SaveStats->UnencodableCount > 0)
+    {
+        sprintf_s(SaveMark, sizeof(SaveMark), " (not saved, %llu characters don't fit %s, Ctrl+Shift+S saves UTF-8)",
+                  SaveStats->UnencodableCount, GetTextEncodingName(SaveStats->UnencodableEncoding));
+    }
+    else if (!Panel->IsSaveDirty && SaveStats->SaveCount > 0)
+    {
+        sprintf_s(SaveMark, sizeof(SaveMark), " (saved, wrote %llu bytes)", SaveStats->LastWrittenSize);
+    }
+
+    // NOTE(traian): Plain UTF-8 with LF line endings isn't marked, since most documents are stored that way.
+    char FormatMark[64] = {};
+    text_file_format *Format = &Panel->Format;
+    if (Format->Encoding != TextEncoding_UTF8 || Format->HasByteOrderMark || Format->LineEnding != LineEnding_LF ||
+        Format->IsLossy)
+    {
+        sprintf_s(FormatMark, sizeof(FormatMark), " [%s%s %s%s]", GetTextEncodingName(Format->Encoding),
+                  Format->HasByteOrderMark ? " BOM" : "", GetLineEndingName(Format->LineEnding),
+                  Format->IsLossy ? ", lossy" : "");
+    }
+
+    // NOTE(traian): The match count is marked as partial while the rest of the text is still being searched.
+    char FindMark[160] = {};
+    text_find *Find = &Panel->Find;
+    if (Find->IsActive && Find->IsRegex && Find->QueryLength > 0 && !Find->IsQueryValid)
+    {
+        sprintf_s(FindMark, sizeof(FindMark), " [regex \"%.*s\": invalid]",
+                  (int)Minimum(Find->QueryLength, 32), Find->Query);
+    }
+    else if (Find->IsActive)
+    {
+        char ReplaceMark[48] = {};
+        if (Find->IsEditingReplacement || Find->ReplacementLength > 0)
+        {
+            sprintf_s(ReplaceMark, sizeof(ReplaceMark), " -> \"%.*s\"%s",
+                      (int)Minimum(Find->ReplacementLength, 32), Find->Replacement,
+                      Find->IsReplaceAllPending ? " pending" : "");
+        }
+
+        sprintf_s(FindMark, sizeof(FindMark), " [%s \"%.*s\"%s: %llu%s matches]", Find->IsRegex ? "regex" : "find",
+                  (int)Minimum(Find->QueryLength, 32), Find->Query, ReplaceMark, Find->MatchCount,
+                  IsTextFindComplete(Panel) ? "" : "+");
+    }
+
+    // NOTE(traian): The results panel shows the progress of the search, instead of a find of its own.
+    if (IsFindInFilesResults && !Find->IsActive)
+    {
+        char ElapsedMark[32] = {};
+        if (!Search->IsActive)
+        {
+            sprintf_s(ElapsedMark, sizeof(ElapsedMark), " in %.2fs", Search->ElapsedSeconds);
+        }
+
+        sprintf_s(FindMark, sizeof(FindMark), " [find in files %s\"%.*s\": %llu%s lines, %llu files%s%s%s]",
+                  Search->IsRegex ? "regex " : "", (int)Minimum(Search->QueryLength, 32), Search->Query,
+                  Search->ResultLineCount, Search->IsActive ? "+" : "", GetFindInFilesSearchedFileCount(Search),
+                  ElapsedMark, Search->IsUsingIndex ? ", indexed" : "", Search->IsTruncated ? ", truncated" : "");
+    }
+
+    char IndexMark[64] = {};
+    find_in_files *IndexBuild = &EditorState->IndexBuild;
+    if (IndexBuild->IsActive)
+    {
+        sprintf_s(IndexMark, sizeof(IndexMark), " [%s: %llu files, %llu unchanged%s]",
+                  IndexBuild->IsWritingIndex ? "writing index" : "indexing",
+                  GetFindInFilesSearchedFileCount(IndexBuild), GetTrigramIndexReusedFileCount(IndexBuild),
+                  IndexBuild->IsCancelled ? ", stopped" : "");
+    }
+
+    char TitleBuffer[512] = {};
+    int Count = sprintf_s(TitleBuffer, sizeof(TitleBuffer), "%s%s%s%s%s%s%s - L#%llu%s C#%llu",
+                          FileName, DirtyMark, LoadMark, SaveMark, FormatMark, FindMark, IndexMark,
                           Panel->Caret.Position.Line + 1, Whitespace, Panel->Caret.Position.Column + 1);
     Assert(Count < sizeof(TitleBuffer));
 
@@ -538,11 +652,32 @@ GetCharacterDrawOffset(editor_state *EditorState, rectangle2 PanelSurface, u32 L
     return Result;
 }
 
+internal inline u32
+GetSyntaxClassColor(editor_settings *Settings, syntax_class Class)
+{
+    u32 Result = Settings->TextColor;
+    switch (Class)
+    {
+        case SyntaxClass_Keyword:      { Result = Settings->KeywordColor; } break;
+        case SyntaxClass_Comment:      { Result = Settings->CommentColor; } break;
+        case SyntaxClass_String:       { Result = Settings->StringColor; } break;
+        case SyntaxClass_Number:       { Result = Settings->NumberColor; } break;
+        case SyntaxClass_Preprocessor: { Result = Settings->PreprocessorColor; } break;
+        default:                       { } break;
+    }
+    return Result;
+}
+
+// NOTE(traian): The colors are computed only for the visible lines, from the newest states that the highlight jobs
+// computed, and the lines that were never lexed are drawn with the text color. Only the part of a line that can be
+// visible is lexed, since a codepoint is at most four bytes and takes at least one column, except when the next
+// line starts inside of a raw string, whose delimiter is carried from the end of the line.
 internal void
 WidgetPainter_PanelContent(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
 {
     editor_settings *Settings = &EditorState->Settings;
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_highlight *Highlight = &Panel->Highlight;
 
     font *Font = GetFontFromID(EditorState, FontID_Text);
     u32 TextHeight = Font->Ascent + Font->Descent;
@@ -555,11 +690,43 @@ WidgetPainter_PanelContent(bitmap *OffscreenBitmap, editor_state *EditorState, u
     u8 R, G, B;
     UnpackRGBA(Settings->TextColor, &R, &G, &B);
 
+    u64 FirstLine = Panel->FirstLineIndex;
+    b32 IsHighlighted = UpdateVisibleTextHighlight(Panel, FirstLine + Panel->ScreenLineCount);
+    syntax_lexer Lexer = GetTextHighlightLexer(Panel, FirstLine);
+    memory_size MaxVisibleByteCount = 4 * (Panel->FirstColumnIndex + Panel->ScreenColumnCount + 1);
+    syntax_span Spans[SYNTAX_SPAN_CAPACITY];
+
     text_iterator Iterator = NewTextIterator(&Panel->Buffer, Panel->BufferOffset);
     for (u32 LineIndex = 0; LineIndex < Panel->ScreenLineCount; ++LineIndex)
     {
+        u64 Line = FirstLine + LineIndex;
+        u32 SpanCount = 0;
+        u32 SpanIndex = 0;
+        memory_offset LineStart = Iterator.Offset;
+        b32 IsLineLexed = false;
+        if (IsHighlighted && Lexer.State != SyntaxState_Unknown)
+        {
+            b32 IsNextRawString = (GetTextHighlightState(Highlight, Line + 1) == SyntaxState_RawString);
+            memory_size ByteCount;
+            char *Text = GetTextHighlightLine(Panel, Line, IsNextRawString ? INVALID_SIZE : MaxVisibleByteCount,
+                                              &ByteCount);
+            if (Text)
+            {
+                Lexer = LexSyntaxLine(Lexer, Text, ByteCount, Spans, &SpanCount);
+                IsLineLexed = IsNextRawString;
+            }
+        }
+
+        if (!IsLineLexed)
+        {
+            Lexer = GetTextHighlightLexer(Panel, Line + 1);
+        }
+
+        u32 Color = (SpanCount > 0) ? GetSyntaxClassColor(Settings, Spans[0].Class) : Settings->TextColor;
+        UnpackRGBA(Color, &R, &G, &B);
+
         b32 SkipLine = false;
-        u32 FirstColumnIndex = 0;
+        u64 FirstColumnIndex = 0;
         while (FirstColumnIndex < Panel->FirstColumnIndex)
         {
             if (!IsValid(Iterator))
@@ -581,7 +748,7 @@ WidgetPainter_PanelContent(bitmap *OffscreenBitmap, editor_state *EditorState, u
         b32 ReachedEndOfLine = false;
         if (!SkipLine)
         {
-            u32 EmptyColumns = FirstColumnIndex - Panel->FirstColumnIndex;
+            u32 EmptyColumns = (u32)(FirstColumnIndex - Panel->FirstColumnIndex);
             Position.X += EmptyColumns * Font->Advance;
             for (u32 ColumnOffset = 0; ColumnOffset < Panel->ScreenColumnCount - EmptyColumns;)
             {
@@ -597,6 +764,16 @@ WidgetPainter_PanelContent(bitmap *OffscreenBitmap, editor_state *EditorState, u
                     break;
                 }
 
+                memory_offset LineOffset = Iterator.Offset - LineStart;
+                if (SpanIndex + 1 < SpanCount && Spans[SpanIndex + 1].Offset <= LineOffset)
+                {
+                    while (SpanIndex + 1 < SpanCount && Spans[SpanIndex + 1].Offset <= LineOffset)
+                    {
+                        ++SpanIndex;
+                    }
+                    UnpackRGBA(GetSyntaxClassColor(Settings, Spans[SpanIndex].Class), &R, &G, &B);
+                }
+
                 if (IsDrawableCodepoint(Iterator.Codepoint))
                 {
                     font_entry *Entry = Font->ASCIIEntries + (Iterator.Codepoint - FONT_ASCII_OFFSET);
@@ -628,13 +805,13 @@ internal void
 WidgetPainter_LineHighlight(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
-    u32 LineIndex = Panel->Caret.Position.Line;
+    u64 LineIndex = Panel->Caret.Position.Line;
 
     if (Panel->FirstLineIndex <= LineIndex && LineIndex <= Panel->FirstLineIndex + Panel->ScreenLineCount)
     {
         font *Font = GetFontFromID(EditorState, FontID_Text);
         u32 FontHeight = Font->Ascent + Font->Descent;
-        u32 RelativeLine = LineIndex - Panel->FirstLineIndex;
+        u32 RelativeLine = (u32)(LineIndex - Panel->FirstLineIndex);
 
         rectangle2 Highlight;
         Highlight.Offset.X = Panel->Surface.Offset.X;
@@ -648,20 +825,93 @@ WidgetPainter_LineHighlight(bitmap *OffscreenBitmap, editor_state *EditorState,
     }
 }
 
+// NOTE(traian): The text that is on the screen is searched directly until the scan of the whole text reaches it,
+// so the matches are highlighted in the same frame in which the query changes. Neither a literal query nor a regex
+// match ever contains a new line, so each match lies on a single line.
 internal void
-WidgetPainter_Caret(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
+WidgetPainter_FindHighlight(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
 {
+    editor_settings *Settings = &EditorState->Settings;
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
-    u32 LineIndex = Panel->Caret.Position.Line;
-    u32 ColumnIndex = Panel->Caret.Position.Column;
+    text_find *Find = &Panel->Find;
+
+    if (!Find->IsActive || !Find->IsQueryValid)
+    {
+        return;
+    }
+
+    font *Font = GetFontFromID(EditorState, FontID_Text);
+    u32 FontHeight = Font->Ascent + Font->Descent;
+
+    // NOTE(traian): The renderer never waits for a file that is still loading.
+    u64 EndLine = Panel->FirstLineIndex + Panel->ScreenLineCount;
+    memory_offset VisibleStart = Panel->BufferOffset;
+    memory_offset VisibleEnd = Panel->Load.IsActive ? GetBufferOffsetOfLine(&Panel->LineIndex, EndLine)
+                                                    : GetBufferOffsetOfLine(Panel, EndLine);
+    VisibleEnd = Minimum(VisibleEnd, Panel->Buffer.Used);
+
+    b32 UseScannedMatches = AreTextFindMatchesCurrent(Panel) && (Find->ScanOffset >= VisibleEnd);
+    u64 MatchIndex = UseScannedMatches ? FindTextMatchIndex(Find, VisibleStart) : 0;
+    memory_offset SearchOffset = VisibleStart;
+    u64 Line = Panel->FirstLineIndex;
+
+    while (true)
+    {
+        text_find_match Match;
+        if (UseScannedMatches)
+        {
+            if (MatchIndex >= Find->MatchCount || Find->Matches[MatchIndex].Offset >= VisibleEnd)
+            {
+                break;
+            }
+            Match = Find->Matches[MatchIndex++];
+        }
+        else
+        {
+            if (!FindTextMatch(Find, &Panel->Buffer, SearchOffset, VisibleEnd, &Match))
+            {
+                break;
+            }
+            SearchOffset = Match.Offset + Match.Size;
+        }
+
+        while (GetBufferOffsetOfLine(&Panel->LineIndex, Line + 1) <= Match.Offset)
+        {
+            ++Line;
+        }
+
+        text_column_map *Map = GetTextColumnMap(Panel, Settings, Line);
+        u64 FirstColumn = GetColumnOfLineOffset(Map, Match.Offset - Map->LineOffset);
+        u64 EndColumn = GetColumnOfLineOffset(Map, Match.Offset + Match.Size - Map->LineOffset);
+
+        FirstColumn = Maximum(FirstColumn, Panel->FirstColumnIndex);
+        EndColumn = Minimum(EndColumn, Panel->FirstColumnIndex + Panel->ScreenColumnCount);
+        if (FirstColumn < EndColumn)
+        {
+            u32 RelativeLine = (u32)(Line - Panel->FirstLineIndex);
+            u32 RelativeColumn = (u32)(FirstColumn - Panel->FirstColumnIndex);
+
+            DrawTransparentQuad(OffscreenBitmap,
+                                GetCharacterDrawOffset(EditorState, Panel->Surface, RelativeLine, RelativeColumn),
+                                { (s32)(EndColumn - FirstColumn) * (s32)Font->Advance, (s32)FontHeight },
+                                Settings->FindHighlightColor);
+        }
+    }
+}
+
+internal void
+DrawTextCaret(bitmap *OffscreenBitmap, editor_state *EditorState, text_panel *Panel, text_caret *Caret)
+{
+    u64 LineIndex = Caret->Position.Line;
+    u64 ColumnIndex = Caret->Position.Column;
 
     if (Panel->FirstLineIndex <= LineIndex && LineIndex <= Panel->FirstLineIndex + Panel->ScreenLineCount &&
         Panel->FirstColumnIndex <= ColumnIndex && ColumnIndex <= Panel->FirstColumnIndex + Panel->ScreenColumnCount)
     {
         font *Font = GetFontFromID(EditorState, FontID_Text);
         u32 FontHeight = Font->Ascent + Font->Descent;
-        u32 RelativeLine = Panel->Caret.Position.Line - Panel->FirstLineIndex;
-        u32 RelativeColumn = Panel->Caret.Position.Column - Panel->FirstColumnIndex;
+        u32 RelativeLine = (u32)(Caret->Position.Line - Panel->FirstLineIndex);
+        u32 RelativeColumn = (u32)(Caret->Position.Column - Panel->FirstColumnIndex);
 
         rectangle2 Position;
         Position.Offset = GetCharacterDrawOffset(EditorState, Panel->Surface, RelativeLine, RelativeColumn);
@@ -675,30 +925,41 @@ WidgetPainter_Caret(bitmap *OffscreenBitmap, editor_state *EditorState, u32 Pane
 }
 
 internal void
-WidgetPainter_SelectionHighlight(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
+WidgetPainter_Caret(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+
+    DrawTextCaret(OffscreenBitmap, EditorState, Panel, &Panel->Caret);
+    for (u64 CaretIndex = 0; CaretIndex < Panel->ExtraCarets.Count; ++CaretIndex)
+    {
+        DrawTextCaret(OffscreenBitmap, EditorState, Panel, Panel->ExtraCarets.Carets + CaretIndex);
+    }
+}
+
+internal void
+DrawTextCaretSelection(bitmap *OffscreenBitmap, editor_state *EditorState, text_panel *Panel, text_caret *Caret)
+{
     font *Font = GetFontFromID(EditorState, FontID_Text);
     u32 FontHeight = Font->Ascent + Font->Descent;
 
-    if (Panel->Caret.IsSelecting)
+    if (Caret->IsSelecting)
     {
-        u32 Line, Column;
+        u64 Line, Column;
         memory_offset BufferOffset, TargetOffset;
 
-        if (Panel->Caret.Position.Offset > Panel->Caret.Selection.Offset)
+        if (Caret->Position.Offset > Caret->Selection.Offset)
         {
-            Line = Panel->Caret.Selection.Line;
-            Column = Panel->Caret.Selection.Column;
-            BufferOffset = Panel->Caret.Selection.Offset;
-            TargetOffset = Panel->Caret.Position.Offset;
+            Line = Caret->Selection.Line;
+            Column = Caret->Selection.Column;
+            BufferOffset = Caret->Selection.Offset;
+            TargetOffset = Caret->Position.Offset;
         }
         else
         {
-            Line = Panel->Caret.Position.Line;
-            Column = Panel->Caret.Position.Column;
-            BufferOffset = Panel->Caret.Position.Offset;
-            TargetOffset = Panel->Caret.Selection.Offset;
+            Line = Caret->Position.Line;
+            Column = Caret->Position.Column;
+            BufferOffset = Caret->Position.Offset;
+            TargetOffset = Caret->Selection.Offset;
         }
 
         text_iterator Iterator = NewTextIterator(&Panel->Buffer, BufferOffset);
@@ -707,8 +968,8 @@ WidgetPainter_SelectionHighlight(bitmap *OffscreenBitmap, editor_state *EditorSt
             if ((Panel->FirstLineIndex <= Line && Line < Panel->FirstLineIndex + Panel->ScreenLineCount) &&
                 (Panel->FirstColumnIndex <= Column && Column < Panel->FirstColumnIndex + Panel->ScreenColumnCount))
             {
-                u32 RelativeLine = Line - Panel->FirstLineIndex;
-                u32 RelativeColumn = Column - Panel->FirstColumnIndex;
+                u32 RelativeLine = (u32)(Line - Panel->FirstLineIndex);
+                u32 RelativeColumn = (u32)(Column - Panel->FirstColumnIndex);
                 u32 ColumnCount = GetCodepointColumnCount(&EditorState->Settings, Iterator.Codepoint, Column);
 
                 DrawTransparentQuad(OffscreenBitmap,
@@ -733,6 +994,18 @@ WidgetPainter_SelectionHighlight(bitmap *OffscreenBitmap, editor_state *EditorSt
     }
 }
 
+internal void
+WidgetPainter_SelectionHighlight(bitmap *OffscreenBitmap, editor_state *EditorState, u32 PanelIndex)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+
+    DrawTextCaretSelection(OffscreenBitmap, EditorState, Panel, &Panel->Caret);
+    for (u64 CaretIndex = 0; CaretIndex < Panel->ExtraCarets.Count; ++CaretIndex)
+    {
+        DrawTextCaretSelection(OffscreenBitmap, EditorState, Panel, Panel->ExtraCarets.Carets + CaretIndex);
+    }
+}
+
 //=========================================================================================
 // NOTE(traian): EDITOR INITIALIZATION.
 //=========================================================================================
@@ -744,6 +1017,13 @@ InitializeColorScheme(editor_settings *Settings)
     Settings->BackgroundColor     = PackRGBA(23,  23,  23,  255);
     Settings->LineHighlightColor  = PackRGBA(40,  60,  210, 60);
     Settings->CaretColor          = PackRGBA(220, 220, 60,  225);
+    Settings->FindHighlightColor  = PackRGBA(230, 200, 60,  90);
+
+    Settings->KeywordColor        = PackRGBA(86,  156, 214, 255);
+    Settings->CommentColor        = PackRGBA(106, 153, 85,  255);
+    Settings->StringColor         = PackRGBA(206, 145, 120, 255);
+    Settings->NumberColor         = PackRGBA(181, 206, 168, 255);
+    Settings->PreprocessorColor   = PackRGBA(197, 134, 192, 255);
 
     // Settings->StatusBarColor      = PackRGBA(135);
     // Settings->StatusBarTextColor  = PackRGBA(8);
@@ -803,6 +1083,13 @@ OpenDefaultFiles(editor_state *EditorState, editor_memory *EditorMemory)
 void
 InitializeEditor(editor_state *EditorState, editor_memory *EditorMemory)
 {
+    EditorState->WorkQueue = EditorMemory->WorkQueue;
+    EditorState->FileQueue = EditorMemory->FileQueue;
+    EditorState->SearchQueue = EditorMemory->SearchQueue;
+    EditorState->SearchThreadCount = EditorMemory->SearchThreadCount;
+    EditorState->IndexQueue = EditorMemory->IndexQueue;
+    EditorState->IndexThreadCount = EditorMemory->IndexThreadCount;
+    DetectProcessorFeatures();
     InitializeFonts(EditorState, EditorMemory);
     InitializeEditorCommandTable(EditorState);
 
@@ -817,7 +1104,16 @@ InitializeEditor(editor_state *EditorState, editor_memory *EditorMemory)
     Settings->TabWidth = 4;
     Settings->ReplaceTabWithSpaces = true;
 
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(EditorState->TextPanels); ++PanelIndex)
+    {
+        EditorState->TextPanels[PanelIndex].Journal.WorkQueue = EditorState->WorkQueue;
+    }
+
     OpenDefaultFiles(EditorState, EditorMemory);
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(EditorState->TextPanels); ++PanelIndex)
+    {
+        BeginTextJournalRecovery(&EditorState->TextPanels[PanelIndex].Journal);
+    }
     EditorState->FocusedTextPanelIndex = 0;
 }
 
@@ -831,12 +1127,21 @@ UpdateAndRenderEditor(editor_state *EditorState, editor_memory *EditorMemory,
 {
     ResetEditorLayout(EditorState, EditorLayout_Dual);
 
+    // NOTE(traian): Lazy line indices are kept one screen ahead of the visible lines, so the navigation
+    // commands and the status bar see the lines that follow.
+    for (u32 PanelIndex = 0; PanelIndex < 2; ++PanelIndex)
+    {
+        text_panel *Panel = EditorState->TextPanels + PanelIndex;
+        EnsureLinesAreIndexed(Panel, Panel->FirstLineIndex + 2 * Panel->ScreenLineCount);
+    }
+
     rectangle2 StatusBarSurface0 = GetStatusBarSurface(EditorState, 0);
     WidgetPainter_ClearStatusBar(OffscreenBitmap, &EditorState->Settings, StatusBarSurface0, true);
     WidgetPainter_StatusBarText(OffscreenBitmap, EditorState, 0, StatusBarSurface0);
     WidgetPainter_ClearPanel(OffscreenBitmap, EditorState, 0);
     WidgetPainter_PanelContent(OffscreenBitmap, EditorState, 0);
     WidgetPainter_LineHighlight(OffscreenBitmap, EditorState, 0);
+    WidgetPainter_FindHighlight(OffscreenBitmap, EditorState, 0);
     WidgetPainter_Caret(OffscreenBitmap, EditorState, 0);
     WidgetPainter_SelectionHighlight(OffscreenBitmap, EditorState, 0);
 
@@ -846,6 +1151,7 @@ UpdateAndRenderEditor(editor_state *EditorState, editor_memory *EditorMemory,
     WidgetPainter_ClearPanel(OffscreenBitmap, EditorState, 1);
     WidgetPainter_PanelContent(OffscreenBitmap, EditorState, 1);
     WidgetPainter_LineHighlight(OffscreenBitmap, EditorState, 1);
+    WidgetPainter_FindHighlight(OffscreenBitmap, EditorState, 1);
     WidgetPainter_Caret(OffscreenBitmap, EditorState, 1);
     WidgetPainter_SelectionHighlight(OffscreenBitmap, EditorState, 1);
 
@@ -859,4 +1165,108 @@ void
 EditorEventKeyPressed(editor_state *EditorState, key_code KeyCode)
 {
     ExecuteEditorCommand(EditorState, KeyCode);
+
+    // NOTE(traian): The lines that the command edited are lexed right away, instead of on the next timer tick.
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(EditorState->TextPanels); ++PanelIndex)
+    {
+        ContinueTextHighlight(EditorState->TextPanels + PanelIndex, EditorState->WorkQueue);
+    }
+}
+
+b32
+EditorEventTimerTick(editor_state *EditorState)
+{
+    b32 IsRedrawNeeded = false;
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(EditorState->TextPanels); ++PanelIndex)
+    {
+        text_panel *Panel = EditorState->TextPanels + PanelIndex;
+        if (AbsorbLoadedText(Panel))
+        {
+            IsRedrawNeeded = true;
+        }
+
+        if (!Panel->Load.IsActive && CompleteTextJournalRecovery(Panel))
+        {
+            IsRedrawNeeded = true;
+        }
+
+        if (CompleteTextSave(Panel))
+        {
+            IsRedrawNeeded = true;
+        }
+
+        text_find *Find = &Panel->Find;
+        if (Find->IsActive && ContinueTextFindForSeconds(Panel, TEXT_FIND_TICK_SECONDS))
+        {
+            IsRedrawNeeded = true;
+        }
+
+        // NOTE(traian): A pending replace all is dropped if the text was edited since it was requested.
+        if (Find->IsReplaceAllPending && Find->ReplaceAllEditVersion != Panel->EditVersion)
+        {
+            Find->IsReplaceAllPending = false;
+        }
+        else if (Find->IsReplaceAllPending && IsTextFindComplete(Panel))
+        {
+            CompleteReplaceAll(EditorState, PanelIndex);
+            IsRedrawNeeded = true;
+        }
+
+        if (ContinueTextHighlight(Panel, EditorState->WorkQueue))
+        {
+            IsRedrawNeeded = true;
+        }
+
+        SyncTextJournal(EditorState->WorkQueue, &Panel->Journal);
+    }
+
+    // NOTE(traian): The search is stopped if its results panel was given another document.
+    find_in_files *Search = &EditorState->FindInFiles;
+    text_panel *ResultsPanel = EditorState->TextPanels + Search->ResultsPanelIndex;
+    if (Search->IsActive && !ResultsPanel->IsReadOnly)
+    {
+        CancelFindInFiles(Search);
+    }
+    if (ContinueFindInFiles(Search, ResultsPanel))
+    {
+        IsRedrawNeeded = true;
+    }
+
+    // NOTE(traian): A search that found a changed file among the ones the index selected doesn't trust the index with
+    // the others either, so the index is built again once the search is done, or by the next search if a build is
+    // already running.
+    if (!Search->IsActive && Search->IsIndexStale)
+    {
+        Search->IsIndexStale = false;
+        EditorState->IsTrigramIndexStale = true;
+        RefreshTrigramIndex(EditorState, Search->Directory);
+    }
+
+    // NOTE(traian): The progress of the index build is shown by every panel.
+    find_in_files *IndexBuild = &EditorState->IndexBuild;
+    if (IndexBuild->IsActive)
+    {
+        ContinueTrigramIndexBuild(IndexBuild, EditorState->IndexQueue);
+        IsRedrawNeeded = true;
+    }
+
+    return IsRedrawNeeded;
+}
+
+void
+EditorEventShutdown(editor_state *EditorState)
+{
+    CancelFindInFiles(&EditorState->FindInFiles);
+    FinishTrigramIndexBuild(&EditorState->IndexBuild);
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(EditorState->TextPanels); ++PanelIndex)
+    {
+        text_panel *Panel = EditorState->TextPanels + PanelIndex;
+        CancelTextLoad(Panel);
+        FinishTextSave(Panel);
+        FlushTextJournal(&Panel->Journal);
+    }
+
+    // NOTE(traian): The highlight jobs that are still running don't touch anything that outlives them, but the
+    // process only exits once no work entry is left.
+    PlatformCompleteAllWork(EditorState->WorkQueue);
 }
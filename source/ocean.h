@@ -34,20 +34,38 @@
 #define ArrayCount(Array) (sizeof(Array) / sizeof((Array)[0]))
 #define OffsetOf(Type, Member) (u64)(&(((Type *)0)->Member))
 
-#define Kilobytes(X) (1024 * (X))
+#define Kilobytes(X) (1024ull * (X))
 #define Megabytes(X) Kilobytes(1024 * (X))
 #define Gigabytes(X) Megabytes(1024 * (X))
 
 #define Bit(X) (1 << (X))
 
+#define AlignForward(Value, Alignment) (((Value) + (Alignment) - 1) & ~((Alignment) - 1))
+
 #define INVALID_SIZE ((memory_size)(-1))
 
 #define Minimum(X, Y) ((X) < (Y) ? (X) : (Y))
 #define Maximum(X, Y) ((X) > (Y) ? (X) : (Y))
 
+#if OCEAN_COMPILER_MSVC
+    #define CompletePreviousWritesBeforeFutureWrites _WriteBarrier()
+    #define CompletePreviousReadsBeforeFutureReads _ReadBarrier()
+    // NOTE(traian): Also keeps the processor from reading ahead of the previous writes.
+    #define CompletePreviousMemoryOperations _mm_mfence()
+
+    // NOTE(traian): The atomic operations return the value from before the operation.
+    #define AtomicAddU32(Value, Addend) \
+        (u32)_InterlockedExchangeAdd((long volatile *)(Value), (long)(Addend))
+    #define AtomicAddU64(Value, Addend) \
+        (u64)_InterlockedExchangeAdd64((__int64 volatile *)(Value), (__int64)(Addend))
+    #define AtomicCompareExchangeU64(Value, NewValue, ExpectedValue) \
+        (u64)_InterlockedCompareExchange64((__int64 volatile *)(Value), (__int64)(NewValue), (__int64)(ExpectedValue))
+#endif // OCEAN_COMPILER_MSVC
+
 #include "ocean_math.h"
 
 void CopyMem(void *Destination, void *Source, memory_size Size);
+void MoveMem(void *Destination, void *Source, memory_size Size);
 void SetMemory(void *Destination, u8 Value, memory_size Size);
 void SetMemoryToZero(void *Destination, memory_size Size);
 
@@ -92,11 +110,51 @@ struct buffer
     memory_size Size;
 };
 
+struct platform_file
+{
+    // NOTE(traian): NULL if the file couldn't be opened.
+    void *Handle;
+    memory_size Size;
+};
+
+// NOTE(traian): The longest path, including the null terminator, that the platform layer can open.
+#define PLATFORM_PATH_CAPACITY 260
+
+struct platform_directory_entry
+{
+    char Name[PLATFORM_PATH_CAPACITY];
+    b32 IsDirectory;
+    // NOTE(traian): In the units of PlatformGetFileWriteTime, or 0 if the platform doesn't list it.
+    u64 WriteTime;
+};
+
+struct platform_directory_iterator
+{
+    // NOTE(traian): NULL if the directory couldn't be opened or all of its entries were read.
+    void *Handle;
+    b32 HasPendingEntry;
+    platform_directory_entry PendingEntry;
+};
+
+struct platform_work_queue;
+#define PLATFORM_WORK_QUEUE_CALLBACK(Name) void Name(platform_work_queue *Queue, void *Data)
+typedef PLATFORM_WORK_QUEUE_CALLBACK(platform_work_queue_callback);
+
 struct editor_memory
 {
     memory_size PermanentStorageSize;
     void *PermanentStorage;
     memory_arena PermanentArena;
+
+    // NOTE(traian): Executes the work entries on background threads. The loads and the saves of the panels
+    // go to the file queue, and the workers of a find in files and of an index build go to the search and the
+    // index queues, since they keep their threads until they are done.
+    platform_work_queue *WorkQueue;
+    platform_work_queue *FileQueue;
+    platform_work_queue *SearchQueue;
+    u32 SearchThreadCount;
+    platform_work_queue *IndexQueue;
+    u32 IndexThreadCount;
 };
 
 struct bitmap
@@ -160,6 +218,13 @@ struct editor_settings
     u32 BackgroundColor;
     u32 LineHighlightColor;
     u32 CaretColor;
+    u32 FindHighlightColor;
+
+    u32 KeywordColor;
+    u32 CommentColor;
+    u32 StringColor;
+    u32 NumberColor;
+    u32 PreprocessorColor;
 
     u32 StatusBarColor;
     u32 StatusBarTextColor;
@@ -187,42 +252,761 @@ typedef enum editor_layout_enum
 }
 editor_layout;
 
+// NOTE(traian): The text buffer is a gap buffer. The text is stored in two spans, [0, GapOffset) and
+// [GapOffset + GapSize, Size), where GapSize is (Size - Used). All offsets used by the editor are
+// logical offsets into the text, so they never account for the gap. Insertions and deletions are
+// performed at the gap, which is moved to the edit location first, so the cost of an edit is
+// proportional to the caret movement since the last edit and not to the size of the file.
 struct text_buffer
 {
     char *Base;
     memory_size Size;
     memory_size Used;
+    memory_offset GapOffset;
+
+    // NOTE(traian): The memory is a read-only view of the file, with an empty gap at the end. It must be
+    // promoted to an allocated buffer before the text is modified.
+    b32 IsMapped;
+};
+
+// NOTE(traian): The size of the gap that is left in front of the text when a file is opened.
+#define TEXT_BUFFER_DEFAULT_GAP_SIZE Kilobytes(64)
+
+// NOTE(traian): Files at least this big are mapped instead of being read into a text buffer.
+#define TEXT_BUFFER_MAPPED_FILE_THRESHOLD Megabytes(64)
+
+// NOTE(traian): The offsets of the first byte of every line of a text panel. Just like the text, the
+// array is a gap buffer: the entries before the gap store the offset from the start of the text, while the
+// entries after the gap store the distance from the end of the text. Inserting or removing text only has
+// to add or remove the entries of the lines it touches, instead of shifting the offset of every line below.
+struct text_line_index
+{
+    memory_offset *Entries;
+    u64 Capacity;
+    u64 Count;
+    u64 GapIndex;
+    memory_size TextSize;
+
+    // NOTE(traian): The number of bytes, from the start of the text, that were scanned for new lines.
+    // It's smaller than TextSize only while the index of a mapped file is being built lazily, in which
+    // case the gap is always at the end of the index.
+    memory_size ScannedSize;
+};
+
+// NOTE(traian): The number of bytes that are scanned at once when a lazy line index is extended.
+#define LINE_INDEX_SCAN_CHUNK_SIZE Kilobytes(256)
+
+// NOTE(traian): A codepoint of a line that isn't one byte and one column wide, or a tab, whose width in columns
+// depends on the column where it starts. The stops that are one byte wide are tabs.
+struct text_column_stop
+{
+    memory_offset Offset;
+    u64 Column;
+    u32 Width;
+    u32 ColumnCount;
+};
+
+// NOTE(traian): Converts between the offsets and the columns of a line. Every codepoint of the line that isn't
+// a stop is one byte and one column wide, so an offset or a column is found with a binary search over the stops
+// instead of walking the line. The offsets of the stops are relative to the start of the line.
+struct text_column_map
+{
+    u64 Line;
+    memory_offset LineOffset;
+    // NOTE(traian): The size of the line, without its new line.
+    memory_size ByteCount;
+    u64 ColumnCount;
+    u32 TabWidth;
+    b32 IsValid;
+
+    text_column_stop *Stops;
+    u64 StopCount;
+    u64 StopCapacity;
+    u64 LastUseTime;
+};
+
+// NOTE(traian): The maps of the lines that the caret moved through most recently are kept, so moving back
+// and forth between a few long lines doesn't rebuild them.
+#define TEXT_COLUMN_MAP_COUNT 4
+// NOTE(traian): The number of bytes that are scanned for ASCII at once while a map is built, so that building
+// the map of a short line doesn't scan the rest of the text.
+#define TEXT_COLUMN_MAP_SCAN_SIZE Kilobytes(4)
+
+typedef enum text_encoding_enum : u8
+{
+    TextEncoding_UTF8,
+    TextEncoding_UTF16LE,
+    TextEncoding_Windows1252,
+}
+text_encoding;
+
+typedef enum text_line_ending_enum : u8
+{
+    LineEnding_LF,
+    LineEnding_CRLF,
+    LineEnding_Mixed,
+}
+text_line_ending;
+
+// NOTE(traian): The classes of characters that the token motion commands jump over. Both of them only
+// contain ASCII characters, so the runs are found by classifying the bytes, without decoding them.
+typedef enum token_class_enum : u8
+{
+    TokenClass_Contiguous,
+    TokenClass_Ignored,
+}
+token_class;
+
+// NOTE(traian): How a document is stored on the disk. The text of a panel is always UTF-8, so documents in
+// other encodings are transcoded when they are loaded and saved. The byte order mark isn't part of the text.
+struct text_file_format
+{
+    text_encoding Encoding;
+    b32 HasByteOrderMark;
+
+    // NOTE(traian): New lines in the text are always a single '\n'. The line endings of the document are
+    // normalized when it's loaded and restored when it's saved. NewLineEnding is the ending of the first line,
+    // which is also used by the new lines that are typed, while LineEnding is Mixed if some lines end otherwise.
+    // HasNewLine is set once the first new line is loaded.
+    text_line_ending LineEnding;
+    text_line_ending NewLineEnding;
+    b32 HasNewLine;
+
+    // NOTE(traian): Set when the document has bytes that its encoding can't decode, which are loaded as U+FFFD,
+    // so that saving it doesn't restore them.
+    b32 IsLossy;
+};
+
+// NOTE(traian): The offsets of the new lines whose ending on the disk isn't the NewLineEnding of the document,
+// in order, so that a mixed document is saved exactly as it was loaded. The edits keep the offsets on their
+// new lines.
+struct text_line_endings
+{
+    buffer Memory;
+    memory_offset *Offsets;
+    u64 Count;
 };
 
+// NOTE(traian): A file that is loaded into a text panel in the background. The file is read one chunk at
+// a time by a work queue thread, right after the text that is already loaded, and the progress is published
+// through LoadedSize. The main thread appends the loaded chunks to the text buffer and the line index.
+struct text_load
+{
+    platform_file File;
+    char *Destination;
+    // NOTE(traian): The hashes of the chunks are computed by the thread, right after the chunks are read.
+    u64 *ChunkHashes;
+    memory_size FileSize;
+    memory_offset FileOffset;
+
+    // NOTE(traian): A document that isn't UTF-8 is read into the staging memory and decoded into the
+    // destination. The bytes that the decoder didn't consume are moved in front of the next chunk.
+    text_file_format Format;
+    buffer Staging;
+    memory_size StagingCount;
+    // NOTE(traian): The line endings of the panel, which are recorded by the thread while it normalizes them.
+    text_line_endings *LineEndings;
+    // NOTE(traian): A carriage return at the end of the loaded text, which is only normalized once the next
+    // chunk shows whether a new line follows it.
+    memory_size PendingCount;
+
+    // NOTE(traian): The number of bytes of text that were written to the destination.
+    memory_size volatile LoadedSize;
+    b32 volatile IsCancelled;
+    b32 volatile IsDone;
+    // NOTE(traian): Set when a chunk couldn't be read, in which case the loaded text is only a part of the file.
+    b32 volatile HasFailed;
+
+    // NOTE(traian): Only accessed by the main thread.
+    b32 IsActive;
+};
+
+// NOTE(traian): The first chunk is read before the file is displayed, the rest is read in the background.
+#define TEXT_LOAD_FIRST_CHUNK_SIZE Kilobytes(512)
+#define TEXT_LOAD_CHUNK_SIZE Megabytes(4)
+
 struct text_caret_position
 {
     memory_size Offset;
-    u32 Line;
-    u32 Column;
+    u64 Line;
+    u64 Column;
 };
 
 struct text_caret
 {
     text_caret_position Position;
-    u32 TargetColumn;
+    u64 TargetColumn;
 
     text_caret_position Selection;
     b32 IsSelecting;
 };
 
+// NOTE(traian): The carets of a panel besides its main caret. They are sorted by offset and never overlap each
+// other or the main caret, so that an edit is applied at all of the carets in a single pass over the text.
+struct text_caret_list
+{
+    text_caret *Carets;
+    u64 Count;
+    u64 Capacity;
+};
+
+typedef enum regex_instruction_kind_enum : u8
+{
+    RegexInstruction_ByteSet,
+    RegexInstruction_Split,
+    // NOTE(traian): Zero-width assertions that the byte before (or after) the current position is a new line or
+    // the boundary of the text. The line anchors are compiled to them, swapped in the reversed program.
+    RegexInstruction_AssertPreviousNewLine,
+    RegexInstruction_AssertNextNewLine,
+    RegexInstruction_Match,
+}
+regex_instruction_kind;
+
+struct regex_instruction
+{
+    regex_instruction_kind Kind;
+    u32 ByteSetIndex;
+    u32 Out;
+    // NOTE(traian): The less preferred branch of a split.
+    u32 Out1;
+};
+
+struct regex_byte_set
+{
+    u32 Bits[8];
+};
+
+struct regex_program
+{
+    regex_instruction *Instructions;
+    u32 InstructionCount;
+    u32 Start;
+};
+
+// NOTE(traian): A DFA that is built lazily, one transition at a time, while the text is searched. The states are
+// sets of program instructions. The cache of the states is bounded, and when it fills up, it is flushed and the
+// search continues from a copy of the current state, so the memory never grows with the size of the text.
+struct regex_dfa
+{
+    regex_program *Program;
+    // NOTE(traian): An unanchored DFA starts a new thread of the program at every byte. A leftmost-first DFA drops
+    // the threads that the pattern prefers less than a thread that matched.
+    b32 IsUnanchored;
+    b32 IsLeftmostFirst;
+
+    u32 Stride;
+    u32 StateCapacity;
+    u32 StateCount;
+    u32 *Transitions;
+    u8 *StateFlags;
+    u32 *StateSetOffsets;
+    u32 *StateSetCounts;
+    u32 *HashSlots;
+
+    u32 SetEntryCapacity;
+    u32 SetEntryCount;
+    u32 *SetEntries;
+
+    u32 StartStates[2];
+    u32 FlushCount;
+};
+
+#define REGEX_PATTERN_CAPACITY 256
+#define REGEX_INSTRUCTION_CAPACITY 4096
+#define REGEX_BYTE_SET_CAPACITY 1024
+#define REGEX_DFA_STATE_CAPACITY 2048
+#define REGEX_DFA_SET_ENTRY_CAPACITY (64 * 1024)
+
+// NOTE(traian): A compiled regular expression. The forward DFA finds where the leftmost match ends, and the DFA
+// of the reversed pattern, which is run backwards from there, finds where the match starts. The bytes that no
+// part of the pattern tells apart share a class, so the transition tables only have a column per class.
+struct regex
+{
+    buffer Memory;
+    b32 IsValid;
+
+    regex_byte_set *ByteSets;
+    u32 ByteSetCount;
+    u8 ByteClasses[256];
+    u8 ClassRepresentatives[256];
+    u32 ClassCount;
+
+    regex_program Forward;
+    regex_program Reverse;
+    regex_dfa ForwardDFA;
+    regex_dfa ReverseDFA;
+
+    // NOTE(traian): The literal that every match starts with. The forward search skips to its occurrences
+    // whenever the DFA has no live threads.
+    char Prefix[REGEX_PATTERN_CAPACITY];
+    memory_size PrefixLength;
+
+    // NOTE(traian): The scratch memory of the transition computation.
+    u32 *ClosureStack;
+    u32 *CurrentStack;
+    u32 *ClosureMarks;
+    u32 *CurrentMarks;
+    u32 MarkGeneration;
+    u32 *NextSet;
+    u32 *CurrentSet;
+};
+
+#define TEXT_FIND_QUERY_CAPACITY 256
+
+struct text_find_match
+{
+    memory_offset Offset;
+    memory_size Size;
+};
+
+// NOTE(traian): The incremental find of a text panel. The matches are never empty, never overlap and are sorted
+// by offset. The text is searched in slices by the timer tick, so the matches before ScanOffset are known, while
+// the rest of the text is still to be searched. The visible text is searched directly while it isn't scanned yet.
+struct text_find
+{
+    b32 IsActive;
+    char Query[TEXT_FIND_QUERY_CAPACITY];
+    memory_size QueryLength;
+
+    // NOTE(traian): The query is either a literal or a regular expression, which is compiled every time the query
+    // changes. The query isn't valid if it's empty or if the regular expression is malformed.
+    b32 IsRegex;
+    b32 IsQueryValid;
+    regex Regex;
+
+    // NOTE(traian): The text that replaces every match. While the replacement is edited, the typed characters go
+    // to it instead of the query.
+    char Replacement[TEXT_FIND_QUERY_CAPACITY];
+    memory_size ReplacementLength;
+    b32 IsEditingReplacement;
+
+    // NOTE(traian): The offset of the caret when the find was started. Typing the query selects the first match
+    // that starts at or after it.
+    memory_offset StartOffset;
+
+    text_find_match *Matches;
+    u64 MatchCount;
+    u64 MatchCapacity;
+
+    memory_offset ScanOffset;
+    // NOTE(traian): The matches are discarded when the text is edited.
+    u64 EditVersion;
+
+    // NOTE(traian): A replace all waits for the scan to complete, and is dropped if the text is edited or the query
+    // changes in the meantime.
+    b32 IsReplaceAllPending;
+    u64 ReplaceAllEditVersion;
+};
+
+// NOTE(traian): The text is searched in slices of this size, until the time a timer tick spends on the find is up.
+#define TEXT_FIND_SLICE_SIZE Kilobytes(256)
+#define TEXT_FIND_TICK_SECONDS 0.003
+
+// NOTE(traian): The state of the lexer at the start of a line. Only the constructs that can continue on the next
+// line have a state of their own: block comments, line comments and strings that end with a backslash, and
+// raw strings. The state of a line that was never lexed is unknown. A line whose previous line was edited keeps
+// its last state, which is still drawn, but is marked as pending until it's lexed again.
+typedef enum syntax_state_enum : u8
+{
+    SyntaxState_Normal,
+    SyntaxState_BlockComment,
+    SyntaxState_LineComment,
+    SyntaxState_String,
+    SyntaxState_RawString,
+
+    SyntaxState_Unknown = 0x7F,
+    SyntaxState_PendingFlag = 0x80,
+}
+syntax_state;
+
+typedef enum syntax_class_enum : u8
+{
+    SyntaxClass_Default,
+    SyntaxClass_Keyword,
+    SyntaxClass_Comment,
+    SyntaxClass_String,
+    SyntaxClass_Number,
+    SyntaxClass_Preprocessor,
+}
+syntax_class;
+
+// NOTE(traian): The bytes of a line, starting at the offset (relative to the start of the line) and ending at
+// the next span, have the same class.
+struct syntax_span
+{
+    u32 Offset;
+    syntax_class Class;
+};
+
+// NOTE(traian): A raw string ends at a closing parenthesis that is followed by its delimiter, which the state of a
+// line doesn't remember. It's recovered by lexing the line where the raw string starts.
+#define SYNTAX_RAW_DELIMITER_CAPACITY 16
+
+struct syntax_lexer
+{
+    syntax_state State;
+    u8 RawDelimiterLength;
+    char RawDelimiter[SYNTAX_RAW_DELIMITER_CAPACITY];
+};
+
+// NOTE(traian): The spans of a line after the last one keep its class.
+#define SYNTAX_SPAN_CAPACITY 1024
+
+// NOTE(traian): A slice of the lines that is lexed by a work queue thread. The thread works on copies of the text
+// and of the states, so the panel can be edited while it runs, in which case its results are discarded. The lexing
+// starts at a line whose state is known and stops when a line ends in the state that the next line already had.
+struct text_highlight_job
+{
+    // NOTE(traian): The version of the highlight when the job was started.
+    u64 Version;
+    u64 StartLine;
+    syntax_state StartState;
+    // NOTE(traian): The states of the lines in [FirstLine, FirstLine + LineCount) are computed. The text contains
+    // the lines from StartLine up to the last one of them, including its new line.
+    u64 FirstLine;
+    u64 LineCount;
+    buffer Text;
+    memory_size TextSize;
+    buffer States;
+
+    // NOTE(traian): Written by the thread.
+    u64 ResultCount;
+    b32 HasConverged;
+    b32 volatile IsDone;
+
+    // NOTE(traian): Only accessed by the main thread.
+    b32 IsActive;
+};
+
+// NOTE(traian): The number of bytes after the first pending line that are copied for a job. The slice starts small,
+// since the lines after an edit usually converge right away, and grows while the jobs don't converge.
+#define TEXT_HIGHLIGHT_FIRST_SLICE_SIZE Kilobytes(64)
+#define TEXT_HIGHLIGHT_MAX_SLICE_SIZE Megabytes(4)
+
+// NOTE(traian): The syntax highlighting of a text panel. The state at the start of every line is kept, so an edit
+// only invalidates the lines after the edited ones, which are lexed again until their states are the same as
+// before. The states are computed in the background, one job at a time, and the colors are computed from them
+// for the visible lines when they are drawn.
+struct text_highlight
+{
+    b32 IsEnabled;
+    syntax_state *LineStates;
+    u64 LineCount;
+    u64 LineCapacity;
+    // NOTE(traian): Every line before it has a state that isn't pending.
+    u64 FirstPendingLine;
+    // NOTE(traian): The edits that don't go through ApplyTextEdit (such as a replace-all) discard the states.
+    u64 EditVersion;
+    // NOTE(traian): Incremented every time the states are moved or discarded, which makes the running job stale.
+    u64 Version;
+    text_highlight_job Job;
+    memory_size SliceSize;
+
+    // NOTE(traian): A line that is split by the gap of the buffer is copied here, so that it's lexed at once.
+    char *Scratch;
+    memory_size ScratchSize;
+};
+
+// NOTE(traian): The caret and the scroll position of a text panel. They are saved right before and right
+// after each edit, so undoing or redoing the edit restores them without scanning the text.
+struct text_view_state
+{
+    text_caret Caret;
+    u64 FirstLineIndex;
+    u64 FirstColumnIndex;
+    memory_size BufferOffset;
+};
+
+typedef enum text_edit_kind_enum : u8
+{
+    TextEditKind_Insert,
+    TextEditKind_Remove,
+}
+text_edit_kind;
+
+// NOTE(traian): An edit of the text of a panel. In the history memory, the record is followed by the bytes
+// that were inserted or removed (padded to 8 bytes) and by the total size of the record, so that the
+// records can be walked in both directions.
+// NOTE(traian): The bytes of a record are followed by the line endings of their new lines, relative to the offset
+// of the record: the ones that a removal dropped, or the ones that an insertion put back.
+struct text_edit_record
+{
+    memory_offset Offset;
+    memory_size ByteCount;
+    u64 LineEndingCount;
+    text_edit_kind Kind;
+
+    // NOTE(traian): Set if the record is undone and redone in the same step as the record before it.
+    b32 IsChained;
+
+    text_view_state Before;
+    text_view_state After;
+};
+
+// NOTE(traian): The undo/redo history of a text panel. The records in [0, UndoOffset) of the arena can be
+// undone, while the records in [UndoOffset, Arena.Offset) were undone and can be redone. When the arena is
+// full, the oldest records are discarded, so the memory of the history never exceeds its byte budget.
+struct text_history
+{
+    memory_arena Arena;
+    memory_offset UndoOffset;
+
+    // NOTE(traian): Set while the next edit is allowed to extend the last record, such as while typing.
+    b32 CanCoalesce;
+
+    // NOTE(traian): All of the edits that are made while a group is open are undone in a single step.
+    u32 GroupDepth;
+    b32 IsGroupEmpty;
+    text_view_state GroupBefore;
+    // NOTE(traian): The arena offset of the first record of the open group, which is never discarded while the group
+    // is open. When the group doesn't fit in the budget, the history is forgotten and the rest of the group isn't
+    // recorded, since a group can't be undone in part.
+    memory_offset GroupOffset;
+    b32 IsGroupDiscarded;
+};
+
+// NOTE(traian): The byte budget of the history of each text panel.
+#define TEXT_HISTORY_BUDGET_SIZE Megabytes(16)
+
+// NOTE(traian): Only edits up to this size are coalesced, and the coalesced record can't grow past the
+// maximum size, so that a single undo step never discards too much typing.
+#define TEXT_HISTORY_COALESCE_EDIT_SIZE 16
+#define TEXT_HISTORY_COALESCE_MAX_SIZE Kilobytes(1)
+
+// NOTE(traian): The journal of a text panel is an append-only file, next to the document, that records the
+// edits made since the document was last saved. If the editor dies before the document is saved, the journal
+// is replayed when the document is opened again. The file starts with a header, which identifies the version
+// of the document that the edits apply to, followed by the entries.
+struct text_journal_header
+{
+    u32 Magic;
+    u32 Version;
+    memory_size FileSize;
+    u64 FileWriteTime;
+};
+
+// NOTE(traian): An insertion entry is followed by the inserted bytes and by the line endings of their new lines,
+// relative to the offset of the entry. The checksum covers the entry (with the checksum set to zero) and what
+// follows it, so that an entry which was only partially written is detected.
+struct text_journal_entry
+{
+    memory_offset Offset;
+    memory_size ByteCount;
+    u64 LineEndingCount;
+    u32 Kind;
+    u32 Checksum;
+};
+
+// NOTE(traian): The recovered text is described by a list of pieces, which are either spans of the document or of
+// the bytes inserted by the journal, so that an entry only changes the pieces around its offset. The text is
+// copied once, after the last entry.
+struct text_journal_piece
+{
+    memory_offset Offset;
+    memory_size Size;
+    b32 IsInserted;
+};
+
+struct text_journal_replay
+{
+    text_journal_piece *Pieces;
+    u64 PieceCount;
+
+    // NOTE(traian): The piece that the last entry ended at, and where it starts in the text, since the next entry
+    // is usually close to it.
+    u64 CursorIndex;
+    memory_offset CursorOffset;
+    memory_size TextSize;
+
+    // NOTE(traian): The inserted bytes, one entry after the other, and the offsets of their line endings.
+    char *Inserted;
+    memory_size InsertedSize;
+    text_line_endings InsertedLineEndings;
+};
+
+// NOTE(traian): The entries are collected in memory and handed to a work queue thread at most once every
+// sync interval. The thread appends them to the file and flushes the file to the disk, so the editor never
+// waits for the disk while typing.
+struct text_journal
+{
+    char FileName[512];
+    platform_file File;
+    b32 IsOpen;
+
+    // NOTE(traian): Set if the journal file couldn't be created, so that it isn't retried on every edit.
+    b32 IsUnavailable;
+
+    // NOTE(traian): The offset in the file where the next batch of entries is written.
+    memory_offset FileOffset;
+
+    buffer Pending;
+    memory_size PendingSize;
+
+    // NOTE(traian): The batch that is being written by the work queue thread.
+    buffer Writing;
+    memory_size WritingSize;
+    memory_offset WritingOffset;
+    b32 volatile IsWriting;
+
+    // NOTE(traian): Set when entries were written to the file, but the file wasn't flushed since.
+    b32 NeedsSync;
+    u64 LastSyncWallClock;
+
+    // NOTE(traian): A full batch is handed to this queue right away, instead of waiting for the next sync.
+    platform_work_queue *WorkQueue;
+
+    // NOTE(traian): Set for the documents that are opened at startup, whose journal was left behind by a previous
+    // session. It's replayed once the document is loaded.
+    b32 IsRecoveryPending;
+};
+
+#define TEXT_JOURNAL_MAGIC 0x4C4A434F
+#define TEXT_JOURNAL_VERSION 2
+#define TEXT_JOURNAL_FILE_EXTENSION ".journal"
+#define TEXT_JOURNAL_BUFFER_SIZE Kilobytes(64)
+#define TEXT_JOURNAL_SYNC_INTERVAL_SECONDS 0.5
+
+// NOTE(traian): The hashes of the fixed-size chunks of a document, as it is on the disk. They are computed
+// when the document is loaded and updated by every save. The text of the panel is identical to the document
+// on the disk before the offset of the first edit, so a save only has to hash the chunks that follow it, and
+// skips the write when none of their hashes changed.
+struct text_disk_hashes
+{
+    buffer Memory;
+    u64 *ChunkHashes;
+    u64 ChunkCount;
+
+    // NOTE(traian): The version of the document that the hashes were computed for.
+    memory_size FileSize;
+    u64 FileWriteTime;
+    b32 IsValid;
+};
+
+// NOTE(traian): The load chunk sizes are multiples of the hash chunk size, so each loaded chunk is hashed on its own.
+#define TEXT_DISK_HASH_CHUNK_SIZE Kilobytes(64)
+
+// NOTE(traian): Statistics about the saves of the current document, which are displayed in the status bar.
+struct text_save_stats
+{
+    u64 SaveCount;
+    u64 SkippedCount;
+    memory_size LastWrittenSize;
+    memory_size TotalWrittenSize;
+
+    // NOTE(traian): The characters that the encoding of the document can't represent, which refused the last save.
+    u64 UnencodableCount;
+    text_encoding UnencodableEncoding;
+};
+
+// NOTE(traian): Produces the bytes of the document from the UTF-8 snapshot of a save, one chunk at a time, so
+// that the encoded document is never held in memory as a whole. The snapshot is returned as it is when it's
+// already the document.
+struct text_save_encoder
+{
+    text_file_format Format;
+    text_line_endings *LineEndings;
+    u8 *Text;
+    memory_size TextSize;
+    b32 IsTranscoded;
+
+    memory_offset TextOffset;
+    u64 LineEndingIndex;
+    buffer Staging;
+    memory_size StagingCount;
+
+    // NOTE(traian): The encoded bytes, which start with the ones that didn't fit in the last returned chunk.
+    buffer Output;
+    memory_size OutputCount;
+    memory_size ReturnedCount;
+    u64 ReplacedCount;
+};
+
+// NOTE(traian): A save of a text panel, which runs on a work queue thread. The main thread copies the text into
+// a snapshot before the save is queued, so the panel can be edited right away. The thread encodes the snapshot
+// into a temporary file next to the document and finally renames the temporary file over the document. The
+// document on the disk is therefore always either the old or the new version, even if the editor dies in the
+// middle of the save.
+struct text_save
+{
+    char FileName[512];
+    char TemporaryFileName[512];
+
+    buffer Snapshot;
+    memory_size SnapshotSize;
+    // NOTE(traian): The save is refused if the text has characters that the encoding can't represent, which are
+    // counted in UnencodableCount, so that it never loses any of them.
+    text_file_format Format;
+    u64 UnencodableCount;
+    // NOTE(traian): A copy of the line endings of the panel, since the panel can be edited during the save.
+    text_line_endings LineEndings;
+
+    // NOTE(traian): The edit version of the panel when the save was started.
+    u64 EditVersion;
+
+    // NOTE(traian): The offset of the journal entries that were made after the save was started.
+    memory_offset JournalOffset;
+
+    // NOTE(traian): Only the chunks that start at or after this offset can differ from the document on the disk.
+    // The thread replaces the disk hashes once the save succeeds.
+    text_disk_hashes *DiskHashes;
+    memory_size UnmodifiedSize;
+
+    b32 volatile IsDone;
+    b32 volatile HasSucceeded;
+    // NOTE(traian): The number of bytes that were actually written to the disk, which is 0 if the document
+    // on the disk already contained the text.
+    memory_size volatile BytesWritten;
+
+    // NOTE(traian): Only accessed by the main thread.
+    b32 IsActive;
+    text_save_stats Stats;
+};
+
+#define TEXT_SAVE_FILE_EXTENSION ".saving"
+// NOTE(traian): The snapshot is written in chunks of this size, at offsets that are multiples of it.
+#define TEXT_SAVE_CHUNK_SIZE Megabytes(4)
+
 struct text_panel
 {
     rectangle2 Surface;
     text_buffer Buffer;
+    text_line_index LineIndex;
+    text_load Load;
+    text_history History;
+    text_journal Journal;
+    text_save Save;
+    text_disk_hashes DiskHashes;
+    text_file_format Format;
+    text_line_endings LineEndings;
+    text_column_map ColumnMaps[TEXT_COLUMN_MAP_COUNT];
+    u64 ColumnMapClock;
     b32 IsSaveDirty;
+
+    // NOTE(traian): Incremented by every edit, so that a save knows if the panel was edited while saving.
+    u64 EditVersion;
+    // NOTE(traian): The offset of the first byte that was edited since the document was loaded or since the
+    // last save was started. INVALID_SIZE if the text wasn't edited.
+    memory_offset UnmodifiedSize;
     char *FileName;
-    u32 LineCount;
+    u64 LineCount;
 
-    u32 FirstLineIndex;
-    u32 FirstColumnIndex;
+    u64 FirstLineIndex;
+    u64 FirstColumnIndex;
     memory_size BufferOffset;
 
     text_caret Caret;
+    text_caret_list ExtraCarets;
+    text_find Find;
+    text_highlight Highlight;
+
+    // NOTE(traian): The commands that edit the text are ignored by a read-only panel.
+    b32 IsReadOnly;
+    // NOTE(traian): Set when the file couldn't be read completely. The partial text can't be edited or saved,
+    // so that it never replaces the document on the disk.
+    b32 HasLoadFailed;
+    // NOTE(traian): The name of a file that was opened from the results of a find in files, since the results
+    // don't outlive the search.
+    char FileNameStorage[PLATFORM_PATH_CAPACITY];
 
     // NOTE(traian): These are the number of lines/columns that fit completely on the screen.
     // There might be an aditional line at the bottom of the screen that only fits partially. In this
@@ -256,6 +1040,7 @@ typedef enum key_code_enum : u8
     KeyCode_PageDown,
     KeyCode_Backspace,
     KeyCode_Delete,
+    KeyCode_Escape,
 
     KeyCode_AlphabetKeyFirst = 'A',
     KeyCode_AlphabetKeyLast  = 'Z',
@@ -312,6 +1097,11 @@ struct command_entry
     u32 NextIndex;
     key_modifier Modifiers;
     editor_command_function *Callback;
+
+    // NOTE(traian): Set for the commands that move the caret, which are repeated for every caret of the panel.
+    b32 IsCaretCommand;
+    // NOTE(traian): Set for the commands that edit the text, which aren't executed on a read-only panel.
+    b32 IsEditCommand;
 };
 
 struct command_table
@@ -323,6 +1113,207 @@ struct command_table
     u32 CommandEntriesPoolOffset;
 };
 
+//
+// NOTE(traian): TRIGRAM INDEX.
+//
+
+// NOTE(traian): The index is stored in the directory that it covers. Being hidden, it's never indexed or searched.
+#define TRIGRAM_INDEX_FILE_NAME ".ocean_index"
+#define TRIGRAM_INDEX_TEMPORARY_FILE_NAME ".ocean_index.tmp"
+#define TRIGRAM_INDEX_MAGIC 0x5844494F
+#define TRIGRAM_INDEX_VERSION 1
+#define TRIGRAM_INDEX_TRIGRAM_CAPACITY (1 << 24)
+// NOTE(traian): The trigrams of the files are stored in chunks that every worker allocates for itself.
+#define TRIGRAM_INDEX_CHUNK_SIZE Megabytes(16)
+#define TRIGRAM_INDEX_CHUNK_CAPACITY 1024
+
+// NOTE(traian): The index file is made of the header, the file table, which is sorted by path, the trigram table,
+// which is sorted by trigram, and the sections that the tables point into. A posting list holds the indices of the
+// files that contain its trigram and a forward list holds the trigrams of its file, both sorted and stored as
+// varint deltas.
+struct trigram_index_header
+{
+    u32 Magic;
+    u32 Version;
+    // NOTE(traian): A build that was stopped writes an index without the trigram table, which can't be queried.
+    // The next build only reads the files that the stopped one didn't reach.
+    b32 IsComplete;
+    u32 FileCount;
+    u64 TrigramCount;
+    memory_size Size;
+
+    memory_offset FileTableOffset;
+    memory_offset TrigramTableOffset;
+    memory_offset PostingsOffset;
+    memory_size PostingsSize;
+    memory_offset ForwardListsOffset;
+    memory_size ForwardListsSize;
+    memory_offset PathsOffset;
+    memory_size PathsSize;
+};
+
+struct trigram_index_file
+{
+    u64 WriteTime;
+    memory_offset ForwardListOffset;
+    memory_size ForwardListSize;
+    // NOTE(traian): The path is relative to the directory and null terminated.
+    memory_offset PathOffset;
+    memory_size PathLength;
+};
+
+struct trigram_index_trigram
+{
+    u32 Trigram;
+    u32 FileCount;
+    memory_offset PostingOffset;
+    memory_size PostingSize;
+};
+
+// NOTE(traian): A file of the index that is being built. Its forward list is either in the memory of a worker,
+// or in the previous index if the file didn't change since then.
+struct trigram_index_entry
+{
+    b32 IsIndexed;
+    char *Path;
+    memory_size PathLength;
+    u64 WriteTime;
+    u8 *ForwardList;
+    memory_size ForwardListSize;
+};
+
+//
+// NOTE(traian): FIND IN FILES.
+//
+
+#define FIND_IN_FILES_WORKER_CAPACITY 16
+#define FIND_IN_FILES_DEQUE_CAPACITY 4096
+#define FIND_IN_FILES_ITEM_CAPACITY (1024 * 1024)
+#define FIND_IN_FILES_PATH_POOL_SIZE Megabytes(128)
+#define FIND_IN_FILES_RESULT_BLOCK_CAPACITY (256 * 1024)
+#define FIND_IN_FILES_RESULT_TEXT_SIZE Megabytes(32)
+// NOTE(traian): The results of a file are published once the file is searched, or when they fill the output.
+#define FIND_IN_FILES_OUTPUT_SIZE Kilobytes(64)
+// NOTE(traian): Only the start of a long line is shown in the results.
+#define FIND_IN_FILES_LINE_PREVIEW_SIZE 256
+// NOTE(traian): A file with a null byte in its first bytes is considered binary and isn't searched.
+#define FIND_IN_FILES_BINARY_SAMPLE_SIZE Kilobytes(8)
+
+// NOTE(traian): A file or a directory that was found by the walk, or a file of the trigram index. Its path is stored
+// in the path pool.
+struct find_in_files_item
+{
+    memory_offset PathOffset;
+    u32 PathLength;
+    b32 IsDirectory;
+    u64 WriteTime;
+};
+
+// NOTE(traian): The items of a worker. The worker pushes and pops items at the bottom, while the other workers
+// steal them from the top, so a worker walks its part of the tree depth first while the others take the
+// directories that are closest to the root.
+struct find_in_files_deque
+{
+    u64 volatile Top;
+    u64 volatile Bottom;
+    u32 Items[FIND_IN_FILES_DEQUE_CAPACITY];
+};
+
+// NOTE(traian): A run of complete result lines, which is appended to the results panel once it's ready.
+struct find_in_files_result_block
+{
+    memory_offset TextOffset;
+    memory_size TextSize;
+    u64 LineCount;
+    b32 volatile IsReady;
+};
+
+struct find_in_files_worker
+{
+    struct find_in_files *Search;
+    u32 WorkerIndex;
+    find_in_files_deque Deque;
+
+    // NOTE(traian): Every worker has its own copy of the query, since the regex DFA is built while searching.
+    text_find Find;
+
+    char *Output;
+    memory_size OutputCount;
+    u64 OutputLineCount;
+    u64 volatile SearchedFileCount;
+
+    // NOTE(traian): Only used while building the trigram index. The bits mark the trigrams that were already
+    // seen in the current file, so that every trigram is only listed once.
+    buffer TrigramBits;
+    buffer TrigramMemory;
+    u32 *Trigrams;
+    u32 *TrigramScratch;
+    memory_size TrigramCapacity;
+    buffer ForwardListChunks[TRIGRAM_INDEX_CHUNK_CAPACITY];
+    u32 ForwardListChunkCount;
+    memory_size ForwardListChunkUsed;
+    u64 volatile ReusedFileCount;
+};
+
+struct find_in_files
+{
+    // NOTE(traian): Set while the workers are running.
+    b32 IsActive;
+    u32 ResultsPanelIndex;
+    // NOTE(traian): The panel where the search was started, in which the results are opened.
+    u32 SourcePanelIndex;
+
+    char Directory[PLATFORM_PATH_CAPACITY];
+    memory_size DirectoryLength;
+    char Query[TEXT_FIND_QUERY_CAPACITY];
+    memory_size QueryLength;
+    b32 IsRegex;
+
+    buffer Memory;
+    find_in_files_item *Items;
+    u32 volatile ItemCount;
+    char *PathPool;
+    memory_size volatile PathPoolUsed;
+
+    find_in_files_result_block *ResultBlocks;
+    u32 volatile ResultBlockCount;
+    char *ResultText;
+    memory_size volatile ResultTextUsed;
+
+    u32 WorkerCount;
+    find_in_files_worker *Workers;
+    // NOTE(traian): The number of items that were pushed, but weren't processed yet. The walk is complete when
+    // it reaches zero.
+    u64 volatile PendingItemCount;
+    u32 volatile ActiveWorkerCount;
+    b32 volatile IsCancelled;
+    // NOTE(traian): Set when the tree or the results don't fit in the memory of the search.
+    b32 volatile IsTruncated;
+
+    // NOTE(traian): When the directory has a complete trigram index, the items are the files of the index that can
+    // contain a match, which the workers claim in order instead of walking the tree. A candidate that changed or
+    // disappeared since the index was built marks the index as stale.
+    b32 IsUsingIndex;
+    u32 CandidateCount;
+    u32 volatile NextCandidate;
+    b32 volatile IsIndexStale;
+
+    // NOTE(traian): Set when the workers build the trigram index of the directory instead of searching it. Once
+    // they stop, the index is written by another work entry.
+    b32 IsBuildingIndex;
+    trigram_index_entry *IndexEntries;
+    buffer IndexEntryMemory;
+    buffer PreviousIndex;
+    b32 IsWritingIndex;
+    b32 volatile IsIndexWritten;
+
+    // NOTE(traian): These are only accessed by the main thread.
+    u32 AbsorbedBlockCount;
+    u64 ResultLineCount;
+    u64 StartClock;
+    f64 ElapsedSeconds;
+};
+
 struct editor_state
 {
     // NOTE(traian): These are the dimensions of the window client area.
@@ -337,6 +1328,22 @@ struct editor_state
     u32 FocusedTextPanelIndex;
 
     command_table CommandTable;
+    // NOTE(traian): Consulted before the command table while the focused panel is finding text.
+    command_table FindCommandTable;
+    // NOTE(traian): Consulted before the command table while the focused panel shows the results of a find in files.
+    command_table FindInFilesCommandTable;
+    find_in_files FindInFiles;
+    // NOTE(traian): Builds the trigram index in the background, using the walk of the find in files.
+    find_in_files IndexBuild;
+    // NOTE(traian): Set when a file is saved, since the trigram index might still list its old trigrams.
+    b32 IsTrigramIndexStale;
+
+    platform_work_queue *WorkQueue;
+    platform_work_queue *FileQueue;
+    platform_work_queue *SearchQueue;
+    u32 SearchThreadCount;
+    platform_work_queue *IndexQueue;
+    u32 IndexThreadCount;
 };
 
 void InitializeEditor(editor_state *EditorState, editor_memory *EditorMemory);
@@ -349,6 +1356,10 @@ void EditorEventMouseButtonPressed(editor_state *EditorState, mouse_button Butto
 void EditorEventMouseButtonReleased(editor_state *EditorState, mouse_button Button);
 void EditorEventMouseMoved(editor_state *EditorState, s32 OffsetX, s32 OffsetY);
 void EditorEventWindowResized(editor_state *EditorState, u32 Width, u32 Height);
+// NOTE(traian): Called periodically by the platform layer. Returns true if the editor has to be redrawn.
+b32 EditorEventTimerTick(editor_state *EditorState);
+// NOTE(traian): Called by the platform layer before the editor exits.
+void EditorEventShutdown(editor_state *EditorState);
 
 //
 // NOTE(traian): PLATFORM LAYER.
@@ -359,10 +1370,53 @@ void PlatformReleaseMemory(buffer Block);
 
 memory_size PlatformGetFileSize(char *FileName);
 
+platform_file PlatformOpenFile(char *FileName);
+memory_size PlatformReadFile(platform_file *File, memory_offset FileOffset, buffer Buffer);
+void PlatformCloseFile(platform_file *File);
+
+// NOTE(traian): Opens the file for reading and writing, creating it if it doesn't exist. The content of an
+// existing file is kept, unless Truncate is set.
+platform_file PlatformOpenFileForWriting(char *FileName, b32 Truncate);
+memory_size PlatformWriteFile(platform_file *File, memory_offset FileOffset, buffer Buffer);
+void PlatformSetFileSize(platform_file *File, memory_size Size);
+// NOTE(traian): Blocks until all of the data written to the file reaches the disk.
+void PlatformFlushFile(platform_file *File);
+
+void PlatformDeleteFile(char *FileName);
+// NOTE(traian): Returns true if the directory exists afterwards. Only an empty directory can be deleted.
+b32 PlatformCreateDirectory(char *DirectoryName);
+void PlatformDeleteDirectory(char *DirectoryName);
+// NOTE(traian): Replaces the destination file, if it exists. The data of the source is on the disk when this
+// function returns.
+b32 PlatformMoveFile(char *SourceFileName, char *DestinationFileName);
+// NOTE(traian): Measured in platform specific units. Returns 0 if the file doesn't exist.
+u64 PlatformGetFileWriteTime(char *FileName);
+
+// NOTE(traian): Maps the entire file into memory as read-only. The returned view's Data is NULL if
+// the file couldn't be mapped (this includes empty files).
+buffer PlatformMapFile(char *FileName);
+void PlatformUnmapFile(buffer View);
+
+// NOTE(traian): Lists the entries of a directory, except for "." and "..". The links to other directories
+// are skipped, so that walking a tree can't loop.
+platform_directory_iterator PlatformBeginDirectoryIteration(char *DirectoryName);
+b32 PlatformNextDirectoryEntry(platform_directory_iterator *Iterator, platform_directory_entry *Entry);
+void PlatformEndDirectoryIteration(platform_directory_iterator *Iterator);
+
 memory_size PlatformReadEntireFile(char *FileName, buffer FileBuffer);
 buffer PlatformReadEntireFile(char *FileName, memory_arena *Arena);
 
 memory_size PlatformWriteEntireFile(char *FileName, buffer Buffer);
+memory_size PlatformWriteEntireFile(char *FileName, buffer *Buffers, u32 BufferCount);
+
+// NOTE(traian): Work entries can only be added by the main thread. Returns false if the queue is full, in which
+// case the entry isn't added.
+b32 PlatformAddWorkEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data);
+void PlatformCompleteAllWork(platform_work_queue *Queue);
+
+// NOTE(traian): The wall clock is measured in platform specific ticks.
+u64 PlatformGetWallClock();
+f64 PlatformGetSecondsElapsed(u64 StartWallClock, u64 EndWallClock);
 
 key_modifier PlatformGetKeyModifiers();
 b32 PlatformIsCapsLockActive();
@@ -0,0 +1,2247 @@
+/*  =====================================================================
+    $File:   ocean_benchmark.cpp $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+
+#include "ocean.h"
+#include "ocean_text.h"
+#include "ocean_trigram_index.h"
+
+// NOTE(traian): The benchmarks are platform independent and only use the platform layer for memory
+// and timing. The results are printed to the standard output.
+
+#define BENCHMARK_REPEAT_COUNT 3
+
+struct benchmark_random
+{
+    u64 State;
+};
+
+internal inline u64
+NextRandom(benchmark_random *Random)
+{
+    // NOTE(traian): xorshift64.
+    u64 X = Random->State;
+    X ^= X << 13;
+    X ^= X >> 7;
+    X ^= X << 17;
+    Random->State = X;
+    return X;
+}
+
+// NOTE(traian): Fills the buffer with printable ASCII lines between 0 and MaxLineLength characters long.
+internal void
+GenerateSyntheticText(buffer Text, u32 MaxLineLength, u64 Seed)
+{
+    benchmark_random Random = { Seed };
+    memory_size Index = 0;
+    while (Index < Text.Size)
+    {
+        memory_size LineLength = NextRandom(&Random) % (MaxLineLength + 1);
+        memory_size LineEnd = Minimum(Index + LineLength, Text.Size);
+        for (; Index < LineEnd; ++Index)
+        {
+            Text.Data[Index] = (u8)(' ' + (NextRandom(&Random) % 95));
+        }
+
+        if (Index < Text.Size)
+        {
+            Text.Data[Index++] = '\n';
+        }
+    }
+}
+
+internal void
+PrintBenchmarkResult(const char *Name, memory_size ByteCount, f64 Seconds)
+{
+    f64 Gigabytes = (f64)ByteCount / (f64)Gigabytes(1);
+    printf("    %-28s %8.2f ms %8.2f GB/s\n", Name, Seconds * 1000.0, Gigabytes / Seconds);
+}
+
+// NOTE(traian): The number of checks that failed, which is the exit code of the benchmark executable.
+global u32 GlobalFailedCheckCount;
+
+// NOTE(traian): Some benchmarks also check that the code they measure is correct, since they are the only place
+// where it runs outside of the editor.
+internal b32
+CheckBenchmarkResult(const char *Name, b32 IsCorrect)
+{
+    printf("    %-28s %s\n", Name, IsCorrect ? "ok" : "WRONG");
+    if (!IsCorrect)
+    {
+        ++GlobalFailedCheckCount;
+    }
+    return IsCorrect;
+}
+
+//=========================================================================================
+// NOTE(traian): NEW LINE KERNELS.
+//=========================================================================================
+
+typedef memory_size count_new_lines_kernel(char *Base, memory_size Count);
+typedef memory_size find_line_starts_kernel(char *Base, memory_size Count, memory_offset BaseOffset,
+                                             memory_offset *Output);
+
+struct new_line_kernel
+{
+    const char *Name;
+    b32 IsSupported;
+    count_new_lines_kernel *CountNewLines;
+    find_line_starts_kernel *FindLineStarts;
+};
+
+internal void
+BenchmarkNewLineKernels(memory_size TextSize)
+{
+    printf("New line kernels on %llu MB of synthetic text:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticText(Text, 120, 0x9E3779B97F4A7C15);
+
+    new_line_kernel Kernels[] =
+    {
+        { "Scalar", true, CountNewLines_Scalar, FindLineStarts_Scalar },
+        { "SSE2", GlobalProcessorFeatures.HasSSE2, CountNewLines_SSE2, FindLineStarts_SSE2 },
+        { "AVX2", GlobalProcessorFeatures.HasAVX2, CountNewLines_AVX2, FindLineStarts_AVX2 },
+    };
+
+    memory_size ExpectedCount = CountNewLines_Scalar((char *)Text.Data, Text.Size);
+    buffer LineStarts = PlatformAllocateMemory(ExpectedCount * sizeof(memory_offset));
+    printf("    %llu new lines.\n", ExpectedCount);
+
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(Kernels); ++KernelIndex)
+    {
+        new_line_kernel *Kernel = Kernels + KernelIndex;
+        if (!Kernel->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Kernel->Name);
+            continue;
+        }
+
+        f64 BestCountSeconds = 0.0;
+        f64 BestFindSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            memory_size Count = Kernel->CountNewLines((char *)Text.Data, Text.Size);
+            u64 CountClock = PlatformGetWallClock();
+            memory_size FoundCount = Kernel->FindLineStarts((char *)Text.Data, Text.Size, 0,
+                                                            (memory_offset *)LineStarts.Data);
+            u64 FindClock = PlatformGetWallClock();
+
+            if (Count != ExpectedCount || FoundCount != ExpectedCount)
+            {
+                printf("    %s kernel is WRONG: %llu counted, %llu found, %llu expected.\n",
+                       Kernel->Name, Count, FoundCount, ExpectedCount);
+                break;
+            }
+
+            f64 CountSeconds = PlatformGetSecondsElapsed(StartClock, CountClock);
+            f64 FindSeconds = PlatformGetSecondsElapsed(CountClock, FindClock);
+            if (Repeat == 0 || CountSeconds < BestCountSeconds)
+            {
+                BestCountSeconds = CountSeconds;
+            }
+            if (Repeat == 0 || FindSeconds < BestFindSeconds)
+            {
+                BestFindSeconds = FindSeconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "CountNewLines_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestCountSeconds);
+        sprintf_s(Name, sizeof(Name), "FindLineStarts_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestFindSeconds);
+    }
+
+    PlatformReleaseMemory(LineStarts);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT ITERATORS.
+//=========================================================================================
+
+// NOTE(traian): Fills the buffer with lines of printable ASCII, where roughly one character in
+// NonASCIIPeriod is a 2, 3 or 4 byte UTF-8 sequence, like source code with comments in other languages.
+internal void
+GenerateSyntheticUTF8Text(buffer Text, u32 MaxLineLength, u32 NonASCIIPeriod, u64 Seed)
+{
+    // NOTE(traian): 'e' with acute accent, CJK ideograph and an emoji.
+    u8 Sequences[3][4] = { { 0xC3, 0xA9 }, { 0xE4, 0xB8, 0xAD }, { 0xF0, 0x9F, 0x98, 0x80 } };
+
+    benchmark_random Random = { Seed };
+    memory_size Index = 0;
+    while (Index < Text.Size)
+    {
+        memory_size LineLength = NextRandom(&Random) % (MaxLineLength + 1);
+        memory_size LineEnd = Minimum(Index + LineLength, Text.Size);
+        while (Index < LineEnd)
+        {
+            u64 Value = NextRandom(&Random);
+            u32 SequenceIndex = (u32)((Value >> 32) % ArrayCount(Sequences));
+            u32 SequenceWidth = SequenceIndex + 2;
+            if ((Value % NonASCIIPeriod) == 0 && Index + SequenceWidth <= LineEnd)
+            {
+                CopyMem(Text.Data + Index, Sequences[SequenceIndex], SequenceWidth);
+                Index += SequenceWidth;
+            }
+            else
+            {
+                Text.Data[Index++] = (u8)(' ' + (Value % 95));
+            }
+        }
+
+        if (Index < Text.Size)
+        {
+            Text.Data[Index++] = '\n';
+        }
+    }
+}
+
+internal void
+BenchmarkTextIterator(memory_size TextSize)
+{
+    printf("Text iterator on %llu MB of mixed UTF-8 text:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticUTF8Text(Text, 120, 32, 0xD1B54A32D192ED03);
+
+    // NOTE(traian): An empty gap is placed in the middle of the text, so the ASCII runs are split at the gap
+    // just like in a buffer that was edited.
+    text_buffer Buffer = {};
+    Buffer.Base = (char *)Text.Data;
+    Buffer.Size = Text.Size;
+    Buffer.Used = Text.Size;
+    Buffer.GapOffset = Text.Size / 2;
+
+    // NOTE(traian): The ASCII fast path is measured with each of the kernels, by hiding the wider ones.
+    processor_features DetectedFeatures = GlobalProcessorFeatures;
+    processor_features ScalarFeatures = {};
+    processor_features SSE2Features = {};
+    SSE2Features.HasSSE2 = DetectedFeatures.HasSSE2;
+
+    struct iterator_variant
+    {
+        const char *Name;
+        b32 IsSupported;
+        processor_features Features;
+    };
+
+    iterator_variant Variants[] =
+    {
+        { "Scalar", true, ScalarFeatures },
+        { "SSE2", DetectedFeatures.HasSSE2, SSE2Features },
+        { "AVX2", DetectedFeatures.HasAVX2, DetectedFeatures },
+    };
+
+    u64 ExpectedCount = 0;
+    for (u32 VariantIndex = 0; VariantIndex < ArrayCount(Variants); ++VariantIndex)
+    {
+        iterator_variant *Variant = Variants + VariantIndex;
+        if (!Variant->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Variant->Name);
+            continue;
+        }
+
+        GlobalProcessorFeatures = Variant->Features;
+        f64 BestSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            u64 CodepointCount = 0;
+            u64 CodepointSum = 0;
+            text_iterator Iterator = NewTextIterator(&Buffer, 0);
+            while (IsValid(Iterator))
+            {
+                ++CodepointCount;
+                CodepointSum += Iterator.Codepoint;
+                Iterator = AdvanceIterator(Iterator);
+            }
+            u64 EndClock = PlatformGetWallClock();
+
+            if (ExpectedCount == 0)
+            {
+                ExpectedCount = CodepointCount;
+                printf("    %llu codepoints (checksum %llu).\n", CodepointCount, CodepointSum);
+            }
+            else if (CodepointCount != ExpectedCount)
+            {
+                printf("    %s iterator is WRONG: %llu codepoints, %llu expected.\n",
+                       Variant->Name, CodepointCount, ExpectedCount);
+                break;
+            }
+
+            f64 Seconds = PlatformGetSecondsElapsed(StartClock, EndClock);
+            if (Repeat == 0 || Seconds < BestSeconds)
+            {
+                BestSeconds = Seconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "AdvanceIterator_%s", Variant->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestSeconds);
+    }
+
+    GlobalProcessorFeatures = DetectedFeatures;
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT ENCODINGS.
+//=========================================================================================
+
+typedef b32 validate_utf8_kernel(u8 *Bytes, memory_size Count);
+typedef transcode_result transcode_kernel(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal);
+
+struct encoding_kernel
+{
+    const char *Name;
+    b32 IsSupported;
+    validate_utf8_kernel *IsValidUTF8;
+    transcode_kernel *DecodeUTF16LE;
+    transcode_kernel *DecodeWindows1252;
+};
+
+// NOTE(traian): Runs a transcoder over the whole source in load sized chunks, carrying the unconsumed bytes
+// over to the next chunk, just like the background load does.
+internal memory_size
+TranscodeInChunks(transcode_kernel *Kernel, buffer Source, u8 *Destination)
+{
+    memory_size WrittenCount = 0;
+    memory_offset Offset = 0;
+    while (Offset < Source.Size)
+    {
+        memory_size ChunkSize = Minimum(TEXT_LOAD_CHUNK_SIZE, Source.Size - Offset);
+        transcode_result Result = Kernel(Source.Data + Offset, ChunkSize, Destination + WrittenCount,
+                                         Offset + ChunkSize == Source.Size);
+        if (Result.ReadCount == 0)
+        {
+            break;
+        }
+
+        Offset += Result.ReadCount;
+        WrittenCount += Result.WrittenCount;
+    }
+
+    return WrittenCount;
+}
+
+internal void
+BenchmarkTextEncodings(memory_size TextSize)
+{
+    printf("Text encodings on %llu MB of mixed UTF-8 text:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticUTF8Text(Text, 120, 32, 0x94D049BB133111EB);
+
+    // NOTE(traian): The same text encoded as UTF-16LE and as Windows-1252 is the input of the decoders, and
+    // decoding it must give back exactly what was encoded.
+    buffer UTF16Text = PlatformAllocateMemory(GetMaxEncodedSize(TextEncoding_UTF16LE, TextSize));
+    UTF16Text.Size = EncodeText(TextEncoding_UTF16LE, Text.Data, Text.Size, UTF16Text.Data, true).WrittenCount;
+    buffer LatinText = PlatformAllocateMemory(GetMaxEncodedSize(TextEncoding_Windows1252, TextSize));
+    LatinText.Size = EncodeText(TextEncoding_Windows1252, Text.Data, Text.Size, LatinText.Data, true).WrittenCount;
+
+    u64 TextHash = HashTextChunk(Text.Data, Text.Size);
+    buffer Decoded = PlatformAllocateMemory(GetMaxDecodedSize(TextEncoding_Windows1252, LatinText.Size));
+    memory_size ExpectedLatinSize = TranscodeInChunks(DecodeWindows1252_Scalar, LatinText, Decoded.Data);
+
+    encoding_kernel Kernels[] =
+    {
+        { "Scalar", true, IsValidUTF8_Scalar, DecodeUTF16LE_Scalar, DecodeWindows1252_Scalar },
+        { "SSE2", GlobalProcessorFeatures.HasSSE2, IsValidUTF8_SSE2, DecodeUTF16LE_SSE2, DecodeWindows1252_SSE2 },
+        { "AVX2", GlobalProcessorFeatures.HasAVX2, IsValidUTF8_AVX2, NULL, NULL },
+    };
+
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(Kernels); ++KernelIndex)
+    {
+        encoding_kernel *Kernel = Kernels + KernelIndex;
+        if (!Kernel->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Kernel->Name);
+            continue;
+        }
+
+        f64 BestValidateSeconds = 0.0;
+        f64 BestUTF16Seconds = 0.0;
+        f64 BestLatinSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            b32 IsValid = Kernel->IsValidUTF8(Text.Data, Text.Size);
+            u64 ValidateClock = PlatformGetWallClock();
+            if (!IsValid)
+            {
+                printf("    %s validator is WRONG: the text was rejected.\n", Kernel->Name);
+                break;
+            }
+            BestValidateSeconds = (Repeat == 0) ? PlatformGetSecondsElapsed(StartClock, ValidateClock) :
+                Minimum(BestValidateSeconds, PlatformGetSecondsElapsed(StartClock, ValidateClock));
+
+            if (Kernel->DecodeUTF16LE)
+            {
+                StartClock = PlatformGetWallClock();
+                memory_size DecodedSize = TranscodeInChunks(Kernel->DecodeUTF16LE, UTF16Text, Decoded.Data);
+                u64 DecodeClock = PlatformGetWallClock();
+                if (DecodedSize != Text.Size || HashTextChunk(Decoded.Data, DecodedSize) != TextHash)
+                {
+                    printf("    %s UTF-16LE decoder is WRONG.\n", Kernel->Name);
+                    break;
+                }
+                BestUTF16Seconds = (Repeat == 0) ? PlatformGetSecondsElapsed(StartClock, DecodeClock) :
+                    Minimum(BestUTF16Seconds, PlatformGetSecondsElapsed(StartClock, DecodeClock));
+            }
+
+            if (Kernel->DecodeWindows1252)
+            {
+                StartClock = PlatformGetWallClock();
+                memory_size DecodedSize = TranscodeInChunks(Kernel->DecodeWindows1252, LatinText, Decoded.Data);
+                u64 DecodeClock = PlatformGetWallClock();
+                if (DecodedSize != ExpectedLatinSize)
+                {
+                    printf("    %s Windows-1252 decoder is WRONG.\n", Kernel->Name);
+                    break;
+                }
+                BestLatinSeconds = (Repeat == 0) ? PlatformGetSecondsElapsed(StartClock, DecodeClock) :
+                    Minimum(BestLatinSeconds, PlatformGetSecondsElapsed(StartClock, DecodeClock));
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "IsValidUTF8_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestValidateSeconds);
+        if (Kernel->DecodeUTF16LE)
+        {
+            sprintf_s(Name, sizeof(Name), "DecodeUTF16LE_%s", Kernel->Name);
+            PrintBenchmarkResult(Name, UTF16Text.Size, BestUTF16Seconds);
+        }
+        if (Kernel->DecodeWindows1252)
+        {
+            sprintf_s(Name, sizeof(Name), "DecodeWindows1252_%s", Kernel->Name);
+            PrintBenchmarkResult(Name, LatinText.Size, BestLatinSeconds);
+        }
+    }
+
+    PlatformReleaseMemory(Decoded);
+    PlatformReleaseMemory(LatinText);
+    PlatformReleaseMemory(UTF16Text);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): LINE ENDINGS.
+//=========================================================================================
+
+typedef transcode_result normalize_line_endings_kernel(u8 *Text, memory_size Count, b32 IsFinal);
+typedef memory_size expand_line_endings_kernel(u8 *Source, memory_size Count, u8 *Destination);
+
+struct line_ending_kernel
+{
+    const char *Name;
+    b32 IsSupported;
+    normalize_line_endings_kernel *NormalizeLineEndings;
+    expand_line_endings_kernel *ExpandLineEndings;
+};
+
+internal void
+BenchmarkLineEndings(memory_size TextSize)
+{
+    printf("Line endings on %llu MB of synthetic text:\n", TextSize / Megabytes(1));
+
+    // NOTE(traian): The normalized text must be exactly the text before its line endings were expanded.
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticText(Text, 120, 0xBF58476D1CE4E5B9);
+    u64 TextHash = HashTextChunk(Text.Data, Text.Size);
+
+    buffer CRLFText = PlatformAllocateMemory(2 * TextSize);
+    CRLFText.Size = ExpandLineEndings_Scalar(Text.Data, Text.Size, CRLFText.Data);
+    buffer Normalized = PlatformAllocateMemory(CRLFText.Size);
+
+    line_ending_kernel Kernels[] =
+    {
+        { "Scalar", true, NormalizeLineEndings_Scalar, ExpandLineEndings_Scalar },
+        { "SSE2", GlobalProcessorFeatures.HasSSE2, NormalizeLineEndings_SSE2, ExpandLineEndings_SSE2 },
+        { "AVX2", GlobalProcessorFeatures.HasAVX2, NormalizeLineEndings_AVX2, ExpandLineEndings_AVX2 },
+    };
+
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(Kernels); ++KernelIndex)
+    {
+        line_ending_kernel *Kernel = Kernels + KernelIndex;
+        if (!Kernel->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Kernel->Name);
+            continue;
+        }
+
+        f64 BestNormalizeSeconds = 0.0;
+        f64 BestExpandSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            // NOTE(traian): The text is normalized in place, so it's copied first.
+            CopyMem(Normalized.Data, CRLFText.Data, CRLFText.Size);
+            u64 StartClock = PlatformGetWallClock();
+            transcode_result Result = Kernel->NormalizeLineEndings(Normalized.Data, CRLFText.Size, true);
+            u64 NormalizeClock = PlatformGetWallClock();
+            memory_size ExpandedCount = Kernel->ExpandLineEndings(Text.Data, Text.Size, CRLFText.Data);
+            u64 ExpandClock = PlatformGetWallClock();
+
+            if (Result.ReadCount != CRLFText.Size || Result.WrittenCount != Text.Size ||
+                HashTextChunk(Normalized.Data, Result.WrittenCount) != TextHash || ExpandedCount != CRLFText.Size)
+            {
+                printf("    %s kernels are WRONG: %llu normalized, %llu expanded.\n", Kernel->Name,
+                       Result.WrittenCount, ExpandedCount);
+                break;
+            }
+
+            f64 NormalizeSeconds = PlatformGetSecondsElapsed(StartClock, NormalizeClock);
+            f64 ExpandSeconds = PlatformGetSecondsElapsed(NormalizeClock, ExpandClock);
+            if (Repeat == 0 || NormalizeSeconds < BestNormalizeSeconds)
+            {
+                BestNormalizeSeconds = NormalizeSeconds;
+            }
+            if (Repeat == 0 || ExpandSeconds < BestExpandSeconds)
+            {
+                BestExpandSeconds = ExpandSeconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "NormalizeLineEndings_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, CRLFText.Size, BestNormalizeSeconds);
+        sprintf_s(Name, sizeof(Name), "ExpandLineEndings_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestExpandSeconds);
+    }
+
+    PlatformReleaseMemory(Normalized);
+    PlatformReleaseMemory(CRLFText);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): TOKEN KERNELS.
+//=========================================================================================
+
+typedef memory_size count_token_bytes_kernel(char *Base, memory_size Count, token_class Class);
+
+struct token_kernel
+{
+    const char *Name;
+    b32 IsSupported;
+    count_token_bytes_kernel *CountLeadingTokenBytes;
+    count_token_bytes_kernel *CountTrailingTokenBytes;
+};
+
+internal void
+BenchmarkTokenKernels(memory_size TextSize)
+{
+    printf("Token kernels on a %llu MB token:\n", TextSize / Megabytes(1));
+
+    // NOTE(traian): A single token that spans the whole text, which is the worst case for the token motion
+    // commands. The last byte isn't part of the token, so the backward scan has to stop right before it.
+    buffer Text = PlatformAllocateMemory(TextSize);
+    const char TokenCharacters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+    for (memory_offset Offset = 0; Offset < Text.Size; ++Offset)
+    {
+        Text.Data[Offset] = TokenCharacters[Offset % (ArrayCount(TokenCharacters) - 1)];
+    }
+    Text.Data[Text.Size - 1] = '(';
+    memory_size TokenSize = Text.Size - 1;
+
+    token_kernel Kernels[] =
+    {
+        { "Scalar", true, CountLeadingTokenBytes_Scalar, CountTrailingTokenBytes_Scalar },
+        { "SSE2", GlobalProcessorFeatures.HasSSE2, CountLeadingTokenBytes_SSE2, CountTrailingTokenBytes_SSE2 },
+        { "AVX2", GlobalProcessorFeatures.HasAVX2, CountLeadingTokenBytes_AVX2, CountTrailingTokenBytes_AVX2 },
+    };
+
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(Kernels); ++KernelIndex)
+    {
+        token_kernel *Kernel = Kernels + KernelIndex;
+        if (!Kernel->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Kernel->Name);
+            continue;
+        }
+
+        f64 BestLeadingSeconds = 0.0;
+        f64 BestTrailingSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            memory_size LeadingCount = Kernel->CountLeadingTokenBytes((char *)Text.Data, Text.Size,
+                                                                      TokenClass_Contiguous);
+            u64 LeadingClock = PlatformGetWallClock();
+            memory_size TrailingCount = Kernel->CountTrailingTokenBytes((char *)Text.Data, TokenSize,
+                                                                        TokenClass_Contiguous);
+            u64 TrailingClock = PlatformGetWallClock();
+
+            if (LeadingCount != TokenSize || TrailingCount != TokenSize)
+            {
+                printf("    %s kernels are WRONG: %llu leading, %llu trailing.\n", Kernel->Name,
+                       LeadingCount, TrailingCount);
+                break;
+            }
+
+            f64 LeadingSeconds = PlatformGetSecondsElapsed(StartClock, LeadingClock);
+            f64 TrailingSeconds = PlatformGetSecondsElapsed(LeadingClock, TrailingClock);
+            if (Repeat == 0 || LeadingSeconds < BestLeadingSeconds)
+            {
+                BestLeadingSeconds = LeadingSeconds;
+            }
+            if (Repeat == 0 || TrailingSeconds < BestTrailingSeconds)
+            {
+                BestTrailingSeconds = TrailingSeconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "CountLeadingTokenBytes_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestLeadingSeconds);
+        sprintf_s(Name, sizeof(Name), "CountTrailingTokenBytes_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, TokenSize, BestTrailingSeconds);
+    }
+
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): FIND KERNELS.
+//=========================================================================================
+
+typedef memory_size find_literal_kernel(char *Base, memory_size Count, char *Pattern, memory_size PatternLength);
+
+struct find_kernel
+{
+    const char *Name;
+    b32 IsSupported;
+    find_literal_kernel *FindLiteral;
+};
+
+internal void
+BenchmarkFindKernels(memory_size TextSize)
+{
+    printf("Find kernels on %llu MB of source code:\n", TextSize / Megabytes(1));
+
+    // NOTE(traian): The query shares its first and last bytes with many positions of the text, so the candidates
+    // that the vector kernels confirm aren't only the single match at the end of the text.
+    buffer Text = PlatformAllocateMemory(TextSize);
+    const char Line[] = "    Result = GetBufferOffsetOfLine(&Panel->LineIndex, Panel->FirstLineIndex);\n";
+    for (memory_offset Offset = 0; Offset < Text.Size; ++Offset)
+    {
+        Text.Data[Offset] = Line[Offset % (ArrayCount(Line) - 1)];
+    }
+
+    char Query[] = "LineIndex->FirstLine";
+    memory_size QueryLength = ArrayCount(Query) - 1;
+    memory_offset MatchOffset = Text.Size - QueryLength;
+    CopyMem(Text.Data + MatchOffset, Query, QueryLength);
+
+    find_kernel Kernels[] =
+    {
+        { "Scalar", true, FindLiteral_Scalar },
+        { "SSE2", GlobalProcessorFeatures.HasSSE2, FindLiteral_SSE2 },
+        { "AVX2", GlobalProcessorFeatures.HasAVX2, FindLiteral_AVX2 },
+    };
+
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(Kernels); ++KernelIndex)
+    {
+        find_kernel *Kernel = Kernels + KernelIndex;
+        if (!Kernel->IsSupported)
+        {
+            printf("    %-28s not supported by the processor.\n", Kernel->Name);
+            continue;
+        }
+
+        f64 BestSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            memory_size Index = Kernel->FindLiteral((char *)Text.Data, Text.Size, Query, QueryLength);
+            u64 EndClock = PlatformGetWallClock();
+
+            if (Index != MatchOffset)
+            {
+                printf("    %s kernel is WRONG: found %llu, expected %llu.\n", Kernel->Name, Index, MatchOffset);
+                break;
+            }
+
+            f64 Seconds = PlatformGetSecondsElapsed(StartClock, EndClock);
+            if (Repeat == 0 || Seconds < BestSeconds)
+            {
+                BestSeconds = Seconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "FindLiteral_%s", Kernel->Name);
+        PrintBenchmarkResult(Name, Text.Size, BestSeconds);
+    }
+
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): REGEX SEARCH.
+//=========================================================================================
+
+struct regex_benchmark_query
+{
+    const char *Pattern;
+    b32 IsRegex;
+};
+
+// NOTE(traian): Counts the matches of the query in the whole buffer, the way the incremental find scans it.
+internal u64
+CountBenchmarkMatches(text_buffer *Buffer, regex *Regex, regex_benchmark_query *Query)
+{
+    u64 MatchCount = 0;
+    memory_offset Offset = 0;
+    memory_size PatternLength = StringLength((char *)Query->Pattern);
+    while (Offset < Buffer->Used)
+    {
+        text_find_match Match;
+        if (Query->IsRegex)
+        {
+            if (!FindRegexInBuffer(Regex, Buffer, Offset, Buffer->Used, &Match))
+            {
+                break;
+            }
+        }
+        else
+        {
+            Match.Offset = FindTextInBuffer(Buffer, Offset, Buffer->Used, (char *)Query->Pattern, PatternLength);
+            Match.Size = PatternLength;
+            if (Match.Offset == INVALID_SIZE)
+            {
+                break;
+            }
+        }
+
+        ++MatchCount;
+        Offset = Match.Offset + Maximum(Match.Size, 1);
+    }
+
+    return MatchCount;
+}
+
+// NOTE(traian): Fills the buffer with lines of code that are picked at random, so the matches aren't spaced evenly
+// and every line is seen in many different contexts.
+internal void
+GenerateSyntheticSourceCode(buffer Text, u64 Seed)
+{
+    const char *Lines[] =
+    {
+        "    memory_offset Result = GetBufferOffsetOfLine(&Panel->LineIndex, Panel->FirstLineIndex);\n",
+        "    text_caret *Caret = &Panel->Caret;\n",
+        "    if (Panel->Load.IsActive && Line >= Panel->LineIndex.Count)\n",
+        "    {\n",
+        "    }\n",
+        "        SetCaretFromTextOffset(Panel, Settings, Caret, Offset);\n",
+        "    return Result;\n",
+        "internal inline u64\n",
+        "GetLineOfBufferOffset(text_line_index *LineIndex, memory_offset Offset)\n",
+        "        Caret->Position.Column = GetColumnOfLineOffset(Map, Offset - Map->LineOffset);\n",
+        "    // NOTE(traian): The lines after the first visible line are drawn until the panel is full.\n",
+        "\n",
+    };
+
+    benchmark_random Random = { Seed };
+    memory_offset Offset = 0;
+    while (Offset < Text.Size)
+    {
+        const char *Line = Lines[NextRandom(&Random) % ArrayCount(Lines)];
+        for (; *Line && Offset < Text.Size; ++Line)
+        {
+            Text.Data[Offset++] = *Line;
+        }
+    }
+}
+
+internal void
+BenchmarkRegexSearch(memory_size TextSize)
+{
+    printf("Regex search on %llu MB of source code:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticSourceCode(Text, 0x9E3779B97F4A7C15);
+
+    text_buffer Buffer = {};
+    Buffer.Base = (char *)Text.Data;
+    Buffer.Size = Text.Size;
+    Buffer.Used = Text.Size;
+    Buffer.GapOffset = Text.Size / 2;
+
+    // NOTE(traian): The first regex is the same literal as the first query, so it measures the cost of going
+    // through the DFA when the prefilter does all the work. The last ones have no literal prefix at all.
+    regex_benchmark_query Queries[] =
+    {
+        { "GetColumnOfLineOffset", false },
+        { "GetColumnOfLineOffset", true },
+        { "GetColumn\\w+\\(Map", true },
+        { "^\\s*return \\w+;$", true },
+        { "\\w+->First\\w+", true },
+        { "(Get|Set)\\w+Line", true },
+        { "[A-Z]\\w*\\(&?Panel", true },
+        { "\\w+->Zzz\\w+", true },
+    };
+
+    regex Regex = {};
+    for (u32 QueryIndex = 0; QueryIndex < ArrayCount(Queries); ++QueryIndex)
+    {
+        regex_benchmark_query *Query = Queries + QueryIndex;
+        if (Query->IsRegex && !CompileRegex(&Regex, (char *)Query->Pattern, StringLength((char *)Query->Pattern)))
+        {
+            printf("    %s is not a valid regex.\n", Query->Pattern);
+            continue;
+        }
+
+        u64 MatchCount = 0;
+        f64 BestSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 StartClock = PlatformGetWallClock();
+            MatchCount = CountBenchmarkMatches(&Buffer, &Regex, Query);
+            u64 EndClock = PlatformGetWallClock();
+
+            f64 Seconds = PlatformGetSecondsElapsed(StartClock, EndClock);
+            if (Repeat == 0 || Seconds < BestSeconds)
+            {
+                BestSeconds = Seconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "%s %s", Query->IsRegex ? "regex" : "literal", Query->Pattern);
+        PrintBenchmarkResult(Name, Text.Size, BestSeconds);
+        if (Query->IsRegex)
+        {
+            printf("        %llu matches, %u + %u DFA states, %u cache flushes\n", MatchCount,
+                   Regex.ForwardDFA.StateCount, Regex.ReverseDFA.StateCount,
+                   Regex.ForwardDFA.FlushCount + Regex.ReverseDFA.FlushCount);
+        }
+        else
+        {
+            printf("        %llu matches\n", MatchCount);
+        }
+    }
+
+    ReleaseRegex(&Regex);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): REPLACE ALL.
+//=========================================================================================
+
+internal void
+BenchmarkReplaceAll(memory_size TextSize)
+{
+    printf("Replace all on %llu MB of source code:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticSourceCode(Text, 0x2545F4914F6CDD1D);
+
+    // NOTE(traian): The panel has no file, so nothing is journaled, and the replaced text doesn't fit in the
+    // history, so only the rebuild of the text is measured.
+    buffer PanelMemory = PlatformAllocateMemory(sizeof(text_panel));
+    text_panel *Panel = (text_panel *)PanelMemory.Data;
+    Panel->Journal.IsUnavailable = true;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+
+    editor_settings Settings = {};
+    Settings.TabWidth = 4;
+
+    struct replace_query
+    {
+        const char *Query;
+        const char *Replacement;
+    };
+
+    replace_query Queries[] =
+    {
+        { "Panel", "TextPanel" },
+        { "TextPanel", "Panel" },
+        { "Offset", "Pos" },
+    };
+
+    for (u32 QueryIndex = 0; QueryIndex < ArrayCount(Queries); ++QueryIndex)
+    {
+        replace_query *Query = Queries + QueryIndex;
+        text_find *Find = &Panel->Find;
+
+        // NOTE(traian): Every query is replaced in the text that the previous one left behind.
+        if (QueryIndex == 0)
+        {
+            buffer TextCopy = PlatformAllocateMemory(Text.Size + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+            CopyMem(TextCopy.Data, Text.Data, Text.Size);
+            Panel->Buffer.Base = (char *)TextCopy.Data;
+            Panel->Buffer.Size = TextCopy.Size;
+            Panel->Buffer.Used = Text.Size;
+            Panel->Buffer.GapOffset = Text.Size;
+            BuildLineIndex(&Panel->LineIndex, &Panel->Buffer);
+            Panel->LineCount = Panel->LineIndex.Count - 1;
+        }
+
+        Find->QueryLength = StringLength((char *)Query->Query);
+        CopyMem(Find->Query, (void *)Query->Query, Find->QueryLength);
+        UpdateTextFindQuery(Panel);
+
+        memory_size OldSize = Panel->Buffer.Used;
+        u64 StartClock = PlatformGetWallClock();
+        CompleteTextFind(Panel);
+        u64 MatchCount = Find->MatchCount;
+        text_view_state Before = GetTextViewState(Panel);
+        ReplaceAllTextMatches(Panel, &Settings, (char *)Query->Replacement,
+                              StringLength((char *)Query->Replacement), &Before);
+        u64 EndClock = PlatformGetWallClock();
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "%s -> %s", Query->Query, Query->Replacement);
+        PrintBenchmarkResult(Name, OldSize, PlatformGetSecondsElapsed(StartClock, EndClock));
+        printf("        %llu matches, %llu lines\n", MatchCount, Panel->LineCount + 1);
+    }
+
+    ReleaseBufferMemory(&Panel->Buffer);
+    PlatformReleaseMemory(PanelMemory);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): TRIGRAM INDEX.
+//=========================================================================================
+
+// NOTE(traian): Every file is a slice of source code, whose trigrams are in almost every file, followed by a
+// random identifier, whose trigrams are rare, like the names that a search in a large tree usually looks for.
+internal void
+BenchmarkTrigramIndex(u32 FileCount, memory_size FileSize)
+{
+    printf("Trigram index of %u files of %llu bytes:\n", FileCount, FileSize);
+
+    const memory_size IdentifierLength = 16;
+    buffer Source = PlatformAllocateMemory(Megabytes(64));
+    GenerateSyntheticSourceCode(Source, 0x94D049BB133111EB);
+    buffer Files = PlatformAllocateMemory(FileCount * FileSize);
+    benchmark_random Random = { 0xBF58476D1CE4E5B9 };
+    for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+    {
+        u8 *File = Files.Data + FileIndex * FileSize;
+        memory_size SliceSize = FileSize - IdentifierLength;
+        CopyMem(File, Source.Data + NextRandom(&Random) % (Source.Size - SliceSize), SliceSize);
+        for (memory_offset Index = SliceSize; Index < FileSize; ++Index)
+        {
+            File[Index] = (u8)('a' + NextRandom(&Random) % 26);
+        }
+    }
+
+    buffer EntryMemory = PlatformAllocateMemory(FileCount * sizeof(trigram_index_entry));
+    trigram_index_entry *Entries = (trigram_index_entry *)EntryMemory.Data;
+    buffer PathMemory = PlatformAllocateMemory(FileCount * 32);
+    buffer ForwardListMemory = PlatformAllocateMemory(4 * FileCount * FileSize);
+    buffer Bits = PlatformAllocateMemory(TRIGRAM_INDEX_TRIGRAM_CAPACITY / 8);
+    buffer TrigramMemory = PlatformAllocateMemory(2 * FileSize * sizeof(u32));
+    u32 *Trigrams = (u32 *)TrigramMemory.Data;
+
+    u64 StartClock = PlatformGetWallClock();
+    memory_offset ForwardListOffset = 0;
+    for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+    {
+        trigram_index_entry *Entry = Entries + FileIndex;
+        Entry->IsIndexed = true;
+        Entry->Path = (char *)PathMemory.Data + FileIndex * 32;
+        Entry->PathLength = sprintf_s(Entry->Path, 32, "dir%u/file%u.cpp", FileIndex % 997, FileIndex);
+
+        memory_size TrigramCount = CollectTrigrams(Files.Data + FileIndex * FileSize, FileSize, (u64 *)Bits.Data, Trigrams);
+        u32 *SortedTrigrams = SortTrigrams(Trigrams, Trigrams + FileSize, TrigramCount);
+        Entry->ForwardList = ForwardListMemory.Data + ForwardListOffset;
+        Entry->ForwardListSize = EncodeTrigramForwardList(SortedTrigrams, TrigramCount, Entry->ForwardList);
+        ForwardListOffset += Entry->ForwardListSize;
+    }
+    u64 ForwardClock = PlatformGetWallClock();
+    buffer Index = BuildTrigramIndex(Entries, FileCount, true);
+    u64 EndClock = PlatformGetWallClock();
+
+    trigram_index_header *Header = GetTrigramIndexHeader(Index);
+    PrintBenchmarkResult("forward lists", Files.Size, PlatformGetSecondsElapsed(StartClock, ForwardClock));
+    PrintBenchmarkResult("posting lists", Files.Size, PlatformGetSecondsElapsed(ForwardClock, EndClock));
+    printf("        %llu trigrams, %llu MB index\n", Header->TrigramCount, Index.Size / Megabytes(1));
+
+    // NOTE(traian): The identifier of a file is only in that file, so the index selects a single candidate.
+    char Identifier[16 + 1] = {};
+    CopyMem(Identifier, Files.Data + (FileCount / 2) * FileSize + FileSize - IdentifierLength, IdentifierLength);
+    const char *Queries[] = { "GetColumnOfLineOffset", Identifier, "SetCaretFromTextOffset(Panel, Zzz" };
+
+    buffer CandidateMemory = PlatformAllocateMemory(FileCount * sizeof(u32));
+    for (u32 QueryIndex = 0; QueryIndex < ArrayCount(Queries); ++QueryIndex)
+    {
+        char *Query = (char *)Queries[QueryIndex];
+        memory_size QueryLength = StringLength(Query);
+
+        u32 CandidateCount = 0;
+        f64 BestSeconds = 0.0;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            u64 QueryStartClock = PlatformGetWallClock();
+            CandidateCount = FindTrigramIndexCandidates(Index, Header, Query, QueryLength, (u32 *)CandidateMemory.Data);
+            f64 Seconds = PlatformGetSecondsElapsed(QueryStartClock, PlatformGetWallClock());
+            if (Repeat == 0 || Seconds < BestSeconds)
+            {
+                BestSeconds = Seconds;
+            }
+        }
+
+        // NOTE(traian): Every file that matches has to be a candidate.
+        u64 ScanStartClock = PlatformGetWallClock();
+        u32 MatchCount = 0;
+        for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+        {
+            char *File = (char *)Files.Data + FileIndex * FileSize;
+            MatchCount += (FindLiteral(File, FileSize, Query, QueryLength) < FileSize);
+        }
+        f64 ScanSeconds = PlatformGetSecondsElapsed(ScanStartClock, PlatformGetWallClock());
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "query %.20s", Query);
+        PrintBenchmarkResult(Name, Files.Size, BestSeconds);
+        printf("        %u candidates, %u matching files, %.2f ms to scan every file\n", CandidateCount, MatchCount,
+               ScanSeconds * 1000.0);
+        if (CandidateCount < MatchCount)
+        {
+            printf("        the index is WRONG: a matching file isn't a candidate.\n");
+        }
+    }
+
+    PlatformReleaseMemory(CandidateMemory);
+    PlatformReleaseMemory(Index);
+    PlatformReleaseMemory(TrigramMemory);
+    PlatformReleaseMemory(Bits);
+    PlatformReleaseMemory(ForwardListMemory);
+    PlatformReleaseMemory(PathMemory);
+    PlatformReleaseMemory(EntryMemory);
+    PlatformReleaseMemory(Files);
+    PlatformReleaseMemory(Source);
+}
+
+//=========================================================================================
+// NOTE(traian): SYNTAX HIGHLIGHT.
+//=========================================================================================
+
+// NOTE(traian): Runs the highlight jobs on the calling thread, one after the other, until no line is pending. Returns
+// the seconds that were spent preparing and absorbing the jobs, which is the work left on the main thread.
+internal f64
+RunTextHighlightJobs(text_panel *Panel, f64 *JobSeconds)
+{
+    f64 MainSeconds = 0.0;
+    text_highlight_job *Job = &Panel->Highlight.Job;
+    while (true)
+    {
+        u64 StartClock = PlatformGetWallClock();
+        b32 IsPrepared = SyncTextHighlight(Panel) && PrepareTextHighlightJob(Panel);
+        u64 PreparedClock = PlatformGetWallClock();
+        MainSeconds += PlatformGetSecondsElapsed(StartClock, PreparedClock);
+        if (!IsPrepared)
+        {
+            break;
+        }
+
+        Job->IsActive = true;
+        LexTextHighlightWork(NULL, Job);
+        u64 LexedClock = PlatformGetWallClock();
+        AbsorbTextHighlightJob(Panel);
+        u64 EndClock = PlatformGetWallClock();
+
+        *JobSeconds += PlatformGetSecondsElapsed(PreparedClock, LexedClock);
+        MainSeconds += PlatformGetSecondsElapsed(LexedClock, EndClock);
+    }
+    return MainSeconds;
+}
+
+// NOTE(traian): Measures the highlighting of a file that was just opened and then of the kinds of edits that are
+// typed into it, separating the time that the main thread spends on the jobs from the time of the jobs themselves.
+internal void
+BenchmarkSyntaxHighlight(memory_size TextSize)
+{
+    printf("Syntax highlight on %llu MB of source code:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticSourceCode(Text, 0x9E3779B97F4A7C15);
+
+    buffer PanelMemory = PlatformAllocateMemory(sizeof(text_panel));
+    text_panel *Panel = (text_panel *)PanelMemory.Data;
+    Panel->Journal.IsUnavailable = true;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+    Panel->FileName = (char *)"benchmark.cpp";
+
+    buffer TextCopy = PlatformAllocateMemory(Text.Size + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+    CopyMem(TextCopy.Data, Text.Data, Text.Size);
+    Panel->Buffer.Base = (char *)TextCopy.Data;
+    Panel->Buffer.Size = TextCopy.Size;
+    Panel->Buffer.Used = Text.Size;
+    Panel->Buffer.GapOffset = Text.Size;
+    BuildLineIndex(&Panel->LineIndex, &Panel->Buffer);
+    Panel->LineCount = Panel->LineIndex.Count - 1;
+    printf("    %llu lines\n", Panel->LineIndex.Count);
+
+    f64 JobSeconds = 0.0;
+    f64 MainSeconds = RunTextHighlightJobs(Panel, &JobSeconds);
+    PrintBenchmarkResult("Whole file (jobs)", Text.Size, JobSeconds);
+    PrintBenchmarkResult("Whole file (main thread)", Text.Size, MainSeconds);
+
+    struct highlight_edit
+    {
+        const char *Name;
+        const char *Characters;
+    };
+
+    highlight_edit Edits[] =
+    {
+        { "Typed character", "x" },
+        { "Typed new line", "\n" },
+        { "Opened block comment", "/*" },
+    };
+
+    u32 EditCount = 100;
+    benchmark_random Random = { 0x2545F4914F6CDD1D };
+    for (u32 EditIndex = 0; EditIndex < ArrayCount(Edits); ++EditIndex)
+    {
+        highlight_edit *Edit = Edits + EditIndex;
+        memory_size ByteCount = StringLength((char *)Edit->Characters);
+
+        f64 EditSeconds = 0.0;
+        JobSeconds = 0.0;
+        MainSeconds = 0.0;
+        for (u32 Index = 0; Index < EditCount; ++Index)
+        {
+            u64 Line = NextRandom(&Random) % Panel->LineIndex.Count;
+            memory_offset Offset = GetBufferOffsetOfLine(&Panel->LineIndex, Line);
+
+            u64 StartClock = PlatformGetWallClock();
+            ApplyTextEdit(Panel, TextEditKind_Insert, Offset, (char *)Edit->Characters, ByteCount);
+            u64 EndClock = PlatformGetWallClock();
+
+            EditSeconds += PlatformGetSecondsElapsed(StartClock, EndClock);
+            MainSeconds += RunTextHighlightJobs(Panel, &JobSeconds);
+        }
+
+        printf("    %-28s %8.3f ms edit %8.3f ms main thread %8.3f ms jobs\n", Edit->Name,
+               EditSeconds * 1000.0 / EditCount, MainSeconds * 1000.0 / EditCount, JobSeconds * 1000.0 / EditCount);
+    }
+
+    text_highlight *Highlight = &Panel->Highlight;
+    PlatformReleaseMemory({ (u8 *)Highlight->LineStates, Highlight->LineCapacity * sizeof(syntax_state) });
+    PlatformReleaseMemory(Highlight->Job.Text);
+    PlatformReleaseMemory(Highlight->Job.States);
+    ReleaseBufferMemory(&Panel->Buffer);
+    PlatformReleaseMemory(PanelMemory);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): LARGE FILES.
+//=========================================================================================
+
+#define BENCHMARK_LARGE_FILE_NAME "ocean_benchmark_large_file.txt"
+
+// NOTE(traian): Reads, scrolls and edits the loaded large file past 4 GB.
+internal void
+BenchmarkLargeFileEdits(text_panel *Panel, char *FileName, memory_size FileSize, u64 LineCount)
+{
+    text_buffer *Buffer = &Panel->Buffer;
+
+    // NOTE(traian): A single read that starts below 4 GB and ends past it.
+    memory_offset ReadOffset = Minimum(Gigabytes(4) - Megabytes(256), FileSize / 2);
+    buffer ReadBuffer = PlatformAllocateMemory(Minimum(Gigabytes(1) + Megabytes(512), FileSize - ReadOffset));
+    platform_file File = PlatformOpenFile(FileName);
+    memory_size ReadSize = PlatformReadFile(&File, ReadOffset, ReadBuffer);
+    PlatformCloseFile(&File);
+    CheckBenchmarkResult("read across 4 GB", ReadSize == ReadBuffer.Size &&
+                         HashTextChunk(ReadBuffer.Data, ReadBuffer.Size) ==
+                         HashTextChunk((u8 *)GetBufferAddress(Buffer, ReadOffset), ReadBuffer.Size));
+    PlatformReleaseMemory(ReadBuffer);
+
+    // NOTE(traian): Every line starts right after a new line and maps back to itself. The text has no tabs or
+    // multi-byte sequences, so the column of the caret is its distance from the start of its line.
+    editor_settings Settings = {};
+    Settings.TabWidth = 4;
+    u64 Lines[] = { 0, LineCount / 3, GetLineOfBufferOffset(&Panel->LineIndex, FileSize - FileSize / 4),
+                    LineCount - 2, LineCount - 1 };
+    b32 IsScrolled = true;
+    for (u32 Index = 0; Index < ArrayCount(Lines); ++Index)
+    {
+        u64 Line = Lines[Index];
+        memory_offset LineOffset = GetBufferOffsetOfLine(&Panel->LineIndex, Line);
+        memory_offset NextLineOffset = GetBufferOffsetOfLine(&Panel->LineIndex, Line + 1);
+        memory_offset CaretOffset = LineOffset + (NextLineOffset - LineOffset) / 2;
+        SetCaretFromTextOffset(Panel, &Settings, &Panel->Caret, CaretOffset);
+
+        IsScrolled = IsScrolled && (LineOffset == 0 || GetBufferCharacter(Buffer, LineOffset - 1) == '\n') &&
+                     (GetLineOfBufferOffset(&Panel->LineIndex, LineOffset) == Line) &&
+                     (Panel->Caret.Position.Line == Line) &&
+                     (Panel->Caret.Position.Column == CaretOffset - LineOffset);
+    }
+    CheckBenchmarkResult("line and column lookups", IsScrolled);
+
+    // NOTE(traian): Splitting a line past 4 GB moves the gap over most of the text, and an edit at the start of the
+    // text moves it back.
+    memory_offset EditOffset = FileSize - FileSize / 4;
+    u64 EditLine = GetLineOfBufferOffset(&Panel->LineIndex, EditOffset);
+    u64 StartClock = PlatformGetWallClock();
+    ApplyTextEdit(Panel, TextEditKind_Insert, EditOffset, (char *)"\n", 1);
+    u64 SplitClock = PlatformGetWallClock();
+    b32 IsSplit = (Buffer->Used == FileSize + 1) && (Panel->LineIndex.Count == LineCount + 1) &&
+                  (GetBufferOffsetOfLine(&Panel->LineIndex, EditLine + 1) == EditOffset + 1);
+
+    ApplyTextEdit(Panel, TextEditKind_Remove, EditOffset, NULL, 1);
+    ApplyTextEdit(Panel, TextEditKind_Insert, 0, (char *)"x", 1);
+    u64 EndClock = PlatformGetWallClock();
+    b32 IsJoined = (Buffer->Used == FileSize + 1) && (Panel->LineIndex.Count == LineCount) &&
+                   (GetLineOfBufferOffset(&Panel->LineIndex, EditOffset + 1) == EditLine) &&
+                   (GetBufferCharacter(Buffer, 0) == 'x');
+
+    PrintBenchmarkResult("split a line past 4 GB", FileSize, PlatformGetSecondsElapsed(StartClock, SplitClock));
+    PrintBenchmarkResult("join it, insert at the start", FileSize, PlatformGetSecondsElapsed(SplitClock, EndClock));
+    CheckBenchmarkResult("edits past 4 GB", IsSplit && IsJoined);
+}
+
+// NOTE(traian): Writes a document that is larger than 4 GB, loads it back through the background load (run on the
+// calling thread) and then scrolls and edits it past 4 GB, so that an offset, line or column that is truncated to
+// 32 bits shows up. The write, and the read of the range around 4 GB, span several chunks of the platform file I/O.
+internal void
+BenchmarkLargeFile(memory_size FileSize)
+{
+    printf("Large file of %llu MB:\n", FileSize / Megabytes(1));
+    char *FileName = (char *)BENCHMARK_LARGE_FILE_NAME;
+
+    // NOTE(traian): The loaded text is compared with the hashes of the document, rather than with a second copy.
+    buffer Text = PlatformAllocateMemory(FileSize);
+    GenerateSyntheticText(Text, 120, 0xD1B54A32D192ED03);
+    u64 LineCount = GetNumberOfLines((char *)Text.Data, Text.Size) + 1;
+    buffer HashMemory = PlatformAllocateMemory(GetTextChunkCount(FileSize) * sizeof(u64));
+    u64 *ChunkHashes = (u64 *)HashMemory.Data;
+    HashTextChunks(ChunkHashes, FileSize, Text.Data, 0, FileSize);
+
+    platform_file File = PlatformOpenFileForWriting(FileName, true);
+    if (!File.Handle)
+    {
+        CheckBenchmarkResult("create file", false);
+        PlatformReleaseMemory(HashMemory);
+        PlatformReleaseMemory(Text);
+        return;
+    }
+
+    u64 StartClock = PlatformGetWallClock();
+    memory_size WrittenSize = PlatformWriteFile(&File, 0, Text);
+    PlatformCloseFile(&File);
+    PrintBenchmarkResult("write", FileSize, PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock()));
+    PlatformReleaseMemory(Text);
+    CheckBenchmarkResult("written size", WrittenSize == FileSize && PlatformGetFileSize(FileName) == FileSize);
+
+    // NOTE(traian): The panel starts out the way Command_OpenFile leaves it for the background load, with an empty
+    // buffer that ends where the loaded text begins.
+    buffer PanelMemory = PlatformAllocateMemory(sizeof(text_panel));
+    text_panel *Panel = (text_panel *)PanelMemory.Data;
+    Panel->Journal.IsUnavailable = true;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+
+    text_buffer *Buffer = &Panel->Buffer;
+    buffer BufferMemory = PlatformAllocateMemory(FileSize + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+    Buffer->Base = (char *)BufferMemory.Data;
+    Buffer->Size = TEXT_BUFFER_DEFAULT_GAP_SIZE;
+    BuildLineIndex(&Panel->LineIndex, Buffer);
+    BeginTextDiskHashes(&Panel->DiskHashes, FileName, FileSize);
+
+    text_load *Load = &Panel->Load;
+    Load->File = PlatformOpenFile(FileName);
+    Load->Destination = Buffer->Base + Buffer->Size;
+    Load->ChunkHashes = Panel->DiskHashes.ChunkHashes;
+    Load->FileSize = FileSize;
+    Load->LineEndings = &Panel->LineEndings;
+    Load->IsActive = true;
+
+    StartClock = PlatformGetWallClock();
+    LoadTextFileWork(NULL, Load);
+    AbsorbLoadedText(Panel);
+    PrintBenchmarkResult("load and index", FileSize, PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock()));
+
+    b32 IsLoaded = !Panel->HasLoadFailed && Panel->DiskHashes.IsValid && (Buffer->Used == FileSize);
+    for (u64 ChunkIndex = 0; IsLoaded && ChunkIndex < Panel->DiskHashes.ChunkCount; ++ChunkIndex)
+    {
+        IsLoaded = (Panel->DiskHashes.ChunkHashes[ChunkIndex] == ChunkHashes[ChunkIndex]);
+    }
+    IsLoaded = CheckBenchmarkResult("loaded text", IsLoaded);
+    IsLoaded = CheckBenchmarkResult("line count", Panel->LineIndex.Count == LineCount) && IsLoaded;
+
+    if (IsLoaded)
+    {
+        BenchmarkLargeFileEdits(Panel, FileName, FileSize, LineCount);
+    }
+
+    PlatformDeleteFile(FileName);
+    PlatformReleaseMemory(Panel->DiskHashes.Memory);
+    PlatformReleaseMemory({ (u8 *)Panel->LineIndex.Entries, Panel->LineIndex.Capacity * sizeof(memory_offset) });
+    ReleaseBufferMemory(Buffer);
+    PlatformReleaseMemory(PanelMemory);
+    PlatformReleaseMemory(HashMemory);
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT HISTORY.
+//=========================================================================================
+
+// NOTE(traian): A panel without a file, so nothing is journaled or highlighted, with a copy of the text.
+internal text_panel *
+AllocateBenchmarkPanel(buffer Text)
+{
+    buffer PanelMemory = PlatformAllocateMemory(sizeof(text_panel));
+    text_panel *Panel = (text_panel *)PanelMemory.Data;
+    Panel->Journal.IsUnavailable = true;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+
+    buffer TextCopy = PlatformAllocateMemory(Text.Size + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+    CopyMem(TextCopy.Data, Text.Data, Text.Size);
+    Panel->Buffer.Base = (char *)TextCopy.Data;
+    Panel->Buffer.Size = TextCopy.Size;
+    Panel->Buffer.Used = Text.Size;
+    Panel->Buffer.GapOffset = Text.Size;
+    BuildLineIndex(&Panel->LineIndex, &Panel->Buffer);
+    Panel->LineCount = Panel->LineIndex.Count - 1;
+    return Panel;
+}
+
+internal void
+ReleaseBenchmarkPanel(text_panel *Panel)
+{
+    text_line_index *LineIndex = &Panel->LineIndex;
+    PlatformReleaseMemory({ (u8 *)LineIndex->Entries, LineIndex->Capacity * sizeof(memory_offset) });
+    if (Panel->History.Arena.Base)
+    {
+        PlatformReleaseMemory({ Panel->History.Arena.Base, Panel->History.Arena.Size });
+    }
+    if (Panel->LineEndings.Memory.Data)
+    {
+        PlatformReleaseMemory(Panel->LineEndings.Memory);
+    }
+    if (Panel->Find.Matches)
+    {
+        PlatformReleaseMemory({ (u8 *)Panel->Find.Matches, Panel->Find.MatchCapacity * sizeof(text_find_match) });
+    }
+    ReleaseBufferMemory(&Panel->Buffer);
+    PlatformReleaseMemory({ (u8 *)Panel, sizeof(text_panel) });
+}
+
+// NOTE(traian): Hashes the whole text of the panel, which is copied to the scratch memory first.
+internal u64
+HashBenchmarkPanelText(text_panel *Panel, buffer Scratch)
+{
+    Assert(Panel->Buffer.Used <= Scratch.Size);
+    CopyFromBuffer(&Panel->Buffer, 0, Panel->Buffer.Used, (char *)Scratch.Data);
+    u64 Result = HashTextChunk(Scratch.Data, Panel->Buffer.Used);
+    return Result;
+}
+
+// NOTE(traian): Records and applies an edit, the way the text commands do.
+internal void
+ApplyRecordedTextEdit(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                      memory_size ByteCount)
+{
+    text_view_state Before = GetTextViewState(Panel);
+    text_edit_record *Record = RecordTextEdit(Panel, Kind, Offset, Characters, ByteCount, &Before);
+    ApplyTextEdit(Panel, Kind, Offset, Characters, ByteCount);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+}
+
+// NOTE(traian): Fills the history with edits until the oldest ones are discarded, and then makes groups of edits
+// that only fit once older records are discarded, or that don't fit at all. Undoing a group must restore the text
+// from before it, and never a part of a group.
+internal void
+CheckTextHistory()
+{
+    printf("Text history:\n");
+
+    buffer Text = PlatformAllocateMemory(Megabytes(1));
+    GenerateSyntheticText(Text, 120, 0x5851F42D4C957F2D);
+    text_panel *Panel = AllocateBenchmarkPanel(Text);
+    text_history *History = &Panel->History;
+
+    const u32 EditCount = 80;
+    const memory_size EditSize = Kilobytes(256);
+    buffer Insertion = PlatformAllocateMemory(Megabytes(12));
+    GenerateSyntheticText(Insertion, 60, 0x2127599BF4325C37);
+    buffer Scratch = PlatformAllocateMemory(Text.Size + EditCount * EditSize + Insertion.Size);
+
+    // NOTE(traian): The hash of the text after each edit. The undo steps can only go back as far as the oldest
+    // record that is left, so the text after undoing everything must match one of them.
+    u64 TextHashes[EditCount + 1];
+    TextHashes[0] = HashBenchmarkPanelText(Panel, Scratch);
+    benchmark_random Random = { 0x6A09E667F3BCC909 };
+    for (u32 EditIndex = 0; EditIndex < EditCount; ++EditIndex)
+    {
+        memory_offset Offset = NextRandom(&Random) % Panel->Buffer.Used;
+        ApplyRecordedTextEdit(Panel, TextEditKind_Insert, Offset, (char *)Insertion.Data + EditIndex, EditSize);
+        TextHashes[EditIndex + 1] = HashBenchmarkPanelText(Panel, Scratch);
+    }
+
+    // NOTE(traian): The group only fits once all of the older records are discarded. The first two records leave
+    // less than a quarter of the budget to the older records, so the last one is recorded while every older record
+    // is being discarded, and the first record of the group has to stay.
+    BeginTextEditGroup(Panel);
+    ApplyRecordedTextEdit(Panel, TextEditKind_Remove, Kilobytes(4), NULL, Megabytes(3));
+    ApplyRecordedTextEdit(Panel, TextEditKind_Insert, Kilobytes(4), (char *)Insertion.Data, Megabytes(9));
+    ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, Megabytes(2));
+    EndTextEditGroup(Panel);
+    u64 GroupHash = HashBenchmarkPanelText(Panel, Scratch);
+
+    text_edit_record *OldestRecord = (text_edit_record *)History->Arena.Base;
+    CheckBenchmarkResult("oldest record isn't chained", History->Arena.Offset > 0 && !OldestRecord->IsChained);
+
+    b32 IsUndone = UndoTextEdit(Panel) && (HashBenchmarkPanelText(Panel, Scratch) == TextHashes[EditCount]);
+    CheckBenchmarkResult("undo a group that evicted", IsUndone);
+
+    u32 UndoCount = 1;
+    while (UndoTextEdit(Panel))
+    {
+        ++UndoCount;
+    }
+
+    u32 OldestEditIndex = EditCount + 1 - UndoCount;
+    b32 IsUndoneToOldest = (UndoCount <= EditCount + 1) &&
+                           (HashBenchmarkPanelText(Panel, Scratch) == TextHashes[OldestEditIndex]);
+    CheckBenchmarkResult("undo every step", IsUndoneToOldest);
+
+    while (RedoTextEdit(Panel))
+    {
+    }
+    CheckBenchmarkResult("redo every step", HashBenchmarkPanelText(Panel, Scratch) == GroupHash);
+
+    // NOTE(traian): A group that doesn't fit at all forgets the history and isn't recorded, instead of being undone
+    // in part.
+    BeginTextEditGroup(Panel);
+    ApplyRecordedTextEdit(Panel, TextEditKind_Remove, 0, NULL, Megabytes(10));
+    ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, Megabytes(10));
+    ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, 1);
+    EndTextEditGroup(Panel);
+    CheckBenchmarkResult("group larger than the budget", History->Arena.Offset == 0 && !UndoTextEdit(Panel));
+
+    u64 BeforeHash = HashBenchmarkPanelText(Panel, Scratch);
+    ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, EditSize);
+    CheckBenchmarkResult("undo after a dropped group",
+                         UndoTextEdit(Panel) && HashBenchmarkPanelText(Panel, Scratch) == BeforeHash);
+
+    PlatformReleaseMemory(Scratch);
+    PlatformReleaseMemory(Insertion);
+    ReleaseBenchmarkPanel(Panel);
+    PlatformReleaseMemory(Text);
+}
+
+#define BENCHMARK_JOURNAL_FILE_NAME "ocean_benchmark_journal.txt"
+
+// NOTE(traian): Journals words typed all over a document, with an occasional backspace, and recovers them onto the
+// document on the disk, the way the editor does at startup after a crash.
+internal void
+BenchmarkJournalRecovery(memory_size TextSize, u32 EditCount)
+{
+    printf("Journal recovery of %u edits:\n", EditCount);
+    char *FileName = (char *)BENCHMARK_JOURNAL_FILE_NAME;
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticText(Text, 120, 0x9E3779B97F4A7C15);
+    if (PlatformWriteEntireFile(FileName, Text) != Text.Size)
+    {
+        CheckBenchmarkResult("create file", false);
+        PlatformReleaseMemory(Text);
+        return;
+    }
+
+    text_panel *Panel = AllocateBenchmarkPanel(Text);
+    Panel->FileName = FileName;
+    SetTextJournalDocument(&Panel->Journal, FileName);
+
+    benchmark_random Random = { 0xBB67AE8584CAA73B };
+    memory_offset Offset = 0;
+    for (u32 EditIndex = 0; EditIndex < EditCount; ++EditIndex)
+    {
+        if (EditIndex % 16 == 0)
+        {
+            Offset = NextRandom(&Random) % (Panel->Buffer.Used + 1);
+        }
+
+        if (Offset > 0 && NextRandom(&Random) % 8 == 0)
+        {
+            ApplyTextEdit(Panel, TextEditKind_Remove, --Offset, NULL, 1);
+        }
+        else
+        {
+            char Character = (char)('a' + NextRandom(&Random) % 26);
+            ApplyTextEdit(Panel, TextEditKind_Insert, Offset++, &Character, 1);
+        }
+    }
+
+    // NOTE(traian): The journal is left behind, like when the editor crashes.
+    buffer Scratch = PlatformAllocateMemory(Panel->Buffer.Used);
+    u64 EditedHash = HashBenchmarkPanelText(Panel, Scratch);
+    FlushTextJournal(&Panel->Journal);
+    PlatformCloseFile(&Panel->Journal.File);
+    Panel->Journal.IsOpen = false;
+
+    text_panel *RecoveredPanel = AllocateBenchmarkPanel(Text);
+    RecoveredPanel->FileName = FileName;
+    SetTextJournalDocument(&RecoveredPanel->Journal, FileName);
+    memory_size JournalSize = PlatformGetFileSize(RecoveredPanel->Journal.FileName);
+
+    u64 StartClock = PlatformGetWallClock();
+    b32 IsRecovered = RecoverTextJournal(RecoveredPanel);
+    PrintBenchmarkResult("recover", JournalSize, PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock()));
+    CheckBenchmarkResult("recovered text", IsRecovered && (RecoveredPanel->Buffer.Used == Panel->Buffer.Used) &&
+                                           (HashBenchmarkPanelText(RecoveredPanel, Scratch) == EditedHash));
+
+    CloseTextJournal(&RecoveredPanel->Journal);
+    PlatformDeleteFile(FileName);
+    text_panel *Panels[] = { Panel, RecoveredPanel };
+    for (u32 PanelIndex = 0; PanelIndex < ArrayCount(Panels); ++PanelIndex)
+    {
+        text_journal *Journal = &Panels[PanelIndex]->Journal;
+        if (Journal->Pending.Data)
+        {
+            PlatformReleaseMemory(Journal->Pending);
+            PlatformReleaseMemory(Journal->Writing);
+        }
+        ReleaseBenchmarkPanel(Panels[PanelIndex]);
+    }
+    PlatformReleaseMemory(Scratch);
+    PlatformReleaseMemory(Text);
+}
+
+// NOTE(traian): Replaces two matches that are far apart, so that the whole span between them is recorded as one
+// removal and one insertion. When both records fit in the history, the replacement is undone in one step. When
+// they don't, the history is forgotten instead of keeping a part of the group.
+internal void
+CheckReplaceAllHistory()
+{
+    printf("Replace all history:\n");
+
+    // NOTE(traian): The synthetic text has no tabs, so the query only matches where it's written.
+    const char Query[] = "\tmatch\t";
+    const char Replacement[] = "\treplaced match\t";
+    memory_size QueryLength = sizeof(Query) - 1;
+    memory_size ReplacementLength = sizeof(Replacement) - 1;
+
+    buffer Text = PlatformAllocateMemory(Megabytes(24));
+    buffer Insertion = PlatformAllocateMemory(Megabytes(1));
+    GenerateSyntheticText(Insertion, 60, 0x9FB21C651E98DF25);
+    buffer Scratch = PlatformAllocateMemory(Text.Size + 4 * Insertion.Size + Kilobytes(4));
+
+    editor_settings Settings = {};
+    Settings.TabWidth = 4;
+
+    memory_size SpanSizes[] = { Megabytes(6), Megabytes(10) };
+    for (u32 SpanIndex = 0; SpanIndex < ArrayCount(SpanSizes); ++SpanIndex)
+    {
+        memory_size SpanSize = SpanSizes[SpanIndex];
+        GenerateSyntheticText(Text, 120, 0xAF251AF3B0F025B5);
+        CopyMem(Text.Data + Kilobytes(4), (char *)Query, QueryLength);
+        CopyMem(Text.Data + Kilobytes(4) + SpanSize - QueryLength, (char *)Query, QueryLength);
+
+        text_panel *Panel = AllocateBenchmarkPanel(Text);
+        for (u32 EditIndex = 0; EditIndex < 4; ++EditIndex)
+        {
+            ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, Insertion.Size);
+        }
+        u64 BeforeHash = HashBenchmarkPanelText(Panel, Scratch);
+
+        text_find *Find = &Panel->Find;
+        Find->QueryLength = QueryLength;
+        CopyMem(Find->Query, (char *)Query, QueryLength);
+        UpdateTextFindQuery(Panel);
+        CompleteTextFind(Panel);
+
+        memory_size OldSize = Panel->Buffer.Used;
+        text_view_state Before = GetTextViewState(Panel);
+        text_edit_record *Record = ReplaceAllTextMatches(Panel, &Settings, (char *)Replacement, ReplacementLength,
+                                                         &Before);
+        b32 IsReplaced = (Panel->Buffer.Used == OldSize + 2 * (ReplacementLength - QueryLength));
+
+        char Name[64];
+        if (GetTextEditRecordSize(SpanSize, 0) + GetTextEditRecordSize(SpanSize + ReplacementLength - QueryLength, 0) <=
+            TEXT_HISTORY_BUDGET_SIZE)
+        {
+            sprintf_s(Name, sizeof(Name), "undo a %llu MB replacement", SpanSize / Megabytes(1));
+            CheckBenchmarkResult(Name, IsReplaced && Record && UndoTextEdit(Panel) &&
+                                       (HashBenchmarkPanelText(Panel, Scratch) == BeforeHash));
+        }
+        else
+        {
+            sprintf_s(Name, sizeof(Name), "forget a %llu MB replacement", SpanSize / Megabytes(1));
+            b32 IsForgotten = IsReplaced && !Record && (Panel->History.Arena.Offset == 0) && !UndoTextEdit(Panel);
+
+            u64 ReplacedHash = HashBenchmarkPanelText(Panel, Scratch);
+            ApplyRecordedTextEdit(Panel, TextEditKind_Insert, 0, (char *)Insertion.Data, Insertion.Size);
+            CheckBenchmarkResult(Name, IsForgotten && UndoTextEdit(Panel) && !UndoTextEdit(Panel) &&
+                                       (HashBenchmarkPanelText(Panel, Scratch) == ReplacedHash));
+        }
+
+        ReleaseBenchmarkPanel(Panel);
+    }
+
+    PlatformReleaseMemory(Scratch);
+    PlatformReleaseMemory(Insertion);
+    PlatformReleaseMemory(Text);
+}
+
+// NOTE(traian): Replaces the matches of patterns that match any character in text with non-ASCII characters. Every
+// match must be a whole character, so the text is still valid UTF-8 after the replacement.
+internal void
+CheckRegexCharacters()
+{
+    printf("Regex characters:\n");
+
+    struct regex_character_replacement
+    {
+        const char *Pattern;
+        const char *Text;
+        const char *ReplacedText;
+    };
+
+    regex_character_replacement Replacements[] =
+    {
+        { "caf.", "caf\xC3\xA9 ok", "X ok" },
+        { "[^a ]", "\xC3\xA9 a", "X a" },
+        { "\\W", "\xC3\xA9!", "XX" },
+        { "[^\\W]+", "a\xC3\xA9 b", "X\xC3\xA9 X" },
+        { "\\S+", "\xE6\x97\xA5\xE6\x9C\xAC x", "X X" },
+        { ".", "\xF0\x9F\x98\x80", "X" },
+    };
+
+    editor_settings Settings = {};
+    Settings.TabWidth = 4;
+    for (u32 ReplacementIndex = 0; ReplacementIndex < ArrayCount(Replacements); ++ReplacementIndex)
+    {
+        regex_character_replacement *Replacement = Replacements + ReplacementIndex;
+        text_panel *Panel = AllocateBenchmarkPanel({ (u8 *)Replacement->Text,
+                                                     StringLength((char *)Replacement->Text) });
+        text_find *Find = &Panel->Find;
+        Find->IsRegex = true;
+        Find->QueryLength = StringLength((char *)Replacement->Pattern);
+        CopyMem(Find->Query, (char *)Replacement->Pattern, Find->QueryLength);
+        UpdateTextFindQuery(Panel);
+        CompleteTextFind(Panel);
+
+        text_view_state Before = GetTextViewState(Panel);
+        ReplaceAllTextMatches(Panel, &Settings, (char *)"X", 1, &Before);
+
+        char Text[64];
+        memory_size ReplacedSize = StringLength((char *)Replacement->ReplacedText);
+        CopyFromBuffer(&Panel->Buffer, 0, Minimum(Panel->Buffer.Used, sizeof(Text)), Text);
+        b32 IsCorrect = Find->IsQueryValid && (Panel->Buffer.Used == ReplacedSize) &&
+                        AreBytesEqual(Text, (char *)Replacement->ReplacedText, ReplacedSize);
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "replace %s", Replacement->Pattern);
+        CheckBenchmarkResult(Name, IsCorrect);
+        ReleaseRegex(&Find->Regex);
+        ReleaseBenchmarkPanel(Panel);
+    }
+}
+
+// NOTE(traian): Finds the previous match from offsets all over a text that spans several slices, without
+// scanning it first. A literal has to find the last occurrence before the offset, and a regex the last match that
+// the scan finds before it.
+internal void
+CheckFindPrevious()
+{
+    printf("Find previous:\n");
+
+    buffer Text = PlatformAllocateMemory(4 * TEXT_FIND_SLICE_SIZE + 1000);
+    benchmark_random Random = { 19 };
+    memory_size Index = 0;
+    while (Index < Text.Size)
+    {
+        memory_size LineEnd = Minimum(Index + NextRandom(&Random) % 80, Text.Size);
+        for (; Index < LineEnd; ++Index)
+        {
+            Text.Data[Index] = (u8)('a' + NextRandom(&Random) % 4);
+        }
+        if (Index < Text.Size)
+        {
+            Text.Data[Index++] = '\n';
+        }
+    }
+    for (u32 MarkIndex = 1; MarkIndex < 6; ++MarkIndex)
+    {
+        CopyMem(Text.Data + MarkIndex * (Text.Size / 6), "xab", 3);
+    }
+
+    const char *Queries[] = { "xa", "ab", "aa", "xa|^cc", "[ab]+x", "d+$" };
+    text_panel *Panel = AllocateBenchmarkPanel(Text);
+    text_find *Find = &Panel->Find;
+    buffer Matches = PlatformAllocateMemory(Text.Size * sizeof(memory_offset));
+    memory_offset *Offsets = (memory_offset *)Matches.Data;
+    for (u32 QueryIndex = 0; QueryIndex < ArrayCount(Queries); ++QueryIndex)
+    {
+        Find->IsRegex = (QueryIndex >= 3);
+        Find->QueryLength = StringLength((char *)Queries[QueryIndex]);
+        CopyMem(Find->Query, (char *)Queries[QueryIndex], Find->QueryLength);
+        UpdateTextFindQuery(Panel);
+        CompleteTextFind(Panel);
+
+        // NOTE(traian): The scan skips the occurrences of a literal that overlap a match.
+        u64 MatchCount = 0;
+        for (u64 MatchIndex = 0; Find->IsRegex && MatchIndex < Find->MatchCount; ++MatchIndex)
+        {
+            Offsets[MatchCount++] = Find->Matches[MatchIndex].Offset;
+        }
+        for (memory_offset Offset = 0; !Find->IsRegex && Offset + Find->QueryLength <= Text.Size; ++Offset)
+        {
+            if (AreBytesEqual((char *)Text.Data + Offset, Find->Query, Find->QueryLength))
+            {
+                Offsets[MatchCount++] = Offset;
+            }
+        }
+
+        b32 IsCorrect = (MatchCount > 0);
+        for (u32 OffsetIndex = 0; OffsetIndex < 200 && IsCorrect; ++OffsetIndex)
+        {
+            memory_offset Offset = (OffsetIndex == 0) ? 0 : NextRandom(&Random) % (Text.Size + 1);
+            u64 MatchIndex = 0;
+            while (MatchIndex < MatchCount && Offsets[MatchIndex] < Offset)
+            {
+                ++MatchIndex;
+            }
+            memory_offset Expected = Offsets[((MatchIndex > 0) ? MatchIndex : MatchCount) - 1];
+
+            RestartTextFind(Panel);
+            text_find_match Match;
+            IsCorrect = FindPreviousTextMatch(Panel, Offset, &Match) && (Match.Offset == Expected);
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "previous %s", Queries[QueryIndex]);
+        CheckBenchmarkResult(Name, IsCorrect);
+        if (Find->IsRegex)
+        {
+            ReleaseRegex(&Find->Regex);
+        }
+    }
+
+    PlatformReleaseMemory(Matches);
+    ReleaseBenchmarkPanel(Panel);
+    PlatformReleaseMemory(Text);
+}
+
+//=========================================================================================
+// NOTE(traian): FIND IN FILES.
+//=========================================================================================
+
+#define BENCHMARK_TREE_DIRECTORY "ocean_benchmark_tree"
+#define BENCHMARK_TREE_DIRECTORY_COUNT 64
+
+internal void
+GetBenchmarkTreeFileName(char *FileName, u32 FileIndex)
+{
+    sprintf_s(FileName, PLATFORM_PATH_CAPACITY, "%s/dir%u/file%u.cpp", BENCHMARK_TREE_DIRECTORY,
+              FileIndex % BENCHMARK_TREE_DIRECTORY_COUNT, FileIndex);
+}
+
+// NOTE(traian): Runs the whole search on the calling thread, from the walk or the index to the last result that is
+// appended to the results panel. Returns the number of result lines.
+internal u64
+RunBenchmarkFindInFiles(find_in_files *Search, char *Query, f64 *Seconds)
+{
+    text_panel *Results = AllocateBenchmarkPanel({});
+    u64 StartClock = PlatformGetWallClock();
+    BeginFindInFiles(Search, NULL, 1, (char *)BENCHMARK_TREE_DIRECTORY, Query, StringLength(Query), false);
+    ContinueFindInFiles(Search, Results);
+    *Seconds = PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock());
+
+    u64 Result = Search->ResultLineCount;
+    ReleaseBenchmarkPanel(Results);
+    return Result;
+}
+
+internal f64
+RunBenchmarkTrigramIndexBuild(find_in_files *IndexBuild)
+{
+    u64 StartClock = PlatformGetWallClock();
+    if (BeginTrigramIndexBuild(IndexBuild, NULL, 1, (char *)BENCHMARK_TREE_DIRECTORY))
+    {
+        while (!ContinueTrigramIndexBuild(IndexBuild, NULL))
+        {
+        }
+    }
+    f64 Result = PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock());
+    return Result;
+}
+
+// NOTE(traian): Measures the searches of a tree of files on the disk end to end, once by walking the tree and once
+// with its trigram index, on a single thread. The index is trusted for the files it rules out, so after a file
+// changes, only a search that reads it notices, and the files that are added are only found after the next build.
+internal void
+BenchmarkFindInFiles(u32 FileCount, memory_size FileSize)
+{
+    printf("Find in files on %u files of %llu bytes:\n", FileCount, FileSize);
+
+    char FileName[PLATFORM_PATH_CAPACITY];
+    b32 IsCreated = PlatformCreateDirectory((char *)BENCHMARK_TREE_DIRECTORY);
+    for (u32 DirectoryIndex = 0; DirectoryIndex < BENCHMARK_TREE_DIRECTORY_COUNT; ++DirectoryIndex)
+    {
+        sprintf_s(FileName, sizeof(FileName), "%s/dir%u", BENCHMARK_TREE_DIRECTORY, DirectoryIndex);
+        IsCreated = IsCreated && PlatformCreateDirectory(FileName);
+    }
+
+    // NOTE(traian): Like in the benchmark of the index, every file ends with an identifier that no other file has.
+    const memory_size IdentifierLength = 16;
+    buffer Source = PlatformAllocateMemory(Megabytes(16));
+    GenerateSyntheticSourceCode(Source, 0x94D049BB133111EB);
+    buffer File = PlatformAllocateMemory(2 * FileSize);
+    benchmark_random Random = { 0xBF58476D1CE4E5B9 };
+    char Identifier[16 + 1] = {};
+    for (u32 FileIndex = 0; IsCreated && FileIndex < FileCount; ++FileIndex)
+    {
+        memory_size SliceSize = FileSize - IdentifierLength;
+        CopyMem(File.Data, Source.Data + NextRandom(&Random) % (Source.Size - SliceSize), SliceSize);
+        for (memory_offset Index = SliceSize; Index < FileSize; ++Index)
+        {
+            File.Data[Index] = (u8)('a' + NextRandom(&Random) % 26);
+        }
+        if (FileIndex == FileCount / 2)
+        {
+            CopyMem(Identifier, File.Data + SliceSize, IdentifierLength);
+        }
+
+        GetBenchmarkTreeFileName(FileName, FileIndex);
+        IsCreated = (PlatformWriteEntireFile(FileName, { File.Data, FileSize }) == FileSize);
+    }
+
+    buffer SearchMemory = PlatformAllocateMemory(2 * sizeof(find_in_files));
+    find_in_files *Search = (find_in_files *)SearchMemory.Data;
+    find_in_files *IndexBuild = Search + 1;
+    const char *Queries[] = { "GetColumnOfLineOffset", Identifier, "SetCaretFromTextOffset(Panel, Zzz" };
+    f64 WalkSeconds[ArrayCount(Queries)] = {};
+    u64 WalkLineCounts[ArrayCount(Queries)] = {};
+    if (IsCreated)
+    {
+        for (u32 QueryIndex = 0; QueryIndex < ArrayCount(Queries); ++QueryIndex)
+        {
+            for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+            {
+                f64 Seconds;
+                WalkLineCounts[QueryIndex] = RunBenchmarkFindInFiles(Search, (char *)Queries[QueryIndex], &Seconds);
+                if (Repeat == 0 || Seconds < WalkSeconds[QueryIndex])
+                {
+                    WalkSeconds[QueryIndex] = Seconds;
+                }
+            }
+        }
+
+        PrintBenchmarkResult("index build", FileCount * FileSize, RunBenchmarkTrigramIndexBuild(IndexBuild));
+        PrintBenchmarkResult("index build, nothing changed", FileCount * FileSize,
+                             RunBenchmarkTrigramIndexBuild(IndexBuild));
+    }
+
+    b32 AreResultsCorrect = IsCreated;
+    for (u32 QueryIndex = 0; IsCreated && QueryIndex < ArrayCount(Queries); ++QueryIndex)
+    {
+        u64 LineCount = 0;
+        f64 BestSeconds = 0.0;
+        b32 IsUsingIndex = true;
+        for (u32 Repeat = 0; Repeat < BENCHMARK_REPEAT_COUNT; ++Repeat)
+        {
+            f64 Seconds;
+            LineCount = RunBenchmarkFindInFiles(Search, (char *)Queries[QueryIndex], &Seconds);
+            IsUsingIndex = IsUsingIndex && Search->IsUsingIndex;
+            if (Repeat == 0 || Seconds < BestSeconds)
+            {
+                BestSeconds = Seconds;
+            }
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "query %.20s", Queries[QueryIndex]);
+        PrintBenchmarkResult(Name, FileCount * FileSize, BestSeconds);
+        printf("        %llu lines, %llu files searched, %.2f ms with the walk\n", LineCount,
+               GetFindInFilesSearchedFileCount(Search), WalkSeconds[QueryIndex] * 1000.0);
+        AreResultsCorrect = AreResultsCorrect && IsUsingIndex && (LineCount == WalkLineCounts[QueryIndex]);
+    }
+    CheckBenchmarkResult("index finds what the walk does", AreResultsCorrect);
+
+    if (IsCreated)
+    {
+        // NOTE(traian): The identifier is on the last line of its file, so the line that is appended is another
+        // result.
+        char Line[32];
+        memory_size LineLength = sprintf_s(Line, sizeof(Line), "\n%s\n", Identifier);
+        GetBenchmarkTreeFileName(FileName, FileCount / 2);
+        memory_size ChangedSize = PlatformReadEntireFile(FileName, File);
+        CopyMem(File.Data + ChangedSize, Line, LineLength);
+        PlatformWriteEntireFile(FileName, { File.Data, ChangedSize + LineLength });
+
+        f64 Seconds;
+        u64 LineCount = RunBenchmarkFindInFiles(Search, Identifier, &Seconds);
+        CheckBenchmarkResult("a changed candidate is noticed", (LineCount == 2) && Search->IsIndexStale);
+
+        sprintf_s(FileName, sizeof(FileName), "%s/dir0/added.cpp", BENCHMARK_TREE_DIRECTORY);
+        PlatformWriteEntireFile(FileName, { (u8 *)Line, LineLength });
+        RunBenchmarkTrigramIndexBuild(IndexBuild);
+        LineCount = RunBenchmarkFindInFiles(Search, Identifier, &Seconds);
+        CheckBenchmarkResult("the next build finds new files", (LineCount == 3) && !Search->IsIndexStale);
+        PlatformDeleteFile(FileName);
+    }
+
+    for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+    {
+        GetBenchmarkTreeFileName(FileName, FileIndex);
+        PlatformDeleteFile(FileName);
+    }
+    for (u32 DirectoryIndex = 0; DirectoryIndex < BENCHMARK_TREE_DIRECTORY_COUNT; ++DirectoryIndex)
+    {
+        sprintf_s(FileName, sizeof(FileName), "%s/dir%u", BENCHMARK_TREE_DIRECTORY, DirectoryIndex);
+        PlatformDeleteDirectory(FileName);
+    }
+    GetTrigramIndexFileName((char *)BENCHMARK_TREE_DIRECTORY, StringLength((char *)BENCHMARK_TREE_DIRECTORY),
+                            (char *)TRIGRAM_INDEX_FILE_NAME, FileName);
+    PlatformDeleteFile(FileName);
+    PlatformDeleteDirectory((char *)BENCHMARK_TREE_DIRECTORY);
+
+    PlatformReleaseMemory(Search->Memory);
+    PlatformReleaseMemory(IndexBuild->Memory);
+    PlatformReleaseMemory(SearchMemory);
+    PlatformReleaseMemory(File);
+    PlatformReleaseMemory(Source);
+}
+
+//=========================================================================================
+// NOTE(traian): LINE ENDING ROUND TRIP.
+//=========================================================================================
+
+// NOTE(traian): Normalizes the document the way it's loaded, ChunkSize bytes at a time, into a new panel.
+internal text_panel *
+LoadBenchmarkDocument(const char *Document, memory_size ChunkSize)
+{
+    memory_size DocumentSize = StringLength((char *)Document);
+    buffer Text = PlatformAllocateMemory(DocumentSize + 1);
+    text_file_format Format = {};
+    text_line_endings LineEndings = {};
+
+    memory_offset FileOffset = 0;
+    memory_size LoadedSize = 0;
+    memory_size PendingCount = 0;
+    do
+    {
+        memory_size Size = Minimum(ChunkSize, DocumentSize - FileOffset);
+        u8 *Chunk = Text.Data + LoadedSize;
+        CopyMem(Chunk + PendingCount, (char *)Document + FileOffset, Size);
+        FileOffset += Size;
+
+        transcode_result Normalized = NormalizeLoadedLineEndings(&Format, &LineEndings, LoadedSize, Chunk,
+                                                                 PendingCount + Size, FileOffset == DocumentSize);
+        PendingCount = PendingCount + Size - Normalized.ReadCount;
+        LoadedSize += Normalized.WrittenCount;
+    } while (FileOffset < DocumentSize);
+
+    Assert(PendingCount == 0);
+    text_panel *Panel = AllocateBenchmarkPanel({ Text.Data, LoadedSize });
+    Panel->Format = Format;
+    Panel->LineEndings = LineEndings;
+    PlatformReleaseMemory(Text);
+    return Panel;
+}
+
+// NOTE(traian): Encodes the text of the panel the way it's saved and compares it with the document.
+internal b32
+IsSavedAsBenchmarkDocument(text_panel *Panel, const char *Document)
+{
+    text_save Save = {};
+    Save.Format = Panel->Format;
+    Save.LineEndings = Panel->LineEndings;
+    Save.Snapshot = PlatformAllocateMemory(Panel->Buffer.Used + 1);
+    CopyFromBuffer(&Panel->Buffer, 0, Panel->Buffer.Used, (char *)Save.Snapshot.Data);
+
+    text_save_encoder Encoder;
+    BeginTextSaveEncoder(&Encoder, &Save, Panel->Buffer.Used);
+    memory_size DocumentSize = StringLength((char *)Document);
+    memory_size SavedSize = 0;
+    b32 Result = true;
+    for (buffer Chunk = NextTextSaveChunk(&Encoder); Chunk.Size > 0; Chunk = NextTextSaveChunk(&Encoder))
+    {
+        Result = Result && (SavedSize + Chunk.Size <= DocumentSize) &&
+                 AreBytesEqual((char *)Chunk.Data, (char *)Document + SavedSize, Chunk.Size);
+        SavedSize += Chunk.Size;
+    }
+    Result = Result && (SavedSize == DocumentSize);
+
+    EndTextSaveEncoder(&Encoder);
+    PlatformReleaseMemory(Save.Snapshot);
+    return Result;
+}
+
+// NOTE(traian): Loads documents with every kind of line endings in chunks of every size, so that the CRLF pairs
+// are also split between chunks, and saves them back. The text must not contain a CRLF pair, and the saved
+// document must be the same as the loaded one, also after the text is edited.
+internal void
+CheckLineEndings()
+{
+    printf("Line endings:\n");
+
+    struct line_ending_document
+    {
+        const char *Name;
+        const char *Document;
+        text_line_ending LineEnding;
+    };
+
+    line_ending_document Documents[] =
+    {
+        { "LF", "abc\ndef\n", LineEnding_LF },
+        { "CRLF", "abc\r\ndef\r\n", LineEnding_CRLF },
+        { "mixed, CRLF first", "abc\r\ndef\nghi\r\n\n", LineEnding_Mixed },
+        { "mixed, LF first", "abc\ndef\r\n\r\nghi\n", LineEnding_Mixed },
+        { "lone carriage returns", "a\rb\r\nc\r", LineEnding_CRLF },
+        { "no new lines", "abc", LineEnding_LF },
+        { "empty", "", LineEnding_LF },
+    };
+
+    for (u32 DocumentIndex = 0; DocumentIndex < ArrayCount(Documents); ++DocumentIndex)
+    {
+        line_ending_document *Document = Documents + DocumentIndex;
+        memory_size DocumentSize = StringLength((char *)Document->Document);
+
+        b32 IsCorrect = true;
+        for (memory_size ChunkSize = 1; ChunkSize <= DocumentSize + 1; ++ChunkSize)
+        {
+            text_panel *Panel = LoadBenchmarkDocument(Document->Document, ChunkSize);
+            char Text[64];
+            CopyFromBuffer(&Panel->Buffer, 0, Panel->Buffer.Used, Text);
+            IsCorrect = IsCorrect && (Panel->Format.LineEnding == Document->LineEnding) &&
+                        (FindLiteral(Text, Panel->Buffer.Used, (char *)"\r\n", 2) == Panel->Buffer.Used) &&
+                        IsSavedAsBenchmarkDocument(Panel, Document->Document);
+            ReleaseBenchmarkPanel(Panel);
+        }
+
+        char Name[64];
+        sprintf_s(Name, sizeof(Name), "round trip, %s", Document->Name);
+        CheckBenchmarkResult(Name, IsCorrect);
+    }
+
+    struct line_ending_edit
+    {
+        const char *Document;
+        text_edit_kind Kind;
+        memory_offset Offset;
+        const char *Characters;
+        memory_size ByteCount;
+        const char *SavedDocument;
+    };
+
+    // NOTE(traian): The new lines that are typed take the line ending of the first line, while the other new lines
+    // keep their own.
+    line_ending_edit Edits[] =
+    {
+        { "abc\ndef\n", TextEditKind_Insert, 1, "\n", 1, "a\nbc\ndef\n" },
+        { "abc\r\ndef\r\n", TextEditKind_Insert, 1, "\n", 1, "a\r\nbc\r\ndef\r\n" },
+        { "abc\r\ndef\nghi\r\n", TextEditKind_Insert, 1, "\n", 1, "a\r\nbc\r\ndef\nghi\r\n" },
+        { "abc\r\ndef\nghi\r\n", TextEditKind_Remove, 4, NULL, 4, "abc\r\nghi\r\n" },
+        { "abc\ndef\r\nghi\n", TextEditKind_Insert, 0, "x\n", 2, "x\nabc\ndef\r\nghi\n" },
+        { "abc\ndef\r\nghi\n", TextEditKind_Remove, 2, NULL, 3, "abef\r\nghi\n" },
+    };
+
+    b32 AreEditsCorrect = true;
+    b32 AreUndoneEditsCorrect = true;
+    for (u32 EditIndex = 0; EditIndex < ArrayCount(Edits); ++EditIndex)
+    {
+        line_ending_edit *Edit = Edits + EditIndex;
+        text_panel *Panel = LoadBenchmarkDocument(Edit->Document, Kilobytes(4));
+        ApplyRecordedTextEdit(Panel, Edit->Kind, Edit->Offset, (char *)Edit->Characters, Edit->ByteCount);
+        AreEditsCorrect = AreEditsCorrect && IsSavedAsBenchmarkDocument(Panel, Edit->SavedDocument);
+        AreUndoneEditsCorrect = AreUndoneEditsCorrect && UndoTextEdit(Panel) &&
+                                IsSavedAsBenchmarkDocument(Panel, Edit->Document) && RedoTextEdit(Panel) &&
+                                IsSavedAsBenchmarkDocument(Panel, Edit->SavedDocument);
+        ReleaseBenchmarkPanel(Panel);
+    }
+    CheckBenchmarkResult("edits keep the line endings", AreEditsCorrect);
+    CheckBenchmarkResult("undo and redo keep the line endings", AreUndoneEditsCorrect);
+
+    struct line_ending_replacement
+    {
+        const char *Query;
+        const char *Replacement;
+        const char *SavedDocument;
+    };
+
+    // NOTE(traian): The lines between the matches keep their line endings, while a new line inside of a match
+    // takes the line ending of the first line.
+    line_ending_replacement Replacements[] =
+    {
+        { "=1", "=10", "a=10\r\nb=2\nc=10\r\nd=2\ne=10\r\nf\n" },
+        { "2\nc", "2\nC", "a=1\r\nb=2\r\nC=1\r\nd=2\ne=1\r\nf\n" },
+    };
+
+    editor_settings Settings = {};
+    Settings.TabWidth = 4;
+    const char *Document = "a=1\r\nb=2\nc=1\r\nd=2\ne=1\r\nf\n";
+    b32 AreReplacementsCorrect = true;
+    b32 AreUndoneReplacementsCorrect = true;
+    for (u32 ReplacementIndex = 0; ReplacementIndex < ArrayCount(Replacements); ++ReplacementIndex)
+    {
+        line_ending_replacement *Replacement = Replacements + ReplacementIndex;
+        text_panel *Panel = LoadBenchmarkDocument(Document, Kilobytes(4));
+        text_find *Find = &Panel->Find;
+        Find->QueryLength = StringLength((char *)Replacement->Query);
+        CopyMem(Find->Query, (char *)Replacement->Query, Find->QueryLength);
+        UpdateTextFindQuery(Panel);
+        CompleteTextFind(Panel);
+
+        text_view_state Before = GetTextViewState(Panel);
+        ReplaceAllTextMatches(Panel, &Settings, (char *)Replacement->Replacement,
+                              StringLength((char *)Replacement->Replacement), &Before);
+        AreReplacementsCorrect = AreReplacementsCorrect &&
+                                 IsSavedAsBenchmarkDocument(Panel, Replacement->SavedDocument);
+        AreUndoneReplacementsCorrect = AreUndoneReplacementsCorrect && UndoTextEdit(Panel) &&
+                                       IsSavedAsBenchmarkDocument(Panel, Document) && RedoTextEdit(Panel) &&
+                                       IsSavedAsBenchmarkDocument(Panel, Replacement->SavedDocument);
+        ReleaseBenchmarkPanel(Panel);
+    }
+    CheckBenchmarkResult("replace all keeps the line endings", AreReplacementsCorrect);
+    CheckBenchmarkResult("undoing a replace all keeps the line endings", AreUndoneReplacementsCorrect);
+}
+
+//=========================================================================================
+// NOTE(traian): SAVE ENCODING.
+//=========================================================================================
+
+// NOTE(traian): The transcoders count the sequences they replace, both in the vector blocks and in the tail, so a
+// save can fall back to UTF-8 and a load can mark the document as lossy.
+internal void
+CheckLossyTranscoding()
+{
+    printf("Lossy transcoding:\n");
+
+    // NOTE(traian): 20 ASCII units, so that the vector kernels see a whole block, then a lone high surrogate, a
+    // lone low surrogate, an emoji and a lone byte.
+    u8 UTF16Text[64];
+    memory_size UTF16Size = 0;
+    for (u32 Index = 0; Index < 20; ++Index)
+    {
+        UTF16Text[UTF16Size++] = 'a';
+        UTF16Text[UTF16Size++] = 0;
+    }
+    u8 UTF16Tail[] = { 0x00, 0xD8, 'b', 0, 0x00, 0xDC, 0x3D, 0xD8, 0x00, 0xDE, 'c' };
+    CopyMem(UTF16Text + UTF16Size, UTF16Tail, sizeof(UTF16Tail));
+    UTF16Size += sizeof(UTF16Tail);
+
+    char *LatinText = (char *)"the price is 5\xE2\x82\xAC, caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC";
+    char *EncodableText = (char *)"the price is 5\xE2\x82\xAC, caf\xC3\xA9";
+
+    transcode_kernel *UTF16Decoders[] = { DecodeUTF16LE_Scalar, DecodeUTF16LE_SSE2 };
+    transcode_kernel *LatinEncoders[] = { EncodeWindows1252_Scalar, EncodeWindows1252_SSE2 };
+    b32 IsCorrect = true;
+    for (u32 KernelIndex = 0; KernelIndex < ArrayCount(UTF16Decoders); ++KernelIndex)
+    {
+        u8 Destination[128];
+        transcode_result Decoded = UTF16Decoders[KernelIndex](UTF16Text, UTF16Size, Destination, true);
+        transcode_result Encoded = LatinEncoders[KernelIndex]((u8 *)LatinText, StringLength(LatinText),
+                                                              Destination, true);
+        transcode_result Encodable = LatinEncoders[KernelIndex]((u8 *)EncodableText, StringLength(EncodableText),
+                                                                Destination, true);
+        IsCorrect = IsCorrect && (Decoded.ReplacedCount == 3) && (Encoded.ReplacedCount == 2) &&
+                    (Encodable.ReplacedCount == 0);
+    }
+    CheckBenchmarkResult("replaced sequences are counted", IsCorrect);
+}
+
+// NOTE(traian): The save encodes the document one chunk at a time, which must give the same bytes as encoding the
+// whole text at once, also when a chunk of the text grows past the size of a chunk of the document.
+internal void
+CheckSaveEncoder(memory_size TextSize)
+{
+    printf("Save encoder on %llu MB of UTF-8 text:\n", TextSize / Megabytes(1));
+
+    buffer Text = PlatformAllocateMemory(TextSize);
+    GenerateSyntheticUTF8Text(Text, 120, 32, 0x2545F4914F6CDD1D);
+
+    text_save Save = {};
+    Save.Snapshot = Text;
+    Save.Format.Encoding = TextEncoding_UTF16LE;
+    Save.Format.HasByteOrderMark = true;
+    Save.Format.NewLineEnding = LineEnding_CRLF;
+
+    buffer Expanded = PlatformAllocateMemory(2 * TextSize);
+    memory_size ExpandedSize = ExpandLineEndings(Text.Data, TextSize, Expanded.Data);
+    memory_size MarkSize = GetByteOrderMarkSize(Save.Format);
+    buffer Document = PlatformAllocateMemory(MarkSize + GetMaxEncodedSize(TextEncoding_UTF16LE, ExpandedSize));
+    CopyMem(Document.Data, GetByteOrderMark(Save.Format), MarkSize);
+    Document.Size = MarkSize + EncodeText(TextEncoding_UTF16LE, Expanded.Data, ExpandedSize, Document.Data + MarkSize,
+                                          true).WrittenCount;
+
+    text_save_encoder Encoder;
+    BeginTextSaveEncoder(&Encoder, &Save, TextSize);
+    memory_size SavedSize = 0;
+    b32 IsCorrect = true;
+    for (buffer Chunk = NextTextSaveChunk(&Encoder); Chunk.Size > 0; Chunk = NextTextSaveChunk(&Encoder))
+    {
+        b32 IsLast = (SavedSize + Chunk.Size == Document.Size);
+        IsCorrect = IsCorrect && (IsLast || Chunk.Size == TEXT_SAVE_CHUNK_SIZE) &&
+                    (SavedSize + Chunk.Size <= Document.Size) &&
+                    AreBytesEqual((char *)Chunk.Data, (char *)Document.Data + SavedSize, Chunk.Size);
+        SavedSize += Chunk.Size;
+    }
+    IsCorrect = IsCorrect && (SavedSize == Document.Size) && (Encoder.ReplacedCount == 0);
+    CheckBenchmarkResult("chunks match the whole document", IsCorrect);
+
+    EndTextSaveEncoder(&Encoder);
+    PlatformReleaseMemory(Document);
+    PlatformReleaseMemory(Expanded);
+    PlatformReleaseMemory(Text);
+}
+
+internal void
+RunBenchmarks()
+{
+    DetectProcessorFeatures();
+    printf("Processor features: SSE2=%d SSE4.2=%d AVX2=%d\n\n", GlobalProcessorFeatures.HasSSE2,
+           GlobalProcessorFeatures.HasSSE42, GlobalProcessorFeatures.HasAVX2);
+
+    BenchmarkNewLineKernels(Gigabytes(1));
+    printf("\n");
+    BenchmarkTextIterator(Megabytes(500));
+    printf("\n");
+    BenchmarkTextEncodings(Megabytes(500));
+    printf("\n");
+    BenchmarkLineEndings(Megabytes(500));
+    printf("\n");
+    BenchmarkTokenKernels(Megabytes(500));
+    printf("\n");
+    BenchmarkFindKernels(Megabytes(500));
+    printf("\n");
+    BenchmarkRegexSearch(Megabytes(256));
+    printf("\n");
+    BenchmarkReplaceAll(Megabytes(256));
+    printf("\n");
+    BenchmarkTrigramIndex(300 * 1000, Kilobytes(1));
+    printf("\n");
+    BenchmarkFindInFiles(20 * 1000, Kilobytes(1));
+    printf("\n");
+    BenchmarkSyntaxHighlight(Megabytes(24));
+    printf("\n");
+    BenchmarkLargeFile(Gigabytes(6));
+    printf("\n");
+    CheckTextHistory();
+    printf("\n");
+    BenchmarkJournalRecovery(Megabytes(64), 100 * 1000);
+    printf("\n");
+    CheckReplaceAllHistory();
+    printf("\n");
+    CheckRegexCharacters();
+    CheckFindPrevious();
+    printf("\n");
+    CheckLineEndings();
+    printf("\n");
+    CheckLossyTranscoding();
+    printf("\n");
+    CheckSaveEncoder(Megabytes(24));
+}
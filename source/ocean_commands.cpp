@@ -8,14 +8,17 @@
 #include "ocean.h"
 #include "ocean_math.h"
 #include "ocean_text.h"
+#include "ocean_find_in_files.h"
 
 #if OCEAN_DEBUG
     #define VALIDATE_CARET_OFFSET(EditorState, PanelIndex)                                          \
         {                                                                                           \
             text_panel *Panel = EditorState->TextPanels + (PanelIndex);                             \
-            memory_size ExpectedOffset = GetBufferOffset(Panel->Buffer, &EditorState->Settings,     \
+            memory_size ExpectedOffset = GetBufferOffset(Panel, &EditorState->Settings,             \
                                                          Panel->Caret.Position.Line, Panel->Caret.Position.Column);   \
             Assert(Panel->Caret.Position.Offset == ExpectedOffset);                                          \
+            Assert(Panel->Caret.Position.Line == GetLineOfBufferOffset(&Panel->LineIndex,              \
+                                                                       Panel->Caret.Position.Offset)); \
         }
 #else
     #define VALIDATE_CARET_OFFSET(...)
@@ -37,12 +40,12 @@ internal EDITOR_COMMAND(Command_ScrollWindowToFitCaret)
     if (Caret->Position.Line >= Panel->FirstLineIndex + Panel->ScreenLineCount)
     {
         Panel->FirstLineIndex = Caret->Position.Line - Panel->ScreenLineCount + 1;
-        Panel->BufferOffset = GetBufferOffsetOfLine(Panel->Buffer, Panel->FirstLineIndex);
+        Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
     }
     else if (Caret->Position.Line < Panel->FirstLineIndex)
     {
         Panel->FirstLineIndex = Caret->Position.Line;
-        Panel->BufferOffset = GetBufferOffsetOfLine(Panel->Buffer, Panel->FirstLineIndex);
+        Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
     }
 
     if (Caret->Position.Column >= Panel->FirstColumnIndex + Panel->ScreenColumnCount)
@@ -65,7 +68,7 @@ internal EDITOR_COMMAND(Command_PageUp)
         Panel->Caret.Selection = {};
     }
 
-    s32 RelativeLine = Panel->Caret.Position.Line - Panel->FirstLineIndex;
+    s64 RelativeLine = Panel->Caret.Position.Line - Panel->FirstLineIndex;
     if (RelativeLine < 0 || RelativeLine >= Panel->ScreenLineCount)
     {
         RelativeLine = Panel->ScreenLineCount / 2;
@@ -84,10 +87,10 @@ internal EDITOR_COMMAND(Command_PageUp)
         Panel->FirstLineIndex = 0;
     }
 
-    Panel->BufferOffset = GetBufferOffsetOfLine(Panel->Buffer, Panel->FirstLineIndex);
+    Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
     Panel->Caret.Position.Line = Panel->FirstLineIndex + RelativeLine;
     Panel->Caret.Position.Column = 0;
-    Panel->Caret.Position.Offset = GetBufferOffset(Panel->Buffer, &EditorState->Settings,
+    Panel->Caret.Position.Offset = GetBufferOffset(Panel, &EditorState->Settings,
                                                    Panel->Caret.Position.Line, Panel->Caret.Position.Column);
     Panel->Caret.TargetColumn = Panel->Caret.Position.Column;
 
@@ -98,6 +101,7 @@ internal EDITOR_COMMAND(Command_PageUp)
 internal EDITOR_COMMAND(Command_PageDown)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    EnsureLinesAreIndexed(Panel, Panel->FirstLineIndex + 2 * Panel->ScreenLineCount);
 
     if (Panel->Caret.IsSelecting)
     {
@@ -105,7 +109,7 @@ internal EDITOR_COMMAND(Command_PageDown)
         Panel->Caret.Selection = {};
     }
 
-    s32 RelativeLine = Panel->Caret.Position.Line - Panel->FirstLineIndex;
+    s64 RelativeLine = Panel->Caret.Position.Line - Panel->FirstLineIndex;
     if (RelativeLine < 0 || RelativeLine >= Panel->ScreenLineCount)
     {
         RelativeLine = Panel->ScreenLineCount / 2;
@@ -120,10 +124,10 @@ internal EDITOR_COMMAND(Command_PageDown)
         Panel->FirstLineIndex += Panel->ScreenLineCount;
     }
 
-    Panel->BufferOffset = GetBufferOffsetOfLine(Panel->Buffer, Panel->FirstLineIndex);
-    Panel->Caret.Position.Line = Panel->FirstLineIndex + RelativeLine;
+    Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
+    Panel->Caret.Position.Line = Minimum(Panel->FirstLineIndex + RelativeLine, Panel->LineCount);
     Panel->Caret.Position.Column = 0;
-    Panel->Caret.Position.Offset = GetBufferOffset(Panel->Buffer, &EditorState->Settings,
+    Panel->Caret.Position.Offset = GetBufferOffset(Panel, &EditorState->Settings,
                                                    Panel->Caret.Position.Line, Panel->Caret.Position.Column);
     Panel->Caret.TargetColumn = Panel->Caret.Position.Column;
 
@@ -139,39 +143,21 @@ internal EDITOR_COMMAND(Command_MoveCaretToLeft)
 
     if (Panel->Caret.Position.Offset > 0)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Panel->Caret.Position.Offset);
-        
         if (Panel->Caret.Position.Column == 0)
         {
-            Iterator = GetPreviousLineFirstIterator(Iterator);
-            u32 ColumnOffset = 0;
-            while (Iterator.Codepoint != '\n')
-            {
-                ColumnOffset += GetCodepointColumnCount(Settings, Iterator.Codepoint, ColumnOffset);
-                Iterator = AdvanceIterator(Iterator);
-            }
-
+            text_column_map *Map = GetTextColumnMap(Panel, Settings, Panel->Caret.Position.Line - 1);
             Panel->Caret.Position.Line--;
-            Panel->Caret.Position.Column = ColumnOffset;
-            Panel->Caret.Position.Offset = Iterator.Offset;
+            Panel->Caret.Position.Column = Map->ColumnCount;
+            Panel->Caret.Position.Offset = Map->LineOffset + Map->ByteCount;
         }
         else
         {
+            text_iterator Iterator = NewTextIterator(&Panel->Buffer, Panel->Caret.Position.Offset);
             text_iterator PreviousIterator = DevanceIterator(Iterator);
             memory_offset TargetBufferOffset = Iterator.Offset - PreviousIterator.Width;
-            Iterator = GetCurrentLineFirstIterator(Iterator);
-
-            u32 ColumnOffset = 0;
-            memory_offset BufferOffset = Iterator.Offset;
-            while (BufferOffset < TargetBufferOffset)
-            {
-                ColumnOffset += GetCodepointColumnCount(Settings, Iterator.Codepoint, ColumnOffset);
-                BufferOffset += Iterator.Width;
-                Iterator = AdvanceIterator(Iterator);
-            }
 
-            Assert(BufferOffset == TargetBufferOffset);
-            Panel->Caret.Position.Column = ColumnOffset;
+            text_column_map *Map = GetTextColumnMap(Panel, Settings, Panel->Caret.Position.Line);
+            Panel->Caret.Position.Column = GetColumnOfLineOffset(Map, TargetBufferOffset - Map->LineOffset);
             Panel->Caret.Position.Offset = TargetBufferOffset;
         }
 
@@ -217,21 +203,10 @@ internal EDITOR_COMMAND(Command_MoveCaretUp)
 
     if (Panel->Caret.Position.Line > 0)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Caret->Position.Offset);
-        Iterator = GetPreviousLineFirstIterator(Iterator);
-        Assert(IsValid(Iterator));
-
-        u32 ColumnOffset = 0;
-        while (ColumnOffset < Caret->TargetColumn && IsValidAndNotNewLine(Iterator))
-        {
-            ColumnOffset += GetCodepointColumnCount(Settings, Iterator.Codepoint, ColumnOffset);
-            Iterator = AdvanceIterator(Iterator);
-        }
-
+        text_column_map *Map = GetTextColumnMap(Panel, Settings, Caret->Position.Line - 1);
         Caret->Position.Line--;
-        Caret->Position.Column = ColumnOffset;
-        Assert(IsValid(Iterator));
-        Caret->Position.Offset = Iterator.Offset;
+        Caret->Position.Offset = Map->LineOffset + GetLineOffsetOfColumn(Map, Caret->TargetColumn,
+                                                                         &Caret->Position.Column);
     }
 
     Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
@@ -244,30 +219,13 @@ internal EDITOR_COMMAND(Command_MoveCaretDown)
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
     text_caret *Caret = &Panel->Caret;
 
+    EnsureLinesAreIndexed(Panel, Caret->Position.Line + 1);
     if (Caret->Position.Line < Panel->LineCount)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Caret->Position.Offset);
-        Iterator = GetNextLineFirstIterator(Iterator);
-
-        if (IsValid(Iterator))
-        {
-            u32 ColumnOffset = 0;
-            while (ColumnOffset < Caret->TargetColumn && IsValidAndNotNewLine(Iterator))
-            {
-                ColumnOffset += GetCodepointColumnCount(Settings, Iterator.Codepoint, ColumnOffset);
-                Iterator = AdvanceIterator(Iterator);
-            }
-
-            Caret->Position.Column = ColumnOffset;
-            Caret->Position.Offset = IsValid(Iterator) ? Iterator.Offset : Panel->Buffer.Used;
-        }
-        else
-        {
-            Caret->Position.Column = 0;
-            Caret->Position.Offset = Panel->Buffer.Used;
-        }
-
+        text_column_map *Map = GetTextColumnMap(Panel, Settings, Caret->Position.Line + 1);
         Caret->Position.Line++;
+        Caret->Position.Offset = Map->LineOffset + GetLineOffsetOfColumn(Map, Caret->TargetColumn,
+                                                                         &Caret->Position.Column);
     }
 
     Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
@@ -346,20 +304,20 @@ internal EDITOR_COMMAND(Command_ArrowDown)
     Command_MoveCaretDown(EditorState, PanelIndex, NULL);
 }
 
-internal inline b32
-IsContiguousTokenCodepoint(u32 Codepoint)
+// NOTE(traian): Places the caret at an offset on its current line. The column is computed only once, from the
+// column map of the line, instead of accumulating it one character at a time.
+internal void
+MoveCaretWithinLine(editor_state *EditorState, u32 PanelIndex, memory_offset Offset)
 {
-    b32 Result = ('a' <= Codepoint && Codepoint <= 'z') ||
-                 ('A' <= Codepoint && Codepoint <= 'Z') ||
-                 (Codepoint == '_');
-    return Result;
-}
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_caret *Caret = &Panel->Caret;
 
-internal inline b32
-IsIgnoredTokenCodepoint(u32 Codepoint)
-{
-    b32 Result = (Codepoint == ' ' || Codepoint == '\t');
-    return Result;
+    text_column_map *Map = GetTextColumnMap(Panel, &EditorState->Settings, Caret->Position.Line);
+    Assert(Map->LineOffset <= Offset && Offset <= Map->LineOffset + Map->ByteCount);
+
+    Caret->Position.Column = GetColumnOfLineOffset(Map, Offset - Map->LineOffset);
+    Caret->Position.Offset = Offset;
+    Caret->TargetColumn = Caret->Position.Column;
 }
 
 internal EDITOR_COMMAND(Command_GoToNextToken)
@@ -369,31 +327,15 @@ internal EDITOR_COMMAND(Command_GoToNextToken)
 
     if (Caret->Position.Offset < Panel->Buffer.Used)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Caret->Position.Offset);
-
-        if (IsContiguousTokenCodepoint(Iterator.Codepoint))
+        memory_offset TargetOffset = FindNextTokenBoundary(&Panel->Buffer, Caret->Position.Offset);
+        if (TargetOffset != Caret->Position.Offset)
         {
-            while (IsValid(Iterator) && IsContiguousTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToRight(EditorState, PanelIndex, NULL);
-                Iterator = AdvanceIterator(Iterator);
-            }
-            while (IsValid(Iterator) && IsIgnoredTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToRight(EditorState, PanelIndex, NULL);
-                Iterator = AdvanceIterator(Iterator);
-            }
-        }
-        else if (IsIgnoredTokenCodepoint(Iterator.Codepoint))
-        {
-            while (IsValid(Iterator) && IsIgnoredTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToRight(EditorState, PanelIndex, NULL);
-                Iterator = AdvanceIterator(Iterator);
-            }
+            MoveCaretWithinLine(EditorState, PanelIndex, TargetOffset);
         }
         else
         {
+            // NOTE(traian): The character isn't part of a token, so the caret only steps over it. This is the only
+            // case where the caret can move onto another line.
             Command_MoveCaretToRight(EditorState, PanelIndex, NULL);
         }
     }
@@ -409,44 +351,19 @@ internal EDITOR_COMMAND(Command_GoToPreviousToken)
 
     if (Caret->Position.Offset > 0)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Caret->Position.Offset);
-        Iterator = DevanceIterator(Iterator);
-
-        if (IsContiguousTokenCodepoint(Iterator.Codepoint))
-        {
-            while (IsValid(Iterator) && IsContiguousTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToLeft(EditorState, PanelIndex, NULL);
-                Iterator = DevanceIterator(Iterator);
-            }
-
-            text_caret CurrentCaret = *Caret;
-
-            while (IsValid(Iterator) && IsIgnoredTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToLeft(EditorState, PanelIndex, NULL);
-                Iterator = DevanceIterator(Iterator);
-            }
-
-            if (Iterator.Codepoint == '\n')
-            {
-                *Caret = CurrentCaret;
-                Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
-            }
-        }
-        else if (IsIgnoredTokenCodepoint(Iterator.Codepoint))
+        memory_offset TargetOffset = FindPreviousTokenBoundary(&Panel->Buffer, Caret->Position.Offset);
+        if (TargetOffset != Caret->Position.Offset)
         {
-            while (IsValid(Iterator) && IsIgnoredTokenCodepoint(Iterator.Codepoint))
-            {
-                Command_MoveCaretToLeft(EditorState, PanelIndex, NULL);
-                Iterator = DevanceIterator(Iterator);
-            }
+            MoveCaretWithinLine(EditorState, PanelIndex, TargetOffset);
         }
         else
         {
             Command_MoveCaretToLeft(EditorState, PanelIndex, NULL);
         }
     }
+
+    VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
 }
 
 internal EDITOR_COMMAND(Command_ScrollPanelUp)
@@ -455,12 +372,8 @@ internal EDITOR_COMMAND(Command_ScrollPanelUp)
 
     if (Panel->FirstLineIndex > 0)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Panel->BufferOffset);
-        Iterator = GetPreviousLineFirstIterator(Iterator);
-        Assert(IsValid(Iterator));
-
-        Panel->BufferOffset = Iterator.Offset;
         Panel->FirstLineIndex--;
+        Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
     }
 }
 
@@ -468,14 +381,11 @@ internal EDITOR_COMMAND(Command_ScrollPanelDown)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
 
+    EnsureLinesAreIndexed(Panel, Panel->FirstLineIndex + 1);
     if (Panel->FirstLineIndex < Panel->LineCount - 1)
     {
-        text_iterator Iterator = NewTextIterator(&Panel->Buffer, Panel->BufferOffset);
-        Iterator = GetNextLineFirstIterator(Iterator);
-        Assert(IsValid(Iterator));
-
-        Panel->BufferOffset = Iterator.Offset;
         Panel->FirstLineIndex++;
+        Panel->BufferOffset = GetBufferOffsetOfLine(Panel, Panel->FirstLineIndex);
     }
 }
 
@@ -615,6 +525,68 @@ internal EDITOR_COMMAND(Command_SelectUntilPreviousToken)
     }
 }
 
+//=========================================================================================
+// NOTE(traian): MULTIPLE CARET COMMANDS.
+//=========================================================================================
+
+// NOTE(traian): Adds a caret on the line above (or below) the outermost caret, at the column that the caret
+// targets. The view follows the new caret, even though it doesn't become the main caret.
+internal void
+AddCaretOnAdjacentLine(editor_state *EditorState, u32 PanelIndex, b32 IsAbove)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_caret_list *List = &Panel->ExtraCarets;
+
+    text_caret *Outermost = &Panel->Caret;
+    if (List->Count > 0)
+    {
+        text_caret *Candidate = IsAbove ? List->Carets : List->Carets + List->Count - 1;
+        if (IsAbove ? (Candidate->Position.Offset < Outermost->Position.Offset)
+                    : (Candidate->Position.Offset > Outermost->Position.Offset))
+        {
+            Outermost = Candidate;
+        }
+    }
+
+    u64 Line = Outermost->Position.Line;
+    EnsureLinesAreIndexed(Panel, Line + 1);
+    if (IsAbove ? (Line == 0) : (Line >= Panel->LineCount))
+    {
+        return;
+    }
+
+    text_caret Caret = {};
+    Caret.Position.Line = IsAbove ? Line - 1 : Line + 1;
+    Caret.TargetColumn = Outermost->TargetColumn;
+    text_column_map *Map = GetTextColumnMap(Panel, &EditorState->Settings, Caret.Position.Line);
+    Caret.Position.Offset = Map->LineOffset + GetLineOffsetOfColumn(Map, Caret.TargetColumn, &Caret.Position.Column);
+
+    if (AddTextCaret(Panel, &Caret))
+    {
+        text_caret MainCaret = Panel->Caret;
+        Panel->Caret = Caret;
+        Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+        Panel->Caret = MainCaret;
+    }
+}
+
+internal EDITOR_COMMAND(Command_AddCaretAbove)
+{
+    AddCaretOnAdjacentLine(EditorState, PanelIndex, true);
+}
+
+internal EDITOR_COMMAND(Command_AddCaretBelow)
+{
+    AddCaretOnAdjacentLine(EditorState, PanelIndex, false);
+}
+
+internal EDITOR_COMMAND(Command_ClearExtraCarets)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    Panel->ExtraCarets.Count = 0;
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+}
+
 //=========================================================================================
 // NOTE(traian): TEXT INPUT AND DELETION COMMANDS.
 //=========================================================================================
@@ -631,35 +603,87 @@ internal EDITOR_COMMAND(Command_RemoveCharacters)
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
     text_buffer *Buffer = &Panel->Buffer;
 
+    text_view_state Before = GetTextViewState(Panel);
+    text_edit_record *Record = NULL;
+
     if (Panel->Caret.Position.Offset + CommandData->ByteCount <= Buffer->Used && CommandData->ByteCount > 0)
     {
-        text_iterator Iterator = NewTextIterator(Buffer, Panel->Caret.Position.Offset);
+        MakeTextPanelEditable(Panel);
+        Record = RecordTextEdit(Panel, TextEditKind_Remove, Panel->Caret.Position.Offset, NULL,
+                                CommandData->ByteCount, &Before);
+        ApplyTextEdit(Panel, TextEditKind_Remove, Panel->Caret.Position.Offset, NULL, CommandData->ByteCount);
+    }
 
-        memory_offset TargetOffset = Panel->Caret.Position.Offset + CommandData->ByteCount;
-        while (IsValid(Iterator) && Iterator.Offset < TargetOffset)
-        {
-            if (Iterator.Codepoint == '\n')
-            {
-                Panel->LineCount--;
-            }
-            Iterator = AdvanceIterator(Iterator);
-        }
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+}
 
-        Buffer->Used -= CommandData->ByteCount;
-        for (memory_offset BufferOffset = Panel->Caret.Position.Offset; BufferOffset < Buffer->Used; ++BufferOffset)
-        {
-            Buffer->Base[BufferOffset] = Buffer->Base[BufferOffset + CommandData->ByteCount];
-        }
+// NOTE(traian): When the panel has extra carets, the text commands edit the text at every caret in one pass.
+// The whole pass is undone in a single step.
+internal void
+RemoveAtEachCaret(editor_state *EditorState, u32 PanelIndex, text_caret_removal Removal)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
 
-        Panel->IsSaveDirty = true;
+    BeginTextEditGroup(Panel);
+    text_edit_record *Record = RemoveAtTextCarets(Panel, &EditorState->Settings, Removal);
+
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+    EndTextEditGroup(Panel);
+
+    VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
+}
+
+internal void
+InsertAtEachCaret(editor_state *EditorState, u32 PanelIndex, char *Characters, memory_size ByteCount)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_caret_list *List = &Panel->ExtraCarets;
+
+    b32 IsSelecting = Panel->Caret.IsSelecting;
+    for (u64 Index = 0; Index < List->Count && !IsSelecting; ++Index)
+    {
+        IsSelecting = List->Carets[Index].IsSelecting;
+    }
+
+    BeginTextEditGroup(Panel);
+    text_edit_record *Record = NULL;
+    if (IsSelecting)
+    {
+        Record = RemoveAtTextCarets(Panel, &EditorState->Settings, CaretRemoval_Selection);
     }
 
+    text_edit_record *InsertRecord = InsertAtTextCarets(Panel, &EditorState->Settings, Characters, ByteCount);
+    Record = InsertRecord ? InsertRecord : Record;
+
     Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+    EndTextEditGroup(Panel);
+
+    VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
 }
 
 EDITOR_COMMAND(Command_RemoveCharacterFromRight)
 {
-   text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (Panel->ExtraCarets.Count > 0)
+    {
+        RemoveAtEachCaret(EditorState, PanelIndex, CaretRemoval_NextCharacter);
+        return;
+    }
+
+    // NOTE(traian): Undoing the removal restores the selection (or the caret) from before the command.
+    BeginTextEditGroup(Panel);
 
     if (Panel->Caret.IsSelecting)
     {
@@ -693,11 +717,20 @@ EDITOR_COMMAND(Command_RemoveCharacterFromRight)
 
         Command_RemoveCharacters(EditorState, PanelIndex, &RemoveCommandInfo);
     }
+
+    EndTextEditGroup(Panel);
 }
 
 internal EDITOR_COMMAND(Command_RemoveCharacterFromLeft)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (Panel->ExtraCarets.Count > 0)
+    {
+        RemoveAtEachCaret(EditorState, PanelIndex, CaretRemoval_PreviousCharacter);
+        return;
+    }
+
+    BeginTextEditGroup(Panel);
 
     if (Panel->Caret.IsSelecting)
     {
@@ -725,6 +758,8 @@ internal EDITOR_COMMAND(Command_RemoveCharacterFromLeft)
         Command_MoveCaretToLeft(EditorState, PanelIndex, NULL);
         Command_RemoveCharacterFromRight(EditorState, PanelIndex, NULL);
     }
+
+    EndTextEditGroup(Panel);
 }
 
 struct command_insert_characters_data
@@ -739,43 +774,19 @@ internal EDITOR_COMMAND(Command_InsertCharacters)
 
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
     text_caret *Caret = &Panel->Caret;
-    text_buffer *Buffer = &Panel->Buffer;
 
     text_buffer InsertBuffer = {};
     InsertBuffer.Base = CommandData->Characters;
     InsertBuffer.Size = CommandData->ByteCount;
     InsertBuffer.Used = CommandData->ByteCount;
+    InsertBuffer.GapOffset = CommandData->ByteCount;
 
-    if (Buffer->Used + CommandData->ByteCount > Buffer->Size)
-    {
-        memory_size NewTextBufferSize = Maximum(Buffer->Used + CommandData->ByteCount, 2 * Buffer->Size);
-        buffer OldTextBuffer;
-        OldTextBuffer.Data = (u8 *)Buffer->Base;
-        OldTextBuffer.Size = Buffer->Size;
-
-        buffer NewTextBuffer = PlatformAllocateMemory(NewTextBufferSize);
-        Buffer->Base = (char *)NewTextBuffer.Data;
-        Buffer->Size = NewTextBuffer.Size;
-        
-        if (OldTextBuffer.Data)
-        {
-            CopyMem(Buffer->Base, OldTextBuffer.Data, Buffer->Used);
-            PlatformReleaseMemory(OldTextBuffer);
-        }
-    }
-
-    Buffer->Used += CommandData->ByteCount;
-    memory_offset InsertOffset = Caret->Position.Offset;
-
-    for (memory_offset BufferOffset = Buffer->Used - 1;
-        BufferOffset >= InsertOffset + CommandData->ByteCount;
-        --BufferOffset)
-    {
-        Buffer->Base[BufferOffset] = Buffer->Base[BufferOffset - CommandData->ByteCount];
-    }
-
-    CopyMem(Buffer->Base + InsertOffset, CommandData->Characters, CommandData->ByteCount);
-    Panel->IsSaveDirty = true;
+    text_view_state Before = GetTextViewState(Panel);
+    MakeTextPanelEditable(Panel);
+    text_edit_record *Record = RecordTextEdit(Panel, TextEditKind_Insert, Caret->Position.Offset,
+                                              CommandData->Characters, CommandData->ByteCount, &Before);
+    ApplyTextEdit(Panel, TextEditKind_Insert, Caret->Position.Offset, CommandData->Characters,
+                  CommandData->ByteCount);
 
     text_iterator Iterator = NewTextIterator(&InsertBuffer, 0);
     while (IsValid(Iterator))
@@ -784,7 +795,6 @@ internal EDITOR_COMMAND(Command_InsertCharacters)
         {
             Caret->Position.Line++;
             Caret->Position.Column = 0;
-            Panel->LineCount++;
         }
         else
         {
@@ -796,6 +806,11 @@ internal EDITOR_COMMAND(Command_InsertCharacters)
     }
 
     Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+
     VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
 }
 
@@ -803,6 +818,26 @@ internal EDITOR_COMMAND(Command_InsertCharacter)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
 
+    u32 Codepoint = GetCodepointFromKeyCode(CommandInfo->KeyCode);
+    if (CommandInfo->Modifiers & KeyModifier_Shift)
+    {
+        Codepoint = GetCodepointShiftCorrespondant(Codepoint);
+    }
+    if (CommandInfo->IsCapsLockActive)
+    {
+        Codepoint = GetCodepointToggledCapital(Codepoint);
+    }
+
+    if (Panel->ExtraCarets.Count > 0)
+    {
+        char Character = (char)Codepoint;
+        InsertAtEachCaret(EditorState, PanelIndex, &Character, 1);
+        return;
+    }
+
+    // NOTE(traian): Typing over a selection is undone in a single step.
+    BeginTextEditGroup(Panel);
+
     if (Panel->Caret.IsSelecting)
     {
         text_caret_position Position = Panel->Caret.Selection;
@@ -824,16 +859,6 @@ internal EDITOR_COMMAND(Command_InsertCharacter)
 
         Command_RemoveCharacters(EditorState, PanelIndex, &CommandInfo);
     }
-    
-    u32 Codepoint = GetCodepointFromKeyCode(CommandInfo->KeyCode);
-    if (CommandInfo->Modifiers & KeyModifier_Shift)
-    {
-        Codepoint = GetCodepointShiftCorrespondant(Codepoint);
-    }
-    if (CommandInfo->IsCapsLockActive)
-    {
-        Codepoint = GetCodepointToggledCapital(Codepoint);
-    }
 
     // TODO(traian): Unicode encodings!
     char Buffer[4] = { (char)Codepoint };
@@ -852,16 +877,30 @@ internal EDITOR_COMMAND(Command_InsertCharacter)
     InsertCommandInfo.OpaqueData = &InsertCharactersData;
 
     Command_InsertCharacters(EditorState, PanelIndex, &InsertCommandInfo);
+    EndTextEditGroup(Panel);
 }
 
 internal EDITOR_COMMAND(Command_RemoveCharactersUntilNextToken)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (Panel->ExtraCarets.Count > 0)
+    {
+        RemoveAtEachCaret(EditorState, PanelIndex, CaretRemoval_NextToken);
+        return;
+    }
 
-    text_caret CurrentCaret = Panel->Caret;
-    Command_GoToNextToken(EditorState, PanelIndex, NULL);
-    memory_size BytesToRemove = Panel->Caret.Position.Offset - CurrentCaret.Position.Offset;
-    Panel->Caret = CurrentCaret;
+    memory_offset CurrentOffset = Panel->Caret.Position.Offset;
+
+    // NOTE(traian): The removed range is found directly, so the caret doesn't have to be moved over it first.
+    memory_size BytesToRemove = 0;
+    if (CurrentOffset < Panel->Buffer.Used)
+    {
+        BytesToRemove = FindNextTokenBoundary(&Panel->Buffer, CurrentOffset) - CurrentOffset;
+        if (BytesToRemove == 0)
+        {
+            BytesToRemove = NewTextIterator(&Panel->Buffer, CurrentOffset).Width;
+        }
+    }
 
     command_remove_characters_data CommandData = {};
     CommandData.ByteCount = BytesToRemove;
@@ -874,7 +913,14 @@ internal EDITOR_COMMAND(Command_RemoveCharactersUntilNextToken)
 internal EDITOR_COMMAND(Command_RemoveCharactersUntilPreviousToken)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (Panel->ExtraCarets.Count > 0)
+    {
+        RemoveAtEachCaret(EditorState, PanelIndex, CaretRemoval_PreviousToken);
+        return;
+    }
+
     
+    BeginTextEditGroup(Panel);
     memory_offset CurrentOffset = Panel->Caret.Position.Offset;
     Command_GoToPreviousToken(EditorState, PanelIndex, NULL);
     memory_size BytesToRemove = CurrentOffset - Panel->Caret.Position.Offset;
@@ -885,98 +931,627 @@ internal EDITOR_COMMAND(Command_RemoveCharactersUntilPreviousToken)
     RemoveCommandInfo.OpaqueData = &CommandData;
 
     Command_RemoveCharacters(EditorState, PanelIndex, &RemoveCommandInfo);
+    EndTextEditGroup(Panel);
 }
 
 //=========================================================================================
-// NOTE(traian): FILE MANAGEMENT COMMANDS.
+// NOTE(traian): UNDO AND REDO COMMANDS.
 //=========================================================================================
 
-internal EDITOR_COMMAND(Command_SaveFile)
+internal EDITOR_COMMAND(Command_Undo)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
-    text_buffer *Buffer = &Panel->Buffer;
-
-    if (Panel->FileName)
+    if (UndoTextEdit(Panel))
     {
-        buffer TextBuffer;
-        TextBuffer.Data = (u8 *)Buffer->Base;
-        TextBuffer.Size = Buffer->Used;
-
-        memory_size BytesWritten = PlatformWriteEntireFile(Panel->FileName, TextBuffer);
-        Assert(BytesWritten == Buffer->Used);
-        Panel->IsSaveDirty = false;
+        VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
     }
 }
 
-internal inline void
-ResetCaret(text_caret *Caret)
+internal EDITOR_COMMAND(Command_Redo)
 {
-    Caret->Position.Offset = 0;
-    Caret->Position.Line = 0;
-    Caret->Position.Column = 0;
-    Caret->TargetColumn = 0;
-    Caret->IsSelecting = false;
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (RedoTextEdit(Panel))
+    {
+        VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
+    }
 }
 
-struct command_open_file_data
-{
-    char *FileName;
-};
+//=========================================================================================
+// NOTE(traian): FIND COMMANDS.
+//=========================================================================================
 
-internal EDITOR_COMMAND(Command_OpenFile)
+// NOTE(traian): Selects the match, with the caret placed at its end.
+internal void
+SelectTextFindMatch(editor_state *EditorState, u32 PanelIndex, text_find_match Match)
 {
-    EDITOR_COMMAND_CAST_DATA(command_open_file_data);
-
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
-    text_buffer *Buffer = &Panel->Buffer;
+    text_caret *Caret = &Panel->Caret;
+    memory_offset EndOffset = Match.Offset + Match.Size;
 
-    Panel->IsSaveDirty = false;
-    Panel->FileName = NULL;
-    Panel->LineCount = 0;
+    // NOTE(traian): The lazy line index of a mapped file might not reach the match yet.
+    while (Panel->LineIndex.ScannedSize <= EndOffset && !IsLineIndexComplete(&Panel->LineIndex))
+    {
+        EnsureLinesAreIndexed(Panel, Panel->LineIndex.Count);
+    }
 
-    ResetCaret(&Panel->Caret);
-    Panel->FirstLineIndex = 0;
-    Panel->FirstColumnIndex = 0;
-    Panel->BufferOffset = 0;
+    SetCaretFromTextOffset(Panel, &EditorState->Settings, Caret, Match.Offset);
+    Caret->Selection = Caret->Position;
+    SetCaretFromTextOffset(Panel, &EditorState->Settings, Caret, EndOffset);
+    Caret->IsSelecting = true;
+    Panel->ExtraCarets.Count = 0;
 
-    memory_size FileSize = PlatformGetFileSize(CommandData->FileName);
-    if (FileSize != INVALID_SIZE)
-    {
-        memory_size TextBufferSize = FileSize + FileSize / 2;
-        if (TextBufferSize > Buffer->Size || Buffer->Size > (2 * TextBufferSize))
-        {
-            buffer OldTextBuffer = { (u8 *)Buffer->Base, Buffer->Size };
-            PlatformReleaseMemory(OldTextBuffer);
+    VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+}
 
-            buffer NewTextBuffer = PlatformAllocateMemory(TextBufferSize);
-            Buffer->Size = TextBufferSize;
-            Buffer->Base = (char *)NewTextBuffer.Data;
-        }
+internal EDITOR_COMMAND(Command_BeginFind)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    ResetTextFind(Panel);
+    Panel->Find.IsActive = true;
+    Panel->Find.StartOffset = GetCaretStartOffset(&Panel->Caret);
+}
 
-        Buffer->Used = FileSize;
+internal EDITOR_COMMAND(Command_EndFind)
+{
+    // NOTE(traian): The query is kept, so that the next match can still be found.
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    Panel->Find.IsActive = false;
+    Panel->Find.IsReplaceAllPending = false;
+}
 
-        buffer FileBuffer = { (u8 *)Buffer->Base, Buffer->Size };
-        memory_size ReadByteCount = PlatformReadEntireFile(CommandData->FileName, FileBuffer);
-        Assert(ReadByteCount == Buffer->Used);
+// NOTE(traian): Every change of the query selects the first match at or after the offset where the find was
+// started, so the selection only moves forward while the query is typed.
+internal void
+SelectFirstTextFindMatch(editor_state *EditorState, u32 PanelIndex)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    UpdateTextFindQuery(Panel);
 
-        Panel->FileName = CommandData->FileName;
-        Panel->LineCount = GetNumberOfLines(Buffer->Base, Buffer->Used);
+    text_find_match Match;
+    if (FindNextTextMatch(Panel, Panel->Find.StartOffset, &Match))
+    {
+        SelectTextFindMatch(EditorState, PanelIndex, Match);
     }
 }
 
-internal EDITOR_COMMAND(Command_NewTextBuffer)
+internal EDITOR_COMMAND(Command_FindInsertCharacter)
 {
     text_panel *Panel = EditorState->TextPanels + PanelIndex;
-    text_buffer *Buffer = &Panel->Buffer;
-
-    Panel->IsSaveDirty = false;
-    Panel->FileName = NULL;
-    Panel->LineCount = 0;
-    
-    ResetCaret(&Panel->Caret);
-    Panel->FirstLineIndex = 0;
-    Panel->FirstColumnIndex = 0;
-    Panel->BufferOffset = 0;
+    text_find *Find = &Panel->Find;
+
+    u32 Codepoint = GetCodepointFromKeyCode(CommandInfo->KeyCode);
+    if (CommandInfo->Modifiers & KeyModifier_Shift)
+    {
+        Codepoint = GetCodepointShiftCorrespondant(Codepoint);
+    }
+    if (CommandInfo->IsCapsLockActive)
+    {
+        Codepoint = GetCodepointToggledCapital(Codepoint);
+    }
+
+    if (Find->IsEditingReplacement)
+    {
+        if (Find->ReplacementLength < ArrayCount(Find->Replacement))
+        {
+            Find->Replacement[Find->ReplacementLength++] = (char)Codepoint;
+        }
+    }
+    else if (Find->QueryLength < ArrayCount(Find->Query))
+    {
+        Find->Query[Find->QueryLength++] = (char)Codepoint;
+        SelectFirstTextFindMatch(EditorState, PanelIndex);
+    }
+}
+
+internal EDITOR_COMMAND(Command_FindRemoveCharacter)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+
+    if (Find->IsEditingReplacement)
+    {
+        if (Find->ReplacementLength > 0)
+        {
+            --Find->ReplacementLength;
+        }
+    }
+    else if (Find->QueryLength > 0)
+    {
+        --Find->QueryLength;
+        SelectFirstTextFindMatch(EditorState, PanelIndex);
+    }
+}
+
+// NOTE(traian): A malformed regex keeps the old selection, while the find shows that the query isn't valid.
+internal EDITOR_COMMAND(Command_FindToggleRegex)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    Panel->Find.IsRegex = !Panel->Find.IsRegex;
+    SelectFirstTextFindMatch(EditorState, PanelIndex);
+}
+
+internal EDITOR_COMMAND(Command_FindNext)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+
+    if (Find->IsQueryValid)
+    {
+        Find->IsActive = true;
+        text_find_match Match;
+        if (FindNextTextMatch(Panel, GetCaretEndOffset(&Panel->Caret), &Match))
+        {
+            Find->StartOffset = Match.Offset;
+            SelectTextFindMatch(EditorState, PanelIndex, Match);
+        }
+    }
+}
+
+internal EDITOR_COMMAND(Command_FindPrevious)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+
+    if (Find->IsQueryValid)
+    {
+        Find->IsActive = true;
+        text_find_match Match;
+        if (FindPreviousTextMatch(Panel, GetCaretStartOffset(&Panel->Caret), &Match))
+        {
+            Find->StartOffset = Match.Offset;
+            SelectTextFindMatch(EditorState, PanelIndex, Match);
+        }
+    }
+}
+
+internal EDITOR_COMMAND(Command_BeginReplace)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    if (!Panel->Find.IsActive)
+    {
+        Command_BeginFind(EditorState, PanelIndex, CommandInfo);
+    }
+    Panel->Find.IsEditingReplacement = true;
+}
+
+// NOTE(traian): Switches the typed characters between the query and the replacement.
+internal EDITOR_COMMAND(Command_FindToggleReplacement)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    Panel->Find.IsEditingReplacement = !Panel->Find.IsEditingReplacement;
+}
+
+// NOTE(traian): Replaces every match once the scan is complete.
+internal void
+CompleteReplaceAll(editor_state *EditorState, u32 PanelIndex)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+
+    text_view_state Before = GetTextViewState(Panel);
+    text_edit_record *Record = ReplaceAllTextMatches(Panel, &EditorState->Settings, Find->Replacement,
+                                                     Find->ReplacementLength, &Before);
+
+    Command_ScrollWindowToFitCaret(EditorState, PanelIndex, NULL);
+    if (Record)
+    {
+        Record->After = GetTextViewState(Panel);
+    }
+    VALIDATE_CARET_OFFSET(EditorState, PanelIndex);
+}
+
+// NOTE(traian): The rest of the text is scanned by the timer ticks, which replace the matches once the scan is
+// complete, so a large file doesn't block the editor.
+internal EDITOR_COMMAND(Command_ReplaceAll)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+
+    if (Find->IsQueryValid)
+    {
+        Find->IsActive = true;
+        Find->IsReplaceAllPending = true;
+        Find->ReplaceAllEditVersion = Panel->EditVersion;
+        if (IsTextFindComplete(Panel))
+        {
+            CompleteReplaceAll(EditorState, PanelIndex);
+        }
+    }
+}
+
+//=========================================================================================
+// NOTE(traian): FILE MANAGEMENT COMMANDS.
+//=========================================================================================
+
+internal inline void
+ResetCaret(text_caret *Caret)
+{
+    Caret->Position.Offset = 0;
+    Caret->Position.Line = 0;
+    Caret->Position.Column = 0;
+    Caret->TargetColumn = 0;
+    Caret->IsSelecting = false;
+}
+
+// NOTE(traian): Moves the caret and the view back to the start of the text.
+internal void
+ResetTextPanelView(text_panel *Panel)
+{
+    ResetCaret(&Panel->Caret);
+    Panel->ExtraCarets.Count = 0;
+    Panel->FirstLineIndex = 0;
+    Panel->FirstColumnIndex = 0;
+    Panel->BufferOffset = 0;
+}
+
+// NOTE(traian): Replays the journal of a document that was opened at startup, waiting for the document to load.
+// The caret and the view go back to the start, since the text they were placed in was replaced. Returns true if any
+// edit was recovered.
+internal b32
+CompleteTextJournalRecovery(text_panel *Panel)
+{
+    if (!Panel->Journal.IsRecoveryPending)
+    {
+        return false;
+    }
+
+    if (Panel->Load.IsActive)
+    {
+        EnsureLinesAreIndexed(Panel, (u64)-1);
+    }
+
+    b32 Result = RecoverTextJournal(Panel);
+    if (Result)
+    {
+        ResetTextPanelView(Panel);
+    }
+    return Result;
+}
+
+internal EDITOR_COMMAND(Command_SaveFile)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_buffer *Buffer = &Panel->Buffer;
+
+    // NOTE(traian): The whole file has to be loaded before it's written back.
+    if (Panel->Load.IsActive)
+    {
+        EnsureLinesAreIndexed(Panel, (u64)-1);
+    }
+    CompleteTextJournalRecovery(Panel);
+
+    if (Panel->HasLoadFailed)
+    {
+        return;
+    }
+
+    // NOTE(traian): A mapped file was never modified, so the file on disk already contains its text.
+    // The dirty flag and the journal are updated when the save completes.
+    if (Panel->FileName && !Buffer->IsMapped)
+    {
+        BeginTextSave(EditorState->FileQueue, Panel);
+        EditorState->IsTrigramIndexStale = true;
+    }
+}
+
+// NOTE(traian): A save is refused if the encoding of the document can't represent some of the characters, so
+// the document is only switched to UTF-8 when it's asked for. The whole document changes, so none of the document
+// on the disk is assumed to be kept.
+internal EDITOR_COMMAND(Command_SaveFileAsUTF8)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_file_format *Format = &Panel->Format;
+    if (Format->Encoding != TextEncoding_UTF8 || Format->HasByteOrderMark)
+    {
+        Format->Encoding = TextEncoding_UTF8;
+        Format->HasByteOrderMark = false;
+        Panel->UnmodifiedSize = 0;
+        Panel->IsSaveDirty = true;
+    }
+
+    Command_SaveFile(EditorState, PanelIndex, CommandInfo);
+}
+
+// NOTE(traian): Forgets the document of the panel, before another one is opened in it.
+internal void
+ResetTextPanelDocument(text_panel *Panel)
+{
+    FinishTextSave(Panel);
+    CancelTextLoad(Panel);
+    ResetTextHistory(&Panel->History);
+    CloseTextJournal(&Panel->Journal);
+    SetTextJournalDocument(&Panel->Journal, NULL);
+
+    Panel->IsSaveDirty = false;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+    Panel->DiskHashes.IsValid = false;
+    Panel->Format = {};
+    Panel->LineEndings.Count = 0;
+    Panel->Save.Stats = {};
+    InvalidateTextColumnMaps(Panel);
+    ResetTextHighlight(Panel);
+    Panel->FileName = NULL;
+    Panel->LineCount = 0;
+    Panel->IsReadOnly = false;
+    Panel->HasLoadFailed = false;
+
+    ResetTextPanelView(Panel);
+    ResetTextFind(Panel);
+}
+
+struct command_open_file_data
+{
+    char *FileName;
+};
+
+// NOTE(traian): Opens the file as a read-only mapping. The pages of the file are only touched when they are
+// displayed or scanned for new lines, and the text is copied into an allocated buffer before the first edit.
+internal b32
+OpenMappedFile(text_panel *Panel, char *FileName)
+{
+    buffer View = PlatformMapFile(FileName);
+    if (!View.Data)
+    {
+        // TODO(traian): Logging.
+        return false;
+    }
+
+    // NOTE(traian): The view can only be used as the text if the document is UTF-8 without a byte order mark
+    // and uses LF line endings. Other documents are read instead, so that they can be decoded and normalized.
+    memory_size SampleSize = Minimum(View.Size, TEXT_LOAD_FIRST_CHUNK_SIZE);
+    text_file_format Format = DetectTextFileFormat(View.Data, SampleSize, SampleSize == View.Size);
+    if (Format.Encoding != TextEncoding_UTF8 || Format.HasByteOrderMark ||
+        DetectLineEnding(View.Data, SampleSize) != LineEnding_LF)
+    {
+        PlatformUnmapFile(View);
+        return false;
+    }
+
+    text_buffer *Buffer = &Panel->Buffer;
+    ReleaseBufferMemory(Buffer);
+    Buffer->Base = (char *)View.Data;
+    Buffer->Size = View.Size;
+    Buffer->Used = View.Size;
+    Buffer->GapOffset = View.Size;
+    Buffer->IsMapped = true;
+
+    Panel->FileName = FileName;
+    BeginLineIndex(&Panel->LineIndex, Buffer);
+
+    // NOTE(traian): The mapped file is hashed when it's copied into an allocated buffer, before its first edit.
+    BeginTextDiskHashes(&Panel->DiskHashes, FileName, View.Size);
+    Panel->LineCount = 0;
+
+    SetTextJournalDocument(&Panel->Journal, FileName);
+    return true;
+}
+
+internal PLATFORM_WORK_QUEUE_CALLBACK(LoadTextFileWork)
+{
+    text_load *Load = (text_load *)Data;
+    b32 IsTranscoded = (Load->Format.Encoding != TextEncoding_UTF8);
+
+    memory_offset FileOffset = Load->FileOffset;
+    memory_size LoadedSize = Load->LoadedSize;
+    while (FileOffset < Load->FileSize && !Load->IsCancelled)
+    {
+        // NOTE(traian): A UTF-8 document is read straight into the destination, right after the loaded text.
+        u8 *Text = (u8 *)Load->Destination + LoadedSize;
+        memory_size TextCount = Load->PendingCount;
+        memory_size ChunkSize = Minimum(TEXT_LOAD_CHUNK_SIZE, Load->FileSize - FileOffset);
+        u8 *ChunkData = IsTranscoded ? (Load->Staging.Data + Load->StagingCount) : (Text + TextCount);
+        buffer Chunk = { ChunkData, ChunkSize };
+        if (PlatformReadFile(&Load->File, FileOffset, Chunk) != ChunkSize)
+        {
+            // TODO(traian): Logging.
+            Load->HasFailed = true;
+            break;
+        }
+
+        HashTextChunks(Load->ChunkHashes, Load->FileSize, Chunk.Data, FileOffset, ChunkSize);
+        FileOffset += ChunkSize;
+        b32 IsFinal = (FileOffset == Load->FileSize);
+
+        if (IsTranscoded)
+        {
+            memory_size StagedCount = Load->StagingCount + ChunkSize;
+            transcode_result Decoded = DecodeText(Load->Format.Encoding, Load->Staging.Data, StagedCount,
+                                                  Text + TextCount, IsFinal);
+            Load->StagingCount = StagedCount - Decoded.ReadCount;
+            MoveMem(Load->Staging.Data, Load->Staging.Data + Decoded.ReadCount, Load->StagingCount);
+            TextCount += Decoded.WrittenCount;
+            Load->Format.IsLossy |= (Decoded.ReplacedCount > 0);
+        }
+        else
+        {
+            TextCount += ChunkSize;
+        }
+
+        transcode_result Normalized = NormalizeLoadedLineEndings(&Load->Format, Load->LineEndings, LoadedSize, Text,
+                                                                 TextCount, IsFinal);
+        Load->PendingCount = TextCount - Normalized.ReadCount;
+        LoadedSize += Normalized.WrittenCount;
+
+        Load->FileOffset = FileOffset;
+        CompletePreviousWritesBeforeFutureWrites;
+        Load->LoadedSize = LoadedSize;
+    }
+
+    CompletePreviousWritesBeforeFutureWrites;
+    Load->IsDone = true;
+}
+
+internal EDITOR_COMMAND(Command_OpenFile)
+{
+    EDITOR_COMMAND_CAST_DATA(command_open_file_data);
+
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_buffer *Buffer = &Panel->Buffer;
+
+    ResetTextPanelDocument(Panel);
+
+    platform_file File = PlatformOpenFile(CommandData->FileName);
+    if (File.Handle && File.Size >= TEXT_BUFFER_MAPPED_FILE_THRESHOLD)
+    {
+        PlatformCloseFile(&File);
+        if (OpenMappedFile(Panel, CommandData->FileName))
+        {
+            return;
+        }
+
+        // NOTE(traian): The file couldn't be mapped, so it is read instead.
+        File = PlatformOpenFile(CommandData->FileName);
+    }
+
+    if (File.Handle)
+    {
+        memory_size FileSize = File.Size;
+        memory_size TextBufferSize = FileSize + TEXT_BUFFER_DEFAULT_GAP_SIZE;
+        if (Buffer->IsMapped || TextBufferSize > Buffer->Size || Buffer->Size > (2 * TextBufferSize))
+        {
+            ReleaseBufferMemory(Buffer);
+
+            buffer NewTextBuffer = PlatformAllocateMemory(TextBufferSize);
+            Buffer->Size = TextBufferSize;
+            Buffer->Base = (char *)NewTextBuffer.Data;
+        }
+
+        // NOTE(traian): The file is read at the end of the buffer, with the gap in front of it. The caret
+        // starts at the beginning of the file, so the first edits don't have to move the text.
+        memory_size GapSize = Buffer->Size - FileSize;
+        char *FileText = Buffer->Base + GapSize;
+
+        // NOTE(traian): Only the first chunk is read now, so the file can be displayed right away. Until the
+        // rest of the file is loaded, the buffer ends right after the loaded text.
+        memory_size FirstChunkSize = Minimum(FileSize, TEXT_LOAD_FIRST_CHUNK_SIZE);
+        buffer FirstChunk = { (u8 *)FileText, FirstChunkSize };
+        if (PlatformReadFile(&File, 0, FirstChunk) != FirstChunkSize)
+        {
+            // NOTE(traian): The panel is left empty, and it can't be saved over the document.
+            // TODO(traian): Logging.
+            PlatformCloseFile(&File);
+            Buffer->Used = 0;
+            Buffer->GapOffset = 0;
+            BuildLineIndex(&Panel->LineIndex, Buffer);
+            Panel->FileName = CommandData->FileName;
+            Panel->HasLoadFailed = true;
+            return;
+        }
+
+        b32 IsLoaded = (FirstChunkSize == FileSize);
+        text_file_format Format = DetectTextFileFormat(FirstChunk.Data, FirstChunkSize, IsLoaded);
+        memory_size MarkSize = GetByteOrderMarkSize(Format);
+
+        text_disk_hashes *DiskHashes = &Panel->DiskHashes;
+        BeginTextDiskHashes(DiskHashes, CommandData->FileName, FileSize);
+        HashTextChunks(DiskHashes->ChunkHashes, FileSize, FirstChunk.Data, 0, FirstChunkSize);
+        DiskHashes->IsValid = IsLoaded;
+
+        // NOTE(traian): The byte order mark becomes part of the gap.
+        char *Destination = FileText + MarkSize;
+        memory_size LoadedSize = FirstChunkSize - MarkSize;
+        buffer Staging = {};
+        memory_size StagingCount = 0;
+
+        if (Format.Encoding != TextEncoding_UTF8)
+        {
+            // NOTE(traian): The decoded text can be larger than the document, so it's decoded into a new buffer
+            // that can hold the whole document once it's decoded.
+            memory_size DecodedBufferSize = GetMaxDecodedSize(Format.Encoding, FileSize) + TEXT_BUFFER_DEFAULT_GAP_SIZE;
+            buffer DecodedBuffer = PlatformAllocateMemory(DecodedBufferSize);
+            Destination = (char *)DecodedBuffer.Data + TEXT_BUFFER_DEFAULT_GAP_SIZE;
+
+            transcode_result Decoded = DecodeText(Format.Encoding, FirstChunk.Data + MarkSize, LoadedSize,
+                                                  (u8 *)Destination, IsLoaded);
+            if (!IsLoaded)
+            {
+                // NOTE(traian): Room for the chunks that are read in the background, and for the bytes that the
+                // decoder leaves over from the previous chunk.
+                Staging = PlatformAllocateMemory(TEXT_LOAD_CHUNK_SIZE + sizeof(u32));
+                StagingCount = LoadedSize - Decoded.ReadCount;
+                CopyMem(Staging.Data, FirstChunk.Data + MarkSize + Decoded.ReadCount, StagingCount);
+            }
+
+            LoadedSize = Decoded.WrittenCount;
+            Format.IsLossy = (Decoded.ReplacedCount > 0);
+            ReleaseBufferMemory(Buffer);
+            Buffer->Base = (char *)DecodedBuffer.Data;
+        }
+
+        transcode_result Normalized = NormalizeLoadedLineEndings(&Format, &Panel->LineEndings, 0, (u8 *)Destination,
+                                                                 LoadedSize, IsLoaded);
+        memory_size PendingCount = LoadedSize - Normalized.ReadCount;
+        LoadedSize = Normalized.WrittenCount;
+
+        Buffer->Size = (Destination - Buffer->Base) + LoadedSize;
+        Buffer->Used = LoadedSize;
+        Buffer->GapOffset = 0;
+
+        Panel->FileName = CommandData->FileName;
+        Panel->Format = Format;
+        BuildLineIndex(&Panel->LineIndex, Buffer);
+        Panel->LineCount = Panel->LineIndex.Count - 1;
+
+        if (!IsLoaded)
+        {
+            text_load *Load = &Panel->Load;
+            Load->File = File;
+            Load->Destination = Destination;
+            Load->ChunkHashes = DiskHashes->ChunkHashes;
+            Load->FileSize = FileSize;
+            Load->FileOffset = FirstChunkSize;
+            Load->Format = Format;
+            Load->LineEndings = &Panel->LineEndings;
+            Load->Staging = Staging;
+            Load->StagingCount = StagingCount;
+            Load->PendingCount = PendingCount;
+            Load->LoadedSize = LoadedSize;
+            Load->IsCancelled = false;
+            Load->IsDone = false;
+            Load->HasFailed = false;
+            Load->IsActive = true;
+            if (!PlatformAddWorkEntry(EditorState->FileQueue, LoadTextFileWork, Load))
+            {
+                // NOTE(traian): The load fails like one that couldn't read the file, so the panel keeps the first
+                // chunk and shows the failure.
+                Load->HasFailed = true;
+                Load->IsDone = true;
+            }
+        }
+        else
+        {
+            PlatformCloseFile(&File);
+        }
+
+        SetTextJournalDocument(&Panel->Journal, Panel->FileName);
+    }
+}
+
+// NOTE(traian): Same as Command_OpenFile, except that the file is always mapped, regardless of its size.
+internal EDITOR_COMMAND(Command_OpenMappedFile)
+{
+    EDITOR_COMMAND_CAST_DATA(command_open_file_data);
+
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    ResetTextPanelDocument(Panel);
+
+    if (!OpenMappedFile(Panel, CommandData->FileName))
+    {
+        Command_OpenFile(EditorState, PanelIndex, CommandInfo);
+    }
+}
+
+internal EDITOR_COMMAND(Command_NewTextBuffer)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_buffer *Buffer = &Panel->Buffer;
+    ResetTextPanelDocument(Panel);
+
+    if (Buffer->IsMapped)
+    {
+        ReleaseBufferMemory(Buffer);
+    }
 
     if (Buffer->Size == 0)
     {
@@ -987,6 +1562,188 @@ internal EDITOR_COMMAND(Command_NewTextBuffer)
 
     SetMemoryToZero(Buffer->Base, Buffer->Size);
     Buffer->Used = 0;
+    Buffer->GapOffset = 0;
+    BuildLineIndex(&Panel->LineIndex, Buffer);
+}
+
+//=========================================================================================
+// NOTE(traian): FIND IN FILES COMMANDS.
+//=========================================================================================
+
+internal inline u32
+GetTextPanelCount(editor_layout EditorLayout)
+{
+    u32 Result = 1;
+    switch (EditorLayout)
+    {
+        case EditorLayout_Single:      { Result = 1; } break;
+        case EditorLayout_Dual:        { Result = 2; } break;
+        case EditorLayout_TripleLeft:  { Result = 3; } break;
+        case EditorLayout_TripleRight: { Result = 3; } break;
+        case EditorLayout_Quad:        { Result = 4; } break;
+    }
+
+    return Result;
+}
+
+// NOTE(traian): The directory of the panel's file, or the working directory if the panel has no file.
+internal void
+GetTextPanelDirectory(text_panel *Panel, char *Directory)
+{
+    Directory[0] = '.';
+    Directory[1] = 0;
+    if (Panel->FileName)
+    {
+        memory_size FileNameLength = StringLength(Panel->FileName);
+        for (memory_size Index = FileNameLength; Index > 0; --Index)
+        {
+            char Character = Panel->FileName[Index - 1];
+            if (Character == '/' || Character == '\\')
+            {
+                memory_size DirectoryLength = Minimum(Index - 1, PLATFORM_PATH_CAPACITY - 1);
+                CopyMem(Directory, Panel->FileName, DirectoryLength);
+                Directory[DirectoryLength] = 0;
+                break;
+            }
+        }
+    }
+}
+
+// NOTE(traian): Rebuilds the trigram index of the directory in the background, unless a build is already running.
+// Only the files that changed since the previous build are read.
+internal void
+RefreshTrigramIndex(editor_state *EditorState, char *Directory)
+{
+    find_in_files *IndexBuild = &EditorState->IndexBuild;
+    if (!IndexBuild->IsActive &&
+        BeginTrigramIndexBuild(IndexBuild, EditorState->IndexQueue, EditorState->IndexThreadCount, Directory))
+    {
+        EditorState->IsTrigramIndexStale = false;
+    }
+}
+
+// NOTE(traian): Searches every file under the directory of the panel's file for the query of its find. The results
+// are shown in the next panel of the layout, or in the panel itself if it's the only one.
+internal EDITOR_COMMAND(Command_FindInFiles)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_find *Find = &Panel->Find;
+    find_in_files *Search = &EditorState->FindInFiles;
+    if (!Find->IsQueryValid)
+    {
+        return;
+    }
+
+    char Directory[PLATFORM_PATH_CAPACITY];
+    GetTextPanelDirectory(Panel, Directory);
+
+    // NOTE(traian): The query is copied first, since the results might replace the text of this panel.
+    char Query[TEXT_FIND_QUERY_CAPACITY];
+    memory_size QueryLength = Find->QueryLength;
+    b32 IsRegex = Find->IsRegex;
+    CopyMem(Query, Find->Query, QueryLength);
+
+    CancelFindInFiles(Search);
+    u32 ResultsPanelIndex = (PanelIndex + 1) % GetTextPanelCount(EditorState->EditorLayout);
+    Command_NewTextBuffer(EditorState, ResultsPanelIndex, CommandInfo);
+    EditorState->TextPanels[ResultsPanelIndex].IsReadOnly = true;
+    Search->ResultsPanelIndex = ResultsPanelIndex;
+    Search->SourcePanelIndex = PanelIndex;
+
+    // NOTE(traian): Every thread of the search queue gets a worker, so all of them start right away and the
+    // cancel never waits for a worker that is still queued.
+    BeginFindInFiles(Search, EditorState->SearchQueue, EditorState->SearchThreadCount, Directory, Query, QueryLength,
+                     IsRegex);
+    EditorState->FocusedTextPanelIndex = ResultsPanelIndex;
+
+    // NOTE(traian): The index isn't checked against the files that were saved since it was built, so it's built
+    // again next to the search, for the searches that come after it.
+    if (Search->IsUsingIndex && EditorState->IsTrigramIndexStale)
+    {
+        RefreshTrigramIndex(EditorState, Search->Directory);
+    }
+}
+
+// NOTE(traian): Opens the file of the result under the caret, at the line of the result, in the panel where the
+// search was started.
+internal EDITOR_COMMAND(Command_OpenFindInFilesResult)
+{
+    text_panel *Results = EditorState->TextPanels + PanelIndex;
+    find_in_files *Search = &EditorState->FindInFiles;
+
+    u64 ResultLine = Results->Caret.Position.Line;
+    memory_offset LineStart = GetBufferOffsetOfLine(&Results->LineIndex, ResultLine);
+    memory_offset LineEnd = GetBufferOffsetOfLine(&Results->LineIndex, ResultLine + 1);
+    char Text[PLATFORM_PATH_CAPACITY + 32];
+    memory_size TextLength = Minimum(LineEnd - LineStart, sizeof(Text));
+    CopyFromBuffer(&Results->Buffer, LineStart, TextLength, Text);
+
+    memory_size PathLength;
+    u64 Line;
+    if (!ParseFindInFilesResult(Text, TextLength, &PathLength, &Line) ||
+        Search->DirectoryLength + 1 + PathLength >= PLATFORM_PATH_CAPACITY)
+    {
+        return;
+    }
+
+    // NOTE(traian): If the results are in the only panel, the file replaces them, so the search is stopped.
+    u32 TargetPanelIndex = Search->SourcePanelIndex;
+    if (TargetPanelIndex == PanelIndex || TargetPanelIndex >= GetTextPanelCount(EditorState->EditorLayout))
+    {
+        TargetPanelIndex = PanelIndex;
+        CancelFindInFiles(Search);
+    }
+
+    // NOTE(traian): The save of the file that is open in the panel might still use the name that is replaced.
+    text_panel *Panel = EditorState->TextPanels + TargetPanelIndex;
+    FinishTextSave(Panel);
+
+    char *FileName = Panel->FileNameStorage;
+    CopyMem(FileName, Search->Directory, Search->DirectoryLength);
+    FileName[Search->DirectoryLength] = '/';
+    CopyMem(FileName + Search->DirectoryLength + 1, Text, PathLength);
+    FileName[Search->DirectoryLength + 1 + PathLength] = 0;
+
+    command_open_file_data CommandData;
+    CommandData.FileName = FileName;
+    editor_command_info OpenCommandInfo = {};
+    OpenCommandInfo.OpaqueData = &CommandData;
+    Command_OpenFile(EditorState, TargetPanelIndex, &OpenCommandInfo);
+
+    EnsureLinesAreIndexed(Panel, Line);
+    Line = Minimum(Line, Panel->LineCount);
+    SetCaretFromTextOffset(Panel, &EditorState->Settings, &Panel->Caret, GetBufferOffsetOfLine(Panel, Line));
+
+    EditorState->FocusedTextPanelIndex = TargetPanelIndex;
+    VALIDATE_CARET_OFFSET(EditorState, TargetPanelIndex);
+    Command_ScrollWindowToFitCaret(EditorState, TargetPanelIndex, NULL);
+}
+
+// NOTE(traian): The results that were found so far are kept.
+internal EDITOR_COMMAND(Command_CancelFindInFiles)
+{
+    CancelFindInFiles(&EditorState->FindInFiles);
+}
+
+// NOTE(traian): Builds the trigram index of the directory of the panel's file, which the next searches of the
+// directory use to skip the files that can't contain a match. Only the files that changed since the previous
+// build are read. While the build runs, the same command stops it, and the files it reached are still written.
+internal EDITOR_COMMAND(Command_BuildTrigramIndex)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    find_in_files *IndexBuild = &EditorState->IndexBuild;
+    if (IndexBuild->IsActive)
+    {
+        CancelTrigramIndexBuild(IndexBuild);
+        return;
+    }
+
+    char Directory[PLATFORM_PATH_CAPACITY];
+    GetTextPanelDirectory(Panel, Directory);
+
+    // NOTE(traian): Every thread of the index queue gets a worker, so the writer of the index, which is queued
+    // once all of them stopped, always starts right away.
+    BeginTrigramIndexBuild(IndexBuild, EditorState->IndexQueue, EditorState->IndexThreadCount, Directory);
 }
 
 //=========================================================================================
@@ -995,6 +1752,7 @@ internal EDITOR_COMMAND(Command_NewTextBuffer)
 
 internal EDITOR_COMMAND(Command_Quit)
 {
+    // NOTE(traian): The saves and the journals are completed by EditorEventShutdown.
     PlatformQuit();
 }
 
@@ -1028,16 +1786,7 @@ internal EDITOR_COMMAND(Command_FocusOnTextPanelFour)
 
 internal EDITOR_COMMAND(Command_ToggleFocusedTextPanel)
 {
-    u32 PanelCount = 1;
-    switch (EditorState->EditorLayout)
-    {
-        case EditorLayout_Single:      { PanelCount = 1; } break;
-        case EditorLayout_Dual:        { PanelCount = 2; } break;
-        case EditorLayout_TripleLeft:  { PanelCount = 3; } break;
-        case EditorLayout_TripleRight: { PanelCount = 3; } break;
-        case EditorLayout_Quad:        { PanelCount = 4; } break;
-    }
-
+    u32 PanelCount = GetTextPanelCount(EditorState->EditorLayout);
     EditorState->FocusedTextPanelIndex = (EditorState->FocusedTextPanelIndex + 1) % PanelCount;
 }
 
@@ -1054,7 +1803,7 @@ AllocateCommandEntry(command_table *CommandTable)
     return EntryIndex;
 }
 
-internal inline void
+internal inline command_entry *
 BindKeyCommand(command_table *CommandTable, u8 KeyCode, u8 Modifiers, editor_command_function *Callback)
 {
     command_entry *Entry;
@@ -1082,12 +1831,80 @@ BindKeyCommand(command_table *CommandTable, u8 KeyCode, u8 Modifiers, editor_com
     Entry->NextIndex = UINT32_MAX;
     Entry->Modifiers = (key_modifier)Modifiers;
     Entry->Callback = Callback;
+    Entry->IsCaretCommand = false;
+    Entry->IsEditCommand = false;
+    return Entry;
+}
+
+internal inline void
+BindCaretKeyCommand(command_table *CommandTable, u8 KeyCode, u8 Modifiers, editor_command_function *Callback)
+{
+    command_entry *Entry = BindKeyCommand(CommandTable, KeyCode, Modifiers, Callback);
+    Entry->IsCaretCommand = true;
+}
+
+internal inline void
+BindEditKeyCommand(command_table *CommandTable, u8 KeyCode, u8 Modifiers, editor_command_function *Callback)
+{
+    command_entry *Entry = BindKeyCommand(CommandTable, KeyCode, Modifiers, Callback);
+    Entry->IsEditCommand = true;
+}
+
+internal void
+InitializeFindCommandTable(command_table *CommandTable)
+{
+    for (u16 CommandIndex = 0; CommandIndex < ArrayCount(CommandTable->KeyCommands); ++CommandIndex)
+    {
+        CommandTable->KeyCommands[CommandIndex] = UINT32_MAX;
+    }
+
+    // NOTE(traian): The keys that aren't bound here are handled by the editor command table, so the text can
+    // still be navigated and edited while finding.
+    for (u8 KeyCode = KeyCode_AlphabetKeyFirst; KeyCode <= KeyCode_AlphabetKeyLast; ++KeyCode)
+    {
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_FindInsertCharacter);
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_FindInsertCharacter);
+    }
+    for (u8 KeyCode = KeyCode_Zero; KeyCode <= KeyCode_Nine; ++KeyCode)
+    {
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_FindInsertCharacter);
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_FindInsertCharacter);
+    }
+    for (u8 KeyCode = KeyCode_Semicolon; KeyCode <= KeyCode_RightBracket; ++KeyCode)
+    {
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_FindInsertCharacter);
+        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_FindInsertCharacter);
+    }
+
+    BindKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_None,  Command_FindInsertCharacter);
+    BindKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_Shift, Command_FindInsertCharacter);
+    BindKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_None,  Command_FindRemoveCharacter);
+    BindKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_None,  Command_FindNext);
+    BindKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_Shift, Command_FindPrevious);
+    BindKeyCommand(CommandTable, KeyCode_Escape,     KeyModifier_None,  Command_EndFind);
+    BindKeyCommand(CommandTable, KeyCode_Tab,        KeyModifier_None,  Command_FindToggleReplacement);
+    BindEditKeyCommand(CommandTable, KeyCode_Enter,  KeyModifier_Ctrl,  Command_ReplaceAll);
+    BindKeyCommand(CommandTable, 'R',                KeyModifier_Alt,   Command_FindToggleRegex);
+}
+
+internal void
+InitializeFindInFilesCommandTable(command_table *CommandTable)
+{
+    for (u16 CommandIndex = 0; CommandIndex < ArrayCount(CommandTable->KeyCommands); ++CommandIndex)
+    {
+        CommandTable->KeyCommands[CommandIndex] = UINT32_MAX;
+    }
+
+    BindKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_None,  Command_OpenFindInFilesResult);
+    BindKeyCommand(CommandTable, KeyCode_Escape,     KeyModifier_None,  Command_CancelFindInFiles);
 }
 
 void
 InitializeEditorCommandTable(editor_state *EditorState)
 {
     command_table *CommandTable = &EditorState->CommandTable;
+    InitializeFindCommandTable(&EditorState->FindCommandTable);
+    InitializeFindInFilesCommandTable(&EditorState->FindInFilesCommandTable);
 
     for (u16 CommandIndex = 0; CommandIndex < ArrayCount(CommandTable->KeyCommands); ++CommandIndex)
     {
@@ -1100,52 +1917,56 @@ InitializeEditorCommandTable(editor_state *EditorState)
 
     for (u8 KeyCode = KeyCode_AlphabetKeyFirst; KeyCode <= KeyCode_AlphabetKeyLast; ++KeyCode)
     {
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
     }
     for (u8 KeyCode = KeyCode_Zero; KeyCode <= KeyCode_Nine; ++KeyCode)
     {
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
     }
     for (u8 KeyCode = KeyCode_Semicolon; KeyCode <= KeyCode_RightBracket; ++KeyCode)
     {
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
-        BindKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_None,  Command_InsertCharacter);
+        BindEditKeyCommand(CommandTable, KeyCode,  KeyModifier_Shift, Command_InsertCharacter);
     }
 
-    BindKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_None,  Command_InsertCharacter);
-    BindKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_Shift, Command_InsertCharacter);
-    BindKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_None,  Command_InsertCharacter);
-    BindKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_Shift, Command_InsertCharacter);
-    BindKeyCommand(CommandTable, KeyCode_Tab,        KeyModifier_None,  Command_InsertCharacter);
-    BindKeyCommand(CommandTable, KeyCode_Tab,        KeyModifier_Shift, Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_None,  Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Space,      KeyModifier_Shift, Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_None,  Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Enter,      KeyModifier_Shift, Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Tab,        KeyModifier_None,  Command_InsertCharacter);
+    BindEditKeyCommand(CommandTable, KeyCode_Tab,        KeyModifier_Shift, Command_InsertCharacter);
     
     //
     // NOTE(traian): File navigation.
     //
 
-    BindKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_None,  Command_ArrowLeft);
-    BindKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_None,  Command_ArrowRight);
-    BindKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_None,  Command_ArrowUp);
-    BindKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_None,  Command_ArrowDown);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_None,  Command_ArrowLeft);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_None,  Command_ArrowRight);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_None,  Command_ArrowUp);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_None,  Command_ArrowDown);
 
-    BindKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_Shift, Command_SelectArrowLeft);
-    BindKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_Shift, Command_SelectArrowRight);
-    BindKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_Shift, Command_SelectArrowUp);
-    BindKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_Shift, Command_SelectArrowDown);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_Shift, Command_SelectArrowLeft);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_Shift, Command_SelectArrowRight);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_Shift, Command_SelectArrowUp);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_Shift, Command_SelectArrowDown);
     
-    BindKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_Ctrl,  Command_GoToNextToken);
-    BindKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_Ctrl,  Command_GoToPreviousToken);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowRight, KeyModifier_Ctrl,  Command_GoToNextToken);
+    BindCaretKeyCommand(CommandTable, KeyCode_ArrowLeft,  KeyModifier_Ctrl,  Command_GoToPreviousToken);
     BindKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_Ctrl,  Command_ScrollPanelUp);
     BindKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_Ctrl,  Command_ScrollPanelDown);
 
-    BindKeyCommand(CommandTable,
-                   KeyCode_ArrowRight, KeyModifier_Ctrl | KeyModifier_Shift,
-                   Command_SelectUntilNextToken);
-    BindKeyCommand(CommandTable,
-                   KeyCode_ArrowLeft, KeyModifier_Ctrl | KeyModifier_Shift,
-                   Command_SelectUntilPreviousToken);
+    BindCaretKeyCommand(CommandTable,
+                        KeyCode_ArrowRight, KeyModifier_Ctrl | KeyModifier_Shift,
+                        Command_SelectUntilNextToken);
+    BindCaretKeyCommand(CommandTable,
+                        KeyCode_ArrowLeft, KeyModifier_Ctrl | KeyModifier_Shift,
+                        Command_SelectUntilPreviousToken);
+
+    BindKeyCommand(CommandTable, KeyCode_ArrowUp,    KeyModifier_Ctrl | KeyModifier_Alt, Command_AddCaretAbove);
+    BindKeyCommand(CommandTable, KeyCode_ArrowDown,  KeyModifier_Ctrl | KeyModifier_Alt, Command_AddCaretBelow);
+    BindKeyCommand(CommandTable, KeyCode_Escape,     KeyModifier_None,  Command_ClearExtraCarets);
 
     BindKeyCommand(CommandTable, KeyCode_PageUp,     KeyModifier_None,  Command_PageUp);
     BindKeyCommand(CommandTable, KeyCode_PageDown,   KeyModifier_None,  Command_PageDown);
@@ -1154,17 +1975,33 @@ InitializeEditorCommandTable(editor_state *EditorState)
     // NOTE(traian): Text manipulation.
     //
 
-    BindKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_None,  Command_RemoveCharacterFromLeft);
-    BindKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_Shift, Command_RemoveCharacterFromLeft);
-    BindKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_Ctrl,  Command_RemoveCharactersUntilPreviousToken);
-    BindKeyCommand(CommandTable, KeyCode_Delete,     KeyModifier_None,  Command_RemoveCharacterFromRight);
-    BindKeyCommand(CommandTable, KeyCode_Delete,     KeyModifier_Ctrl,  Command_RemoveCharactersUntilNextToken);
+    BindEditKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_None,  Command_RemoveCharacterFromLeft);
+    BindEditKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_Shift, Command_RemoveCharacterFromLeft);
+    BindEditKeyCommand(CommandTable, KeyCode_Backspace,  KeyModifier_Ctrl,  Command_RemoveCharactersUntilPreviousToken);
+    BindEditKeyCommand(CommandTable, KeyCode_Delete,     KeyModifier_None,  Command_RemoveCharacterFromRight);
+    BindEditKeyCommand(CommandTable, KeyCode_Delete,     KeyModifier_Ctrl,  Command_RemoveCharactersUntilNextToken);
+
+    BindEditKeyCommand(CommandTable, 'Z', KeyModifier_Ctrl,                      Command_Undo);
+    BindEditKeyCommand(CommandTable, 'Y', KeyModifier_Ctrl,                      Command_Redo);
+    BindEditKeyCommand(CommandTable, 'Z', KeyModifier_Ctrl | KeyModifier_Shift,  Command_Redo);
 
     //
     // NOTE(traian): File management.
     //
 
-    BindKeyCommand(CommandTable, 'S', KeyModifier_Ctrl, Command_SaveFile);
+    BindKeyCommand(CommandTable, 'S', KeyModifier_Ctrl,                    Command_SaveFile);
+    BindKeyCommand(CommandTable, 'S', KeyModifier_Ctrl | KeyModifier_Shift, Command_SaveFileAsUTF8);
+
+    //
+    // NOTE(traian): Find.
+    //
+
+    BindKeyCommand(CommandTable, 'F', KeyModifier_Ctrl,                     Command_BeginFind);
+    BindKeyCommand(CommandTable, 'H', KeyModifier_Ctrl,                     Command_BeginReplace);
+    BindKeyCommand(CommandTable, 'F', KeyModifier_Ctrl | KeyModifier_Shift, Command_FindInFiles);
+    BindKeyCommand(CommandTable, 'I', KeyModifier_Ctrl | KeyModifier_Shift, Command_BuildTrigramIndex);
+    BindKeyCommand(CommandTable, KeyCode_FKeyFirst + 2, KeyModifier_None,   Command_FindNext);
+    BindKeyCommand(CommandTable, KeyCode_FKeyFirst + 2, KeyModifier_Shift,  Command_FindPrevious);
 
     //
     // NOTE(traian): Editor management.
@@ -1179,23 +2016,48 @@ InitializeEditorCommandTable(editor_state *EditorState)
     BindKeyCommand(CommandTable, KeyCode_Four,           KeyModifier_Alt,  Command_FocusOnTextPanelFour);
 }
 
-internal inline editor_command_function *
-GetEditorCommandCallback(command_table *CommandTable, key_modifier Modifiers, u32 EntryIndex)
+internal inline command_entry *
+GetEditorCommandEntry(command_table *CommandTable, key_modifier Modifiers, u32 EntryIndex)
 {
-    editor_command_function *Callback = NULL;
+    command_entry *Result = NULL;
     while (EntryIndex != UINT32_MAX)
     {
         command_entry *Entry = CommandTable->CommandEntriesPool + EntryIndex;
         if (Entry->Modifiers == Modifiers)
         {
-            Callback = Entry->Callback;
+            Result = Entry;
             break;
         }
 
         EntryIndex = Entry->NextIndex;
     }
 
-    return Callback;
+    return Result;
+}
+
+// NOTE(traian): Runs a caret command for each of the extra carets, by making it the main caret for the duration
+// of the command, and then for the main caret. The view only follows the main caret.
+internal void
+ExecuteCaretCommand(editor_state *EditorState, u32 PanelIndex, editor_command_function *Callback,
+                    editor_command_info *CommandInfo)
+{
+    text_panel *Panel = EditorState->TextPanels + PanelIndex;
+    text_caret_list *List = &Panel->ExtraCarets;
+
+    if (List->Count > 0)
+    {
+        text_view_state View = GetTextViewState(Panel);
+        for (u64 Index = 0; Index < List->Count; ++Index)
+        {
+            Panel->Caret = List->Carets[Index];
+            Callback(EditorState, PanelIndex, CommandInfo);
+            List->Carets[Index] = Panel->Caret;
+        }
+        SetTextViewState(Panel, &View);
+    }
+
+    Callback(EditorState, PanelIndex, CommandInfo);
+    MergeTextCarets(Panel);
 }
 
 void
@@ -1204,18 +2066,48 @@ ExecuteEditorCommand(editor_state *EditorState, key_code KeyCode)
     key_modifier Modifiers = PlatformGetKeyModifiers();
     b32 IsCapsLockActive = PlatformIsCapsLockActive();
 
-    command_table *CommandTable = &EditorState->CommandTable;
-    u32 EntryIndex = CommandTable->KeyCommands[KeyCode];
-    editor_command_function *Callback = GetEditorCommandCallback(CommandTable, Modifiers, EntryIndex);
-    
-    if (Callback)
+    command_entry *Entry = NULL;
+    text_panel *Panel = EditorState->TextPanels + EditorState->FocusedTextPanelIndex;
+    if (Panel->Find.IsActive)
+    {
+        command_table *FindCommandTable = &EditorState->FindCommandTable;
+        Entry = GetEditorCommandEntry(FindCommandTable, Modifiers, FindCommandTable->KeyCommands[KeyCode]);
+    }
+
+    if (!Entry && Panel->IsReadOnly && EditorState->FocusedTextPanelIndex == EditorState->FindInFiles.ResultsPanelIndex)
+    {
+        command_table *FindInFilesCommandTable = &EditorState->FindInFilesCommandTable;
+        Entry = GetEditorCommandEntry(FindInFilesCommandTable, Modifiers,
+                                      FindInFilesCommandTable->KeyCommands[KeyCode]);
+    }
+
+    if (!Entry)
     {
+        command_table *CommandTable = &EditorState->CommandTable;
+        Entry = GetEditorCommandEntry(CommandTable, Modifiers, CommandTable->KeyCommands[KeyCode]);
+    }
+
+    if (Entry && !(Entry->IsEditCommand && (Panel->IsReadOnly || Panel->HasLoadFailed)))
+    {
+        // NOTE(traian): The offsets of an edit refer to the recovered text.
+        if (Entry->IsEditCommand)
+        {
+            CompleteTextJournalRecovery(Panel);
+        }
+
         editor_command_info CommandInfo = {};
         CommandInfo.KeyCode = KeyCode;
         CommandInfo.Modifiers = Modifiers;
         CommandInfo.IsCapsLockActive = IsCapsLockActive;
         CommandInfo.OpaqueData = NULL;
 
-        Callback(EditorState, EditorState->FocusedTextPanelIndex, &CommandInfo);
+        if (Entry->IsCaretCommand)
+        {
+            ExecuteCaretCommand(EditorState, EditorState->FocusedTextPanelIndex, Entry->Callback, &CommandInfo);
+        }
+        else
+        {
+            Entry->Callback(EditorState, EditorState->FocusedTextPanelIndex, &CommandInfo);
+        }
     }
 }
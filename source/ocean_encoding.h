@@ -0,0 +1,1187 @@
+/*  =====================================================================
+    $File:   ocean_encoding.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_ENCODING_H
+
+#include "ocean.h"
+#include "ocean_simd.h"
+
+// NOTE(traian): The text of a panel is always stored as UTF-8. Documents in other encodings are decoded
+// into UTF-8 when they are loaded and encoded back when they are saved. The transcoders work on one chunk
+// at a time: a sequence that is cut by the end of a chunk isn't consumed, unless the chunk is the last one,
+// so the caller passes the unconsumed bytes again in front of the next chunk.
+
+struct transcode_result
+{
+    memory_size ReadCount;
+    memory_size WrittenCount;
+    // NOTE(traian): The number of sequences that the other encoding can't represent, which were written as a
+    // replacement, so the transcoded text doesn't round-trip.
+    u64 ReplacedCount;
+};
+
+// NOTE(traian): Decoded in place of the bytes that aren't part of a well-formed sequence.
+#define UNICODE_REPLACEMENT_CHARACTER 0xFFFD
+
+#define UTF8_BYTE_ORDER_MARK "\xEF\xBB\xBF"
+#define UTF16LE_BYTE_ORDER_MARK "\xFF\xFE"
+
+// NOTE(traian): Windows-1252 maps 0x80-0x9F to these codepoints. The five bytes that the code page leaves
+// undefined map to the C1 control with the same value, so that any file survives a round-trip.
+global u16 GlobalWindows1252HighCodepoints[32] =
+{
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+//=========================================================================================
+// NOTE(traian): UTF-8 SEQUENCES.
+//=========================================================================================
+
+internal inline u32
+GetUTF8SequenceWidth(u8 Lead)
+{
+    u32 Result = 0;
+    if (Lead < 0x80)
+    {
+        Result = 1;
+    }
+    else if ((Lead & 0xE0) == 0xC0)
+    {
+        Result = 2;
+    }
+    else if ((Lead & 0xF0) == 0xE0)
+    {
+        Result = 3;
+    }
+    else if ((Lead & 0xF8) == 0xF0)
+    {
+        Result = 4;
+    }
+    return Result;
+}
+
+// NOTE(traian): Returns the width of the well-formed sequence at the start of the bytes, or 0 if the bytes
+// don't start with a well-formed sequence (this includes overlong encodings, surrogates and sequences that
+// are cut by the end of the bytes).
+internal inline u32
+DecodeUTF8(u8 *Bytes, memory_size Count, u32 *Codepoint)
+{
+    u8 Lead = Bytes[0];
+    u32 Width = GetUTF8SequenceWidth(Lead);
+    if (Width == 1)
+    {
+        *Codepoint = Lead;
+        return 1;
+    }
+    if (Width == 0 || Width > Count)
+    {
+        return 0;
+    }
+
+    local_persist u32 LeadMasks[5] = { 0, 0x7F, 0x1F, 0x0F, 0x07 };
+    local_persist u32 MinCodepoints[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+    u32 Result = Lead & LeadMasks[Width];
+    for (u32 ByteIndex = 1; ByteIndex < Width; ++ByteIndex)
+    {
+        u8 Byte = Bytes[ByteIndex];
+        if ((Byte & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+        Result = (Result << 6) | (Byte & 0x3F);
+    }
+
+    b32 IsSurrogate = (0xD800 <= Result) && (Result <= 0xDFFF);
+    if (Result < MinCodepoints[Width] || Result > 0x10FFFF || IsSurrogate)
+    {
+        return 0;
+    }
+
+    *Codepoint = Result;
+    return Width;
+}
+
+// NOTE(traian): Returns true if the bytes are the start of a sequence that continues past their end.
+internal inline b32
+IsTruncatedUTF8Sequence(u8 *Bytes, memory_size Count)
+{
+    u32 Width = GetUTF8SequenceWidth(Bytes[0]);
+    if (Width <= Count)
+    {
+        return false;
+    }
+
+    for (memory_size ByteIndex = 1; ByteIndex < Count; ++ByteIndex)
+    {
+        if ((Bytes[ByteIndex] & 0xC0) != 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+internal inline u32
+EncodeUTF8(u32 Codepoint, u8 *Destination)
+{
+    if (Codepoint < 0x80)
+    {
+        Destination[0] = (u8)Codepoint;
+        return 1;
+    }
+    if (Codepoint < 0x800)
+    {
+        Destination[0] = (u8)(0xC0 | (Codepoint >> 6));
+        Destination[1] = (u8)(0x80 | (Codepoint & 0x3F));
+        return 2;
+    }
+    if (Codepoint < 0x10000)
+    {
+        Destination[0] = (u8)(0xE0 | (Codepoint >> 12));
+        Destination[1] = (u8)(0x80 | ((Codepoint >> 6) & 0x3F));
+        Destination[2] = (u8)(0x80 | (Codepoint & 0x3F));
+        return 3;
+    }
+
+    Destination[0] = (u8)(0xF0 | (Codepoint >> 18));
+    Destination[1] = (u8)(0x80 | ((Codepoint >> 12) & 0x3F));
+    Destination[2] = (u8)(0x80 | ((Codepoint >> 6) & 0x3F));
+    Destination[3] = (u8)(0x80 | (Codepoint & 0x3F));
+    return 4;
+}
+
+// NOTE(traian): Returns the size of the bytes without the sequence that is cut by their end, if any.
+internal inline memory_size
+GetCompleteUTF8Size(u8 *Bytes, memory_size Count)
+{
+    for (memory_size BackCount = 1; BackCount <= Minimum(Count, (memory_size)3); ++BackCount)
+    {
+        u8 *Sequence = Bytes + Count - BackCount;
+        if ((*Sequence & 0xC0) != 0x80)
+        {
+            if (IsTruncatedUTF8Sequence(Sequence, BackCount))
+            {
+                return Count - BackCount;
+            }
+            break;
+        }
+    }
+    return Count;
+}
+
+//=========================================================================================
+// NOTE(traian): UTF-8 VALIDATION.
+//=========================================================================================
+
+internal b32
+IsValidUTF8_Scalar(u8 *Bytes, memory_size Count)
+{
+    memory_size Index = 0;
+    while (Index < Count)
+    {
+        u32 Codepoint;
+        u32 Width = DecodeUTF8(Bytes + Index, Count - Index, &Codepoint);
+        if (Width == 0)
+        {
+            return false;
+        }
+        Index += Width;
+    }
+    return true;
+}
+
+// NOTE(traian): Blocks of 16 ASCII bytes are skipped, the rest is validated one sequence at a time.
+internal b32
+IsValidUTF8_SSE2(u8 *Bytes, memory_size Count)
+{
+    memory_size Index = 0;
+    while (Index < Count)
+    {
+        if (Index + 16 <= Count && _mm_movemask_epi8(_mm_loadu_si128((__m128i *)(Bytes + Index))) == 0)
+        {
+            Index += 16;
+            continue;
+        }
+
+        u32 Codepoint;
+        u32 Width = DecodeUTF8(Bytes + Index, Count - Index, &Codepoint);
+        if (Width == 0)
+        {
+            return false;
+        }
+        Index += Width;
+    }
+    return true;
+}
+
+// NOTE(traian): Validates 32 bytes per step without branches, by looking up the high and low nibbles of each
+// byte and the high nibble of the byte that follows it in three tables. Each table entry is a set of error
+// bits, and a pair of bytes is malformed if an error bit is set in all three lookups. The sequences that
+// are longer than two bytes are checked by making sure that continuation bytes appear exactly where the
+// preceding lead bytes expect them. (Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction
+// Per Byte").
+#define UTF8_TOO_SHORT      (1 << 0)
+#define UTF8_TOO_LONG       (1 << 1)
+#define UTF8_OVERLONG_3     (1 << 2)
+#define UTF8_TOO_LARGE      (1 << 3)
+#define UTF8_SURROGATE      (1 << 4)
+#define UTF8_OVERLONG_2     (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)
+#define UTF8_TWO_CONTS      (1 << 7)
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define Broadcast16(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+internal inline __m256i
+GetUTF8BlockErrors_AVX2(__m256i Input, __m256i PreviousInput)
+{
+    __m256i LowNibbleMask = _mm256_set1_epi8(0x0F);
+
+    // NOTE(traian): The input shifted right by N bytes, with the last bytes of the previous block in front.
+    __m256i Carried = _mm256_permute2x128_si256(PreviousInput, Input, 0x21);
+    __m256i Previous1 = _mm256_alignr_epi8(Input, Carried, 16 - 1);
+    __m256i Previous2 = _mm256_alignr_epi8(Input, Carried, 16 - 2);
+    __m256i Previous3 = _mm256_alignr_epi8(Input, Carried, 16 - 3);
+
+    __m256i Byte1HighTable = Broadcast16(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+
+    __m256i Byte1LowTable = Broadcast16(
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        UTF8_CARRY,
+        UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000);
+
+    __m256i Byte2HighTable = Broadcast16(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+
+    __m256i Byte1High = _mm256_shuffle_epi8(Byte1HighTable,
+                                            _mm256_and_si256(_mm256_srli_epi16(Previous1, 4), LowNibbleMask));
+    __m256i Byte1Low = _mm256_shuffle_epi8(Byte1LowTable, _mm256_and_si256(Previous1, LowNibbleMask));
+    __m256i Byte2High = _mm256_shuffle_epi8(Byte2HighTable,
+                                            _mm256_and_si256(_mm256_srli_epi16(Input, 4), LowNibbleMask));
+    __m256i SpecialCases = _mm256_and_si256(_mm256_and_si256(Byte1High, Byte1Low), Byte2High);
+
+    // NOTE(traian): Only the third and fourth bytes of a sequence keep their top bit after the subtraction.
+    __m256i IsThirdByte = _mm256_subs_epu8(Previous2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i IsFourthByte = _mm256_subs_epu8(Previous3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i MustBeContinuation = _mm256_and_si256(_mm256_or_si256(IsThirdByte, IsFourthByte),
+                                                  _mm256_set1_epi8((char)0x80));
+
+    __m256i Result = _mm256_xor_si256(MustBeContinuation, SpecialCases);
+    return Result;
+}
+
+// NOTE(traian): Non-zero where the last bytes of the block start a sequence that continues in the next block.
+internal inline __m256i
+GetUTF8BlockIncomplete_AVX2(__m256i Input)
+{
+    __m256i MaxValues = _mm256_setr_epi8(
+        (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF,
+        (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF,
+        (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF,
+        (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF, (char)0xFF,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m256i Result = _mm256_subs_epu8(Input, MaxValues);
+    return Result;
+}
+
+internal b32
+IsValidUTF8_AVX2(u8 *Bytes, memory_size Count)
+{
+    __m256i Errors = _mm256_setzero_si256();
+    __m256i PreviousInput = _mm256_setzero_si256();
+    __m256i PreviousIncomplete = _mm256_setzero_si256();
+
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)31;
+    for (; Index < VectorEnd; Index += 32)
+    {
+        __m256i Input = _mm256_loadu_si256((__m256i *)(Bytes + Index));
+        if (_mm256_movemask_epi8(Input) == 0)
+        {
+            // NOTE(traian): An ASCII block is only malformed if the previous block ended in the middle
+            // of a sequence.
+            Errors = _mm256_or_si256(Errors, PreviousIncomplete);
+        }
+        else
+        {
+            Errors = _mm256_or_si256(Errors, GetUTF8BlockErrors_AVX2(Input, PreviousInput));
+            PreviousIncomplete = GetUTF8BlockIncomplete_AVX2(Input);
+        }
+        PreviousInput = Input;
+    }
+
+    // NOTE(traian): The tail is padded with zeros, which are ASCII, so the last sequence must be complete.
+    u8 Tail[32] = {};
+    CopyMem(Tail, Bytes + Index, Count - Index);
+    __m256i Input = _mm256_loadu_si256((__m256i *)Tail);
+    Errors = _mm256_or_si256(Errors, GetUTF8BlockErrors_AVX2(Input, PreviousInput));
+    Errors = _mm256_or_si256(Errors, GetUTF8BlockIncomplete_AVX2(Input));
+
+    b32 Result = _mm256_testz_si256(Errors, Errors);
+    return Result;
+}
+
+#undef Broadcast16
+
+//=========================================================================================
+// NOTE(traian): WINDOWS-1252.
+//=========================================================================================
+
+// NOTE(traian): Decodes a single non-ASCII byte. Returns the number of bytes written.
+internal inline u32
+DecodeWindows1252Byte(u8 Byte, u8 *Destination)
+{
+    u32 Codepoint = Byte;
+    if (0x80 <= Byte && Byte <= 0x9F)
+    {
+        Codepoint = GlobalWindows1252HighCodepoints[Byte - 0x80];
+    }
+
+    u32 Result = EncodeUTF8(Codepoint, Destination);
+    return Result;
+}
+
+internal transcode_result
+DecodeWindows1252_Scalar(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        Result.WrittenCount += DecodeWindows1252Byte(Source[Index], Destination + Result.WrittenCount);
+    }
+
+    Result.ReadCount = Count;
+    return Result;
+}
+
+internal transcode_result
+DecodeWindows1252_SSE2(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)15;
+    for (; Index < VectorEnd; Index += 16)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Source + Index));
+        if (_mm_movemask_epi8(Bytes) == 0)
+        {
+            _mm_storeu_si128((__m128i *)(Destination + Result.WrittenCount), Bytes);
+            Result.WrittenCount += 16;
+        }
+        else
+        {
+            transcode_result Block = DecodeWindows1252_Scalar(Source + Index, 16,
+                                                              Destination + Result.WrittenCount, false);
+            Result.WrittenCount += Block.WrittenCount;
+        }
+    }
+
+    transcode_result Tail = DecodeWindows1252_Scalar(Source + Index, Count - Index,
+                                                     Destination + Result.WrittenCount, IsFinal);
+    Result.ReadCount = Count;
+    Result.WrittenCount += Tail.WrittenCount;
+    return Result;
+}
+
+// NOTE(traian): The codepoints that can't be represented are written as '?'. Returns false for them.
+internal inline b32
+EncodeWindows1252Codepoint(u32 Codepoint, u8 *Destination)
+{
+    if (Codepoint < 0x80 || (0xA0 <= Codepoint && Codepoint <= 0xFF))
+    {
+        *Destination = (u8)Codepoint;
+        return true;
+    }
+
+    for (u32 Index = 0; Index < ArrayCount(GlobalWindows1252HighCodepoints); ++Index)
+    {
+        if (GlobalWindows1252HighCodepoints[Index] == Codepoint)
+        {
+            *Destination = (u8)(0x80 + Index);
+            return true;
+        }
+    }
+
+    *Destination = '?';
+    return false;
+}
+
+internal transcode_result
+EncodeWindows1252_Scalar(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    while (Result.ReadCount < Count)
+    {
+        u8 *Sequence = Source + Result.ReadCount;
+        memory_size RemainingCount = Count - Result.ReadCount;
+        if (!IsFinal && IsTruncatedUTF8Sequence(Sequence, RemainingCount))
+        {
+            break;
+        }
+
+        u32 Codepoint = '?';
+        u32 Width = DecodeUTF8(Sequence, RemainingCount, &Codepoint);
+        if (!EncodeWindows1252Codepoint(Codepoint, Destination + Result.WrittenCount++) || Width == 0)
+        {
+            ++Result.ReplacedCount;
+        }
+        Result.ReadCount += Maximum(Width, 1);
+    }
+    return Result;
+}
+
+internal transcode_result
+EncodeWindows1252_SSE2(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    while (Result.ReadCount + 16 <= Count)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Source + Result.ReadCount));
+        u32 Mask = (u32)_mm_movemask_epi8(Bytes);
+        if (Mask == 0)
+        {
+            _mm_storeu_si128((__m128i *)(Destination + Result.WrittenCount), Bytes);
+            Result.ReadCount += 16;
+            Result.WrittenCount += 16;
+            continue;
+        }
+
+        // NOTE(traian): The ASCII bytes in front of the first multi-byte sequence are copied, then the
+        // sequence is encoded on its own.
+        unsigned long ASCIICount;
+        _BitScanForward(&ASCIICount, Mask);
+        CopyMem(Destination + Result.WrittenCount, Source + Result.ReadCount, ASCIICount);
+        Result.ReadCount += ASCIICount;
+        Result.WrittenCount += ASCIICount;
+
+        if (!IsFinal && IsTruncatedUTF8Sequence(Source + Result.ReadCount, Count - Result.ReadCount))
+        {
+            return Result;
+        }
+
+        u32 Codepoint = '?';
+        u32 Width = DecodeUTF8(Source + Result.ReadCount, Count - Result.ReadCount, &Codepoint);
+        if (!EncodeWindows1252Codepoint(Codepoint, Destination + Result.WrittenCount++) || Width == 0)
+        {
+            ++Result.ReplacedCount;
+        }
+        Result.ReadCount += Maximum(Width, 1);
+    }
+
+    transcode_result Tail = EncodeWindows1252_Scalar(Source + Result.ReadCount, Count - Result.ReadCount,
+                                                     Destination + Result.WrittenCount, IsFinal);
+    Result.ReadCount += Tail.ReadCount;
+    Result.WrittenCount += Tail.WrittenCount;
+    Result.ReplacedCount += Tail.ReplacedCount;
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): UTF-16LE.
+//=========================================================================================
+
+internal inline u32
+ReadUTF16LEUnit(u8 *Bytes)
+{
+    u32 Result = (u32)Bytes[0] | ((u32)Bytes[1] << 8);
+    return Result;
+}
+
+internal transcode_result
+DecodeUTF16LE_Scalar(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    while (Result.ReadCount < Count)
+    {
+        u8 *Units = Source + Result.ReadCount;
+        memory_size RemainingCount = Count - Result.ReadCount;
+
+        // NOTE(traian): A lone surrogate, or a lone byte, is replaced.
+        u32 Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        b32 IsReplaced = true;
+        u32 Width = 2;
+        if (RemainingCount < 2)
+        {
+            // NOTE(traian): A single byte is left, which is only malformed at the end of the file.
+            if (!IsFinal)
+            {
+                break;
+            }
+            Width = 1;
+        }
+        else
+        {
+            u32 Unit = ReadUTF16LEUnit(Units);
+            if (0xD800 <= Unit && Unit <= 0xDBFF)
+            {
+                if (RemainingCount < 4 && !IsFinal)
+                {
+                    break;
+                }
+
+                u32 LowUnit = (RemainingCount >= 4) ? ReadUTF16LEUnit(Units + 2) : 0;
+                if (0xDC00 <= LowUnit && LowUnit <= 0xDFFF)
+                {
+                    Codepoint = 0x10000 + ((Unit - 0xD800) << 10) + (LowUnit - 0xDC00);
+                    IsReplaced = false;
+                    Width = 4;
+                }
+            }
+            else if (Unit < 0xDC00 || Unit > 0xDFFF)
+            {
+                Codepoint = Unit;
+                IsReplaced = false;
+            }
+        }
+
+        Result.WrittenCount += EncodeUTF8(Codepoint, Destination + Result.WrittenCount);
+        Result.ReadCount += Width;
+        Result.ReplacedCount += IsReplaced;
+    }
+    return Result;
+}
+
+internal transcode_result
+DecodeUTF16LE_SSE2(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    __m128i NonASCIIMask = _mm_set1_epi16((short)0xFF80);
+    __m128i Zero = _mm_setzero_si128();
+
+    // NOTE(traian): 16 units per step. When all of them are ASCII, they are narrowed to bytes.
+    while (Result.ReadCount + 32 <= Count)
+    {
+        __m128i UnitsA = _mm_loadu_si128((__m128i *)(Source + Result.ReadCount));
+        __m128i UnitsB = _mm_loadu_si128((__m128i *)(Source + Result.ReadCount + 16));
+        __m128i NonASCII = _mm_and_si128(_mm_or_si128(UnitsA, UnitsB), NonASCIIMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(NonASCII, Zero)) == 0xFFFF)
+        {
+            _mm_storeu_si128((__m128i *)(Destination + Result.WrittenCount), _mm_packus_epi16(UnitsA, UnitsB));
+            Result.ReadCount += 32;
+            Result.WrittenCount += 16;
+        }
+        else
+        {
+            // NOTE(traian): The block is decoded one unit at a time, up to the point where a surrogate pair
+            // could continue past the block.
+            transcode_result Block = DecodeUTF16LE_Scalar(Source + Result.ReadCount, 32,
+                                                          Destination + Result.WrittenCount, false);
+            Result.ReadCount += Block.ReadCount;
+            Result.WrittenCount += Block.WrittenCount;
+            Result.ReplacedCount += Block.ReplacedCount;
+        }
+    }
+
+    transcode_result Tail = DecodeUTF16LE_Scalar(Source + Result.ReadCount, Count - Result.ReadCount,
+                                                 Destination + Result.WrittenCount, IsFinal);
+    Result.ReadCount += Tail.ReadCount;
+    Result.WrittenCount += Tail.WrittenCount;
+    Result.ReplacedCount += Tail.ReplacedCount;
+    return Result;
+}
+
+internal inline u32
+EncodeUTF16LECodepoint(u32 Codepoint, u8 *Destination)
+{
+    if (Codepoint < 0x10000)
+    {
+        Destination[0] = (u8)Codepoint;
+        Destination[1] = (u8)(Codepoint >> 8);
+        return 2;
+    }
+
+    u32 Value = Codepoint - 0x10000;
+    u32 HighUnit = 0xD800 + (Value >> 10);
+    u32 LowUnit = 0xDC00 + (Value & 0x3FF);
+    Destination[0] = (u8)HighUnit;
+    Destination[1] = (u8)(HighUnit >> 8);
+    Destination[2] = (u8)LowUnit;
+    Destination[3] = (u8)(LowUnit >> 8);
+    return 4;
+}
+
+internal transcode_result
+EncodeUTF16LE_Scalar(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    while (Result.ReadCount < Count)
+    {
+        u8 *Sequence = Source + Result.ReadCount;
+        memory_size RemainingCount = Count - Result.ReadCount;
+        if (!IsFinal && IsTruncatedUTF8Sequence(Sequence, RemainingCount))
+        {
+            break;
+        }
+
+        u32 Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        u32 Width = DecodeUTF8(Sequence, RemainingCount, &Codepoint);
+        Result.WrittenCount += EncodeUTF16LECodepoint(Codepoint, Destination + Result.WrittenCount);
+        Result.ReadCount += Maximum(Width, 1);
+        Result.ReplacedCount += (Width == 0);
+    }
+    return Result;
+}
+
+internal transcode_result
+EncodeUTF16LE_SSE2(u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    __m128i Zero = _mm_setzero_si128();
+    while (Result.ReadCount + 16 <= Count)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Source + Result.ReadCount));
+        if (_mm_movemask_epi8(Bytes) == 0)
+        {
+            // NOTE(traian): ASCII bytes are widened to units by interleaving them with zeros.
+            u8 *Units = Destination + Result.WrittenCount;
+            _mm_storeu_si128((__m128i *)Units, _mm_unpacklo_epi8(Bytes, Zero));
+            _mm_storeu_si128((__m128i *)(Units + 16), _mm_unpackhi_epi8(Bytes, Zero));
+            Result.ReadCount += 16;
+            Result.WrittenCount += 32;
+            continue;
+        }
+
+        u32 Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+        u32 Width = DecodeUTF8(Source + Result.ReadCount, Count - Result.ReadCount, &Codepoint);
+        Result.WrittenCount += EncodeUTF16LECodepoint(Codepoint, Destination + Result.WrittenCount);
+        Result.ReadCount += Maximum(Width, 1);
+        Result.ReplacedCount += (Width == 0);
+    }
+
+    transcode_result Tail = EncodeUTF16LE_Scalar(Source + Result.ReadCount, Count - Result.ReadCount,
+                                                 Destination + Result.WrittenCount, IsFinal);
+    Result.ReadCount += Tail.ReadCount;
+    Result.WrittenCount += Tail.WrittenCount;
+    Result.ReplacedCount += Tail.ReplacedCount;
+    return Result;
+}
+
+//
+// NOTE(traian): Dispatchers, which pick the widest kernel supported by the processor.
+//
+
+internal inline b32
+IsValidUTF8(u8 *Bytes, memory_size Count)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return IsValidUTF8_AVX2(Bytes, Count);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return IsValidUTF8_SSE2(Bytes, Count);
+    }
+    return IsValidUTF8_Scalar(Bytes, Count);
+}
+
+// NOTE(traian): The largest number of bytes that the given number of bytes of the document can be decoded
+// into, or encoded from.
+internal inline memory_size
+GetMaxDecodedSize(text_encoding Encoding, memory_size Count)
+{
+    memory_size Result = Count;
+    if (Encoding == TextEncoding_UTF16LE)
+    {
+        // NOTE(traian): A unit decodes into at most 3 bytes, and so does a lone byte at the end.
+        Result = (Count / 2) * 3 + 3;
+    }
+    else if (Encoding == TextEncoding_Windows1252)
+    {
+        Result = Count * 3;
+    }
+    return Result;
+}
+
+internal inline memory_size
+GetMaxEncodedSize(text_encoding Encoding, memory_size Count)
+{
+    memory_size Result = Count;
+    if (Encoding == TextEncoding_UTF16LE)
+    {
+        Result = Count * 2;
+    }
+    return Result;
+}
+
+// NOTE(traian): Decodes a chunk of the document into UTF-8.
+internal transcode_result
+DecodeText(text_encoding Encoding, u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    switch (Encoding)
+    {
+        case TextEncoding_UTF16LE:
+        {
+            Result = GlobalProcessorFeatures.HasSSE2 ? DecodeUTF16LE_SSE2(Source, Count, Destination, IsFinal)
+                                                     : DecodeUTF16LE_Scalar(Source, Count, Destination, IsFinal);
+        } break;
+
+        case TextEncoding_Windows1252:
+        {
+            Result = GlobalProcessorFeatures.HasSSE2 ? DecodeWindows1252_SSE2(Source, Count, Destination, IsFinal)
+                                                     : DecodeWindows1252_Scalar(Source, Count, Destination, IsFinal);
+        } break;
+
+        default:
+        {
+            CopyMem(Destination, Source, Count);
+            Result.ReadCount = Count;
+            Result.WrittenCount = Count;
+        } break;
+    }
+    return Result;
+}
+
+// NOTE(traian): Encodes a chunk of UTF-8 text into the encoding of the document.
+internal transcode_result
+EncodeText(text_encoding Encoding, u8 *Source, memory_size Count, u8 *Destination, b32 IsFinal)
+{
+    transcode_result Result = {};
+    switch (Encoding)
+    {
+        case TextEncoding_UTF16LE:
+        {
+            Result = GlobalProcessorFeatures.HasSSE2 ? EncodeUTF16LE_SSE2(Source, Count, Destination, IsFinal)
+                                                     : EncodeUTF16LE_Scalar(Source, Count, Destination, IsFinal);
+        } break;
+
+        case TextEncoding_Windows1252:
+        {
+            Result = GlobalProcessorFeatures.HasSSE2 ? EncodeWindows1252_SSE2(Source, Count, Destination, IsFinal)
+                                                     : EncodeWindows1252_Scalar(Source, Count, Destination, IsFinal);
+        } break;
+
+        default:
+        {
+            CopyMem(Destination, Source, Count);
+            Result.ReadCount = Count;
+            Result.WrittenCount = Count;
+        } break;
+    }
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): LINE ENDINGS.
+//=========================================================================================
+
+// NOTE(traian): Removes the carriage return of every CRLF line ending, in place. It stops at the first new
+// line that doesn't follow a carriage return, which is left unread, and at a carriage return that ends the
+// text, unless the text is final, since the new line that completes it can be in the next chunk.
+internal transcode_result
+NormalizeLineEndings_Scalar(u8 *Text, memory_size Count, b32 IsFinal)
+{
+    transcode_result Result = {};
+    memory_size Index = 0;
+    for (; Index < Count; ++Index)
+    {
+        u8 Byte = Text[Index];
+        if (Byte == '\n')
+        {
+            break;
+        }
+
+        if (Byte == '\r')
+        {
+            if (Index + 1 == Count)
+            {
+                if (!IsFinal)
+                {
+                    break;
+                }
+            }
+            else if (Text[Index + 1] == '\n')
+            {
+                Text[Result.WrittenCount++] = '\n';
+                ++Index;
+                continue;
+            }
+        }
+
+        Text[Result.WrittenCount++] = Byte;
+    }
+
+    Result.ReadCount = Index;
+    return Result;
+}
+
+// NOTE(traian): The vector kernels compare each block with the block that starts one byte later, so a
+// carriage return at the end of a block sees the new line at the start of the next one. Only the carriage
+// returns of CRLF pairs are dropped, and the new line of a pair that crosses two blocks is carried over.
+// The writes never pass the end of the block that was loaded, so the text can be normalized in place.
+internal transcode_result
+NormalizeLineEndings_SSE2(u8 *Text, memory_size Count, b32 IsFinal)
+{
+    transcode_result Result = {};
+    memory_size Index = 0;
+    u32 Carry = 0;
+
+    __m128i CarriageReturn = _mm_set1_epi8('\r');
+    __m128i NewLine = _mm_set1_epi8('\n');
+    for (; Index + 17 <= Count; Index += 16)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Text + Index));
+        __m128i NextBytes = _mm_loadu_si128((__m128i *)(Text + Index + 1));
+        u32 CarriageReturnMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, CarriageReturn));
+        u32 NewLineMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, NewLine));
+        u32 PairMask = CarriageReturnMask & (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(NextBytes, NewLine));
+
+        if (NewLineMask & ~((PairMask << 1) | Carry))
+        {
+            break;
+        }
+
+        Carry = PairMask >> 15;
+        if (PairMask == 0)
+        {
+            _mm_storeu_si128((__m128i *)(Text + Result.WrittenCount), Bytes);
+            Result.WrittenCount += 16;
+        }
+        else
+        {
+            u8 Block[16];
+            _mm_storeu_si128((__m128i *)Block, Bytes);
+            for (u32 ByteIndex = 0; ByteIndex < 16; ++ByteIndex)
+            {
+                if (!(PairMask & (1 << ByteIndex)))
+                {
+                    Text[Result.WrittenCount++] = Block[ByteIndex];
+                }
+            }
+        }
+    }
+
+    // NOTE(traian): The new line of a pair whose carriage return was dropped by the last block.
+    if (Carry)
+    {
+        Text[Result.WrittenCount++] = '\n';
+        ++Index;
+    }
+
+    transcode_result Tail = NormalizeLineEndings_Scalar(Text + Index, Count - Index, IsFinal);
+    MoveMem(Text + Result.WrittenCount, Text + Index, Tail.WrittenCount);
+    Result.ReadCount = Index + Tail.ReadCount;
+    Result.WrittenCount += Tail.WrittenCount;
+    return Result;
+}
+
+internal transcode_result
+NormalizeLineEndings_AVX2(u8 *Text, memory_size Count, b32 IsFinal)
+{
+    transcode_result Result = {};
+    memory_size Index = 0;
+    u32 Carry = 0;
+
+    __m256i CarriageReturn = _mm256_set1_epi8('\r');
+    __m256i NewLine = _mm256_set1_epi8('\n');
+    for (; Index + 33 <= Count; Index += 32)
+    {
+        __m256i Bytes = _mm256_loadu_si256((__m256i *)(Text + Index));
+        __m256i NextBytes = _mm256_loadu_si256((__m256i *)(Text + Index + 1));
+        u32 CarriageReturnMask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Bytes, CarriageReturn));
+        u32 NewLineMask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Bytes, NewLine));
+        u32 PairMask = CarriageReturnMask & (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(NextBytes, NewLine));
+
+        if (NewLineMask & ~((PairMask << 1) | Carry))
+        {
+            break;
+        }
+
+        Carry = PairMask >> 31;
+        if (PairMask == 0)
+        {
+            _mm256_storeu_si256((__m256i *)(Text + Result.WrittenCount), Bytes);
+            Result.WrittenCount += 32;
+        }
+        else
+        {
+            u8 Block[32];
+            _mm256_storeu_si256((__m256i *)Block, Bytes);
+            for (u32 ByteIndex = 0; ByteIndex < 32; ++ByteIndex)
+            {
+                if (!(PairMask & (1u << ByteIndex)))
+                {
+                    Text[Result.WrittenCount++] = Block[ByteIndex];
+                }
+            }
+        }
+    }
+
+    if (Carry)
+    {
+        Text[Result.WrittenCount++] = '\n';
+        ++Index;
+    }
+
+    transcode_result Tail = NormalizeLineEndings_Scalar(Text + Index, Count - Index, IsFinal);
+    MoveMem(Text + Result.WrittenCount, Text + Index, Tail.WrittenCount);
+    Result.ReadCount = Index + Tail.ReadCount;
+    Result.WrittenCount += Tail.WrittenCount;
+    return Result;
+}
+
+// NOTE(traian): Writes a carriage return in front of every new line. The destination must have room for
+// twice the number of bytes.
+internal memory_size
+ExpandLineEndings_Scalar(u8 *Source, memory_size Count, u8 *Destination)
+{
+    u8 *Output = Destination;
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        if (Source[Index] == '\n')
+        {
+            *Output++ = '\r';
+        }
+        *Output++ = Source[Index];
+    }
+
+    return Output - Destination;
+}
+
+internal memory_size
+ExpandLineEndings_SSE2(u8 *Source, memory_size Count, u8 *Destination)
+{
+    memory_size WrittenCount = 0;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)15;
+
+    __m128i NewLine = _mm_set1_epi8('\n');
+    for (; Index < VectorEnd; Index += 16)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Source + Index));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, NewLine)) == 0)
+        {
+            _mm_storeu_si128((__m128i *)(Destination + WrittenCount), Bytes);
+            WrittenCount += 16;
+        }
+        else
+        {
+            WrittenCount += ExpandLineEndings_Scalar(Source + Index, 16, Destination + WrittenCount);
+        }
+    }
+
+    WrittenCount += ExpandLineEndings_Scalar(Source + Index, Count - Index, Destination + WrittenCount);
+    return WrittenCount;
+}
+
+internal memory_size
+ExpandLineEndings_AVX2(u8 *Source, memory_size Count, u8 *Destination)
+{
+    memory_size WrittenCount = 0;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)31;
+
+    __m256i NewLine = _mm256_set1_epi8('\n');
+    for (; Index < VectorEnd; Index += 32)
+    {
+        __m256i Bytes = _mm256_loadu_si256((__m256i *)(Source + Index));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(Bytes, NewLine)) == 0)
+        {
+            _mm256_storeu_si256((__m256i *)(Destination + WrittenCount), Bytes);
+            WrittenCount += 32;
+        }
+        else
+        {
+            WrittenCount += ExpandLineEndings_Scalar(Source + Index, 32, Destination + WrittenCount);
+        }
+    }
+
+    WrittenCount += ExpandLineEndings_Scalar(Source + Index, Count - Index, Destination + WrittenCount);
+    return WrittenCount;
+}
+
+internal inline transcode_result
+NormalizeLineEndings(u8 *Text, memory_size Count, b32 IsFinal)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return NormalizeLineEndings_AVX2(Text, Count, IsFinal);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return NormalizeLineEndings_SSE2(Text, Count, IsFinal);
+    }
+    return NormalizeLineEndings_Scalar(Text, Count, IsFinal);
+}
+
+internal inline memory_size
+ExpandLineEndings(u8 *Source, memory_size Count, u8 *Destination)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return ExpandLineEndings_AVX2(Source, Count, Destination);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return ExpandLineEndings_SSE2(Source, Count, Destination);
+    }
+    return ExpandLineEndings_Scalar(Source, Count, Destination);
+}
+
+// NOTE(traian): The line endings that are used by the bytes. Text without any new lines uses LF.
+internal text_line_ending
+DetectLineEnding(u8 *Bytes, memory_size Count)
+{
+    b32 HasLF = false;
+    b32 HasCRLF = false;
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        if (Bytes[Index] == '\n')
+        {
+            if (Index > 0 && Bytes[Index - 1] == '\r')
+            {
+                HasCRLF = true;
+            }
+            else
+            {
+                HasLF = true;
+            }
+        }
+    }
+
+    text_line_ending Result = LineEnding_LF;
+    if (HasCRLF)
+    {
+        Result = HasLF ? LineEnding_Mixed : LineEnding_CRLF;
+    }
+    return Result;
+}
+
+internal inline char *
+GetLineEndingName(text_line_ending LineEnding)
+{
+    char *Result = "LF";
+    if (LineEnding == LineEnding_CRLF)
+    {
+        Result = "CRLF";
+    }
+    else if (LineEnding == LineEnding_Mixed)
+    {
+        Result = "Mixed";
+    }
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): ENCODING DETECTION.
+//=========================================================================================
+
+// NOTE(traian): The number of bytes at the start of the document that are used to detect UTF-16 text.
+#define TEXT_ENCODING_UTF16_SAMPLE_SIZE Kilobytes(4)
+
+internal inline memory_size
+GetByteOrderMarkSize(text_file_format Format)
+{
+    memory_size Result = 0;
+    if (Format.HasByteOrderMark)
+    {
+        Result = (Format.Encoding == TextEncoding_UTF16LE) ? (sizeof(UTF16LE_BYTE_ORDER_MARK) - 1)
+                                                           : (sizeof(UTF8_BYTE_ORDER_MARK) - 1);
+    }
+    return Result;
+}
+
+internal inline char *
+GetByteOrderMark(text_file_format Format)
+{
+    char *Result = (Format.Encoding == TextEncoding_UTF16LE) ? UTF16LE_BYTE_ORDER_MARK : UTF8_BYTE_ORDER_MARK;
+    return Result;
+}
+
+// NOTE(traian): Detects the format from the first bytes of the document. A byte order mark decides the
+// encoding. Otherwise, text where most of the odd bytes are zero and almost none of the even bytes are is
+// taken to be UTF-16LE, and text that isn't valid UTF-8 is taken to be Windows-1252. The last sequence of the
+// bytes may be cut, unless they are the whole document.
+internal text_file_format
+DetectTextFileFormat(u8 *Bytes, memory_size Count, b32 IsWholeFile)
+{
+    text_file_format Result = {};
+    Result.Encoding = TextEncoding_UTF8;
+
+    if (Count >= 3 && Bytes[0] == 0xEF && Bytes[1] == 0xBB && Bytes[2] == 0xBF)
+    {
+        Result.HasByteOrderMark = true;
+        return Result;
+    }
+
+    if (Count >= 2 && Bytes[0] == 0xFF && Bytes[1] == 0xFE)
+    {
+        Result.Encoding = TextEncoding_UTF16LE;
+        Result.HasByteOrderMark = true;
+        return Result;
+    }
+
+    memory_size UnitCount = Minimum(Count, TEXT_ENCODING_UTF16_SAMPLE_SIZE) / 2;
+    memory_size EvenZeroCount = 0;
+    memory_size OddZeroCount = 0;
+    for (memory_size UnitIndex = 0; UnitIndex < UnitCount; ++UnitIndex)
+    {
+        EvenZeroCount += (Bytes[2 * UnitIndex + 0] == 0);
+        OddZeroCount += (Bytes[2 * UnitIndex + 1] == 0);
+    }
+
+    if (UnitCount > 0 && 4 * OddZeroCount >= 3 * UnitCount && 10 * EvenZeroCount < UnitCount)
+    {
+        Result.Encoding = TextEncoding_UTF16LE;
+        return Result;
+    }
+
+    memory_size ValidatedCount = IsWholeFile ? Count : GetCompleteUTF8Size(Bytes, Count);
+    if (!IsValidUTF8(Bytes, ValidatedCount))
+    {
+        Result.Encoding = TextEncoding_Windows1252;
+    }
+    return Result;
+}
+
+internal inline char *
+GetTextEncodingName(text_encoding Encoding)
+{
+    char *Result = "UTF-8";
+    if (Encoding == TextEncoding_UTF16LE)
+    {
+        Result = "UTF-16LE";
+    }
+    else if (Encoding == TextEncoding_Windows1252)
+    {
+        Result = "Windows-1252";
+    }
+    return Result;
+}
+
+#define OCEAN_ENCODING_H
+#endif // OCEAN_ENCODING_H
@@ -0,0 +1,1056 @@
+/*  =====================================================================
+    $File:   ocean_find_in_files.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_FIND_IN_FILES_H
+
+#include "ocean.h"
+#include "ocean_text.h"
+#include "ocean_trigram_index.h"
+
+//=========================================================================================
+// NOTE(traian): WORK STEALING DEQUE.
+//=========================================================================================
+
+// NOTE(traian): Only called by the worker that owns the deque. Returns false if the deque is full.
+internal b32
+PushFindInFilesItem(find_in_files_deque *Deque, u32 ItemIndex)
+{
+    u64 Bottom = Deque->Bottom;
+    if (Bottom - Deque->Top >= FIND_IN_FILES_DEQUE_CAPACITY)
+    {
+        return false;
+    }
+
+    Deque->Items[Bottom % FIND_IN_FILES_DEQUE_CAPACITY] = ItemIndex;
+    CompletePreviousWritesBeforeFutureWrites;
+    Deque->Bottom = Bottom + 1;
+    return true;
+}
+
+// NOTE(traian): Only called by the worker that owns the deque. Returns UINT32_MAX if the deque is empty.
+internal u32
+PopFindInFilesItem(find_in_files_deque *Deque)
+{
+    u64 Bottom = Deque->Bottom;
+    if (Bottom == Deque->Top)
+    {
+        return UINT32_MAX;
+    }
+
+    // NOTE(traian): The bottom is claimed before the top is read, so that a thief that reads the old bottom
+    // is seen here.
+    --Bottom;
+    Deque->Bottom = Bottom;
+    CompletePreviousMemoryOperations;
+    u64 Top = Deque->Top;
+
+    if (Top < Bottom)
+    {
+        return Deque->Items[Bottom % FIND_IN_FILES_DEQUE_CAPACITY];
+    }
+
+    // NOTE(traian): This is the last item, so the worker races the thieves for it. Either way, the deque is
+    // empty afterwards.
+    u32 Result = UINT32_MAX;
+    if (Top == Bottom && AtomicCompareExchangeU64(&Deque->Top, Top + 1, Top) == Top)
+    {
+        Result = Deque->Items[Bottom % FIND_IN_FILES_DEQUE_CAPACITY];
+    }
+    Deque->Bottom = Bottom + 1;
+    return Result;
+}
+
+// NOTE(traian): Called by the other workers. Returns UINT32_MAX if the deque is empty, or if another worker took
+// the item first.
+internal u32
+StealFindInFilesItem(find_in_files_deque *Deque)
+{
+    u64 Top = Deque->Top;
+    CompletePreviousReadsBeforeFutureReads;
+    u64 Bottom = Deque->Bottom;
+    if (Top >= Bottom)
+    {
+        return UINT32_MAX;
+    }
+
+    u32 Result = Deque->Items[Top % FIND_IN_FILES_DEQUE_CAPACITY];
+    if (AtomicCompareExchangeU64(&Deque->Top, Top + 1, Top) != Top)
+    {
+        Result = UINT32_MAX;
+    }
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): SEARCH WORKERS.
+//=========================================================================================
+
+internal inline char *
+GetFindInFilesItemPath(find_in_files *Search, find_in_files_item *Item)
+{
+    char *Result = Search->PathPool + Item->PathOffset;
+    return Result;
+}
+
+// NOTE(traian): Stores the item and its path, which is joined from the path of its directory and its name.
+// Returns UINT32_MAX if the search ran out of memory.
+internal u32
+AddFindInFilesItem(find_in_files *Search, char *DirectoryPath, memory_size DirectoryPathLength, char *Name,
+                   memory_size NameLength, b32 IsDirectory, u64 WriteTime)
+{
+    memory_size PathLength = DirectoryPathLength + 1 + NameLength;
+    Assert(PathLength < PLATFORM_PATH_CAPACITY);
+
+    u32 ItemIndex = AtomicAddU32(&Search->ItemCount, 1);
+    memory_offset PathOffset = AtomicAddU64(&Search->PathPoolUsed, PathLength + 1);
+    if (ItemIndex >= FIND_IN_FILES_ITEM_CAPACITY || PathOffset + PathLength + 1 > FIND_IN_FILES_PATH_POOL_SIZE)
+    {
+        Search->IsTruncated = true;
+        return UINT32_MAX;
+    }
+
+    char *Path = Search->PathPool + PathOffset;
+    CopyMem(Path, DirectoryPath, DirectoryPathLength);
+    Path[DirectoryPathLength] = '/';
+    CopyMem(Path + DirectoryPathLength + 1, Name, NameLength + 1);
+
+    find_in_files_item *Item = Search->Items + ItemIndex;
+    Item->PathOffset = PathOffset;
+    Item->PathLength = (u32)PathLength;
+    Item->IsDirectory = IsDirectory;
+    Item->WriteTime = WriteTime;
+    return ItemIndex;
+}
+
+// NOTE(traian): Publishes the result lines of the worker, so that the main thread can append them to the
+// results panel.
+internal void
+FlushFindInFilesOutput(find_in_files *Search, find_in_files_worker *Worker)
+{
+    if (Worker->OutputCount == 0)
+    {
+        return;
+    }
+
+    u32 BlockIndex = AtomicAddU32(&Search->ResultBlockCount, 1);
+    memory_offset TextOffset = AtomicAddU64(&Search->ResultTextUsed, Worker->OutputCount);
+    if (BlockIndex < FIND_IN_FILES_RESULT_BLOCK_CAPACITY)
+    {
+        // NOTE(traian): A block that doesn't fit in the result text is still published, but empty, since the
+        // main thread appends the blocks in order.
+        find_in_files_result_block *Block = Search->ResultBlocks + BlockIndex;
+        Block->TextOffset = TextOffset;
+        Block->TextSize = 0;
+        Block->LineCount = 0;
+        if (TextOffset + Worker->OutputCount <= FIND_IN_FILES_RESULT_TEXT_SIZE)
+        {
+            CopyMem(Search->ResultText + TextOffset, Worker->Output, Worker->OutputCount);
+            Block->TextSize = Worker->OutputCount;
+            Block->LineCount = Worker->OutputLineCount;
+        }
+        else
+        {
+            Search->IsTruncated = true;
+        }
+
+        CompletePreviousWritesBeforeFutureWrites;
+        Block->IsReady = true;
+    }
+    else
+    {
+        Search->IsTruncated = true;
+    }
+
+    Worker->OutputCount = 0;
+    Worker->OutputLineCount = 0;
+}
+
+// NOTE(traian): Writes a result line, in the "path:line: text" format, with the path relative to the directory
+// that is searched.
+internal void
+AppendFindInFilesResult(find_in_files *Search, find_in_files_worker *Worker, char *Path, memory_size PathLength,
+                        u64 Line, char *Text, memory_size TextLength)
+{
+    char *RelativePath = Path + Search->DirectoryLength + 1;
+    memory_size RelativePathLength = PathLength - Search->DirectoryLength - 1;
+
+    TextLength = Minimum(TextLength, FIND_IN_FILES_LINE_PREVIEW_SIZE);
+    if (TextLength > 0 && Text[TextLength - 1] == '\r')
+    {
+        --TextLength;
+    }
+
+    memory_size MaxLineSize = RelativePathLength + 24 + TextLength + 1;
+    if (Worker->OutputCount + MaxLineSize > FIND_IN_FILES_OUTPUT_SIZE)
+    {
+        FlushFindInFilesOutput(Search, Worker);
+    }
+
+    char *Output = Worker->Output + Worker->OutputCount;
+    int PrefixLength = sprintf_s(Output, FIND_IN_FILES_OUTPUT_SIZE - Worker->OutputCount, "%.*s:%llu: ",
+                                 (int)RelativePathLength, RelativePath, Line + 1);
+    CopyMem(Output + PrefixLength, Text, TextLength);
+    Output[PrefixLength + TextLength] = '\n';
+
+    Worker->OutputCount += PrefixLength + TextLength + 1;
+    ++Worker->OutputLineCount;
+}
+
+// NOTE(traian): The file is mapped instead of read, so its pages are only brought in by the search itself and
+// nothing is copied. Every line that contains a match is reported once.
+internal void
+SearchFileForFindInFiles(find_in_files *Search, find_in_files_worker *Worker, find_in_files_item *Item)
+{
+    char *Path = GetFindInFilesItemPath(Search, Item);
+    buffer View = PlatformMapFile(Path);
+    if (!View.Data)
+    {
+        return;
+    }
+
+    char *Base = (char *)View.Data;
+    char NullByte = 0;
+    memory_size SampleSize = Minimum(View.Size, FIND_IN_FILES_BINARY_SAMPLE_SIZE);
+    if (FindLiteral(Base, SampleSize, &NullByte, 1) < SampleSize)
+    {
+        PlatformUnmapFile(View);
+        return;
+    }
+
+    text_buffer Text = {};
+    Text.Base = Base;
+    Text.Size = View.Size;
+    Text.Used = View.Size;
+    Text.GapOffset = View.Size;
+    Text.IsMapped = true;
+
+    char NewLine = '\n';
+    u64 Line = 0;
+    memory_offset CountedOffset = 0;
+    memory_offset Offset = 0;
+    text_find_match Match;
+    while (!Search->IsCancelled && Offset < Text.Used && FindTextMatch(&Worker->Find, &Text, Offset, Text.Used, &Match))
+    {
+        Line += CountNewLines(Base + CountedOffset, Match.Offset - CountedOffset);
+        CountedOffset = Match.Offset;
+
+        memory_offset LineStart = Match.Offset;
+        while (LineStart > 0 && Base[LineStart - 1] != '\n')
+        {
+            --LineStart;
+        }
+        memory_offset LineEnd = Match.Offset + FindLiteral(Base + Match.Offset, Text.Used - Match.Offset, &NewLine, 1);
+
+        AppendFindInFilesResult(Search, Worker, Path, Item->PathLength, Line, Base + LineStart, LineEnd - LineStart);
+        Offset = LineEnd + 1;
+    }
+
+    PlatformUnmapFile(View);
+    FlushFindInFilesOutput(Search, Worker);
+    ++Worker->SearchedFileCount;
+}
+
+// NOTE(traian): The trigram arrays only grow, and the file that needs them is never larger than the
+// trigram capacity.
+internal void
+ReserveTrigramCapacity(find_in_files_worker *Worker, memory_size Count)
+{
+    if (Count <= Worker->TrigramCapacity)
+    {
+        return;
+    }
+
+    memory_size Capacity = Maximum(2 * Worker->TrigramCapacity, Kilobytes(64));
+    while (Capacity < Count)
+    {
+        Capacity *= 2;
+    }
+    Capacity = Minimum(Capacity, (memory_size)TRIGRAM_INDEX_TRIGRAM_CAPACITY);
+
+    if (Worker->TrigramMemory.Data)
+    {
+        PlatformReleaseMemory(Worker->TrigramMemory);
+    }
+    Worker->TrigramMemory = PlatformAllocateMemory(2 * Capacity * sizeof(u32));
+    Worker->Trigrams = (u32 *)Worker->TrigramMemory.Data;
+    Worker->TrigramScratch = Worker->Trigrams + Capacity;
+    Worker->TrigramCapacity = Capacity;
+}
+
+// NOTE(traian): Returns NULL if the worker ran out of chunks.
+internal u8 *
+ReserveForwardListMemory(find_in_files_worker *Worker, memory_size Size)
+{
+    buffer *Chunk = NULL;
+    if (Worker->ForwardListChunkCount > 0)
+    {
+        Chunk = Worker->ForwardListChunks + Worker->ForwardListChunkCount - 1;
+    }
+
+    if (!Chunk || Worker->ForwardListChunkUsed + Size > Chunk->Size)
+    {
+        if (Worker->ForwardListChunkCount == TRIGRAM_INDEX_CHUNK_CAPACITY)
+        {
+            return NULL;
+        }
+
+        Chunk = Worker->ForwardListChunks + Worker->ForwardListChunkCount++;
+        *Chunk = PlatformAllocateMemory(Maximum(Size, TRIGRAM_INDEX_CHUNK_SIZE));
+        Worker->ForwardListChunkUsed = 0;
+    }
+
+    u8 *Result = Chunk->Data + Worker->ForwardListChunkUsed;
+    Worker->ForwardListChunkUsed += Size;
+    return Result;
+}
+
+// NOTE(traian): A file that has the same write time as in the previous index keeps its forward list, so only the
+// files that are new or that changed are read. The files that the search skips, like the binary ones, are indexed
+// without any trigrams.
+internal void
+IndexFileForFindInFiles(find_in_files *Search, find_in_files_worker *Worker, u32 ItemIndex)
+{
+    find_in_files_item *Item = Search->Items + ItemIndex;
+    char *Path = GetFindInFilesItemPath(Search, Item);
+    trigram_index_entry *Entry = Search->IndexEntries + ItemIndex;
+    Entry->Path = Path + Search->DirectoryLength + 1;
+    Entry->PathLength = Item->PathLength - Search->DirectoryLength - 1;
+    Entry->WriteTime = Item->WriteTime ? Item->WriteTime : PlatformGetFileWriteTime(Path);
+
+    trigram_index_header *PreviousHeader = GetTrigramIndexHeader(Search->PreviousIndex);
+    if (PreviousHeader && Entry->WriteTime != 0)
+    {
+        trigram_index_file *File = FindTrigramIndexFile(Search->PreviousIndex, PreviousHeader,
+                                                        Entry->Path, Entry->PathLength);
+        u8 *ForwardList = File ? GetTrigramIndexForwardList(Search->PreviousIndex, PreviousHeader, File) : NULL;
+        if (ForwardList && File->WriteTime == Entry->WriteTime)
+        {
+            Entry->ForwardList = ForwardList;
+            Entry->ForwardListSize = File->ForwardListSize;
+            Entry->IsIndexed = true;
+            ++Worker->ReusedFileCount;
+            ++Worker->SearchedFileCount;
+            return;
+        }
+    }
+
+    buffer View = PlatformMapFile(Path);
+    u8 *Bytes = View.Data;
+    memory_size SampleSize = Minimum(View.Size, FIND_IN_FILES_BINARY_SAMPLE_SIZE);
+    char NullByte = 0;
+    if (Bytes && FindLiteral((char *)Bytes, SampleSize, &NullByte, 1) == SampleSize && View.Size >= 3)
+    {
+        ReserveTrigramCapacity(Worker, Minimum(View.Size - 2, (memory_size)TRIGRAM_INDEX_TRIGRAM_CAPACITY));
+        memory_size TrigramCount = CollectTrigrams(Bytes, View.Size, (u64 *)Worker->TrigramBits.Data, Worker->Trigrams);
+        u32 *SortedTrigrams = SortTrigrams(Worker->Trigrams, Worker->TrigramScratch, TrigramCount);
+
+        // NOTE(traian): The list is encoded in the space of its worst case, and the rest is given back.
+        memory_size ReservedSize = 4 * TrigramCount;
+        u8 *ForwardList = ReserveForwardListMemory(Worker, ReservedSize);
+        if (!ForwardList)
+        {
+            Search->IsTruncated = true;
+            PlatformUnmapFile(View);
+            return;
+        }
+
+        Entry->ForwardList = ForwardList;
+        Entry->ForwardListSize = EncodeTrigramForwardList(SortedTrigrams, TrigramCount, ForwardList);
+        Worker->ForwardListChunkUsed -= ReservedSize - Entry->ForwardListSize;
+    }
+
+    if (Bytes)
+    {
+        PlatformUnmapFile(View);
+    }
+    Entry->IsIndexed = true;
+    ++Worker->SearchedFileCount;
+}
+
+internal void ProcessFindInFilesItem(find_in_files *Search, find_in_files_worker *Worker, u32 ItemIndex);
+
+// NOTE(traian): The entries of the directory are pushed to the deque of the worker, where the other workers can
+// steal them. If the deque is full, the entry is processed right away instead.
+internal void
+WalkDirectoryForFindInFiles(find_in_files *Search, find_in_files_worker *Worker, find_in_files_item *Item)
+{
+    char *Path = GetFindInFilesItemPath(Search, Item);
+    platform_directory_iterator Iterator = PlatformBeginDirectoryIteration(Path);
+
+    platform_directory_entry Entry;
+    while (!Search->IsCancelled && PlatformNextDirectoryEntry(&Iterator, &Entry))
+    {
+        // NOTE(traian): The hidden entries, like the .git directory, aren't searched.
+        memory_size NameLength = StringLength(Entry.Name);
+        if (Entry.Name[0] == '.' || Item->PathLength + 1 + NameLength >= PLATFORM_PATH_CAPACITY)
+        {
+            continue;
+        }
+
+        u32 ItemIndex = AddFindInFilesItem(Search, Path, Item->PathLength, Entry.Name, NameLength, Entry.IsDirectory,
+                                           Entry.WriteTime);
+        if (ItemIndex == UINT32_MAX)
+        {
+            break;
+        }
+
+        AtomicAddU64(&Search->PendingItemCount, 1);
+        if (!PushFindInFilesItem(&Worker->Deque, ItemIndex))
+        {
+            ProcessFindInFilesItem(Search, Worker, ItemIndex);
+            AtomicAddU64(&Search->PendingItemCount, -1);
+        }
+    }
+
+    PlatformEndDirectoryIteration(&Iterator);
+}
+
+internal void
+ProcessFindInFilesItem(find_in_files *Search, find_in_files_worker *Worker, u32 ItemIndex)
+{
+    find_in_files_item *Item = Search->Items + ItemIndex;
+    if (Item->IsDirectory)
+    {
+        WalkDirectoryForFindInFiles(Search, Worker, Item);
+    }
+    else if (Search->IsBuildingIndex)
+    {
+        IndexFileForFindInFiles(Search, Worker, ItemIndex);
+    }
+    else
+    {
+        // NOTE(traian): The changes are only detected in the files that the index selects, which are read anyway.
+        // The other files are trusted until the next build, which a stale index starts once the search is done.
+        if (Search->IsUsingIndex && PlatformGetFileWriteTime(GetFindInFilesItemPath(Search, Item)) != Item->WriteTime)
+        {
+            Search->IsIndexStale = true;
+        }
+        SearchFileForFindInFiles(Search, Worker, Item);
+    }
+}
+
+// NOTE(traian): A worker takes the items from its own deque first, then the candidates of the trigram index, and
+// steals the items from the other workers when there is nothing else. It only stops when no items are left
+// anywhere, since the items that are being processed by the other workers can still add new ones.
+internal PLATFORM_WORK_QUEUE_CALLBACK(FindInFilesWork)
+{
+    find_in_files_worker *Worker = (find_in_files_worker *)Data;
+    find_in_files *Search = Worker->Search;
+
+    while (!Search->IsCancelled)
+    {
+        u32 ItemIndex = PopFindInFilesItem(&Worker->Deque);
+        if (ItemIndex == UINT32_MAX && Search->NextCandidate < Search->CandidateCount)
+        {
+            u32 CandidateIndex = AtomicAddU32(&Search->NextCandidate, 1);
+            if (CandidateIndex < Search->CandidateCount)
+            {
+                ItemIndex = CandidateIndex;
+            }
+        }
+        for (u32 Offset = 1; ItemIndex == UINT32_MAX && Offset < Search->WorkerCount; ++Offset)
+        {
+            find_in_files_worker *Victim = Search->Workers + (Worker->WorkerIndex + Offset) % Search->WorkerCount;
+            ItemIndex = StealFindInFilesItem(&Victim->Deque);
+        }
+
+        if (ItemIndex != UINT32_MAX)
+        {
+            ProcessFindInFilesItem(Search, Worker, ItemIndex);
+            AtomicAddU64(&Search->PendingItemCount, -1);
+        }
+        else if (Search->PendingItemCount == 0)
+        {
+            break;
+        }
+        else
+        {
+            _mm_pause();
+        }
+    }
+
+    FlushFindInFilesOutput(Search, Worker);
+    AtomicAddU32(&Search->ActiveWorkerCount, -1);
+}
+
+//=========================================================================================
+// NOTE(traian): FIND IN FILES.
+//=========================================================================================
+
+internal void
+AllocateFindInFilesMemory(find_in_files *Search)
+{
+    memory_size WorkerSize = FIND_IN_FILES_WORKER_CAPACITY * (sizeof(find_in_files_worker) + FIND_IN_FILES_OUTPUT_SIZE);
+    memory_size Size = FIND_IN_FILES_ITEM_CAPACITY * sizeof(find_in_files_item) + FIND_IN_FILES_PATH_POOL_SIZE +
+                       FIND_IN_FILES_RESULT_BLOCK_CAPACITY * sizeof(find_in_files_result_block) +
+                       FIND_IN_FILES_RESULT_TEXT_SIZE + WorkerSize;
+
+    Search->Memory = PlatformAllocateMemory(Size);
+    memory_arena Arena;
+    InitializeArena(&Arena, Search->Memory.Data, Search->Memory.Size);
+
+    Search->Items = PushArray(&Arena, find_in_files_item, FIND_IN_FILES_ITEM_CAPACITY);
+    Search->PathPool = (char *)PushSize(&Arena, FIND_IN_FILES_PATH_POOL_SIZE);
+    Search->ResultBlocks = PushArray(&Arena, find_in_files_result_block, FIND_IN_FILES_RESULT_BLOCK_CAPACITY);
+    Search->ResultText = (char *)PushSize(&Arena, FIND_IN_FILES_RESULT_TEXT_SIZE);
+    Search->Workers = PushArray(&Arena, find_in_files_worker, FIND_IN_FILES_WORKER_CAPACITY);
+    for (u32 WorkerIndex = 0; WorkerIndex < FIND_IN_FILES_WORKER_CAPACITY; ++WorkerIndex)
+    {
+        Search->Workers[WorkerIndex].Output = (char *)PushSize(&Arena, FIND_IN_FILES_OUTPUT_SIZE);
+    }
+}
+
+// NOTE(traian): Appends the result blocks that are ready, in order, to the results panel. Returns true if the
+// panel changed.
+internal b32
+AbsorbFindInFilesResults(find_in_files *Search, text_panel *Panel)
+{
+    u32 BlockCount = Minimum(Search->ResultBlockCount, FIND_IN_FILES_RESULT_BLOCK_CAPACITY);
+    text_buffer *Buffer = &Panel->Buffer;
+    memory_size OldSize = Buffer->Used;
+
+    while (Search->AbsorbedBlockCount < BlockCount)
+    {
+        find_in_files_result_block *Block = Search->ResultBlocks + Search->AbsorbedBlockCount;
+        if (!Block->IsReady)
+        {
+            break;
+        }
+        CompletePreviousReadsBeforeFutureReads;
+
+        InsertIntoBuffer(Buffer, Buffer->Used, Search->ResultText + Block->TextOffset, Block->TextSize);
+        Search->ResultLineCount += Block->LineCount;
+        ++Search->AbsorbedBlockCount;
+    }
+
+    b32 Result = (Buffer->Used != OldSize);
+    if (Result)
+    {
+        // NOTE(traian): The panel is never edited, so its line index is only extended over the appended text.
+        Panel->LineIndex.TextSize = Buffer->Used;
+        ExtendLineIndex(&Panel->LineIndex, Buffer, (u64)-1);
+        Panel->LineCount = Panel->LineIndex.Count - 1;
+        InvalidateTextColumnMaps(Panel);
+        ++Panel->EditVersion;
+    }
+    return Result;
+}
+
+internal inline u64
+GetFindInFilesSearchedFileCount(find_in_files *Search)
+{
+    u64 Result = 0;
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        Result += Search->Workers[WorkerIndex].SearchedFileCount;
+    }
+    return Result;
+}
+
+internal inline u64
+GetTrigramIndexReusedFileCount(find_in_files *Search)
+{
+    u64 Result = 0;
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        Result += Search->Workers[WorkerIndex].ReusedFileCount;
+    }
+    return Result;
+}
+
+// NOTE(traian): Called by every timer tick. Returns true if the results panel changed.
+internal b32
+ContinueFindInFiles(find_in_files *Search, text_panel *Panel)
+{
+    if (!Search->IsActive)
+    {
+        return false;
+    }
+
+    // NOTE(traian): The workers publish all of their results before they stop, so once all of them stopped,
+    // the results that are absorbed next are the last ones.
+    b32 IsDone = (Search->ActiveWorkerCount == 0);
+    CompletePreviousReadsBeforeFutureReads;
+
+    b32 Result = AbsorbFindInFilesResults(Search, Panel);
+    if (IsDone)
+    {
+        Search->IsActive = false;
+        Search->ElapsedSeconds = PlatformGetSecondsElapsed(Search->StartClock, PlatformGetWallClock());
+        Result = true;
+    }
+    return Result;
+}
+
+// NOTE(traian): Stops the workers and waits for them, keeping the results that were absorbed so far.
+internal void
+CancelFindInFiles(find_in_files *Search)
+{
+    if (Search->IsActive)
+    {
+        Search->IsCancelled = true;
+        while (Search->ActiveWorkerCount > 0)
+        {
+            _mm_pause();
+        }
+        CompletePreviousReadsBeforeFutureReads;
+
+        Search->IsActive = false;
+        Search->ElapsedSeconds = PlatformGetSecondsElapsed(Search->StartClock, PlatformGetWallClock());
+    }
+}
+
+// NOTE(traian): Resets the search for a new run over the directory, without starting any worker.
+internal void
+PrepareFindInFiles(find_in_files *Search, u32 WorkerCount, char *Directory)
+{
+    if (!Search->Memory.Data)
+    {
+        AllocateFindInFilesMemory(Search);
+    }
+
+    Search->DirectoryLength = Minimum(StringLength(Directory), sizeof(Search->Directory) - 1);
+    CopyMem(Search->Directory, Directory, Search->DirectoryLength);
+    Search->Directory[Search->DirectoryLength] = 0;
+
+    // NOTE(traian): Only the blocks of the previous search have to be cleared.
+    u32 UsedBlockCount = Minimum(Search->ResultBlockCount, FIND_IN_FILES_RESULT_BLOCK_CAPACITY);
+    SetMemoryToZero(Search->ResultBlocks, UsedBlockCount * sizeof(find_in_files_result_block));
+
+    Search->ItemCount = 0;
+    Search->PathPoolUsed = 0;
+    Search->ResultBlockCount = 0;
+    Search->ResultTextUsed = 0;
+    Search->AbsorbedBlockCount = 0;
+    Search->ResultLineCount = 0;
+    Search->IsCancelled = false;
+    Search->IsTruncated = false;
+    Search->ElapsedSeconds = 0.0;
+    Search->StartClock = PlatformGetWallClock();
+    Search->IsUsingIndex = false;
+    Search->CandidateCount = 0;
+    Search->NextCandidate = 0;
+    Search->IsIndexStale = false;
+    Search->IsBuildingIndex = false;
+
+    Search->WorkerCount = Maximum(1, Minimum(WorkerCount, FIND_IN_FILES_WORKER_CAPACITY));
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        find_in_files_worker *Worker = Search->Workers + WorkerIndex;
+        Worker->Search = Search;
+        Worker->WorkerIndex = WorkerIndex;
+        Worker->Deque.Top = 0;
+        Worker->Deque.Bottom = 0;
+        Worker->OutputCount = 0;
+        Worker->OutputLineCount = 0;
+        Worker->SearchedFileCount = 0;
+        Worker->ReusedFileCount = 0;
+    }
+}
+
+// NOTE(traian): The root is stored like any other directory, so its path is the directory itself.
+internal void
+AddFindInFilesRoot(find_in_files *Search)
+{
+    find_in_files_item *Root = Search->Items;
+    Root->PathOffset = 0;
+    Root->PathLength = (u32)Search->DirectoryLength;
+    Root->IsDirectory = true;
+    Root->WriteTime = 0;
+    CopyMem(Search->PathPool, Search->Directory, Search->DirectoryLength + 1);
+    Search->ItemCount = 1;
+    Search->PathPoolUsed = Search->DirectoryLength + 1;
+
+    PushFindInFilesItem(&Search->Workers[0].Deque, 0);
+    Search->PendingItemCount = 1;
+}
+
+// NOTE(traian): Without a queue, the entry runs right away on the calling thread, which is how the benchmarks run
+// the searches and the builds.
+internal b32
+AddFindInFilesWorkEntry(platform_work_queue *WorkQueue, platform_work_queue_callback *Callback, void *Data)
+{
+    if (!WorkQueue)
+    {
+        Callback(NULL, Data);
+        return true;
+    }
+
+    b32 Result = PlatformAddWorkEntry(WorkQueue, Callback, Data);
+    return Result;
+}
+
+// NOTE(traian): The items of a worker that couldn't be queued are stolen by the others. If none of them was
+// queued, the search stops on the next timer tick with whatever it found, which is nothing.
+internal void
+StartFindInFilesWorkers(find_in_files *Search, platform_work_queue *WorkQueue)
+{
+    Search->ActiveWorkerCount = Search->WorkerCount;
+    Search->IsActive = true;
+
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        if (!AddFindInFilesWorkEntry(WorkQueue, FindInFilesWork, Search->Workers + WorkerIndex))
+        {
+            AtomicAddU32(&Search->ActiveWorkerCount, -1);
+            Search->IsTruncated = true;
+        }
+    }
+}
+
+// NOTE(traian): Replaces the walk with the files of the trigram index that can contain a match, since a match of
+// the literal contains all of its trigrams, and so does a match of the regex, which starts with its literal prefix.
+// The file table of the index is trusted, so nothing is walked; the candidates remember their write time in the
+// index, so the ones that changed since the build are noticed when they are searched. Returns false if the
+// directory has no complete index.
+internal b32
+UseTrigramIndexForFindInFiles(find_in_files *Search)
+{
+    char IndexFileName[PLATFORM_PATH_CAPACITY];
+    if (!GetTrigramIndexFileName(Search->Directory, Search->DirectoryLength, TRIGRAM_INDEX_FILE_NAME, IndexFileName))
+    {
+        return false;
+    }
+
+    buffer Index = PlatformMapFile(IndexFileName);
+    trigram_index_header *Header = GetTrigramIndexHeader(Index);
+    if (!Header || !Header->IsComplete)
+    {
+        if (Index.Data)
+        {
+            PlatformUnmapFile(Index);
+        }
+        return false;
+    }
+
+    text_find *Find = &Search->Workers[0].Find;
+    char *Literal = Find->Query;
+    memory_size LiteralLength = Find->QueryLength;
+    if (Find->IsRegex)
+    {
+        Literal = Find->Regex.Prefix;
+        LiteralLength = Find->Regex.PrefixLength;
+    }
+
+    buffer CandidateMemory = PlatformAllocateMemory(Header->FileCount * sizeof(u32));
+    if (!CandidateMemory.Data)
+    {
+        PlatformUnmapFile(Index);
+        return false;
+    }
+
+    // NOTE(traian): The paths are copied to the path pool, so the index is unmapped right away and never keeps the
+    // next build from replacing it.
+    u32 *Candidates = (u32 *)CandidateMemory.Data;
+    u32 CandidateCount = FindTrigramIndexCandidates(Index, Header, Literal, LiteralLength, Candidates);
+    trigram_index_file *Files = GetTrigramIndexFiles(Index, Header);
+    for (u32 CandidateIndex = 0; CandidateIndex < CandidateCount; ++CandidateIndex)
+    {
+        trigram_index_file *File = Files + Candidates[CandidateIndex];
+        char *Path = GetTrigramIndexFilePath(Index, Header, File);
+        if (!Path || Search->DirectoryLength + 1 + File->PathLength >= PLATFORM_PATH_CAPACITY)
+        {
+            continue;
+        }
+
+        if (AddFindInFilesItem(Search, Search->Directory, Search->DirectoryLength, Path, File->PathLength,
+                               false, File->WriteTime) == UINT32_MAX)
+        {
+            break;
+        }
+    }
+
+    Search->CandidateCount = Minimum(Search->ItemCount, FIND_IN_FILES_ITEM_CAPACITY);
+    Search->NextCandidate = 0;
+    Search->PendingItemCount = Search->CandidateCount;
+    Search->IsUsingIndex = true;
+
+    PlatformReleaseMemory(CandidateMemory);
+    PlatformUnmapFile(Index);
+    return true;
+}
+
+// NOTE(traian): Starts searching every file under the directory for the query. The directory itself is the first
+// item, and the workers walk the rest of the tree while they search the files they already found, so the first
+// results are shown long before the walk is complete. If the directory has a trigram index, only the files it
+// selects are searched and nothing is walked. The results panel must be empty. Returns false if the query isn't
+// valid.
+internal b32
+BeginFindInFiles(find_in_files *Search, platform_work_queue *WorkQueue, u32 WorkerCount, char *Directory,
+                 char *Query, memory_size QueryLength, b32 IsRegex)
+{
+    Assert(!Search->IsActive);
+    PrepareFindInFiles(Search, WorkerCount, Directory);
+    Search->QueryLength = Minimum(QueryLength, sizeof(Search->Query));
+    CopyMem(Search->Query, Query, Search->QueryLength);
+    Search->IsRegex = IsRegex;
+
+    // NOTE(traian): The workers are compiled before any of them starts, so a malformed regex doesn't start
+    // the search at all.
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        text_find *Find = &Search->Workers[WorkerIndex].Find;
+        CopyMem(Find->Query, Search->Query, Search->QueryLength);
+        Find->QueryLength = Search->QueryLength;
+        Find->IsRegex = IsRegex;
+        Find->IsQueryValid = (Find->QueryLength > 0);
+        if (Find->IsQueryValid && IsRegex)
+        {
+            Find->IsQueryValid = CompileRegex(&Find->Regex, Find->Query, Find->QueryLength);
+        }
+        if (!Find->IsQueryValid)
+        {
+            return false;
+        }
+    }
+
+    if (!UseTrigramIndexForFindInFiles(Search))
+    {
+        AddFindInFilesRoot(Search);
+    }
+    StartFindInFilesWorkers(Search, WorkQueue);
+    return true;
+}
+
+// NOTE(traian): Splits a result line into the path of the file, relative to the directory that was searched,
+// and the index of the line. Returns false if the line isn't a result.
+internal b32
+ParseFindInFilesResult(char *Text, memory_size TextLength, memory_size *PathLength, u64 *Line)
+{
+    // NOTE(traian): The path can contain colons, like the one after a drive letter, but it's never followed
+    // by a number and another colon.
+    for (memory_size Index = 0; Index < TextLength; ++Index)
+    {
+        if (Text[Index] != ':')
+        {
+            continue;
+        }
+
+        u64 Number = 0;
+        memory_size DigitIndex = Index + 1;
+        while (DigitIndex < TextLength && '0' <= Text[DigitIndex] && Text[DigitIndex] <= '9')
+        {
+            Number = 10 * Number + (Text[DigitIndex] - '0');
+            ++DigitIndex;
+        }
+
+        if (DigitIndex > Index + 1 && DigitIndex < TextLength && Text[DigitIndex] == ':' && Number > 0)
+        {
+            *PathLength = Index;
+            *Line = Number - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//=========================================================================================
+// NOTE(traian): TRIGRAM INDEX BUILD.
+//=========================================================================================
+
+internal void
+ReleaseTrigramIndexBuildMemory(find_in_files *Search)
+{
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        find_in_files_worker *Worker = Search->Workers + WorkerIndex;
+        for (u32 ChunkIndex = 0; ChunkIndex < Worker->ForwardListChunkCount; ++ChunkIndex)
+        {
+            PlatformReleaseMemory(Worker->ForwardListChunks[ChunkIndex]);
+        }
+        if (Worker->TrigramMemory.Data)
+        {
+            PlatformReleaseMemory(Worker->TrigramMemory);
+        }
+        if (Worker->TrigramBits.Data)
+        {
+            PlatformReleaseMemory(Worker->TrigramBits);
+        }
+
+        Worker->ForwardListChunkCount = 0;
+        Worker->ForwardListChunkUsed = 0;
+        Worker->TrigramMemory = {};
+        Worker->TrigramBits = {};
+        Worker->Trigrams = NULL;
+        Worker->TrigramScratch = NULL;
+        Worker->TrigramCapacity = 0;
+    }
+
+    if (Search->IndexEntryMemory.Data)
+    {
+        PlatformReleaseMemory(Search->IndexEntryMemory);
+    }
+    if (Search->PreviousIndex.Data)
+    {
+        PlatformUnmapFile(Search->PreviousIndex);
+    }
+    Search->IndexEntryMemory = {};
+    Search->IndexEntries = NULL;
+    Search->PreviousIndex = {};
+}
+
+// NOTE(traian): The index is written next to the previous one and then replaces it, so a build that fails never
+// leaves a damaged index behind. A build that was stopped writes the files it reached, which the next build
+// doesn't have to read again.
+internal void
+WriteTrigramIndex(find_in_files *Search)
+{
+    b32 IsComplete = !Search->IsCancelled && !Search->IsTruncated;
+    u32 EntryCount = Minimum(Search->ItemCount, FIND_IN_FILES_ITEM_CAPACITY);
+    buffer Index = BuildTrigramIndex(Search->IndexEntries, EntryCount, IsComplete);
+
+    // NOTE(traian): The previous index is only unmapped now, since the forward lists of the files that didn't
+    // change point into it.
+    if (Search->PreviousIndex.Data)
+    {
+        PlatformUnmapFile(Search->PreviousIndex);
+        Search->PreviousIndex = {};
+    }
+
+    char IndexFileName[PLATFORM_PATH_CAPACITY];
+    char TemporaryFileName[PLATFORM_PATH_CAPACITY];
+    if (GetTrigramIndexFileName(Search->Directory, Search->DirectoryLength, TRIGRAM_INDEX_FILE_NAME, IndexFileName) &&
+        GetTrigramIndexFileName(Search->Directory, Search->DirectoryLength, TRIGRAM_INDEX_TEMPORARY_FILE_NAME,
+                                TemporaryFileName))
+    {
+        if (PlatformWriteEntireFile(TemporaryFileName, Index) != Index.Size ||
+            !PlatformMoveFile(TemporaryFileName, IndexFileName))
+        {
+            // TODO(traian): Logging.
+            PlatformDeleteFile(TemporaryFileName);
+        }
+    }
+
+    PlatformReleaseMemory(Index);
+}
+
+internal PLATFORM_WORK_QUEUE_CALLBACK(WriteTrigramIndexWork)
+{
+    find_in_files *Search = (find_in_files *)Data;
+    WriteTrigramIndex(Search);
+    CompletePreviousWritesBeforeFutureWrites;
+    Search->IsIndexWritten = true;
+}
+
+// NOTE(traian): Builds the trigram index of the directory with the walk of the find in files, reusing the trigrams
+// of the files that didn't change since the previous build. Returns false if the index can't be stored in the
+// directory.
+internal b32
+BeginTrigramIndexBuild(find_in_files *Search, platform_work_queue *WorkQueue, u32 WorkerCount, char *Directory)
+{
+    Assert(!Search->IsActive);
+    PrepareFindInFiles(Search, WorkerCount, Directory);
+
+    // NOTE(traian): The name of the temporary file is the longer one, so the name of the index fits too.
+    char IndexFileName[PLATFORM_PATH_CAPACITY];
+    if (!GetTrigramIndexFileName(Search->Directory, Search->DirectoryLength, TRIGRAM_INDEX_TEMPORARY_FILE_NAME,
+                                 IndexFileName))
+    {
+        return false;
+    }
+    GetTrigramIndexFileName(Search->Directory, Search->DirectoryLength, TRIGRAM_INDEX_FILE_NAME, IndexFileName);
+
+    Search->PreviousIndex = PlatformMapFile(IndexFileName);
+    if (Search->PreviousIndex.Data && !GetTrigramIndexHeader(Search->PreviousIndex))
+    {
+        PlatformUnmapFile(Search->PreviousIndex);
+        Search->PreviousIndex = {};
+    }
+
+    Search->IsBuildingIndex = true;
+    Search->IsWritingIndex = false;
+    Search->IsIndexWritten = false;
+    Search->IndexEntryMemory = PlatformAllocateMemory(FIND_IN_FILES_ITEM_CAPACITY * sizeof(trigram_index_entry));
+    Search->IndexEntries = (trigram_index_entry *)Search->IndexEntryMemory.Data;
+    for (u32 WorkerIndex = 0; WorkerIndex < Search->WorkerCount; ++WorkerIndex)
+    {
+        Search->Workers[WorkerIndex].TrigramBits = PlatformAllocateMemory(TRIGRAM_INDEX_TRIGRAM_CAPACITY / 8);
+    }
+
+    AddFindInFilesRoot(Search);
+    StartFindInFilesWorkers(Search, WorkQueue);
+    return true;
+}
+
+// NOTE(traian): Called by every timer tick. Once the workers stop, the index is written by another work entry, so
+// that the main thread never waits for it. Returns true if the build finished.
+internal b32
+ContinueTrigramIndexBuild(find_in_files *Search, platform_work_queue *WorkQueue)
+{
+    if (!Search->IsActive)
+    {
+        return false;
+    }
+
+    if (!Search->IsWritingIndex)
+    {
+        if (Search->ActiveWorkerCount == 0)
+        {
+            // NOTE(traian): If the queue is full, the index is written by a later tick.
+            CompletePreviousReadsBeforeFutureReads;
+            Search->IsWritingIndex = AddFindInFilesWorkEntry(WorkQueue, WriteTrigramIndexWork, Search);
+        }
+        return false;
+    }
+
+    if (!Search->IsIndexWritten)
+    {
+        return false;
+    }
+
+    CompletePreviousReadsBeforeFutureReads;
+    ReleaseTrigramIndexBuildMemory(Search);
+    Search->IsActive = false;
+    Search->ElapsedSeconds = PlatformGetSecondsElapsed(Search->StartClock, PlatformGetWallClock());
+    return true;
+}
+
+// NOTE(traian): Stops the walk. The files that were indexed so far are still written by the next timer tick.
+internal void
+CancelTrigramIndexBuild(find_in_files *Search)
+{
+    if (Search->IsActive)
+    {
+        Search->IsCancelled = true;
+    }
+}
+
+// NOTE(traian): Stops the walk and waits until the index is written, so that the next build can resume from it.
+internal void
+FinishTrigramIndexBuild(find_in_files *Search)
+{
+    if (!Search->IsActive)
+    {
+        return;
+    }
+
+    Search->IsCancelled = true;
+    while (Search->ActiveWorkerCount > 0)
+    {
+        _mm_pause();
+    }
+    CompletePreviousReadsBeforeFutureReads;
+
+    if (Search->IsWritingIndex)
+    {
+        while (!Search->IsIndexWritten)
+        {
+            _mm_pause();
+        }
+        CompletePreviousReadsBeforeFutureReads;
+    }
+    else
+    {
+        WriteTrigramIndex(Search);
+    }
+
+    ReleaseTrigramIndexBuildMemory(Search);
+    Search->IsActive = false;
+}
+
+#define OCEAN_FIND_IN_FILES_H
+#endif // OCEAN_FIND_IN_FILES_H
@@ -0,0 +1,1303 @@
+/*  =====================================================================
+    $File:   ocean_regex.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_REGEX_H
+
+#include "ocean.h"
+#include "ocean_simd.h"
+
+// NOTE(traian): The regular expressions are matched byte by byte, without backtracking, so the time of a search
+// is linear in the size of the text, regardless of the pattern. The supported syntax is:
+//     literals, '.', [...] and [^...] with ranges, \d \w \s \D \W \S, \t \r and escaped punctuation,
+//     groups (...) and (?:...), alternation |, the repetitions * + ? and their lazy versions *? +? ??,
+//     and the line anchors ^ and $.
+// The classes only list ASCII characters. '.', the negated classes and \D \W \S match any other character as a
+// whole UTF-8 sequence, so a match never ends in the middle of a character.
+// Like in line oriented tools, nothing except a literal new line matches a new line, and a match is chosen as in
+// Perl: the leftmost one and, among the matches that start there, the one that the pattern prefers.
+
+//=========================================================================================
+// NOTE(traian): BYTE SETS.
+//=========================================================================================
+
+internal inline b32
+IsByteInRegexSet(regex_byte_set *Set, u8 Byte)
+{
+    b32 Result = (Set->Bits[Byte >> 5] & (1u << (Byte & 31))) != 0;
+    return Result;
+}
+
+internal inline void
+AddByteRangeToRegexSet(regex_byte_set *Set, u8 First, u8 Last)
+{
+    for (u32 Byte = First; Byte <= Last; ++Byte)
+    {
+        Set->Bits[Byte >> 5] |= (1u << (Byte & 31));
+    }
+}
+
+internal inline b32
+HasAllNonASCIIBytes(regex_byte_set *Set)
+{
+    b32 Result = true;
+    for (u32 Index = 0x80 >> 5; Index < ArrayCount(Set->Bits); ++Index)
+    {
+        Result = Result && (Set->Bits[Index] == 0xFFFFFFFF);
+    }
+    return Result;
+}
+
+internal inline void
+RemoveNonASCIIBytes(regex_byte_set *Set)
+{
+    for (u32 Index = 0x80 >> 5; Index < ArrayCount(Set->Bits); ++Index)
+    {
+        Set->Bits[Index] = 0;
+    }
+}
+
+internal inline void
+InvertRegexSet(regex_byte_set *Set)
+{
+    for (u32 Index = 0; Index < ArrayCount(Set->Bits); ++Index)
+    {
+        Set->Bits[Index] = ~Set->Bits[Index];
+    }
+    Set->Bits['\n' >> 5] &= ~(1u << ('\n' & 31));
+}
+
+//=========================================================================================
+// NOTE(traian): PARSER.
+//=========================================================================================
+
+typedef enum regex_node_kind_enum : u8
+{
+    RegexNode_Empty,
+    RegexNode_Literal,
+    RegexNode_ByteSet,
+    RegexNode_LineStart,
+    RegexNode_LineEnd,
+    RegexNode_Concatenation,
+    RegexNode_Alternation,
+    RegexNode_Repetition,
+}
+regex_node_kind;
+
+struct regex_node
+{
+    regex_node_kind Kind;
+    u8 Byte;
+    // NOTE(traian): The repetitions are '*' (0, unbounded), '+' (1, unbounded) and '?' (0, bounded).
+    u8 MinimumCount;
+    b8 IsUnbounded;
+    b8 IsLazy;
+    u32 ByteSetIndex;
+    u32 Left;
+    u32 Right;
+};
+
+#define REGEX_NODE_CAPACITY 1024
+#define REGEX_GROUP_DEPTH 64
+
+// NOTE(traian): The node 0 is always the empty node.
+#define REGEX_EMPTY_NODE 0
+
+// NOTE(traian): The state of a group while it's being parsed. The repetitions apply to the last atom, which is
+// appended to the sequence once the next atom starts.
+struct regex_group
+{
+    u32 Alternation;
+    u32 Sequence;
+    u32 LastAtom;
+};
+
+struct regex_parser
+{
+    regex *Regex;
+    char *At;
+    char *End;
+    b32 HasError;
+
+    regex_node Nodes[REGEX_NODE_CAPACITY];
+    u32 NodeCount;
+
+    // NOTE(traian): The node that matches any UTF-8 sequence of more than one byte. It's built by the first set
+    // that needs it, and shared by the others.
+    u32 MultiByteNode;
+};
+
+internal u32
+AddRegexNode(regex_parser *Parser, regex_node_kind Kind, u32 Left = 0, u32 Right = 0)
+{
+    if (Parser->NodeCount == REGEX_NODE_CAPACITY)
+    {
+        Parser->HasError = true;
+        return REGEX_EMPTY_NODE;
+    }
+
+    u32 Index = Parser->NodeCount++;
+    regex_node *Node = Parser->Nodes + Index;
+    *Node = {};
+    Node->Kind = Kind;
+    Node->Left = Left;
+    Node->Right = Right;
+    return Index;
+}
+
+internal regex_byte_set *
+AddRegexByteSet(regex_parser *Parser, u32 *ByteSetIndex)
+{
+    regex *Regex = Parser->Regex;
+    if (Regex->ByteSetCount == REGEX_BYTE_SET_CAPACITY)
+    {
+        Parser->HasError = true;
+        *ByteSetIndex = 0;
+        return Regex->ByteSets;
+    }
+
+    *ByteSetIndex = Regex->ByteSetCount++;
+    regex_byte_set *Set = Regex->ByteSets + *ByteSetIndex;
+    *Set = {};
+    return Set;
+}
+
+internal inline u32
+JoinRegexNodes(regex_parser *Parser, u32 Left, u32 Right)
+{
+    if (Left == REGEX_EMPTY_NODE)
+    {
+        return Right;
+    }
+    if (Right == REGEX_EMPTY_NODE)
+    {
+        return Left;
+    }
+    return AddRegexNode(Parser, RegexNode_Concatenation, Left, Right);
+}
+
+internal u32
+AddRegexByteRangeNode(regex_parser *Parser, u8 First, u8 Last)
+{
+    u32 Node = AddRegexNode(Parser, RegexNode_ByteSet);
+    AddByteRangeToRegexSet(AddRegexByteSet(Parser, &Parser->Nodes[Node].ByteSetIndex), First, Last);
+    return Node;
+}
+
+// NOTE(traian): A set that has every non-ASCII byte only keeps its ASCII bytes, and is matched together with the
+// sequences of 2, 3 and 4 bytes, so that it consumes a whole character. The bytes that aren't part of a valid
+// sequence aren't matched.
+internal u32
+AddRegexMultiByteSequences(regex_parser *Parser, u32 SetNode)
+{
+    regex_byte_set *Set = Parser->Regex->ByteSets + Parser->Nodes[SetNode].ByteSetIndex;
+    if (!HasAllNonASCIIBytes(Set))
+    {
+        return SetNode;
+    }
+    RemoveNonASCIIBytes(Set);
+
+    if (Parser->MultiByteNode == REGEX_EMPTY_NODE)
+    {
+        // NOTE(traian): The nodes are compiled once for every reference, so the continuation can be shared.
+        u32 Continuation = AddRegexByteRangeNode(Parser, 0x80, 0xBF);
+        u32 TwoBytes = JoinRegexNodes(Parser, AddRegexByteRangeNode(Parser, 0xC2, 0xDF), Continuation);
+        u32 ThreeBytes = JoinRegexNodes(Parser, AddRegexByteRangeNode(Parser, 0xE0, 0xEF),
+                                        JoinRegexNodes(Parser, Continuation, Continuation));
+        u32 FourBytes = JoinRegexNodes(Parser, AddRegexByteRangeNode(Parser, 0xF0, 0xF4),
+                                       JoinRegexNodes(Parser, Continuation,
+                                                      JoinRegexNodes(Parser, Continuation, Continuation)));
+        Parser->MultiByteNode = AddRegexNode(Parser, RegexNode_Alternation,
+                                             AddRegexNode(Parser, RegexNode_Alternation, TwoBytes, ThreeBytes),
+                                             FourBytes);
+    }
+
+    return AddRegexNode(Parser, RegexNode_Alternation, SetNode, Parser->MultiByteNode);
+}
+
+internal inline b32
+IsRegexAlphanumeric(u8 Byte)
+{
+    b32 Result = ('a' <= Byte && Byte <= 'z') || ('A' <= Byte && Byte <= 'Z') || ('0' <= Byte && Byte <= '9');
+    return Result;
+}
+
+// NOTE(traian): Parses the escape that follows a backslash. The classes are added to the set, while a single
+// byte is returned through Byte, in which case the function returns true.
+internal b32
+ParseRegexEscape(regex_parser *Parser, regex_byte_set *Set, u8 *Byte)
+{
+    if (Parser->At == Parser->End)
+    {
+        Parser->HasError = true;
+        return false;
+    }
+
+    u8 Escape = (u8)*Parser->At++;
+    regex_byte_set Class = {};
+    switch (Escape)
+    {
+        case 'd': case 'D':
+        {
+            AddByteRangeToRegexSet(&Class, '0', '9');
+        } break;
+
+        case 'w': case 'W':
+        {
+            AddByteRangeToRegexSet(&Class, 'a', 'z');
+            AddByteRangeToRegexSet(&Class, 'A', 'Z');
+            AddByteRangeToRegexSet(&Class, '0', '9');
+            AddByteRangeToRegexSet(&Class, '_', '_');
+        } break;
+
+        case 's': case 'S':
+        {
+            AddByteRangeToRegexSet(&Class, ' ', ' ');
+            AddByteRangeToRegexSet(&Class, '\t', '\t');
+            AddByteRangeToRegexSet(&Class, '\r', '\r');
+            AddByteRangeToRegexSet(&Class, '\v', '\f');
+        } break;
+
+        case 't':
+        {
+            *Byte = '\t';
+            return true;
+        }
+
+        case 'r':
+        {
+            *Byte = '\r';
+            return true;
+        }
+
+        default:
+        {
+            // NOTE(traian): The other letters and digits are reserved for future escapes.
+            if (IsRegexAlphanumeric(Escape))
+            {
+                Parser->HasError = true;
+            }
+            *Byte = Escape;
+            return true;
+        }
+    }
+
+    if (Escape == 'D' || Escape == 'W' || Escape == 'S')
+    {
+        InvertRegexSet(&Class);
+    }
+    for (u32 Index = 0; Index < ArrayCount(Set->Bits); ++Index)
+    {
+        Set->Bits[Index] |= Class.Bits[Index];
+    }
+    return false;
+}
+
+// NOTE(traian): Parses a bracketed class, right after its opening bracket.
+internal u32
+ParseRegexClass(regex_parser *Parser)
+{
+    u32 Node = AddRegexNode(Parser, RegexNode_ByteSet);
+    regex_byte_set *Set = AddRegexByteSet(Parser, &Parser->Nodes[Node].ByteSetIndex);
+
+    b32 IsNegated = false;
+    if (Parser->At < Parser->End && *Parser->At == '^')
+    {
+        IsNegated = true;
+        ++Parser->At;
+    }
+
+    b32 IsFirst = true;
+    while (true)
+    {
+        if (Parser->At == Parser->End)
+        {
+            Parser->HasError = true;
+            break;
+        }
+
+        u8 Byte = (u8)*Parser->At++;
+        if (Byte == ']' && !IsFirst)
+        {
+            break;
+        }
+        IsFirst = false;
+
+        if (Byte == '\\' && !ParseRegexEscape(Parser, Set, &Byte))
+        {
+            continue;
+        }
+
+        u8 Last = Byte;
+        if (Parser->At + 1 < Parser->End && Parser->At[0] == '-' && Parser->At[1] != ']')
+        {
+            Parser->At += 1;
+            Last = (u8)*Parser->At++;
+            if (Last == '\\' && !ParseRegexEscape(Parser, Set, &Last))
+            {
+                // NOTE(traian): A class can't be the end of a range.
+                Parser->HasError = true;
+            }
+            if (Last < Byte)
+            {
+                Parser->HasError = true;
+                Last = Byte;
+            }
+        }
+        AddByteRangeToRegexSet(Set, Byte, Last);
+    }
+
+    // NOTE(traian): The non-ASCII bytes of a class are parts of characters, so a negated class matches every
+    // non-ASCII character instead of the bytes that are left, unless the class already had all of them (\W).
+    if (IsNegated)
+    {
+        b32 HadNonASCIICharacters = HasAllNonASCIIBytes(Set);
+        RemoveNonASCIIBytes(Set);
+        InvertRegexSet(Set);
+        if (HadNonASCIICharacters)
+        {
+            RemoveNonASCIIBytes(Set);
+        }
+    }
+    return AddRegexMultiByteSequences(Parser, Node);
+}
+
+// NOTE(traian): The groups are parsed with an explicit stack, instead of recursively, so a deeply nested pattern
+// is rejected instead of overflowing the call stack.
+internal u32
+ParseRegex(regex_parser *Parser)
+{
+    regex_group Groups[REGEX_GROUP_DEPTH];
+    u32 GroupCount = 1;
+    Groups[0].Alternation = UINT32_MAX;
+    Groups[0].Sequence = REGEX_EMPTY_NODE;
+    Groups[0].LastAtom = REGEX_EMPTY_NODE;
+
+    while (Parser->At < Parser->End && !Parser->HasError)
+    {
+        regex_group *Group = Groups + GroupCount - 1;
+        u8 Byte = (u8)*Parser->At++;
+
+        u32 Atom = UINT32_MAX;
+        switch (Byte)
+        {
+            case '(':
+            {
+                if (GroupCount == REGEX_GROUP_DEPTH)
+                {
+                    Parser->HasError = true;
+                    break;
+                }
+                if (Parser->At + 1 < Parser->End && Parser->At[0] == '?' && Parser->At[1] == ':')
+                {
+                    Parser->At += 2;
+                }
+
+                Group->Sequence = JoinRegexNodes(Parser, Group->Sequence, Group->LastAtom);
+                Group->LastAtom = REGEX_EMPTY_NODE;
+
+                regex_group *NewGroup = Groups + GroupCount++;
+                NewGroup->Alternation = UINT32_MAX;
+                NewGroup->Sequence = REGEX_EMPTY_NODE;
+                NewGroup->LastAtom = REGEX_EMPTY_NODE;
+            } break;
+
+            case ')':
+            case '|':
+            {
+                u32 Branch = JoinRegexNodes(Parser, Group->Sequence, Group->LastAtom);
+                if (Group->Alternation != UINT32_MAX)
+                {
+                    Branch = AddRegexNode(Parser, RegexNode_Alternation, Group->Alternation, Branch);
+                }
+
+                if (Byte == '|')
+                {
+                    Group->Alternation = Branch;
+                    Group->Sequence = REGEX_EMPTY_NODE;
+                    Group->LastAtom = REGEX_EMPTY_NODE;
+                }
+                else if (GroupCount == 1)
+                {
+                    Parser->HasError = true;
+                }
+                else
+                {
+                    --GroupCount;
+                    Atom = Branch;
+                }
+            } break;
+
+            case '*':
+            case '+':
+            case '?':
+            {
+                if (Group->LastAtom == REGEX_EMPTY_NODE)
+                {
+                    Parser->HasError = true;
+                    break;
+                }
+
+                u32 Repetition = AddRegexNode(Parser, RegexNode_Repetition, Group->LastAtom);
+                regex_node *Node = Parser->Nodes + Repetition;
+                Node->MinimumCount = (Byte == '+') ? 1 : 0;
+                Node->IsUnbounded = (Byte != '?');
+                if (Parser->At < Parser->End && *Parser->At == '?')
+                {
+                    Node->IsLazy = true;
+                    ++Parser->At;
+                }
+                Group->LastAtom = Repetition;
+            } break;
+
+            case '[':
+            {
+                Atom = ParseRegexClass(Parser);
+            } break;
+
+            case '.':
+            {
+                Atom = AddRegexNode(Parser, RegexNode_ByteSet);
+                regex_byte_set *Set = AddRegexByteSet(Parser, &Parser->Nodes[Atom].ByteSetIndex);
+                InvertRegexSet(Set);
+                Atom = AddRegexMultiByteSequences(Parser, Atom);
+            } break;
+
+            case '^':
+            {
+                Atom = AddRegexNode(Parser, RegexNode_LineStart);
+            } break;
+
+            case '$':
+            {
+                Atom = AddRegexNode(Parser, RegexNode_LineEnd);
+            } break;
+
+            case '\\':
+            {
+                regex_byte_set Class = {};
+                if (ParseRegexEscape(Parser, &Class, &Byte))
+                {
+                    Atom = AddRegexNode(Parser, RegexNode_Literal);
+                    Parser->Nodes[Atom].Byte = Byte;
+                }
+                else
+                {
+                    Atom = AddRegexNode(Parser, RegexNode_ByteSet);
+                    *AddRegexByteSet(Parser, &Parser->Nodes[Atom].ByteSetIndex) = Class;
+                    Atom = AddRegexMultiByteSequences(Parser, Atom);
+                }
+            } break;
+
+            default:
+            {
+                Atom = AddRegexNode(Parser, RegexNode_Literal);
+                Parser->Nodes[Atom].Byte = Byte;
+            } break;
+        }
+
+        if (Atom != UINT32_MAX)
+        {
+            // NOTE(traian): A closed group is appended to its parent, which is on top of the stack now.
+            Group = Groups + GroupCount - 1;
+            Group->Sequence = JoinRegexNodes(Parser, Group->Sequence, Group->LastAtom);
+            Group->LastAtom = Atom;
+        }
+    }
+
+    if (GroupCount != 1)
+    {
+        Parser->HasError = true;
+    }
+
+    regex_group *Group = Groups;
+    u32 Result = JoinRegexNodes(Parser, Group->Sequence, Group->LastAtom);
+    if (Group->Alternation != UINT32_MAX)
+    {
+        Result = AddRegexNode(Parser, RegexNode_Alternation, Group->Alternation, Result);
+    }
+    return Result;
+}
+
+// NOTE(traian): Appends the literal bytes that every match starts with. Returns false once the prefix can't
+// be extended any further.
+internal b32
+AppendRegexPrefix(regex *Regex, regex_node *Nodes, u32 NodeIndex)
+{
+    regex_node *Node = Nodes + NodeIndex;
+    switch (Node->Kind)
+    {
+        case RegexNode_Literal:
+        {
+            Regex->Prefix[Regex->PrefixLength++] = (char)Node->Byte;
+            return true;
+        }
+
+        case RegexNode_LineStart:
+        {
+            return true;
+        }
+
+        case RegexNode_Concatenation:
+        {
+            return AppendRegexPrefix(Regex, Nodes, Node->Left) && AppendRegexPrefix(Regex, Nodes, Node->Right);
+        }
+    }
+
+    return false;
+}
+
+//=========================================================================================
+// NOTE(traian): COMPILER.
+//=========================================================================================
+
+internal u32
+EmitRegexInstruction(regex_program *Program, regex_instruction_kind Kind, u32 Out, b32 *HasError)
+{
+    if (Program->InstructionCount == REGEX_INSTRUCTION_CAPACITY)
+    {
+        *HasError = true;
+        return 0;
+    }
+
+    u32 Index = Program->InstructionCount++;
+    regex_instruction *Instruction = Program->Instructions + Index;
+    Instruction->Kind = Kind;
+    Instruction->ByteSetIndex = 0;
+    Instruction->Out = Out;
+    Instruction->Out1 = Out;
+    return Index;
+}
+
+// NOTE(traian): Compiles the node so that it continues to the given instruction, and returns the instruction
+// where it starts. The reversed program matches the reversed text, so its concatenations are compiled in the
+// opposite order and its line anchors look in the opposite direction.
+internal u32
+CompileRegexNode(regex *Regex, regex_program *Program, regex_node *Nodes, u32 NodeIndex, u32 Next,
+                 b32 IsReversed, u32 *LiteralSets, b32 *HasError)
+{
+    if (*HasError)
+    {
+        return Next;
+    }
+
+    regex_node *Node = Nodes + NodeIndex;
+    switch (Node->Kind)
+    {
+        case RegexNode_Empty:
+        {
+            return Next;
+        }
+
+        case RegexNode_Literal:
+        case RegexNode_ByteSet:
+        {
+            u32 ByteSetIndex = Node->ByteSetIndex;
+            if (Node->Kind == RegexNode_Literal)
+            {
+                // NOTE(traian): The literals share a set per byte, so that they don't exhaust the sets.
+                if (LiteralSets[Node->Byte] == UINT32_MAX)
+                {
+                    if (Regex->ByteSetCount == REGEX_BYTE_SET_CAPACITY)
+                    {
+                        *HasError = true;
+                        return Next;
+                    }
+
+                    LiteralSets[Node->Byte] = Regex->ByteSetCount++;
+                    regex_byte_set *Set = Regex->ByteSets + LiteralSets[Node->Byte];
+                    *Set = {};
+                    AddByteRangeToRegexSet(Set, Node->Byte, Node->Byte);
+                }
+                ByteSetIndex = LiteralSets[Node->Byte];
+            }
+
+            u32 Result = EmitRegexInstruction(Program, RegexInstruction_ByteSet, Next, HasError);
+            Program->Instructions[Result].ByteSetIndex = ByteSetIndex;
+            return Result;
+        }
+
+        case RegexNode_LineStart:
+        case RegexNode_LineEnd:
+        {
+            b32 LooksBehind = (Node->Kind == RegexNode_LineStart) != (IsReversed != 0);
+            return EmitRegexInstruction(Program,
+                                        LooksBehind ? RegexInstruction_AssertPreviousNewLine
+                                                    : RegexInstruction_AssertNextNewLine,
+                                        Next, HasError);
+        }
+
+        case RegexNode_Concatenation:
+        {
+            u32 First = IsReversed ? Node->Right : Node->Left;
+            u32 Second = IsReversed ? Node->Left : Node->Right;
+            u32 SecondStart = CompileRegexNode(Regex, Program, Nodes, Second, Next, IsReversed,
+                                               LiteralSets, HasError);
+            return CompileRegexNode(Regex, Program, Nodes, First, SecondStart, IsReversed,
+                                    LiteralSets, HasError);
+        }
+
+        case RegexNode_Alternation:
+        {
+            u32 LeftStart = CompileRegexNode(Regex, Program, Nodes, Node->Left, Next, IsReversed,
+                                             LiteralSets, HasError);
+            u32 RightStart = CompileRegexNode(Regex, Program, Nodes, Node->Right, Next, IsReversed,
+                                              LiteralSets, HasError);
+            u32 Result = EmitRegexInstruction(Program, RegexInstruction_Split, LeftStart, HasError);
+            Program->Instructions[Result].Out1 = RightStart;
+            return Result;
+        }
+
+        case RegexNode_Repetition:
+        {
+            // NOTE(traian): The split decides between another iteration and leaving. A greedy repetition prefers
+            // another iteration, while a lazy one prefers to leave.
+            u32 Split = EmitRegexInstruction(Program, RegexInstruction_Split, Next, HasError);
+            u32 LoopTarget = Node->IsUnbounded ? Split : Next;
+            u32 BodyStart = CompileRegexNode(Regex, Program, Nodes, Node->Left, LoopTarget, IsReversed,
+                                             LiteralSets, HasError);
+            if (*HasError)
+            {
+                return Next;
+            }
+
+            regex_instruction *Instruction = Program->Instructions + Split;
+            Instruction->Out = Node->IsLazy ? Next : BodyStart;
+            Instruction->Out1 = Node->IsLazy ? BodyStart : Next;
+            return (Node->MinimumCount == 1) ? BodyStart : Split;
+        }
+    }
+
+    return Next;
+}
+
+internal b32
+CompileRegexProgram(regex *Regex, regex_program *Program, regex_node *Nodes, u32 Root, b32 IsReversed,
+                    u32 *LiteralSets)
+{
+    b32 HasError = false;
+    Program->InstructionCount = 0;
+    u32 Match = EmitRegexInstruction(Program, RegexInstruction_Match, 0, &HasError);
+    Program->Start = CompileRegexNode(Regex, Program, Nodes, Root, Match, IsReversed, LiteralSets, &HasError);
+    return !HasError;
+}
+
+// NOTE(traian): Splits the bytes into the classes that none of the sets of the pattern tell apart. The new line
+// always has its own class, since the line anchors look at it.
+internal void
+ComputeRegexByteClasses(regex *Regex)
+{
+    u8 Classes[256] = {};
+    u32 ClassCount = 1;
+
+    for (u32 SetIndex = 0; SetIndex <= Regex->ByteSetCount; ++SetIndex)
+    {
+        regex_byte_set NewLineSet = {};
+        AddByteRangeToRegexSet(&NewLineSet, '\n', '\n');
+        regex_byte_set *Set = (SetIndex < Regex->ByteSetCount) ? Regex->ByteSets + SetIndex : &NewLineSet;
+
+        u16 Refinement[2 * 256];
+        SetMemory(Refinement, 0xFF, sizeof(Refinement));
+        u32 NewClassCount = 0;
+        for (u32 Byte = 0; Byte < 256; ++Byte)
+        {
+            u32 Key = 2 * Classes[Byte] + (IsByteInRegexSet(Set, (u8)Byte) ? 1 : 0);
+            if (Refinement[Key] == 0xFFFF)
+            {
+                Refinement[Key] = (u16)NewClassCount++;
+            }
+            Classes[Byte] = (u8)Refinement[Key];
+        }
+        ClassCount = NewClassCount;
+    }
+
+    for (u32 Byte = 256; Byte > 0; --Byte)
+    {
+        Regex->ClassRepresentatives[Classes[Byte - 1]] = (u8)(Byte - 1);
+    }
+    CopyArray(Regex->ByteClasses, Classes, 256);
+    Regex->ClassCount = ClassCount;
+}
+
+//=========================================================================================
+// NOTE(traian): LAZY DFA.
+//=========================================================================================
+
+#define REGEX_DEAD_STATE 0
+#define REGEX_UNKNOWN_STATE 0xFFFFFFFF
+
+// NOTE(traian): The byte before the position of the state was a new line (or the state is at the start of the text).
+#define REGEX_STATE_PREVIOUS_NEW_LINE Bit(0)
+// NOTE(traian): A match ended right before the last byte that was consumed.
+#define REGEX_STATE_MATCH Bit(1)
+// NOTE(traian): The unanchored search still starts new threads. It stops after the first match.
+#define REGEX_STATE_SEARCHING Bit(2)
+#define REGEX_STATE_KEY (REGEX_STATE_PREVIOUS_NEW_LINE | REGEX_STATE_MATCH | REGEX_STATE_SEARCHING)
+#define REGEX_STATE_DEAD Bit(3)
+// NOTE(traian): A start state of a forward DFA with a prefix, where the search skips to the next occurrence of
+// the prefix.
+#define REGEX_STATE_START Bit(4)
+// NOTE(traian): The flags that the scan loops have to stop at.
+#define REGEX_STATE_SPECIAL (REGEX_STATE_MATCH | REGEX_STATE_DEAD | REGEX_STATE_START)
+
+// NOTE(traian): A transition stores the offset of the row of the next state, instead of its index, so the scan
+// loops don't multiply on every byte. The transitions to the special states are tagged, so the loops only have
+// to look at the flags of a state when the tag is set. The unknown transitions are tagged as well.
+#define REGEX_TRANSITION_SPECIAL 0x80000000u
+
+internal inline u32
+EncodeRegexTransition(regex_dfa *DFA, u32 State)
+{
+    u32 Result = State * DFA->Stride;
+    if (DFA->StateFlags[State] & REGEX_STATE_SPECIAL)
+    {
+        Result |= REGEX_TRANSITION_SPECIAL;
+    }
+    return Result;
+}
+
+internal inline u32
+DecodeRegexTransition(regex_dfa *DFA, u32 Transition)
+{
+    u32 Result = (Transition & ~REGEX_TRANSITION_SPECIAL) / DFA->Stride;
+    return Result;
+}
+
+internal void
+FlushRegexDFA(regex_dfa *DFA)
+{
+    SetMemory(DFA->HashSlots, 0xFF, 2 * DFA->StateCapacity * sizeof(u32));
+    DFA->StateCount = 1;
+    DFA->SetEntryCount = 0;
+    DFA->StartStates[0] = REGEX_UNKNOWN_STATE;
+    DFA->StartStates[1] = REGEX_UNKNOWN_STATE;
+
+    DFA->StateFlags[REGEX_DEAD_STATE] = REGEX_STATE_DEAD;
+    DFA->StateSetOffsets[REGEX_DEAD_STATE] = 0;
+    DFA->StateSetCounts[REGEX_DEAD_STATE] = 0;
+    for (u32 Class = 0; Class < DFA->Stride; ++Class)
+    {
+        DFA->Transitions[Class] = EncodeRegexTransition(DFA, REGEX_DEAD_STATE);
+    }
+}
+
+internal inline u32
+HashRegexState(u32 *Set, u32 Count, u8 Flags)
+{
+    u32 Hash = 2166136261u ^ Flags;
+    for (u32 Index = 0; Index < Count; ++Index)
+    {
+        Hash = (Hash ^ Set[Index]) * 16777619u;
+    }
+    return Hash;
+}
+
+// NOTE(traian): Returns REGEX_UNKNOWN_STATE if the cache is full.
+internal u32
+FindOrAddRegexState(regex_dfa *DFA, u32 *Set, u32 Count, u8 Flags)
+{
+    u32 SlotMask = 2 * DFA->StateCapacity - 1;
+    u32 Slot = HashRegexState(Set, Count, Flags) & SlotMask;
+    while (DFA->HashSlots[Slot] != REGEX_UNKNOWN_STATE)
+    {
+        u32 State = DFA->HashSlots[Slot];
+        if ((DFA->StateFlags[State] & REGEX_STATE_KEY) == Flags && DFA->StateSetCounts[State] == Count)
+        {
+            u32 *StateSet = DFA->SetEntries + DFA->StateSetOffsets[State];
+            u32 Index = 0;
+            while (Index < Count && StateSet[Index] == Set[Index])
+            {
+                ++Index;
+            }
+            if (Index == Count)
+            {
+                return State;
+            }
+        }
+        Slot = (Slot + 1) & SlotMask;
+    }
+
+    if (DFA->StateCount == DFA->StateCapacity || DFA->SetEntryCount + Count > DFA->SetEntryCapacity)
+    {
+        return REGEX_UNKNOWN_STATE;
+    }
+
+    u32 State = DFA->StateCount++;
+    DFA->StateFlags[State] = Flags;
+    DFA->StateSetOffsets[State] = DFA->SetEntryCount;
+    DFA->StateSetCounts[State] = Count;
+    CopyArray(DFA->SetEntries + DFA->SetEntryCount, Set, Count);
+    DFA->SetEntryCount += Count;
+    SetMemory(DFA->Transitions + State * DFA->Stride, 0xFF, DFA->Stride * sizeof(u32));
+
+    DFA->HashSlots[Slot] = State;
+    return State;
+}
+
+// NOTE(traian): Adds the instructions that are reachable from the given one without consuming a byte, in the
+// order in which the pattern prefers them. The splits and the satisfied look-behind assertions are followed,
+// while the other instructions are added to the set.
+internal void
+AddRegexClosure(regex *Regex, regex_program *Program, u32 Instruction, b32 PreviousIsNewLine,
+                u32 *Set, u32 *Count)
+{
+    u32 *Stack = Regex->ClosureStack;
+    u32 StackCount = 0;
+    Stack[StackCount++] = Instruction;
+
+    while (StackCount > 0)
+    {
+        u32 Index = Stack[--StackCount];
+        if (Regex->ClosureMarks[Index] == Regex->MarkGeneration)
+        {
+            continue;
+        }
+        Regex->ClosureMarks[Index] = Regex->MarkGeneration;
+
+        regex_instruction *Current = Program->Instructions + Index;
+        switch (Current->Kind)
+        {
+            case RegexInstruction_Split:
+            {
+                Stack[StackCount++] = Current->Out1;
+                Stack[StackCount++] = Current->Out;
+            } break;
+
+            case RegexInstruction_AssertPreviousNewLine:
+            {
+                if (PreviousIsNewLine)
+                {
+                    Stack[StackCount++] = Current->Out;
+                }
+            } break;
+
+            default:
+            {
+                Set[(*Count)++] = Index;
+            } break;
+        }
+    }
+}
+
+// NOTE(traian): The start states are added right after every flush, before any transition can lead to them, so
+// the transitions to the start states are always tagged. The set of a start state can't overflow the cache,
+// since it was just flushed.
+internal void
+AddRegexStartStates(regex *Regex, regex_dfa *DFA)
+{
+    for (u32 PreviousIsNewLine = 0; PreviousIsNewLine < 2; ++PreviousIsNewLine)
+    {
+        ++Regex->MarkGeneration;
+        u32 Count = 0;
+        AddRegexClosure(Regex, DFA->Program, DFA->Program->Start, PreviousIsNewLine, Regex->NextSet, &Count);
+
+        u32 State = REGEX_DEAD_STATE;
+        if (Count > 0 || DFA->IsUnanchored)
+        {
+            u8 Flags = (PreviousIsNewLine ? REGEX_STATE_PREVIOUS_NEW_LINE : 0) |
+                       (DFA->IsUnanchored ? REGEX_STATE_SEARCHING : 0);
+            State = FindOrAddRegexState(DFA, Regex->NextSet, Count, Flags);
+            Assert(State != REGEX_UNKNOWN_STATE);
+
+            if (DFA->IsUnanchored && Regex->PrefixLength > 0)
+            {
+                DFA->StateFlags[State] |= REGEX_STATE_START;
+            }
+        }
+        DFA->StartStates[PreviousIsNewLine] = State;
+    }
+}
+
+internal inline u32
+GetRegexStartState(regex_dfa *DFA, b32 PreviousIsNewLine)
+{
+    u32 Result = DFA->StartStates[PreviousIsNewLine ? 1 : 0];
+    return Result;
+}
+
+// NOTE(traian): Computes the transition of the state on a class of bytes, or on the end of the text for the class
+// that follows the last one. If the cache has to be flushed, the state is added back and updated.
+internal u32
+ComputeRegexTransition(regex *Regex, regex_dfa *DFA, u32 *State, u32 Class)
+{
+    regex_program *Program = DFA->Program;
+    b32 IsEndOfText = (Class == Regex->ClassCount);
+    u8 Byte = IsEndOfText ? 0 : Regex->ClassRepresentatives[Class];
+    b32 NextIsNewLine = IsEndOfText || (Byte == '\n');
+
+    u8 Flags = DFA->StateFlags[*State];
+    u32 *CurrentSet = DFA->SetEntries + DFA->StateSetOffsets[*State];
+    u32 CurrentCount = DFA->StateSetCounts[*State];
+
+    ++Regex->MarkGeneration;
+    u32 NextCount = 0;
+    b32 IsMatch = false;
+    b32 IsSearching = (Flags & REGEX_STATE_SEARCHING) && !IsEndOfText;
+
+    // NOTE(traian): The instructions are visited in the order of preference, and the look-ahead assertions are
+    // followed on the spot, since the next byte is known now.
+    u32 *Stack = Regex->CurrentStack;
+    u32 StackCount = 0;
+    for (u32 Index = CurrentCount; Index > 0; --Index)
+    {
+        Stack[StackCount++] = CurrentSet[Index - 1];
+    }
+
+    while (StackCount > 0)
+    {
+        u32 Index = Stack[--StackCount];
+        if (Regex->CurrentMarks[Index] == Regex->MarkGeneration)
+        {
+            continue;
+        }
+        Regex->CurrentMarks[Index] = Regex->MarkGeneration;
+
+        regex_instruction *Current = Program->Instructions + Index;
+        switch (Current->Kind)
+        {
+            case RegexInstruction_ByteSet:
+            {
+                if (!IsEndOfText && IsByteInRegexSet(Regex->ByteSets + Current->ByteSetIndex, Byte))
+                {
+                    AddRegexClosure(Regex, Program, Current->Out, Byte == '\n', Regex->NextSet, &NextCount);
+                }
+            } break;
+
+            case RegexInstruction_Split:
+            {
+                Stack[StackCount++] = Current->Out1;
+                Stack[StackCount++] = Current->Out;
+            } break;
+
+            case RegexInstruction_AssertPreviousNewLine:
+            {
+                if (Flags & REGEX_STATE_PREVIOUS_NEW_LINE)
+                {
+                    Stack[StackCount++] = Current->Out;
+                }
+            } break;
+
+            case RegexInstruction_AssertNextNewLine:
+            {
+                if (NextIsNewLine)
+                {
+                    Stack[StackCount++] = Current->Out;
+                }
+            } break;
+
+            case RegexInstruction_Match:
+            {
+                IsMatch = true;
+                if (DFA->IsLeftmostFirst)
+                {
+                    // NOTE(traian): The threads that the pattern prefers less than the match are dropped, including
+                    // the threads that would start later.
+                    StackCount = 0;
+                    IsSearching = false;
+                }
+            } break;
+        }
+    }
+
+    if (IsSearching)
+    {
+        AddRegexClosure(Regex, Program, Program->Start, Byte == '\n', Regex->NextSet, &NextCount);
+    }
+
+    u32 Next = REGEX_DEAD_STATE;
+    if (NextCount > 0 || IsMatch || IsSearching)
+    {
+        u8 NextFlags = ((Byte == '\n') ? REGEX_STATE_PREVIOUS_NEW_LINE : 0) |
+                       (IsMatch ? REGEX_STATE_MATCH : 0) |
+                       (IsSearching ? REGEX_STATE_SEARCHING : 0);
+        Next = FindOrAddRegexState(DFA, Regex->NextSet, NextCount, NextFlags);
+        if (Next == REGEX_UNKNOWN_STATE)
+        {
+            // NOTE(traian): The set of the current state is copied out, since the flush discards it.
+            CopyArray(Regex->CurrentSet, CurrentSet, CurrentCount);
+            FlushRegexDFA(DFA);
+            ++DFA->FlushCount;
+
+            *State = FindOrAddRegexState(DFA, Regex->CurrentSet, CurrentCount, Flags & REGEX_STATE_KEY);
+            Next = FindOrAddRegexState(DFA, Regex->NextSet, NextCount, NextFlags);
+            AddRegexStartStates(Regex, DFA);
+            Assert(*State != REGEX_UNKNOWN_STATE && Next != REGEX_UNKNOWN_STATE);
+        }
+    }
+
+    DFA->Transitions[*State * DFA->Stride + Class] = EncodeRegexTransition(DFA, Next);
+    return Next;
+}
+
+//=========================================================================================
+// NOTE(traian): SCANNING.
+//=========================================================================================
+
+// NOTE(traian): Feeds the bytes to the forward DFA, in order. The offset where the last match that was seen ends
+// is stored in MatchEnd. Returns the number of bytes that were consumed, which is smaller than the count only if
+// the DFA died, in which case the search is over.
+internal memory_size
+ScanRegexForward(regex *Regex, u32 *State, u8 *Bytes, memory_size Count, memory_offset BaseOffset,
+                 memory_offset *MatchEnd)
+{
+    regex_dfa *DFA = &Regex->ForwardDFA;
+    u8 *ByteClasses = Regex->ByteClasses;
+    u32 Current = *State;
+    memory_size Index = 0;
+
+    while (Index < Count)
+    {
+        if (DFA->StateFlags[Current] & REGEX_STATE_START)
+        {
+            // NOTE(traian): No thread is live, so the search skips to the next occurrence of the prefix. An occurrence
+            // that continues past the bytes is left to the DFA.
+            memory_size Remaining = Count - Index;
+            memory_size Skip = FindLiteral((char *)Bytes + Index, Remaining, Regex->Prefix, Regex->PrefixLength);
+            if (Skip == Remaining)
+            {
+                Skip = Remaining - Minimum(Remaining, Regex->PrefixLength - 1);
+            }
+
+            if (Skip > 0)
+            {
+                Index += Skip;
+                Current = GetRegexStartState(DFA, Bytes[Index - 1] == '\n');
+                if (Index == Count)
+                {
+                    break;
+                }
+            }
+        }
+
+        // NOTE(traian): The transitions are followed by their row offsets until one of them is tagged.
+        u32 Row = Current * DFA->Stride;
+        for (; Index < Count; ++Index)
+        {
+            u32 Class = ByteClasses[Bytes[Index]];
+            u32 Transition = DFA->Transitions[Row + Class];
+            if (!(Transition & REGEX_TRANSITION_SPECIAL))
+            {
+                Row = Transition;
+                continue;
+            }
+
+            Current = Row / DFA->Stride;
+            Current = (Transition == REGEX_UNKNOWN_STATE) ? ComputeRegexTransition(Regex, DFA, &Current, Class)
+                                                          : DecodeRegexTransition(DFA, Transition);
+            Row = Current * DFA->Stride;
+
+            u8 Flags = DFA->StateFlags[Current];
+            if (Flags & REGEX_STATE_MATCH)
+            {
+                *MatchEnd = BaseOffset + Index;
+            }
+            if (Flags & REGEX_STATE_DEAD)
+            {
+                *State = Current;
+                return Index + 1;
+            }
+            if (Flags & REGEX_STATE_START)
+            {
+                ++Index;
+                break;
+            }
+        }
+        Current = Row / DFA->Stride;
+    }
+
+    *State = Current;
+    return Index;
+}
+
+// NOTE(traian): Feeds the bytes to the reverse DFA, from the last one to the first one. The offset where the last
+// match that was seen starts is stored in MatchStart. Returns the number of bytes that were consumed.
+internal memory_size
+ScanRegexBackward(regex *Regex, u32 *State, u8 *Bytes, memory_size Count, memory_offset BaseOffset,
+                  memory_offset *MatchStart)
+{
+    regex_dfa *DFA = &Regex->ReverseDFA;
+    u8 *ByteClasses = Regex->ByteClasses;
+    u32 Row = *State * DFA->Stride;
+
+    for (memory_size Index = Count; Index > 0; --Index)
+    {
+        u32 Class = ByteClasses[Bytes[Index - 1]];
+        u32 Transition = DFA->Transitions[Row + Class];
+        if (!(Transition & REGEX_TRANSITION_SPECIAL))
+        {
+            Row = Transition;
+            continue;
+        }
+
+        u32 Current = Row / DFA->Stride;
+        Current = (Transition == REGEX_UNKNOWN_STATE) ? ComputeRegexTransition(Regex, DFA, &Current, Class)
+                                                      : DecodeRegexTransition(DFA, Transition);
+        Row = Current * DFA->Stride;
+
+        u8 Flags = DFA->StateFlags[Current];
+        if (Flags & REGEX_STATE_MATCH)
+        {
+            *MatchStart = BaseOffset + Index;
+        }
+        if (Flags & REGEX_STATE_DEAD)
+        {
+            *State = Current;
+            return Count - Index + 1;
+        }
+    }
+
+    *State = Row / DFA->Stride;
+    return Count;
+}
+
+// NOTE(traian): Looks at the byte right past the scanned range (or at the end of the text, if the byte is
+// negative), which tells if a match ends exactly at the boundary of the range.
+internal b32
+IsRegexMatchAtBoundary(regex *Regex, regex_dfa *DFA, u32 State, s32 Byte)
+{
+    if (State == REGEX_DEAD_STATE)
+    {
+        return false;
+    }
+
+    u32 Class = (Byte < 0) ? Regex->ClassCount : Regex->ByteClasses[Byte];
+    u32 Transition = DFA->Transitions[State * DFA->Stride + Class];
+    u32 Next = (Transition == REGEX_UNKNOWN_STATE) ? ComputeRegexTransition(Regex, DFA, &State, Class)
+                                                   : DecodeRegexTransition(DFA, Transition);
+
+    b32 Result = (DFA->StateFlags[Next] & REGEX_STATE_MATCH) != 0;
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): COMPILATION.
+//=========================================================================================
+
+internal void
+InitializeRegexDFA(regex *Regex, regex_dfa *DFA, memory_arena *Arena, regex_program *Program)
+{
+    DFA->Program = Program;
+    DFA->Stride = 257;
+    DFA->StateCapacity = REGEX_DFA_STATE_CAPACITY;
+    DFA->SetEntryCapacity = REGEX_DFA_SET_ENTRY_CAPACITY;
+    DFA->Transitions = PushArray(Arena, u32, DFA->StateCapacity * DFA->Stride);
+    DFA->StateSetOffsets = PushArray(Arena, u32, DFA->StateCapacity);
+    DFA->StateSetCounts = PushArray(Arena, u32, DFA->StateCapacity);
+    DFA->HashSlots = PushArray(Arena, u32, 2 * DFA->StateCapacity);
+    DFA->SetEntries = PushArray(Arena, u32, DFA->SetEntryCapacity);
+    DFA->StateFlags = PushArray(Arena, u8, DFA->StateCapacity);
+}
+
+// NOTE(traian): The memory is allocated by the first compilation and reused by the following ones, which is what
+// the incremental find does on every change of the query. The transition tables are sized for the worst case of
+// one class per byte value, but only the pages of the states that are actually built are ever touched.
+internal void
+AllocateRegexMemory(regex *Regex)
+{
+    memory_size InstructionSize = REGEX_INSTRUCTION_CAPACITY * sizeof(regex_instruction);
+    memory_size ScratchSize = (9 * REGEX_INSTRUCTION_CAPACITY + 2) * sizeof(u32);
+    memory_size DFASize = REGEX_DFA_STATE_CAPACITY * (257 + 4) * sizeof(u32) + REGEX_DFA_STATE_CAPACITY +
+                          REGEX_DFA_SET_ENTRY_CAPACITY * sizeof(u32);
+    memory_size Size = REGEX_BYTE_SET_CAPACITY * sizeof(regex_byte_set) + 2 * InstructionSize + ScratchSize +
+                       2 * DFASize;
+
+    Regex->Memory = PlatformAllocateMemory(Size);
+    memory_arena Arena;
+    InitializeArena(&Arena, Regex->Memory.Data, Regex->Memory.Size);
+
+    Regex->ByteSets = PushArray(&Arena, regex_byte_set, REGEX_BYTE_SET_CAPACITY);
+    Regex->Forward.Instructions = PushArray(&Arena, regex_instruction, REGEX_INSTRUCTION_CAPACITY);
+    Regex->Reverse.Instructions = PushArray(&Arena, regex_instruction, REGEX_INSTRUCTION_CAPACITY);
+
+    Regex->ClosureStack = PushArray(&Arena, u32, 2 * REGEX_INSTRUCTION_CAPACITY + 2);
+    Regex->CurrentStack = PushArray(&Arena, u32, 3 * REGEX_INSTRUCTION_CAPACITY);
+    Regex->ClosureMarks = PushArray(&Arena, u32, REGEX_INSTRUCTION_CAPACITY);
+    Regex->CurrentMarks = PushArray(&Arena, u32, REGEX_INSTRUCTION_CAPACITY);
+    Regex->NextSet = PushArray(&Arena, u32, REGEX_INSTRUCTION_CAPACITY);
+    Regex->CurrentSet = PushArray(&Arena, u32, REGEX_INSTRUCTION_CAPACITY);
+
+    InitializeRegexDFA(Regex, &Regex->ForwardDFA, &Arena, &Regex->Forward);
+    InitializeRegexDFA(Regex, &Regex->ReverseDFA, &Arena, &Regex->Reverse);
+    Regex->ForwardDFA.IsUnanchored = true;
+    Regex->ForwardDFA.IsLeftmostFirst = true;
+    Regex->ReverseDFA.IsUnanchored = false;
+    Regex->ReverseDFA.IsLeftmostFirst = false;
+}
+
+// NOTE(traian): Returns false if the pattern is malformed or too complex, in which case the regex can't be used.
+internal b32
+CompileRegex(regex *Regex, char *Pattern, memory_size PatternLength)
+{
+    if (!Regex->Memory.Data)
+    {
+        AllocateRegexMemory(Regex);
+    }
+
+    Regex->IsValid = false;
+    Regex->ByteSetCount = 0;
+    Regex->PrefixLength = 0;
+    if (PatternLength > REGEX_PATTERN_CAPACITY)
+    {
+        return false;
+    }
+
+    // NOTE(traian): The parser is too big for the stack.
+    buffer ParserMemory = PlatformAllocateMemory(sizeof(regex_parser));
+    regex_parser *Parser = (regex_parser *)ParserMemory.Data;
+    Parser->Regex = Regex;
+    Parser->At = Pattern;
+    Parser->End = Pattern + PatternLength;
+    Parser->HasError = false;
+    Parser->NodeCount = 0;
+    Parser->MultiByteNode = REGEX_EMPTY_NODE;
+    AddRegexNode(Parser, RegexNode_Empty);
+
+    u32 Root = ParseRegex(Parser);
+    if (!Parser->HasError)
+    {
+        u32 LiteralSets[256];
+        SetMemory(LiteralSets, 0xFF, sizeof(LiteralSets));
+
+        if (CompileRegexProgram(Regex, &Regex->Forward, Parser->Nodes, Root, false, LiteralSets) &&
+            CompileRegexProgram(Regex, &Regex->Reverse, Parser->Nodes, Root, true, LiteralSets))
+        {
+            AppendRegexPrefix(Regex, Parser->Nodes, Root);
+            Regex->IsValid = true;
+        }
+    }
+    PlatformReleaseMemory(ParserMemory);
+
+    if (Regex->IsValid)
+    {
+        ComputeRegexByteClasses(Regex);
+        Regex->ForwardDFA.Stride = Regex->ClassCount + 1;
+        Regex->ReverseDFA.Stride = Regex->ClassCount + 1;
+        Regex->ForwardDFA.FlushCount = 0;
+        Regex->ReverseDFA.FlushCount = 0;
+        SetMemoryToZero(Regex->ClosureMarks, REGEX_INSTRUCTION_CAPACITY * sizeof(u32));
+        SetMemoryToZero(Regex->CurrentMarks, REGEX_INSTRUCTION_CAPACITY * sizeof(u32));
+        Regex->MarkGeneration = 0;
+
+        FlushRegexDFA(&Regex->ForwardDFA);
+        FlushRegexDFA(&Regex->ReverseDFA);
+        AddRegexStartStates(Regex, &Regex->ForwardDFA);
+        AddRegexStartStates(Regex, &Regex->ReverseDFA);
+    }
+
+    return Regex->IsValid;
+}
+
+internal void
+ReleaseRegex(regex *Regex)
+{
+    if (Regex->Memory.Data)
+    {
+        PlatformReleaseMemory(Regex->Memory);
+    }
+    *Regex = {};
+}
+
+#define OCEAN_REGEX_H
+#endif // OCEAN_REGEX_H
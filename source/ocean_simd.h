@@ -0,0 +1,653 @@
+/*  =====================================================================
+    $File:   ocean_simd.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_SIMD_H
+
+#include "ocean.h"
+
+//=========================================================================================
+// NOTE(traian): PROCESSOR FEATURES.
+//=========================================================================================
+
+struct processor_features
+{
+    b32 HasSSE2;
+    b32 HasSSE42;
+    b32 HasAVX2;
+};
+
+// NOTE(traian): Zero initialized until DetectProcessorFeatures is called, which means that
+// all of the kernels fall back to the scalar implementation.
+global processor_features GlobalProcessorFeatures;
+
+internal void
+DetectProcessorFeatures()
+{
+    processor_features Features = {};
+
+#if OCEAN_COMPILER_MSVC
+    int CPUInfo[4];
+    __cpuid(CPUInfo, 0);
+    int MaxLeaf = CPUInfo[0];
+
+    __cpuid(CPUInfo, 1);
+    Features.HasSSE2 = (CPUInfo[3] & Bit(26)) != 0;
+    Features.HasSSE42 = (CPUInfo[2] & Bit(20)) != 0;
+
+    // NOTE(traian): AVX2 also requires the operating system to save the YMM registers.
+    b32 HasOSXSave = (CPUInfo[2] & Bit(27)) != 0;
+    b32 HasAVX = (CPUInfo[2] & Bit(28)) != 0;
+    if (MaxLeaf >= 7 && HasOSXSave && HasAVX)
+    {
+        u64 EnabledStates = _xgetbv(0);
+        if ((EnabledStates & 0x6) == 0x6)
+        {
+            __cpuidex(CPUInfo, 7, 0);
+            Features.HasAVX2 = (CPUInfo[1] & Bit(5)) != 0;
+        }
+    }
+#endif // OCEAN_COMPILER_MSVC
+
+    GlobalProcessorFeatures = Features;
+}
+
+//=========================================================================================
+// NOTE(traian): NEW LINE KERNELS.
+//=========================================================================================
+
+internal memory_size
+CountNewLines_Scalar(char *Base, memory_size Count)
+{
+    memory_size Result = 0;
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        if (Base[Index] == '\n')
+        {
+            ++Result;
+        }
+    }
+
+    return Result;
+}
+
+internal memory_size
+CountNewLines_SSE2(char *Base, memory_size Count)
+{
+    memory_size Result = 0;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)15;
+
+    __m128i NewLine = _mm_set1_epi8('\n');
+    __m128i Zero = _mm_setzero_si128();
+
+    while (Index < VectorEnd)
+    {
+        // NOTE(traian): Each byte lane counts the matches at its position. A lane overflows after
+        // 255 matches, so the counters are flushed into the result at least that often.
+        __m128i Counters = _mm_setzero_si128();
+        memory_size BlockEnd = Minimum(VectorEnd, Index + 255 * 16);
+        for (; Index < BlockEnd; Index += 16)
+        {
+            __m128i Bytes = _mm_loadu_si128((__m128i *)(Base + Index));
+            Counters = _mm_sub_epi8(Counters, _mm_cmpeq_epi8(Bytes, NewLine));
+        }
+
+        __m128i Sums = _mm_sad_epu8(Counters, Zero);
+        Result += _mm_cvtsi128_si64(Sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(Sums, Sums));
+    }
+
+    Result += CountNewLines_Scalar(Base + Index, Count - Index);
+    return Result;
+}
+
+internal memory_size
+CountNewLines_AVX2(char *Base, memory_size Count)
+{
+    memory_size Result = 0;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)63;
+
+    __m256i NewLine = _mm256_set1_epi8('\n');
+    __m256i Zero = _mm256_setzero_si256();
+
+    while (Index < VectorEnd)
+    {
+        // NOTE(traian): 64 bytes per step, using two sets of byte counters. See CountNewLines_SSE2.
+        __m256i CountersA = _mm256_setzero_si256();
+        __m256i CountersB = _mm256_setzero_si256();
+        memory_size BlockEnd = Minimum(VectorEnd, Index + 255 * 64);
+        for (; Index < BlockEnd; Index += 64)
+        {
+            __m256i BytesA = _mm256_loadu_si256((__m256i *)(Base + Index));
+            __m256i BytesB = _mm256_loadu_si256((__m256i *)(Base + Index + 32));
+            CountersA = _mm256_sub_epi8(CountersA, _mm256_cmpeq_epi8(BytesA, NewLine));
+            CountersB = _mm256_sub_epi8(CountersB, _mm256_cmpeq_epi8(BytesB, NewLine));
+        }
+
+        __m256i Sums = _mm256_add_epi64(_mm256_sad_epu8(CountersA, Zero), _mm256_sad_epu8(CountersB, Zero));
+        Result += _mm256_extract_epi64(Sums, 0) + _mm256_extract_epi64(Sums, 1) +
+                  _mm256_extract_epi64(Sums, 2) + _mm256_extract_epi64(Sums, 3);
+    }
+
+    Result += CountNewLines_SSE2(Base + Index, Count - Index);
+    return Result;
+}
+
+// NOTE(traian): Writes the offset of the byte that follows each new line (the start of the next line)
+// into Output and returns the number of offsets written. BaseOffset is added to every offset.
+internal memory_size
+FindLineStarts_Scalar(char *Base, memory_size Count, memory_offset BaseOffset, memory_offset *Output)
+{
+    memory_offset *Entry = Output;
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        if (Base[Index] == '\n')
+        {
+            *Entry++ = BaseOffset + Index + 1;
+        }
+    }
+
+    return Entry - Output;
+}
+
+internal memory_size
+FindLineStarts_SSE2(char *Base, memory_size Count, memory_offset BaseOffset, memory_offset *Output)
+{
+    memory_offset *Entry = Output;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)31;
+
+    __m128i NewLine = _mm_set1_epi8('\n');
+    for (; Index < VectorEnd; Index += 32)
+    {
+        __m128i BytesA = _mm_loadu_si128((__m128i *)(Base + Index));
+        __m128i BytesB = _mm_loadu_si128((__m128i *)(Base + Index + 16));
+        u32 Mask = ((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(BytesA, NewLine))) |
+                   ((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(BytesB, NewLine)) << 16);
+
+        while (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            *Entry++ = BaseOffset + Index + BitIndex + 1;
+            Mask &= Mask - 1;
+        }
+    }
+
+    Entry += FindLineStarts_Scalar(Base + Index, Count - Index, BaseOffset + Index, Entry);
+    return Entry - Output;
+}
+
+internal memory_size
+FindLineStarts_AVX2(char *Base, memory_size Count, memory_offset BaseOffset, memory_offset *Output)
+{
+    memory_offset *Entry = Output;
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)63;
+
+    __m256i NewLine = _mm256_set1_epi8('\n');
+    for (; Index < VectorEnd; Index += 64)
+    {
+        __m256i BytesA = _mm256_loadu_si256((__m256i *)(Base + Index));
+        __m256i BytesB = _mm256_loadu_si256((__m256i *)(Base + Index + 32));
+        u64 Mask = ((u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(BytesA, NewLine))) |
+                   ((u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(BytesB, NewLine)) << 32);
+
+        while (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward64(&BitIndex, Mask);
+            *Entry++ = BaseOffset + Index + BitIndex + 1;
+            Mask &= Mask - 1;
+        }
+    }
+
+    Entry += FindLineStarts_Scalar(Base + Index, Count - Index, BaseOffset + Index, Entry);
+    return Entry - Output;
+}
+
+//=========================================================================================
+// NOTE(traian): ASCII KERNELS.
+//=========================================================================================
+
+// NOTE(traian): Returns the number of ASCII bytes at the start of the range. The text iterators use it to
+// skip the UTF-8 decoder for runs of ASCII characters.
+internal memory_size
+CountLeadingASCII_Scalar(char *Base, memory_size Count)
+{
+    memory_size Index = 0;
+    while (Index < Count && (u8)Base[Index] < 0x80)
+    {
+        ++Index;
+    }
+
+    return Index;
+}
+
+internal memory_size
+CountLeadingASCII_SSE2(char *Base, memory_size Count)
+{
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)15;
+    for (; Index < VectorEnd; Index += 16)
+    {
+        // NOTE(traian): The top bit of each byte is set only for the bytes of multi-byte sequences.
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Base + Index));
+        u32 Mask = (u32)_mm_movemask_epi8(Bytes);
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            return Index + BitIndex;
+        }
+    }
+
+    Index += CountLeadingASCII_Scalar(Base + Index, Count - Index);
+    return Index;
+}
+
+internal memory_size
+CountLeadingASCII_AVX2(char *Base, memory_size Count)
+{
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)31;
+    for (; Index < VectorEnd; Index += 32)
+    {
+        __m256i Bytes = _mm256_loadu_si256((__m256i *)(Base + Index));
+        u32 Mask = (u32)_mm256_movemask_epi8(Bytes);
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            return Index + BitIndex;
+        }
+    }
+
+    Index += CountLeadingASCII_SSE2(Base + Index, Count - Index);
+    return Index;
+}
+
+//
+// NOTE(traian): Dispatchers, which pick the widest kernel supported by the processor.
+//
+
+internal inline memory_size
+CountNewLines(char *Base, memory_size Count)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return CountNewLines_AVX2(Base, Count);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return CountNewLines_SSE2(Base, Count);
+    }
+    return CountNewLines_Scalar(Base, Count);
+}
+
+internal inline memory_size
+FindLineStarts(char *Base, memory_size Count, memory_offset BaseOffset, memory_offset *Output)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return FindLineStarts_AVX2(Base, Count, BaseOffset, Output);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return FindLineStarts_SSE2(Base, Count, BaseOffset, Output);
+    }
+    return FindLineStarts_Scalar(Base, Count, BaseOffset, Output);
+}
+
+internal inline memory_size
+CountLeadingASCII(char *Base, memory_size Count)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return CountLeadingASCII_AVX2(Base, Count);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return CountLeadingASCII_SSE2(Base, Count);
+    }
+    return CountLeadingASCII_Scalar(Base, Count);
+}
+
+//=========================================================================================
+// NOTE(traian): TOKEN KERNELS.
+//=========================================================================================
+
+internal inline b32
+IsContiguousTokenCodepoint(u32 Codepoint)
+{
+    b32 Result = ('a' <= Codepoint && Codepoint <= 'z') ||
+                 ('A' <= Codepoint && Codepoint <= 'Z') ||
+                 (Codepoint == '_');
+    return Result;
+}
+
+internal inline b32
+IsIgnoredTokenCodepoint(u32 Codepoint)
+{
+    b32 Result = (Codepoint == ' ' || Codepoint == '\t');
+    return Result;
+}
+
+internal inline b32
+IsTokenClassCodepoint(u32 Codepoint, token_class Class)
+{
+    b32 Result = (Class == TokenClass_Contiguous) ? IsContiguousTokenCodepoint(Codepoint)
+                                                  : IsIgnoredTokenCodepoint(Codepoint);
+    return Result;
+}
+
+// NOTE(traian): Returns the number of bytes at the start of the range that belong to the token class.
+internal memory_size
+CountLeadingTokenBytes_Scalar(char *Base, memory_size Count, token_class Class)
+{
+    memory_size Index = 0;
+    while (Index < Count && IsTokenClassCodepoint((u8)Base[Index], Class))
+    {
+        ++Index;
+    }
+
+    return Index;
+}
+
+// NOTE(traian): Returns the number of bytes at the end of the range that belong to the token class.
+internal memory_size
+CountTrailingTokenBytes_Scalar(char *Base, memory_size Count, token_class Class)
+{
+    memory_size Index = Count;
+    while (Index > 0 && IsTokenClassCodepoint((u8)Base[Index - 1], Class))
+    {
+        --Index;
+    }
+
+    return Count - Index;
+}
+
+// NOTE(traian): Returns a bit for each of the bytes that belong to the token class.
+internal inline u32
+GetTokenClassMask_SSE2(__m128i Bytes, token_class Class)
+{
+    __m128i Mask;
+    if (Class == TokenClass_Contiguous)
+    {
+        // NOTE(traian): Setting the case bit folds the uppercase letters onto the lowercase ones. After subtracting
+        // 'a', the letters are the only bytes in [0, 26) when compared as signed, since every other byte (including
+        // the ones of multi-byte sequences) either wraps to a negative value or lands past 'z'.
+        __m128i Letter = _mm_sub_epi8(_mm_or_si128(Bytes, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i IsLetter = _mm_and_si128(_mm_cmpgt_epi8(Letter, _mm_set1_epi8(-1)),
+                                         _mm_cmplt_epi8(Letter, _mm_set1_epi8(26)));
+        Mask = _mm_or_si128(IsLetter, _mm_cmpeq_epi8(Bytes, _mm_set1_epi8('_')));
+    }
+    else
+    {
+        Mask = _mm_or_si128(_mm_cmpeq_epi8(Bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(Bytes, _mm_set1_epi8('\t')));
+    }
+
+    return (u32)_mm_movemask_epi8(Mask);
+}
+
+internal inline u32
+GetTokenClassMask_AVX2(__m256i Bytes, token_class Class)
+{
+    __m256i Mask;
+    if (Class == TokenClass_Contiguous)
+    {
+        __m256i Letter = _mm256_sub_epi8(_mm256_or_si256(Bytes, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i IsLetter = _mm256_and_si256(_mm256_cmpgt_epi8(Letter, _mm256_set1_epi8(-1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8(26), Letter));
+        Mask = _mm256_or_si256(IsLetter, _mm256_cmpeq_epi8(Bytes, _mm256_set1_epi8('_')));
+    }
+    else
+    {
+        Mask = _mm256_or_si256(_mm256_cmpeq_epi8(Bytes, _mm256_set1_epi8(' ')),
+                               _mm256_cmpeq_epi8(Bytes, _mm256_set1_epi8('\t')));
+    }
+
+    return (u32)_mm256_movemask_epi8(Mask);
+}
+
+internal memory_size
+CountLeadingTokenBytes_SSE2(char *Base, memory_size Count, token_class Class)
+{
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)15;
+    for (; Index < VectorEnd; Index += 16)
+    {
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Base + Index));
+        u32 Mask = ~GetTokenClassMask_SSE2(Bytes, Class) & 0xFFFF;
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            return Index + BitIndex;
+        }
+    }
+
+    Index += CountLeadingTokenBytes_Scalar(Base + Index, Count - Index, Class);
+    return Index;
+}
+
+internal memory_size
+CountLeadingTokenBytes_AVX2(char *Base, memory_size Count, token_class Class)
+{
+    memory_size Index = 0;
+    memory_size VectorEnd = Count & ~(memory_size)31;
+    for (; Index < VectorEnd; Index += 32)
+    {
+        __m256i Bytes = _mm256_loadu_si256((__m256i *)(Base + Index));
+        u32 Mask = ~GetTokenClassMask_AVX2(Bytes, Class);
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            return Index + BitIndex;
+        }
+    }
+
+    Index += CountLeadingTokenBytes_SSE2(Base + Index, Count - Index, Class);
+    return Index;
+}
+
+internal memory_size
+CountTrailingTokenBytes_SSE2(char *Base, memory_size Count, token_class Class)
+{
+    // NOTE(traian): The blocks are processed from the end of the range, towards its start.
+    memory_size Index = Count;
+    while (Index >= 16)
+    {
+        Index -= 16;
+        __m128i Bytes = _mm_loadu_si128((__m128i *)(Base + Index));
+        u32 Mask = ~GetTokenClassMask_SSE2(Bytes, Class) & 0xFFFF;
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanReverse(&BitIndex, Mask);
+            return Count - (Index + BitIndex + 1);
+        }
+    }
+
+    return (Count - Index) + CountTrailingTokenBytes_Scalar(Base, Index, Class);
+}
+
+internal memory_size
+CountTrailingTokenBytes_AVX2(char *Base, memory_size Count, token_class Class)
+{
+    memory_size Index = Count;
+    while (Index >= 32)
+    {
+        Index -= 32;
+        __m256i Bytes = _mm256_loadu_si256((__m256i *)(Base + Index));
+        u32 Mask = ~GetTokenClassMask_AVX2(Bytes, Class);
+        if (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanReverse(&BitIndex, Mask);
+            return Count - (Index + BitIndex + 1);
+        }
+    }
+
+    return (Count - Index) + CountTrailingTokenBytes_SSE2(Base, Index, Class);
+}
+
+internal inline memory_size
+CountLeadingTokenBytes(char *Base, memory_size Count, token_class Class)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return CountLeadingTokenBytes_AVX2(Base, Count, Class);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return CountLeadingTokenBytes_SSE2(Base, Count, Class);
+    }
+    return CountLeadingTokenBytes_Scalar(Base, Count, Class);
+}
+
+internal inline memory_size
+CountTrailingTokenBytes(char *Base, memory_size Count, token_class Class)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return CountTrailingTokenBytes_AVX2(Base, Count, Class);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return CountTrailingTokenBytes_SSE2(Base, Count, Class);
+    }
+    return CountTrailingTokenBytes_Scalar(Base, Count, Class);
+}
+
+//=========================================================================================
+// NOTE(traian): FIND KERNELS.
+//=========================================================================================
+
+internal inline b32
+AreBytesEqual(char *A, char *B, memory_size Count)
+{
+    for (memory_size Index = 0; Index < Count; ++Index)
+    {
+        if (A[Index] != B[Index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// NOTE(traian): Returns the index of the first occurrence of the pattern in the range, or Count if the
+// pattern doesn't occur in it. The pattern can't be empty.
+internal memory_size
+FindLiteral_Scalar(char *Base, memory_size Count, char *Pattern, memory_size PatternLength)
+{
+    if (PatternLength > Count)
+    {
+        return Count;
+    }
+
+    memory_size LastStart = Count - PatternLength;
+    for (memory_size Index = 0; Index <= LastStart; ++Index)
+    {
+        if (Base[Index] == Pattern[0] && AreBytesEqual(Base + Index + 1, Pattern + 1, PatternLength - 1))
+        {
+            return Index;
+        }
+    }
+    return Count;
+}
+
+// NOTE(traian): The vector kernels compare each block against the first and the last byte of the pattern,
+// at the matching distance from each other. Only the positions where both bytes are equal are confirmed
+// by comparing the whole pattern, which skips almost all of the text for any pattern that isn't trivial.
+internal memory_size
+FindLiteral_SSE2(char *Base, memory_size Count, char *Pattern, memory_size PatternLength)
+{
+    if (PatternLength > Count)
+    {
+        return Count;
+    }
+
+    __m128i First = _mm_set1_epi8(Pattern[0]);
+    __m128i Last = _mm_set1_epi8(Pattern[PatternLength - 1]);
+
+    memory_size Index = 0;
+    memory_size StartCount = Count - PatternLength + 1;
+    for (; Index + 16 <= StartCount; Index += 16)
+    {
+        __m128i FirstBytes = _mm_loadu_si128((__m128i *)(Base + Index));
+        __m128i LastBytes = _mm_loadu_si128((__m128i *)(Base + Index + PatternLength - 1));
+        u32 Mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(FirstBytes, First),
+                                                   _mm_cmpeq_epi8(LastBytes, Last)));
+        while (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            if (AreBytesEqual(Base + Index + BitIndex + 1, Pattern + 1, PatternLength - 1))
+            {
+                return Index + BitIndex;
+            }
+            Mask &= Mask - 1;
+        }
+    }
+
+    Index += FindLiteral_Scalar(Base + Index, Count - Index, Pattern, PatternLength);
+    return Index;
+}
+
+internal memory_size
+FindLiteral_AVX2(char *Base, memory_size Count, char *Pattern, memory_size PatternLength)
+{
+    if (PatternLength > Count)
+    {
+        return Count;
+    }
+
+    __m256i First = _mm256_set1_epi8(Pattern[0]);
+    __m256i Last = _mm256_set1_epi8(Pattern[PatternLength - 1]);
+
+    memory_size Index = 0;
+    memory_size StartCount = Count - PatternLength + 1;
+    for (; Index + 32 <= StartCount; Index += 32)
+    {
+        __m256i FirstBytes = _mm256_loadu_si256((__m256i *)(Base + Index));
+        __m256i LastBytes = _mm256_loadu_si256((__m256i *)(Base + Index + PatternLength - 1));
+        u32 Mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(FirstBytes, First),
+                                                         _mm256_cmpeq_epi8(LastBytes, Last)));
+        while (Mask)
+        {
+            unsigned long BitIndex;
+            _BitScanForward(&BitIndex, Mask);
+            if (AreBytesEqual(Base + Index + BitIndex + 1, Pattern + 1, PatternLength - 1))
+            {
+                return Index + BitIndex;
+            }
+            Mask &= Mask - 1;
+        }
+    }
+
+    Index += FindLiteral_SSE2(Base + Index, Count - Index, Pattern, PatternLength);
+    return Index;
+}
+
+internal inline memory_size
+FindLiteral(char *Base, memory_size Count, char *Pattern, memory_size PatternLength)
+{
+    if (GlobalProcessorFeatures.HasAVX2)
+    {
+        return FindLiteral_AVX2(Base, Count, Pattern, PatternLength);
+    }
+    if (GlobalProcessorFeatures.HasSSE2)
+    {
+        return FindLiteral_SSE2(Base, Count, Pattern, PatternLength);
+    }
+    return FindLiteral_Scalar(Base, Count, Pattern, PatternLength);
+}
+
+#define OCEAN_SIMD_H
+#endif // OCEAN_SIMD_H
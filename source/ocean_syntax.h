@@ -0,0 +1,389 @@
+/*  =====================================================================
+    $File:   ocean_syntax.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_SYNTAX_H
+
+#include "ocean.h"
+#include "ocean_simd.h"
+
+// NOTE(traian): The lexer of the C and C++ syntax. It lexes one line at a time, starting from the state in which
+// the previous line ended, so the lines never have to be lexed in the context of the whole text. It only knows
+// enough of the language to color it: the preprocessor directives are recognized by their first token and the
+// line continuations are only followed by the comments and the strings.
+
+//=========================================================================================
+// NOTE(traian): KEYWORDS.
+//=========================================================================================
+
+global char *SyntaxKeywords[] =
+{
+    "alignas", "alignof", "asm", "auto", "bool", "break", "case", "catch", "char", "char8_t", "char16_t",
+    "char32_t", "class", "co_await", "co_return", "co_yield", "concept", "const", "const_cast", "consteval",
+    "constexpr", "constinit", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+    "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+    "int", "long", "mutable", "namespace", "new", "noexcept", "nullptr", "operator", "private", "protected",
+    "public", "register", "reinterpret_cast", "requires", "restrict", "return", "short", "signed", "sizeof",
+    "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+    "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+    "volatile", "wchar_t", "while", "_Alignas", "_Alignof", "_Atomic", "_Bool", "_Generic", "_Noreturn",
+    "_Static_assert", "_Thread_local",
+};
+
+internal b32
+IsSyntaxKeyword(char *Identifier, memory_size Length)
+{
+    for (u32 KeywordIndex = 0; KeywordIndex < ArrayCount(SyntaxKeywords); ++KeywordIndex)
+    {
+        char *Keyword = SyntaxKeywords[KeywordIndex];
+        if (Keyword[0] == Identifier[0] && AreBytesEqual(Keyword, Identifier, Length) && Keyword[Length] == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//=========================================================================================
+// NOTE(traian): LINE LEXER.
+//=========================================================================================
+
+internal inline b32
+IsSyntaxDigit(char Character)
+{
+    b32 Result = ('0' <= Character && Character <= '9');
+    return Result;
+}
+
+// NOTE(traian): The bytes of the UTF-8 sequences are allowed in identifiers, so they are never split.
+internal inline b32
+IsSyntaxIdentifierCharacter(char Character)
+{
+    b32 Result = ('a' <= Character && Character <= 'z') || ('A' <= Character && Character <= 'Z') ||
+                 IsSyntaxDigit(Character) || Character == '_' || (u8)Character >= 0x80;
+    return Result;
+}
+
+internal inline b32
+IsSyntaxIdentifierEqual(char *Identifier, memory_size Length, char *String)
+{
+    b32 Result = AreBytesEqual(Identifier, String, Length) && String[Length] == 0;
+    return Result;
+}
+
+internal inline b32
+IsSyntaxLineContinued(char *Line, memory_size Count)
+{
+    b32 Result = (Count > 0 && Line[Count - 1] == '\\');
+    return Result;
+}
+
+// NOTE(traian): A span is only started when the class changes, and the spans after the capacity are dropped.
+internal inline void
+AddSyntaxSpan(syntax_span *Spans, u32 *SpanCount, memory_offset Offset, syntax_class Class)
+{
+    if (Spans)
+    {
+        u32 Count = *SpanCount;
+        if ((Count == 0 || Spans[Count - 1].Class != Class) && Count < SYNTAX_SPAN_CAPACITY)
+        {
+            Spans[Count].Offset = (u32)Offset;
+            Spans[Count].Class = Class;
+            *SpanCount = Count + 1;
+        }
+    }
+}
+
+// NOTE(traian): Returns the offset after the closing quote, or the end of the line if the literal isn't closed
+// on it. A literal that isn't closed continues on the next line only if the line ends with an escaping backslash.
+internal memory_offset
+SkipSyntaxQuotedLiteral(char *Line, memory_size Count, memory_offset Index, char Quote, b32 *IsContinued)
+{
+    *IsContinued = false;
+    while (Index < Count)
+    {
+        char Character = Line[Index++];
+        if (Character == Quote)
+        {
+            return Index;
+        }
+        if (Character == '\\')
+        {
+            if (Index == Count)
+            {
+                *IsContinued = true;
+                break;
+            }
+            ++Index;
+        }
+    }
+    return Count;
+}
+
+// NOTE(traian): Returns the offset after the end of the raw string, or INVALID_SIZE if it doesn't end on the line.
+internal memory_offset
+FindSyntaxRawStringEnd(syntax_lexer *Lexer, char *Line, memory_size Count, memory_offset Index)
+{
+    memory_size TerminatorLength = Lexer->RawDelimiterLength + 2;
+    for (; Index + TerminatorLength <= Count; ++Index)
+    {
+        if (Line[Index] == ')' && Line[Index + TerminatorLength - 1] == '"' &&
+            AreBytesEqual(Line + Index + 1, Lexer->RawDelimiter, Lexer->RawDelimiterLength))
+        {
+            return Index + TerminatorLength;
+        }
+    }
+    return INVALID_SIZE;
+}
+
+// NOTE(traian): Reads the delimiter of a raw string that starts at the given offset, which is right after its
+// opening quote. Returns the offset after the opening parenthesis, or INVALID_SIZE if the delimiter is malformed.
+internal memory_offset
+ReadSyntaxRawDelimiter(syntax_lexer *Lexer, char *Line, memory_size Count, memory_offset Index)
+{
+    for (u32 Length = 0; Length <= SYNTAX_RAW_DELIMITER_CAPACITY && Index + Length < Count; ++Length)
+    {
+        char Character = Line[Index + Length];
+        if (Character == '(')
+        {
+            Lexer->RawDelimiterLength = (u8)Length;
+            CopyMem(Lexer->RawDelimiter, Line + Index, Length);
+            return Index + Length + 1;
+        }
+        if (Character == ' ' || Character == ')' || Character == '\\' || Character == '\t' || Character == '"')
+        {
+            break;
+        }
+    }
+    return INVALID_SIZE;
+}
+
+// NOTE(traian): Lexes a line, without its new line, starting from the state in which the previous line ended.
+// Returns the state in which the line ends. The spans of the line are only computed if they are requested, since
+// the lines that aren't drawn only need their states.
+internal syntax_lexer
+LexSyntaxLine(syntax_lexer Lexer, char *Line, memory_size Count, syntax_span *Spans, u32 *SpanCount)
+{
+    if (Spans)
+    {
+        *SpanCount = 0;
+    }
+
+    memory_offset Index = 0;
+    b32 IsContinued;
+    switch (Lexer.State)
+    {
+        case SyntaxState_BlockComment:
+        {
+            AddSyntaxSpan(Spans, SpanCount, 0, SyntaxClass_Comment);
+            Index = FindLiteral(Line, Count, "*/", 2);
+            if (Index == Count)
+            {
+                return Lexer;
+            }
+            Index += 2;
+        } break;
+
+        case SyntaxState_LineComment:
+        {
+            AddSyntaxSpan(Spans, SpanCount, 0, SyntaxClass_Comment);
+            Lexer.State = IsSyntaxLineContinued(Line, Count) ? SyntaxState_LineComment : SyntaxState_Normal;
+            return Lexer;
+        }
+
+        case SyntaxState_String:
+        {
+            AddSyntaxSpan(Spans, SpanCount, 0, SyntaxClass_String);
+            Index = SkipSyntaxQuotedLiteral(Line, Count, 0, '"', &IsContinued);
+            if (IsContinued)
+            {
+                return Lexer;
+            }
+        } break;
+
+        case SyntaxState_RawString:
+        {
+            AddSyntaxSpan(Spans, SpanCount, 0, SyntaxClass_String);
+            Index = FindSyntaxRawStringEnd(&Lexer, Line, Count, 0);
+            if (Index == INVALID_SIZE)
+            {
+                return Lexer;
+            }
+        } break;
+
+        default:
+        {
+        } break;
+    }
+
+    // NOTE(traian): A directive is only recognized at the start of a line that doesn't continue a construct.
+    b32 IsDirectiveAllowed = (Lexer.State == SyntaxState_Normal);
+    Lexer.State = SyntaxState_Normal;
+    while (Index < Count)
+    {
+        memory_offset Start = Index;
+        char Character = Line[Index];
+        char NextCharacter = (Index + 1 < Count) ? Line[Index + 1] : 0;
+
+        if (Character == ' ' || Character == '\t')
+        {
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Default);
+            ++Index;
+            continue;
+        }
+
+        if (Character == '/' && NextCharacter == '/')
+        {
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Comment);
+            if (IsSyntaxLineContinued(Line, Count))
+            {
+                Lexer.State = SyntaxState_LineComment;
+            }
+            break;
+        }
+        else if (Character == '/' && NextCharacter == '*')
+        {
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Comment);
+            memory_size EndIndex = FindLiteral(Line + Index + 2, Count - Index - 2, "*/", 2);
+            if (Index + 2 + EndIndex == Count)
+            {
+                Lexer.State = SyntaxState_BlockComment;
+                break;
+            }
+            Index += 2 + EndIndex + 2;
+        }
+        else if (Character == '"' || Character == '\'')
+        {
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_String);
+            Index = SkipSyntaxQuotedLiteral(Line, Count, Index + 1, Character, &IsContinued);
+            if (IsContinued && Character == '"')
+            {
+                Lexer.State = SyntaxState_String;
+            }
+        }
+        else if (IsSyntaxDigit(Character) || (Character == '.' && IsSyntaxDigit(NextCharacter)))
+        {
+            // NOTE(traian): Everything that the preprocessor considers a number, including the digit separators
+            // and the signs of the exponents.
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Number);
+            ++Index;
+            while (Index < Count)
+            {
+                char Previous = Line[Index - 1];
+                Character = Line[Index];
+                if (IsSyntaxIdentifierCharacter(Character) || Character == '.')
+                {
+                    ++Index;
+                }
+                else if (Character == '\'' && Index + 1 < Count && IsSyntaxIdentifierCharacter(Line[Index + 1]))
+                {
+                    Index += 2;
+                }
+                else if ((Character == '+' || Character == '-') &&
+                         (Previous == 'e' || Previous == 'E' || Previous == 'p' || Previous == 'P'))
+                {
+                    ++Index;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+        else if (IsSyntaxIdentifierCharacter(Character))
+        {
+            while (Index < Count && IsSyntaxIdentifierCharacter(Line[Index]))
+            {
+                ++Index;
+            }
+
+            char *Identifier = Line + Start;
+            memory_size Length = Index - Start;
+            char Quote = (Index < Count) ? Line[Index] : 0;
+            if (Quote == '"' && (IsSyntaxIdentifierEqual(Identifier, Length, "R") ||
+                                 IsSyntaxIdentifierEqual(Identifier, Length, "u8R") ||
+                                 IsSyntaxIdentifierEqual(Identifier, Length, "uR") ||
+                                 IsSyntaxIdentifierEqual(Identifier, Length, "UR") ||
+                                 IsSyntaxIdentifierEqual(Identifier, Length, "LR")))
+            {
+                AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_String);
+                memory_offset ContentStart = ReadSyntaxRawDelimiter(&Lexer, Line, Count, Index + 1);
+                if (ContentStart == INVALID_SIZE)
+                {
+                    // NOTE(traian): A malformed raw string is colored as an ordinary one.
+                    Index = SkipSyntaxQuotedLiteral(Line, Count, Index + 1, '"', &IsContinued);
+                }
+                else
+                {
+                    Index = FindSyntaxRawStringEnd(&Lexer, Line, Count, ContentStart);
+                    if (Index == INVALID_SIZE)
+                    {
+                        Lexer.State = SyntaxState_RawString;
+                        break;
+                    }
+                }
+            }
+            else if ((Quote == '"' || Quote == '\'') && (IsSyntaxIdentifierEqual(Identifier, Length, "u8") ||
+                                                         IsSyntaxIdentifierEqual(Identifier, Length, "u") ||
+                                                         IsSyntaxIdentifierEqual(Identifier, Length, "U") ||
+                                                         IsSyntaxIdentifierEqual(Identifier, Length, "L")))
+            {
+                AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_String);
+                Index = SkipSyntaxQuotedLiteral(Line, Count, Index + 1, Quote, &IsContinued);
+                if (IsContinued && Quote == '"')
+                {
+                    Lexer.State = SyntaxState_String;
+                }
+            }
+            else if (Spans)
+            {
+                b32 IsKeyword = IsSyntaxKeyword(Identifier, Length);
+                AddSyntaxSpan(Spans, SpanCount, Start, IsKeyword ? SyntaxClass_Keyword : SyntaxClass_Default);
+            }
+        }
+        else if (Character == '#' && IsDirectiveAllowed)
+        {
+            ++Index;
+            while (Index < Count && (Line[Index] == ' ' || Line[Index] == '\t'))
+            {
+                ++Index;
+            }
+
+            memory_offset NameStart = Index;
+            while (Index < Count && IsSyntaxIdentifierCharacter(Line[Index]))
+            {
+                ++Index;
+            }
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Preprocessor);
+
+            // NOTE(traian): The name of a system header is colored as a string.
+            memory_size NameLength = Index - NameStart;
+            if (IsSyntaxIdentifierEqual(Line + NameStart, NameLength, "include"))
+            {
+                while (Index < Count && (Line[Index] == ' ' || Line[Index] == '\t'))
+                {
+                    ++Index;
+                }
+                if (Index < Count && Line[Index] == '<')
+                {
+                    AddSyntaxSpan(Spans, SpanCount, Index, SyntaxClass_String);
+                    while (Index < Count && Line[Index++] != '>');
+                }
+            }
+        }
+        else
+        {
+            AddSyntaxSpan(Spans, SpanCount, Start, SyntaxClass_Default);
+            ++Index;
+        }
+
+        IsDirectiveAllowed = false;
+    }
+
+    return Lexer;
+}
+
+#define OCEAN_SYNTAX_H
+#endif // OCEAN_SYNTAX_H
@@ -7,387 +7,4643 @@
 #ifndef OCEAN_TEXT_H
 
 #include "ocean.h"
+#include "ocean_simd.h"
+#include "ocean_encoding.h"
+#include "ocean_regex.h"
+#include "ocean_syntax.h"
 
-struct text_iterator
+//=========================================================================================
+// NOTE(traian): GAP BUFFER.
+//=========================================================================================
+
+internal inline memory_size
+GetBufferGapSize(text_buffer *Buffer)
 {
-    u32 Codepoint;
-    u32 Width;
-    memory_offset Offset;
-    text_buffer *Buffer;
-};
+    memory_size Result = Buffer->Size - Buffer->Used;
+    return Result;
+}
 
-struct get_codepoint_result
+// NOTE(traian): Translates a logical text offset into the address of the byte in the buffer memory.
+internal inline char *
+GetBufferAddress(text_buffer *Buffer, memory_offset Offset)
 {
-    u32 Codepoint;
-    u32 Width;
-    b32 IsValid;
+    char *Result = Buffer->Base + Offset;
+    if (Offset >= Buffer->GapOffset)
+    {
+        Result += GetBufferGapSize(Buffer);
+    }
+    return Result;
+}
+
+internal inline char
+GetBufferCharacter(text_buffer *Buffer, memory_offset Offset)
+{
+    Assert(Offset < Buffer->Used);
+    char Result = *GetBufferAddress(Buffer, Offset);
+    return Result;
+}
+
+// NOTE(traian): The text is described by the two spans around the gap, in order. Consumers that
+// process the text in bulk (such as the file writer) work directly on the spans, without moving the gap.
+// The spans are only valid until the buffer is modified.
+struct text_buffer_spans
+{
+    buffer Spans[2];
 };
 
-internal inline get_codepoint_result
-GetCodepoint(text_buffer *Buffer, memory_offset Offset)
+internal inline text_buffer_spans
+GetBufferSpans(text_buffer *Buffer)
+{
+    text_buffer_spans Result;
+    memory_size AfterGapCount = Buffer->Used - Buffer->GapOffset;
+
+    Result.Spans[0].Data = (u8 *)Buffer->Base;
+    Result.Spans[0].Size = Buffer->GapOffset;
+    Result.Spans[1].Data = (u8 *)Buffer->Base + Buffer->Size - AfterGapCount;
+    Result.Spans[1].Size = AfterGapCount;
+
+    return Result;
+}
+
+// NOTE(traian): Copies the text in [Offset, Offset + ByteCount) to the destination, without moving the gap.
+internal inline void
+CopyFromBuffer(text_buffer *Buffer, memory_offset Offset, memory_size ByteCount, char *Destination)
+{
+    Assert(Offset + ByteCount <= Buffer->Used);
+    if (Offset < Buffer->GapOffset)
+    {
+        memory_size BeforeGapCount = Minimum(ByteCount, Buffer->GapOffset - Offset);
+        CopyMem(Destination, Buffer->Base + Offset, BeforeGapCount);
+        Destination += BeforeGapCount;
+        Offset += BeforeGapCount;
+        ByteCount -= BeforeGapCount;
+    }
+
+    if (ByteCount > 0)
+    {
+        CopyMem(Destination, GetBufferAddress(Buffer, Offset), ByteCount);
+    }
+}
+
+internal inline void
+MoveBufferGap(text_buffer *Buffer, memory_offset Offset)
 {
     Assert(Offset <= Buffer->Used);
-    get_codepoint_result Result = {};
-    
-    if (Offset < Buffer->Used)
+    memory_size GapSize = GetBufferGapSize(Buffer);
+
+    if (Offset < Buffer->GapOffset)
     {
-        // TODO(traian): Support for Unicode encodings, such as UTF-8 or UTF-16!
-        //               Currently, this code will cause a crash if the file is not plain ASCII.
-        Result.Codepoint = Buffer->Base[Offset];
-        Result.Width = 1;
-        Result.IsValid = true;
+        // NOTE(traian): The bytes between the new and the old gap position move to the end of the gap.
+        MoveMem(Buffer->Base + Offset + GapSize, Buffer->Base + Offset, Buffer->GapOffset - Offset);
+    }
+    else if (Offset > Buffer->GapOffset)
+    {
+        // NOTE(traian): The bytes between the old and the new gap position move to the start of the gap.
+        MoveMem(Buffer->Base + Buffer->GapOffset, Buffer->Base + Buffer->GapOffset + GapSize,
+                Offset - Buffer->GapOffset);
+    }
+
+    Buffer->GapOffset = Offset;
+}
+
+// NOTE(traian): Makes sure that at least ByteCount bytes can be inserted at the gap.
+internal inline void
+ReserveBufferGap(text_buffer *Buffer, memory_size ByteCount)
+{
+    if (GetBufferGapSize(Buffer) < ByteCount)
+    {
+        memory_size NewTextBufferSize = Maximum(Buffer->Used + ByteCount, 2 * Buffer->Size);
+        buffer OldTextBuffer;
+        OldTextBuffer.Data = (u8 *)Buffer->Base;
+        OldTextBuffer.Size = Buffer->Size;
 
-        // NOTE(traian): On Windows, new lines are denoted using the '\r\n' sequence.
-        //               This detail should not matter to the code that uses text iterators,
-        //               so we abstract it by combining the two ASCII bytes into a single
-        //               codepoint equal to '\n', but of width 2.
-        if (Result.Codepoint == '\r')
+        buffer NewTextBuffer = PlatformAllocateMemory(NewTextBufferSize);
+        if (OldTextBuffer.Data)
         {
-            if (Offset + Result.Width < Buffer->Used)
-            {
-                u8 NextByte = Buffer->Base[Offset + 1];
-                if (NextByte == '\n')
-                {
-                    Result.Codepoint = '\n';
-                    Result.Width = 2;
-                }
-            }
+            memory_size AfterGapCount = Buffer->Used - Buffer->GapOffset;
+            CopyMem(NewTextBuffer.Data, OldTextBuffer.Data, Buffer->GapOffset);
+            CopyMem(NewTextBuffer.Data + NewTextBuffer.Size - AfterGapCount,
+                    OldTextBuffer.Data + OldTextBuffer.Size - AfterGapCount, AfterGapCount);
+            PlatformReleaseMemory(OldTextBuffer);
         }
+
+        Buffer->Base = (char *)NewTextBuffer.Data;
+        Buffer->Size = NewTextBuffer.Size;
+    }
+}
+
+internal inline void
+InsertIntoBuffer(text_buffer *Buffer, memory_offset Offset, char *Characters, memory_size ByteCount)
+{
+    Assert(!Buffer->IsMapped);
+    MoveBufferGap(Buffer, Offset);
+    ReserveBufferGap(Buffer, ByteCount);
+
+    CopyMem(Buffer->Base + Buffer->GapOffset, Characters, ByteCount);
+    Buffer->GapOffset += ByteCount;
+    Buffer->Used += ByteCount;
+}
+
+internal inline void
+RemoveFromBuffer(text_buffer *Buffer, memory_offset Offset, memory_size ByteCount)
+{
+    Assert(!Buffer->IsMapped);
+    Assert(Offset + ByteCount <= Buffer->Used);
+
+    // NOTE(traian): The removed bytes are located right after the gap, so the gap simply grows over them.
+    MoveBufferGap(Buffer, Offset);
+    Buffer->Used -= ByteCount;
+}
+
+internal inline void
+ReleaseBufferMemory(text_buffer *Buffer)
+{
+    buffer Memory = { (u8 *)Buffer->Base, Buffer->Size };
+    if (Buffer->IsMapped)
+    {
+        PlatformUnmapFile(Memory);
     }
     else
     {
-        Result.IsValid = true;
+        PlatformReleaseMemory(Memory);
     }
 
-    return Result;
+    Buffer->Base = NULL;
+    Buffer->Size = 0;
+    Buffer->Used = 0;
+    Buffer->GapOffset = 0;
+    Buffer->IsMapped = false;
 }
 
-internal inline text_iterator
-NewTextIterator(text_buffer *Buffer, memory_offset Offset)
+// NOTE(traian): Copies the text of a mapped file into an allocated buffer, so that it can be modified.
+// The gap is placed in front of the text, just like when the file is read.
+internal inline void
+PromoteMappedBuffer(text_buffer *Buffer)
 {
-    text_iterator Result = {};
-
-    get_codepoint_result Codepoint = GetCodepoint(Buffer, Offset);
-    if (Codepoint.IsValid)
+    if (Buffer->IsMapped)
     {
-        Result.Codepoint = Codepoint.Codepoint;
-        Result.Width = Codepoint.Width;
-        Result.Offset = Offset;
-        Result.Buffer = Buffer;
-    }
+        memory_size TextSize = Buffer->Used;
+        buffer NewTextBuffer = PlatformAllocateMemory(TextSize + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+        CopyMem(NewTextBuffer.Data + NewTextBuffer.Size - TextSize, Buffer->Base, TextSize);
+        ReleaseBufferMemory(Buffer);
 
-    return Result;
+        Buffer->Base = (char *)NewTextBuffer.Data;
+        Buffer->Size = NewTextBuffer.Size;
+        Buffer->Used = TextSize;
+        Buffer->GapOffset = 0;
+    }
 }
 
-internal inline text_iterator
-AdvanceIterator(text_iterator Iterator)
+//=========================================================================================
+// NOTE(traian): DISK HASHES.
+//=========================================================================================
+
+// NOTE(traian): A 64-bit hash of a chunk, which processes 8 bytes per step. The size of the chunk is part of
+// the hash, so that a partial chunk never matches a chunk of a different size.
+internal inline u64
+HashTextChunk(u8 *Bytes, memory_size ByteCount)
 {
-    text_iterator Result = {};
-    memory_offset NewOffset = Iterator.Offset + Iterator.Width;
-    if (NewOffset < Iterator.Buffer->Used)
+    u64 Hash = 0x9E3779B97F4A7C15ull ^ ByteCount;
+    memory_offset Index = 0;
+    for (; Index + sizeof(u64) <= ByteCount; Index += sizeof(u64))
     {
-        Result = NewTextIterator(Iterator.Buffer, NewOffset);
+        u64 Word = *(u64 *)(Bytes + Index);
+        Hash = (Hash ^ Word) * 0xFF51AFD7ED558CCDull;
+        Hash ^= Hash >> 32;
+    }
+
+    for (; Index < ByteCount; ++Index)
+    {
+        Hash = (Hash ^ Bytes[Index]) * 0x100000001B3ull;
     }
 
+    Hash ^= Hash >> 33;
+    Hash *= 0xC4CEB9FE1A85EC53ull;
+    Hash ^= Hash >> 33;
+    return Hash;
+}
+
+internal inline u64
+GetTextChunkCount(memory_size TextSize)
+{
+    u64 Result = (TextSize + TEXT_DISK_HASH_CHUNK_SIZE - 1) / TEXT_DISK_HASH_CHUNK_SIZE;
     return Result;
 }
 
-internal inline text_iterator
-DevanceIterator(text_iterator Iterator)
+// NOTE(traian): Computes the hashes of the chunks in [Offset, Offset + ByteCount), where Text points to the
+// byte at Offset. The offset must be the start of a chunk, and the range must end at the end of a chunk or
+// at the end of the document.
+internal void
+HashTextChunks(u64 *ChunkHashes, memory_size TextSize, u8 *Text, memory_offset Offset, memory_size ByteCount)
 {
-    text_iterator Result = {};
+    Assert(Offset % TEXT_DISK_HASH_CHUNK_SIZE == 0);
+    Assert(Offset + ByteCount <= TextSize);
 
-    memory_offset Offset = Iterator.Offset;
-    while (Offset)
+    u64 ChunkIndex = Offset / TEXT_DISK_HASH_CHUNK_SIZE;
+    memory_offset EndOffset = Offset + ByteCount;
+    while (Offset < EndOffset)
     {
-        get_codepoint_result Codepoint = GetCodepoint(Iterator.Buffer, --Offset);
-        if (Codepoint.IsValid)
-        {
-            // NOTE(traian): Consume both of the bytes if the new line sequence is '\r\n'.
-            //               Used when iterating over files that use CRLF new lines.
-            if (Codepoint.Codepoint == '\n')
-            {
-                if (Offset > 0 && Iterator.Buffer->Base[Offset - 1] == '\r')
-                {
-                    --Offset;
-                    Codepoint.Width++;
-                }
-            }
+        memory_size ChunkSize = Minimum(TEXT_DISK_HASH_CHUNK_SIZE, TextSize - Offset);
+        ChunkHashes[ChunkIndex++] = HashTextChunk(Text, ChunkSize);
+        Text += ChunkSize;
+        Offset += ChunkSize;
+    }
+}
 
-            Result.Codepoint = Codepoint.Codepoint;
-            Result.Width = Codepoint.Width;
-            Result.Offset = Offset;
-            Result.Buffer = Iterator.Buffer;
-            break;
+// NOTE(traian): Prepares the hashes for a document that is about to be loaded. The hashes aren't valid until
+// all of the chunks are hashed.
+internal void
+BeginTextDiskHashes(text_disk_hashes *DiskHashes, char *FileName, memory_size FileSize)
+{
+    u64 ChunkCount = GetTextChunkCount(FileSize);
+    if (DiskHashes->Memory.Size < ChunkCount * sizeof(u64))
+    {
+        if (DiskHashes->Memory.Data)
+        {
+            PlatformReleaseMemory(DiskHashes->Memory);
         }
+        DiskHashes->Memory = PlatformAllocateMemory(ChunkCount * sizeof(u64));
     }
 
-    return Result;
+    DiskHashes->ChunkHashes = (u64 *)DiskHashes->Memory.Data;
+    DiskHashes->ChunkCount = ChunkCount;
+    DiskHashes->FileSize = FileSize;
+    DiskHashes->FileWriteTime = PlatformGetFileWriteTime(FileName);
+    DiskHashes->IsValid = false;
 }
 
-internal inline b32
-IsValid(text_iterator Iterator)
-{
-    b32 Result = (Iterator.Width > 0);
-    return Result;
-}
+//=========================================================================================
+// NOTE(traian): LINE INDEX.
+//=========================================================================================
 
-internal inline b32
-IsDrawableCodepoint(u32 Codepoint)
+internal inline memory_size
+GetNumberOfLines(char *Base, memory_size Count)
 {
-    b32 Result = (FONT_ASCII_OFFSET <= Codepoint) && (Codepoint <= FONT_ASCII_OFFSET + FONT_ASCII_COUNT);
+    memory_size Result = CountNewLines(Base, Count);
     return Result;
 }
 
-internal inline b32
-IsValidAndNotNewLine(text_iterator Iterator)
+internal inline u64
+GetLineIndexGapSize(text_line_index *LineIndex)
 {
-    b32 Result = IsValid(Iterator) && (Iterator.Codepoint != '\n');
+    u64 Result = LineIndex->Capacity - LineIndex->Count;
     return Result;
 }
 
-internal inline u32
-GetCodepointColumnCount(editor_settings *Settings, u32 Codepoint, u32 ColumnOffset)
+internal inline memory_offset
+GetBufferOffsetOfLine(text_line_index *LineIndex, u64 Line)
 {
-    u32 Result = 1;
-    if (Codepoint == '\t')
+    memory_offset Result = LineIndex->TextSize;
+    if (Line < LineIndex->GapIndex)
     {
-        Result = Settings->TabWidth - (ColumnOffset % Settings->TabWidth);
+        Result = LineIndex->Entries[Line];
     }
+    else if (Line < LineIndex->Count)
+    {
+        Result = LineIndex->TextSize - LineIndex->Entries[Line + GetLineIndexGapSize(LineIndex)];
+    }
+
     return Result;
 }
 
-internal inline memory_size
-GetNumberOfLines(char *Base, memory_size Count)
+// NOTE(traian): Returns the index of the line that contains the given offset.
+internal inline u64
+GetLineOfBufferOffset(text_line_index *LineIndex, memory_offset Offset)
 {
-    memory_size Result = 0;
-    for (u32 Index = 0; Index < Count; ++Index)
+    Assert(Offset <= LineIndex->TextSize);
+    if (LineIndex->Count == 0)
+    {
+        return 0;
+    }
+
+    // NOTE(traian): Find the last line that starts at or before the offset.
+    u64 First = 0;
+    u64 Last = LineIndex->Count - 1;
+    while (First < Last)
     {
-        if (Base[Index] == '\n')
+        u64 Middle = First + (Last - First + 1) / 2;
+        if (GetBufferOffsetOfLine(LineIndex, Middle) <= Offset)
+        {
+            First = Middle;
+        }
+        else
         {
-            ++Result;
+            Last = Middle - 1;
         }
     }
 
-    return Result;
+    return First;
 }
 
-internal inline u32
-GetBufferOffsetOfLine(text_buffer Buffer, u32 Line)
+internal inline void
+MoveLineIndexGap(text_line_index *LineIndex, u64 Line)
 {
-    u32 Offset = 0;
-    while (Line--)
+    Assert(Line <= LineIndex->Count);
+    u64 GapSize = GetLineIndexGapSize(LineIndex);
+
+    // NOTE(traian): The entries that cross the gap switch between being relative to the start and being
+    // relative to the end of the text.
+    while (LineIndex->GapIndex > Line)
     {
-        while (Offset < Buffer.Used && Buffer.Base[Offset++] != '\n');
+        --LineIndex->GapIndex;
+        memory_offset Offset = LineIndex->Entries[LineIndex->GapIndex];
+        LineIndex->Entries[LineIndex->GapIndex + GapSize] = LineIndex->TextSize - Offset;
+    }
+    while (LineIndex->GapIndex < Line)
+    {
+        memory_offset Distance = LineIndex->Entries[LineIndex->GapIndex + GapSize];
+        LineIndex->Entries[LineIndex->GapIndex] = LineIndex->TextSize - Distance;
+        ++LineIndex->GapIndex;
     }
-
-    return Offset;
 }
 
-internal inline memory_size
-GetBufferOffset(text_buffer Buffer, editor_settings *Settings, u32 Line, u32 Column)
+internal inline void
+ReserveLineIndexGap(text_line_index *LineIndex, u64 EntryCount)
 {
-    memory_size Result = GetBufferOffsetOfLine(Buffer, Line);
-    text_iterator Iterator = NewTextIterator(&Buffer, Result);
-
-    u32 ColumnOffset = 0;
-    while (ColumnOffset < Column)
+    if (GetLineIndexGapSize(LineIndex) < EntryCount)
     {
-        Assert(IsValidAndNotNewLine(Iterator));
+        u64 NewCapacity = Maximum(LineIndex->Count + EntryCount, 2 * LineIndex->Capacity);
+        buffer OldEntries = { (u8 *)LineIndex->Entries, LineIndex->Capacity * sizeof(memory_offset) };
+        buffer NewEntries = PlatformAllocateMemory(NewCapacity * sizeof(memory_offset));
 
-        ColumnOffset += GetCodepointColumnCount(Settings, Iterator.Codepoint, ColumnOffset);
-        Result += Iterator.Width;
-        Iterator = AdvanceIterator(Iterator);
-    }
+        u64 AfterGapCount = LineIndex->Count - LineIndex->GapIndex;
+        memory_offset *Entries = (memory_offset *)NewEntries.Data;
+        if (LineIndex->Entries)
+        {
+            CopyArray(Entries, LineIndex->Entries, LineIndex->GapIndex);
+            CopyArray(Entries + NewCapacity - AfterGapCount,
+                      LineIndex->Entries + LineIndex->Capacity - AfterGapCount, AfterGapCount);
+            PlatformReleaseMemory(OldEntries);
+        }
 
-    Assert(ColumnOffset == Column);
-    return Result;
+        LineIndex->Entries = Entries;
+        LineIndex->Capacity = NewCapacity;
+    }
 }
 
-internal inline text_iterator
-GetCurrentLineFirstIterator(text_iterator Iterator)
+// NOTE(traian): Builds the line index from scratch. The gap is placed at the end of the index.
+internal inline void
+BuildLineIndex(text_line_index *LineIndex, text_buffer *Buffer)
 {
-    text_iterator Result = DevanceIterator(Iterator);
-    while (IsValidAndNotNewLine(Result))
+    text_buffer_spans TextSpans = GetBufferSpans(Buffer);
+    u64 LineCount = 1;
+    for (u32 SpanIndex = 0; SpanIndex < ArrayCount(TextSpans.Spans); ++SpanIndex)
     {
-        Result = DevanceIterator(Result);
+        buffer *Span = TextSpans.Spans + SpanIndex;
+        LineCount += GetNumberOfLines((char *)Span->Data, Span->Size);
     }
 
-    if (!IsValid(Result))
+    LineIndex->Count = 0;
+    LineIndex->GapIndex = 0;
+    LineIndex->TextSize = Buffer->Used;
+    if (LineIndex->Capacity < LineCount || LineIndex->Capacity > 2 * LineCount + Kilobytes(1))
     {
-        Result = NewTextIterator(Iterator.Buffer, 0);
+        buffer OldEntries = { (u8 *)LineIndex->Entries, LineIndex->Capacity * sizeof(memory_offset) };
+        PlatformReleaseMemory(OldEntries);
+        LineIndex->Entries = NULL;
+        LineIndex->Capacity = 0;
+        ReserveLineIndexGap(LineIndex, LineCount + LineCount / 8 + Kilobytes(1));
     }
-    else
+
+    memory_offset *Entry = LineIndex->Entries;
+    *Entry++ = 0;
+
+    memory_offset SpanOffset = 0;
+    for (u32 SpanIndex = 0; SpanIndex < ArrayCount(TextSpans.Spans); ++SpanIndex)
     {
-        Result = AdvanceIterator(Result);
+        buffer *Span = TextSpans.Spans + SpanIndex;
+        Entry += FindLineStarts((char *)Span->Data, Span->Size, SpanOffset, Entry);
+        SpanOffset += Span->Size;
     }
 
-    return Result;
+    LineIndex->Count = LineCount;
+    LineIndex->GapIndex = LineCount;
+    LineIndex->ScannedSize = Buffer->Used;
 }
 
-internal inline text_iterator
-GetCurrentLineLastIterator(text_iterator Iterator)
+// NOTE(traian): Starts a lazy line index, that only knows about the first line. It's extended on demand
+// by ExtendLineIndex, so the text is only scanned as far as it's actually needed.
+internal inline void
+BeginLineIndex(text_line_index *LineIndex, text_buffer *Buffer)
 {
-    text_iterator Result = Iterator;
-    while (IsValidAndNotNewLine(Result))
-    {
-        Result = AdvanceIterator(Result);
-    }
+    LineIndex->Count = 0;
+    LineIndex->GapIndex = 0;
+    LineIndex->TextSize = Buffer->Used;
+    LineIndex->ScannedSize = 0;
+    ReserveLineIndexGap(LineIndex, 1);
 
-    if (!IsValid(Iterator) && Iterator.Buffer->Used > 0)
-    {
-        Result = NewTextIterator(Iterator.Buffer, Iterator.Buffer->Used - 1);
-    }
+    LineIndex->Entries[0] = 0;
+    LineIndex->Count = 1;
+    LineIndex->GapIndex = 1;
+}
 
+internal inline b32
+IsLineIndexComplete(text_line_index *LineIndex)
+{
+    b32 Result = (LineIndex->ScannedSize == LineIndex->TextSize);
     return Result;
 }
 
-internal inline text_iterator
-GetPreviousLineLastIterator(text_iterator Iterator)
+// NOTE(traian): Scans the text that isn't indexed yet, one chunk at a time, until the start of the given
+// line is known or the whole text has been scanned.
+internal inline void
+ExtendLineIndex(text_line_index *LineIndex, text_buffer *Buffer, u64 Line)
 {
-    text_iterator Result = DevanceIterator(Iterator);
-    while (IsValid(Result) && Result.Codepoint != '\n')
+    while (Line >= LineIndex->Count && !IsLineIndexComplete(LineIndex))
     {
-        Result = DevanceIterator(Result);
+        Assert(LineIndex->GapIndex == LineIndex->Count);
+
+        memory_offset ChunkOffset = LineIndex->ScannedSize;
+        memory_size ChunkSize = Minimum(LINE_INDEX_SCAN_CHUNK_SIZE, LineIndex->TextSize - ChunkOffset);
+        if (ChunkOffset < Buffer->GapOffset)
+        {
+            ChunkSize = Minimum(ChunkSize, Buffer->GapOffset - ChunkOffset);
+        }
+
+        char *Chunk = GetBufferAddress(Buffer, ChunkOffset);
+        u64 NewLineCount = GetNumberOfLines(Chunk, ChunkSize);
+        ReserveLineIndexGap(LineIndex, NewLineCount);
+        FindLineStarts(Chunk, ChunkSize, ChunkOffset, LineIndex->Entries + LineIndex->GapIndex);
+
+        LineIndex->Count += NewLineCount;
+        LineIndex->GapIndex += NewLineCount;
+        LineIndex->ScannedSize += ChunkSize;
     }
+}
 
-    return Result;
+internal inline void
+InsertIntoLineIndex(text_line_index *LineIndex, memory_offset Offset, char *Characters, memory_size ByteCount)
+{
+    Assert(IsLineIndexComplete(LineIndex));
+    u64 NewLineCount = GetNumberOfLines(Characters, ByteCount);
+    u64 Line = GetLineOfBufferOffset(LineIndex, Offset);
+
+    // NOTE(traian): The lines after the insertion are stored relative to the end of the text, so they
+    // don't have to be updated.
+    MoveLineIndexGap(LineIndex, Line + 1);
+    ReserveLineIndexGap(LineIndex, NewLineCount);
+    LineIndex->TextSize += ByteCount;
+    LineIndex->ScannedSize += ByteCount;
+
+    memory_offset *Entry = LineIndex->Entries + LineIndex->GapIndex;
+    u64 WrittenCount = FindLineStarts(Characters, ByteCount, Offset, Entry);
+    Assert(WrittenCount == NewLineCount);
+    LineIndex->GapIndex += WrittenCount;
+    LineIndex->Count += WrittenCount;
 }
 
-internal inline text_iterator
-GetPreviousLineFirstIterator(text_iterator Iterator)
+internal inline void
+RemoveFromLineIndex(text_line_index *LineIndex, memory_offset Offset, memory_size ByteCount)
 {
-    text_iterator Result = GetPreviousLineLastIterator(Iterator);
-    if (IsValid(Result))
-    {
-        Result = GetCurrentLineFirstIterator(Result);
-    }
+    Assert(IsLineIndexComplete(LineIndex));
+    u64 Line = GetLineOfBufferOffset(LineIndex, Offset);
+    u64 LastLine = GetLineOfBufferOffset(LineIndex, Offset + ByteCount);
 
-    return Result;
+    // NOTE(traian): The lines that start inside the removed range are [Line + 1, LastLine]. They are
+    // moved right after the gap and then the gap is extended over them.
+    MoveLineIndexGap(LineIndex, Line + 1);
+    LineIndex->Count -= (LastLine - Line);
+    LineIndex->TextSize -= ByteCount;
+    LineIndex->ScannedSize -= ByteCount;
 }
 
-internal inline text_iterator
-GetNextLineFirstIterator(text_iterator Iterator)
+//
+// NOTE(traian): Text panel helpers, which keep the line count of the panel in sync with its line index.
+//
+
+internal void
+ReserveTextLineEndings(text_line_endings *LineEndings, u64 Count)
 {
-    text_iterator Result = Iterator;
-    while (IsValid(Result) && Result.Codepoint != '\n')
+    memory_size RequiredSize = (LineEndings->Count + Count) * sizeof(memory_offset);
+    if (RequiredSize > LineEndings->Memory.Size)
     {
-        Result = AdvanceIterator(Result);
-    }
+        buffer NewMemory = PlatformAllocateMemory(Maximum(Maximum(2 * LineEndings->Memory.Size, Kilobytes(4)),
+                                                          RequiredSize));
+        CopyArray((memory_offset *)NewMemory.Data, LineEndings->Offsets, LineEndings->Count);
+        if (LineEndings->Memory.Data)
+        {
+            PlatformReleaseMemory(LineEndings->Memory);
+        }
 
-    if (IsValid(Result))
-    {
-        Result = AdvanceIterator(Result);
+        LineEndings->Memory = NewMemory;
+        LineEndings->Offsets = (memory_offset *)NewMemory.Data;
     }
+}
 
-    return Result;
+internal void
+AppendTextLineEnding(text_line_endings *LineEndings, memory_offset Offset)
+{
+    ReserveTextLineEndings(LineEndings, 1);
+    LineEndings->Offsets[LineEndings->Count++] = Offset;
 }
 
-internal inline text_iterator
-GetLastCharacterIterator(text_buffer *Buffer)
+// NOTE(traian): Returns the index of the first line ending at or after the offset.
+internal u64
+FindTextLineEnding(text_line_endings *LineEndings, memory_offset Offset)
 {
-    text_iterator Result = {};
-    
-    if (Buffer->Used > 0)
+    u64 First = 0;
+    u64 Last = LineEndings->Count;
+    while (First < Last)
     {
-        Result.Offset = Buffer->Used - 1;
-        Result.Buffer = Buffer;
-        Result = DevanceIterator(Result);
+        u64 Middle = First + (Last - First) / 2;
+        if (LineEndings->Offsets[Middle] < Offset)
+        {
+            First = Middle + 1;
+        }
+        else
+        {
+            Last = Middle;
+        }
     }
 
-    return Result;
+    return First;
 }
 
-internal inline u32
-GetCodepointToggledCapital(u32 Codepoint)
+// NOTE(traian): Returns the index of the first line ending in [Offset, Offset + ByteCount), and their count.
+internal u64
+FindTextLineEndingsInRange(text_line_endings *LineEndings, memory_offset Offset, memory_size ByteCount, u64 *Count)
 {
-    if ('A' <= Codepoint && Codepoint <= 'Z')
+    u64 First = FindTextLineEnding(LineEndings, Offset);
+    *Count = FindTextLineEnding(LineEndings, Offset + ByteCount) - First;
+    return First;
+}
+
+// NOTE(traian): Puts back the line endings of text that was just inserted at the offset, which are given relative
+// to it. The inserted text has no line endings yet.
+internal void
+InsertTextLineEndings(text_line_endings *LineEndings, memory_offset Offset, memory_offset *RelativeOffsets,
+                      u64 Count)
+{
+    if (Count == 0)
     {
-        u32 Result = Codepoint + ('a' - 'A');
-        return Result;
+        return;
     }
-    if ('a' <= Codepoint && Codepoint <= 'z')
+
+    ReserveTextLineEndings(LineEndings, Count);
+    u64 First = FindTextLineEnding(LineEndings, Offset);
+    memory_offset *Offsets = LineEndings->Offsets;
+    MoveMem(Offsets + First + Count, Offsets + First, (LineEndings->Count - First) * sizeof(memory_offset));
+    for (u64 Index = 0; Index < Count; ++Index)
     {
-        u32 Result = Codepoint - ('a' - 'A');
-        return Result;
+        Offsets[First + Index] = Offset + RelativeOffsets[Index];
     }
-
-    return Codepoint;
+    LineEndings->Count += Count;
 }
 
-internal inline u32
-GetCodepointShiftCorrespondant(u32 Codepoint)
+// NOTE(traian): Normalizes the line endings of text that was just loaded at the given offset of the text,
+// in place, and records the new lines that don't end like the first one. The written count is the number of
+// bytes that can be appended to the text; a carriage return that ends a chunk isn't read and is moved right
+// after them, so that it's normalized with the next chunk.
+internal transcode_result
+NormalizeLoadedLineEndings(text_file_format *Format, text_line_endings *LineEndings, memory_offset TextOffset,
+                           u8 *Text, memory_size Count, b32 IsFinal)
 {
-    u32 Result = GetCodepointToggledCapital(Codepoint);
-    if (Result != Codepoint)
+    if (!Format->HasNewLine)
     {
-        return Result;
+        memory_size FirstNewLine = FindLiteral((char *)Text, Count, "\n", 1);
+        b32 IsCRLF = (FirstNewLine > 0 && FirstNewLine < Count && Text[FirstNewLine - 1] == '\r');
+        Format->NewLineEnding = IsCRLF ? LineEnding_CRLF : LineEnding_LF;
+        Format->LineEnding = Format->NewLineEnding;
+        Format->HasNewLine = (FirstNewLine < Count);
     }
 
-    switch (Codepoint)
+    memory_offset ReadIndex = 0;
+    memory_offset WriteIndex = 0;
+    if (Format->NewLineEnding == LineEnding_CRLF)
     {
-        case '0':  return ')';
-        case '1':  return '!';
-        case '2':  return '@';
-        case '3':  return '#';
-        case '4':  return '$';
-        case '5':  return '%';
-        case '6':  return '^';
-        case '7':  return '&';
-        case '8':  return '*';
-        case '9':  return '(';
+        // NOTE(traian): The kernel stops at each new line that doesn't follow a carriage return.
+        for (;;)
+        {
+            transcode_result Normalized = NormalizeLineEndings(Text + ReadIndex, Count - ReadIndex, IsFinal);
+            MoveMem(Text + WriteIndex, Text + ReadIndex, Normalized.WrittenCount);
+            ReadIndex += Normalized.ReadCount;
+            WriteIndex += Normalized.WrittenCount;
+            if (ReadIndex == Count || Text[ReadIndex] != '\n')
+            {
+                break;
+            }
 
-        case ';':  return ':';
-        case ',':  return '<';
-        case '.':  return '>';
-        case '=':  return '+';
-        case '-':  return '_';
-        case '\'': return '"';
-        case '`':  return '~';
-        case '/':  return '?';
-        case '\\': return '|';
-        case '[':  return '{';
-        case ']':  return '}';
+            AppendTextLineEnding(LineEndings, TextOffset + WriteIndex);
+            Text[WriteIndex++] = '\n';
+            ++ReadIndex;
+        }
+    }
+    else
+    {
+        for (;;)
+        {
+            memory_offset PairIndex = ReadIndex + FindLiteral((char *)Text + ReadIndex, Count - ReadIndex, "\r\n", 2);
+            if (WriteIndex < ReadIndex)
+            {
+                MoveMem(Text + WriteIndex, Text + ReadIndex, PairIndex - ReadIndex);
+            }
+            WriteIndex += PairIndex - ReadIndex;
+            ReadIndex = PairIndex;
+            if (ReadIndex == Count)
+            {
+                break;
+            }
+
+            AppendTextLineEnding(LineEndings, TextOffset + WriteIndex);
+            Text[WriteIndex++] = '\n';
+            ReadIndex += 2;
+        }
+
+        if (!IsFinal && WriteIndex > 0 && Text[WriteIndex - 1] == '\r')
+        {
+            --WriteIndex;
+            --ReadIndex;
+        }
+    }
+
+    MoveMem(Text + WriteIndex, Text + ReadIndex, Count - ReadIndex);
+    if (LineEndings->Count > 0)
+    {
+        Format->LineEnding = LineEnding_Mixed;
+    }
+
+    transcode_result Result = { ReadIndex, WriteIndex };
+    return Result;
+}
+
+// NOTE(traian): Keeps the line endings on their new lines when the text is edited. The line endings of the
+// new lines that are removed are dropped, so the history and the journal keep them for the insertion that puts
+// the text back.
+internal void
+UpdateTextLineEndings(text_line_endings *LineEndings, text_edit_kind Kind, memory_offset Offset,
+                      memory_size ByteCount)
+{
+    u64 Count = LineEndings->Count;
+    memory_offset *Offsets = LineEndings->Offsets;
+    if (Count == 0 || Offsets[Count - 1] < Offset)
+    {
+        return;
+    }
+
+    u64 First = FindTextLineEnding(LineEndings, Offset);
+    if (Kind == TextEditKind_Insert)
+    {
+        for (u64 Index = First; Index < Count; ++Index)
+        {
+            Offsets[Index] += ByteCount;
+        }
+    }
+    else
+    {
+        u64 WriteIndex = First;
+        for (u64 Index = First; Index < Count; ++Index)
+        {
+            if (Offsets[Index] >= Offset + ByteCount)
+            {
+                Offsets[WriteIndex++] = Offsets[Index] - ByteCount;
+            }
+        }
+        LineEndings->Count = WriteIndex;
+    }
+}
+
+// NOTE(traian): Appends the chunks that were loaded in the background since the last call to the text
+// of the panel and indexes their lines. Returns true if the panel changed.
+internal b32
+AbsorbLoadedText(text_panel *Panel)
+{
+    text_load *Load = &Panel->Load;
+    if (!Load->IsActive)
+    {
+        return false;
+    }
+
+    // NOTE(traian): IsDone is read first, so the loaded size is final if the load is done.
+    b32 IsDone = Load->IsDone;
+    CompletePreviousReadsBeforeFutureReads;
+    memory_size LoadedSize = Load->LoadedSize;
+    CompletePreviousReadsBeforeFutureReads;
+
+    // NOTE(traian): The text is loaded right after the end of the buffer, while the gap stays in front of
+    // the text. Growing the buffer over the loaded bytes is enough to append them.
+    text_buffer *Buffer = &Panel->Buffer;
+    memory_size NewByteCount = LoadedSize - Buffer->Used;
+    Assert(Buffer->Base + Buffer->Size == Load->Destination + Buffer->Used);
+    Buffer->Size += NewByteCount;
+    Buffer->Used += NewByteCount;
+    Panel->LineIndex.TextSize += NewByteCount;
+
+    ExtendLineIndex(&Panel->LineIndex, Buffer, (u64)-1);
+    Panel->LineCount = Panel->LineIndex.Count - 1;
+
+    if (IsDone)
+    {
+        PlatformCloseFile(&Load->File);
+        Load->IsActive = false;
+
+        if (Load->Staging.Data)
+        {
+            PlatformReleaseMemory(Load->Staging);
+            Load->Staging = {};
+        }
+
+        // NOTE(traian): A load that was cancelled or failed didn't hash all of the chunks.
+        Panel->DiskHashes.IsValid = (Load->FileOffset == Load->FileSize);
+        Panel->Format = Load->Format;
+        Panel->HasLoadFailed = Load->HasFailed;
+    }
+
+    b32 Result = (NewByteCount > 0) || IsDone;
+    return Result;
+}
+
+// NOTE(traian): Stops the background load of the panel, keeping the text that was loaded so far.
+internal void
+CancelTextLoad(text_panel *Panel)
+{
+    text_load *Load = &Panel->Load;
+    if (Load->IsActive)
+    {
+        Load->IsCancelled = true;
+        while (Load->IsActive)
+        {
+            if (!AbsorbLoadedText(Panel))
+            {
+                _mm_pause();
+            }
+        }
+    }
+}
+
+internal inline void
+EnsureLinesAreIndexed(text_panel *Panel, u64 Line)
+{
+    if (!IsLineIndexComplete(&Panel->LineIndex))
+    {
+        ExtendLineIndex(&Panel->LineIndex, &Panel->Buffer, Line);
+        Panel->LineCount = Panel->LineIndex.Count - 1;
+    }
+
+    // NOTE(traian): While the file is loading, only wait for the chunk that contains the line.
+    while (Panel->Load.IsActive && Line >= Panel->LineIndex.Count)
+    {
+        if (!AbsorbLoadedText(Panel))
+        {
+            _mm_pause();
+        }
+    }
+}
+
+internal inline memory_offset
+GetBufferOffsetOfLine(text_panel *Panel, u64 Line)
+{
+    EnsureLinesAreIndexed(Panel, Line);
+    memory_offset Result = GetBufferOffsetOfLine(&Panel->LineIndex, Line);
+    return Result;
+}
+
+// NOTE(traian): The chunks of a mapped file are hashed right before the mapping is given up, since they're only
+// read once.
+internal inline void
+HashMappedText(text_panel *Panel)
+{
+    text_buffer *Buffer = &Panel->Buffer;
+    text_disk_hashes *DiskHashes = &Panel->DiskHashes;
+    if (Buffer->IsMapped && DiskHashes->FileSize == Buffer->Used)
+    {
+        HashTextChunks(DiskHashes->ChunkHashes, Buffer->Used, (u8 *)Buffer->Base, 0, Buffer->Used);
+        DiskHashes->IsValid = true;
+    }
+}
+
+// NOTE(traian): Must be called before the text of the panel is modified. A file that is still loading is
+// waited for, while a mapped file is fully indexed, hashed and copied into an allocated buffer.
+internal inline void
+MakeTextPanelEditable(text_panel *Panel)
+{
+    if (Panel->Load.IsActive || Panel->Buffer.IsMapped)
+    {
+        EnsureLinesAreIndexed(Panel, (u64)-1);
+        HashMappedText(Panel);
+        PromoteMappedBuffer(&Panel->Buffer);
+    }
+}
+
+//=========================================================================================
+// NOTE(traian): COLUMN MAPS.
+//=========================================================================================
+
+// NOTE(traian): The East Asian wide and fullwidth blocks, whose characters take two columns.
+internal inline b32
+IsWideCodepoint(u32 Codepoint)
+{
+    if (Codepoint < 0x1100)
+    {
+        return false;
     }
 
+    b32 Result = (Codepoint <= 0x115F) ||
+                 (0x2E80 <= Codepoint && Codepoint <= 0x303E) ||
+                 (0x3041 <= Codepoint && Codepoint <= 0x33FF) ||
+                 (0x3400 <= Codepoint && Codepoint <= 0x4DBF) ||
+                 (0x4E00 <= Codepoint && Codepoint <= 0x9FFF) ||
+                 (0xA000 <= Codepoint && Codepoint <= 0xA4CF) ||
+                 (0xAC00 <= Codepoint && Codepoint <= 0xD7A3) ||
+                 (0xF900 <= Codepoint && Codepoint <= 0xFAFF) ||
+                 (0xFE30 <= Codepoint && Codepoint <= 0xFE4F) ||
+                 (0xFF00 <= Codepoint && Codepoint <= 0xFF60) ||
+                 (0xFFE0 <= Codepoint && Codepoint <= 0xFFE6) ||
+                 (0x1F300 <= Codepoint && Codepoint <= 0x1F64F) ||
+                 (0x1F900 <= Codepoint && Codepoint <= 0x1F9FF) ||
+                 (0x20000 <= Codepoint && Codepoint <= 0x3FFFD);
     return Result;
 }
 
 internal inline u32
-GetCodepointFromKeyCode(key_code KeyCode)
+GetCodepointColumnCount(editor_settings *Settings, u32 Codepoint, u64 ColumnOffset)
 {
-    if (KeyCode_AlphabetKeyFirst <= KeyCode && KeyCode <= KeyCode_AlphabetKeyLast)
+    u32 Result = 1;
+    if (Codepoint == '\t')
     {
-        u32 Codepoint = 'a' + (KeyCode - KeyCode_AlphabetKeyFirst);
-        return Codepoint;
+        Result = Settings->TabWidth - (u32)(ColumnOffset % Settings->TabWidth);
     }
-    if (KeyCode_Zero <= KeyCode && KeyCode <= KeyCode_Nine)
+    else if (IsWideCodepoint(Codepoint))
     {
-        u32 Codepoint = '0' + (KeyCode - KeyCode_Zero);
-        return Codepoint;
+        Result = 2;
     }
+    return Result;
+}
 
-    switch (KeyCode)
+// NOTE(traian): The index of the first stop that starts at or after the offset in the line.
+internal inline u64
+FindColumnStop(text_column_map *Map, memory_offset Offset)
+{
+    u64 Low = 0;
+    u64 High = Map->StopCount;
+    while (Low < High)
     {
-        case KeyCode_Space:        return ' ';
-        case KeyCode_Enter:        return '\n';
-        case KeyCode_Tab:          return '\t';
+        u64 Middle = Low + (High - Low) / 2;
+        if (Map->Stops[Middle].Offset < Offset)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+    return Low;
+}
 
-        case KeyCode_Semicolon:    return ';';
-        case KeyCode_Comma:        return ',';
-        case KeyCode_Period:       return '.';
-        case KeyCode_Equals:       return '=';
-        case KeyCode_Minus:        return '-';
-        case KeyCode_Apostrophe:   return '\'';
-        case KeyCode_Backtick:     return '`';
-        case KeyCode_Slash:        return '/';
-        case KeyCode_Backslash:    return '\\';
-        case KeyCode_LeftBracket:  return '[';
-        case KeyCode_RightBracket: return ']';
+internal inline void
+ReserveColumnStops(text_column_map *Map, u64 StopCount)
+{
+    if (Map->StopCapacity < StopCount)
+    {
+        u64 NewCapacity = Maximum(StopCount, Maximum(2 * Map->StopCapacity, 256));
+        buffer OldStops = { (u8 *)Map->Stops, Map->StopCapacity * sizeof(text_column_stop) };
+        buffer NewStops = PlatformAllocateMemory(NewCapacity * sizeof(text_column_stop));
+        if (Map->Stops)
+        {
+            CopyArray((text_column_stop *)NewStops.Data, Map->Stops, Map->StopCount);
+            PlatformReleaseMemory(OldStops);
+        }
+
+        Map->Stops = (text_column_stop *)NewStops.Data;
+        Map->StopCapacity = NewCapacity;
     }
+}
 
-    InvalidCodePath;
-    return 0;
+internal inline void
+AddColumnStop(text_column_map *Map, memory_offset Offset, u32 Width, u64 Column, u32 ColumnCount)
+{
+    ReserveColumnStops(Map, Map->StopCount + 1);
+    text_column_stop *Stop = Map->Stops + Map->StopCount++;
+    Stop->Offset = Offset;
+    Stop->Column = Column;
+    Stop->Width = Width;
+    Stop->ColumnCount = ColumnCount;
+}
+
+// NOTE(traian): Recomputes the columns of the stops, starting with the given one. The bytes between the stops
+// are one column each, and only the tabs change their width when they move to another column.
+internal void
+RecomputeColumnStops(text_column_map *Map, u64 FirstStopIndex)
+{
+    u64 Column = 0;
+    memory_offset End = 0;
+    if (FirstStopIndex > 0)
+    {
+        text_column_stop *Previous = Map->Stops + FirstStopIndex - 1;
+        Column = Previous->Column + Previous->ColumnCount;
+        End = Previous->Offset + Previous->Width;
+    }
+
+    for (u64 StopIndex = FirstStopIndex; StopIndex < Map->StopCount; ++StopIndex)
+    {
+        text_column_stop *Stop = Map->Stops + StopIndex;
+        Column += Stop->Offset - End;
+        Stop->Column = Column;
+        if (Stop->Width == 1)
+        {
+            Stop->ColumnCount = Map->TabWidth - (u32)(Column % Map->TabWidth);
+        }
+
+        Column += Stop->ColumnCount;
+        End = Stop->Offset + Stop->Width;
+    }
+
+    Map->ColumnCount = Column + (Map->ByteCount - End);
+}
+
+// NOTE(traian): Returns true if the stop that precedes the offset ends after it, which means that the
+// offset is inside of a codepoint.
+internal inline b32
+IsInsideColumnStop(text_column_map *Map, u64 StopIndex, memory_offset Offset)
+{
+    b32 Result = false;
+    if (StopIndex > 0)
+    {
+        text_column_stop *Previous = Map->Stops + StopIndex - 1;
+        Result = (Previous->Offset + Previous->Width > Offset);
+    }
+    return Result;
+}
+
+// NOTE(traian): Inserts text without new lines into the line. Returns false if the map has to be rebuilt.
+internal b32
+InsertIntoColumnMap(text_column_map *Map, memory_offset Offset, char *Characters, memory_size ByteCount)
+{
+    u64 StopIndex = FindColumnStop(Map, Offset);
+    if (IsInsideColumnStop(Map, StopIndex, Offset) || !IsValidUTF8((u8 *)Characters, ByteCount))
+    {
+        return false;
+    }
+
+    u64 NewStopCount = 0;
+    for (memory_offset Index = 0; Index < ByteCount;)
+    {
+        u32 Codepoint;
+        u32 Width = DecodeUTF8((u8 *)Characters + Index, ByteCount - Index, &Codepoint);
+        NewStopCount += (Width > 1 || Codepoint == '\t');
+        Index += Width;
+    }
+
+    ReserveColumnStops(Map, Map->StopCount + NewStopCount);
+    text_column_stop *Stops = Map->Stops;
+    MoveMem(Stops + StopIndex + NewStopCount, Stops + StopIndex, (Map->StopCount - StopIndex) * sizeof(text_column_stop));
+    Map->StopCount += NewStopCount;
+    for (u64 MovedIndex = StopIndex + NewStopCount; MovedIndex < Map->StopCount; ++MovedIndex)
+    {
+        Stops[MovedIndex].Offset += ByteCount;
+    }
+
+    // NOTE(traian): The columns of the new stops are computed together with the ones after them.
+    text_column_stop *Stop = Stops + StopIndex;
+    for (memory_offset Index = 0; Index < ByteCount;)
+    {
+        u32 Codepoint;
+        u32 Width = DecodeUTF8((u8 *)Characters + Index, ByteCount - Index, &Codepoint);
+        if (Width > 1 || Codepoint == '\t')
+        {
+            Stop->Offset = Offset + Index;
+            Stop->Width = Width;
+            Stop->ColumnCount = IsWideCodepoint(Codepoint) ? 2 : 1;
+            ++Stop;
+        }
+        Index += Width;
+    }
+
+    Map->ByteCount += ByteCount;
+    RecomputeColumnStops(Map, StopIndex);
+    return true;
+}
+
+// NOTE(traian): Removes a range of the line, without its new line. Returns false if the map has to be rebuilt.
+internal b32
+RemoveFromColumnMap(text_column_map *Map, memory_offset Offset, memory_size ByteCount)
+{
+    u64 FirstStopIndex = FindColumnStop(Map, Offset);
+    u64 EndStopIndex = FindColumnStop(Map, Offset + ByteCount);
+    if (IsInsideColumnStop(Map, FirstStopIndex, Offset) || IsInsideColumnStop(Map, EndStopIndex, Offset + ByteCount))
+    {
+        return false;
+    }
+
+    text_column_stop *Stops = Map->Stops;
+    MoveMem(Stops + FirstStopIndex, Stops + EndStopIndex, (Map->StopCount - EndStopIndex) * sizeof(text_column_stop));
+    Map->StopCount -= EndStopIndex - FirstStopIndex;
+    for (u64 MovedIndex = FirstStopIndex; MovedIndex < Map->StopCount; ++MovedIndex)
+    {
+        Stops[MovedIndex].Offset -= ByteCount;
+    }
+
+    Map->ByteCount -= ByteCount;
+    RecomputeColumnStops(Map, FirstStopIndex);
+    return true;
+}
+
+internal inline void
+InvalidateTextColumnMaps(text_panel *Panel)
+{
+    for (u32 MapIndex = 0; MapIndex < TEXT_COLUMN_MAP_COUNT; ++MapIndex)
+    {
+        Panel->ColumnMaps[MapIndex].IsValid = false;
+    }
+}
+
+// NOTE(traian): Called after an edit was applied to the text and to the line index. An edit inside of a line
+// updates its map in place, an edit before it only moves it, and an edit that splits or joins it discards it.
+internal void
+UpdateTextColumnMaps(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                     memory_size ByteCount)
+{
+    text_buffer *Buffer = &Panel->Buffer;
+    for (u32 MapIndex = 0; MapIndex < TEXT_COLUMN_MAP_COUNT; ++MapIndex)
+    {
+        text_column_map *Map = Panel->ColumnMaps + MapIndex;
+        memory_offset LineEnd = Map->LineOffset + Map->ByteCount;
+        if (!Map->IsValid || Offset > LineEnd)
+        {
+            continue;
+        }
+
+        b32 IsKept = false;
+        if (Kind == TextEditKind_Insert)
+        {
+            if (Offset < Map->LineOffset)
+            {
+                Map->LineOffset += ByteCount;
+                Map->Line = GetLineOfBufferOffset(&Panel->LineIndex, Map->LineOffset);
+                IsKept = true;
+            }
+            else if (GetNumberOfLines(Characters, ByteCount) == 0)
+            {
+                // NOTE(traian): The bytes that follow the inserted ones mustn't continue a sequence from them.
+                memory_offset InsertEnd = Offset + ByteCount;
+                IsKept = (InsertEnd == Buffer->Used || (GetBufferCharacter(Buffer, InsertEnd) & 0xC0) != 0x80) &&
+                         InsertIntoColumnMap(Map, Offset - Map->LineOffset, Characters, ByteCount);
+            }
+        }
+        else
+        {
+            if (Offset + ByteCount < Map->LineOffset)
+            {
+                Map->LineOffset -= ByteCount;
+                Map->Line = GetLineOfBufferOffset(&Panel->LineIndex, Map->LineOffset);
+                IsKept = true;
+            }
+            else if (Offset >= Map->LineOffset && Offset + ByteCount <= LineEnd)
+            {
+                IsKept = (Offset == Buffer->Used || (GetBufferCharacter(Buffer, Offset) & 0xC0) != 0x80) &&
+                         RemoveFromColumnMap(Map, Offset - Map->LineOffset, ByteCount);
+            }
+        }
+
+        Map->IsValid = IsKept;
+    }
+}
+
+//=========================================================================================
+// NOTE(traian): SYNTAX HIGHLIGHT.
+//=========================================================================================
+
+global char *SyntaxHighlightedExtensions[] =
+{
+    ".c", ".h", ".cpp", ".hpp", ".cc", ".hh", ".cxx", ".hxx", ".inl",
+};
+
+internal b32
+IsSyntaxHighlightedFile(char *FileName)
+{
+    if (!FileName)
+    {
+        return false;
+    }
+
+    memory_size FileNameLength = StringLength(FileName);
+    for (u32 ExtensionIndex = 0; ExtensionIndex < ArrayCount(SyntaxHighlightedExtensions); ++ExtensionIndex)
+    {
+        char *Extension = SyntaxHighlightedExtensions[ExtensionIndex];
+        memory_size ExtensionLength = StringLength(Extension);
+        if (FileNameLength > ExtensionLength &&
+            AreBytesEqual(FileName + FileNameLength - ExtensionLength, Extension, ExtensionLength))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// NOTE(traian): Discards the states of the lines. The job that is running, if any, keeps its own memory and its
+// results are ignored.
+internal inline void
+ResetTextHighlight(text_panel *Panel)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    Highlight->LineCount = 0;
+    Highlight->FirstPendingLine = 0;
+    Highlight->EditVersion = Panel->EditVersion;
+    Highlight->SliceSize = TEXT_HIGHLIGHT_FIRST_SLICE_SIZE;
+    ++Highlight->Version;
+}
+
+internal inline void
+ReserveTextHighlightLines(text_highlight *Highlight, u64 LineCount)
+{
+    if (Highlight->LineCapacity < LineCount)
+    {
+        u64 NewCapacity = Maximum(LineCount, Maximum(2 * Highlight->LineCapacity, 4096));
+        buffer OldStates = { (u8 *)Highlight->LineStates, Highlight->LineCapacity * sizeof(syntax_state) };
+        buffer NewStates = PlatformAllocateMemory(NewCapacity * sizeof(syntax_state));
+        if (Highlight->LineStates)
+        {
+            CopyArray((syntax_state *)NewStates.Data, Highlight->LineStates, Highlight->LineCount);
+            PlatformReleaseMemory(OldStates);
+        }
+
+        Highlight->LineStates = (syntax_state *)NewStates.Data;
+        Highlight->LineCapacity = NewCapacity;
+    }
+}
+
+// NOTE(traian): The lines that were added to the line index by a load, or by the lazy indexing of a mapped file,
+// start with an unknown state. The first line always starts in the normal state.
+internal inline void
+AddTextHighlightLines(text_highlight *Highlight, u64 LineCount)
+{
+    if (Highlight->LineCount < LineCount)
+    {
+        ReserveTextHighlightLines(Highlight, LineCount);
+        SetMemory(Highlight->LineStates + Highlight->LineCount, SyntaxState_Unknown | SyntaxState_PendingFlag,
+                  LineCount - Highlight->LineCount);
+        if (Highlight->LineCount == 0)
+        {
+            Highlight->LineStates[0] = SyntaxState_Normal;
+        }
+
+        Highlight->FirstPendingLine = Minimum(Highlight->FirstPendingLine, Highlight->LineCount);
+        Highlight->LineCount = LineCount;
+    }
+}
+
+// NOTE(traian): Returns the state that is drawn for the line, which is unknown if the line was never lexed.
+internal inline syntax_state
+GetTextHighlightState(text_highlight *Highlight, u64 Line)
+{
+    syntax_state Result = SyntaxState_Unknown;
+    if (Line < Highlight->LineCount)
+    {
+        Result = (syntax_state)(Highlight->LineStates[Line] & ~SyntaxState_PendingFlag);
+    }
+    return Result;
+}
+
+// NOTE(traian): Returns the first pending line, starting with the given one, or the number of lines if there is
+// no such line. The states are checked eight at a time.
+internal u64
+FindPendingTextHighlightLine(text_highlight *Highlight, u64 Line)
+{
+    syntax_state *States = Highlight->LineStates;
+    u64 LineCount = Highlight->LineCount;
+    for (; Line < LineCount && (Line % 8) != 0; ++Line)
+    {
+        if (States[Line] & SyntaxState_PendingFlag)
+        {
+            return Line;
+        }
+    }
+
+    for (; Line + 8 <= LineCount; Line += 8)
+    {
+        if (*(u64 *)(States + Line) & 0x8080808080808080ull)
+        {
+            break;
+        }
+    }
+
+    for (; Line < LineCount; ++Line)
+    {
+        if (States[Line] & SyntaxState_PendingFlag)
+        {
+            return Line;
+        }
+    }
+    return LineCount;
+}
+
+// NOTE(traian): Called after an edit was applied to the text and to the line index. The lines before the edited
+// one keep their states and the ones after the edited text are moved. The lines that were inserted have unknown
+// states and the line that follows the edited text becomes pending, since its state depends on the edited text.
+internal void
+UpdateTextHighlight(text_panel *Panel, u64 OldLineCount, memory_offset Offset)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    if (Highlight->LineCount == 0 || Highlight->LineCount > OldLineCount ||
+        Highlight->EditVersion + 1 != Panel->EditVersion)
+    {
+        ResetTextHighlight(Panel);
+        return;
+    }
+
+    AddTextHighlightLines(Highlight, OldLineCount);
+    u64 LineCount = Panel->LineIndex.Count;
+    u64 Line = GetLineOfBufferOffset(&Panel->LineIndex, Offset);
+    u64 AddedCount = 0;
+    if (LineCount > OldLineCount)
+    {
+        AddedCount = LineCount - OldLineCount;
+        ReserveTextHighlightLines(Highlight, LineCount);
+        syntax_state *States = Highlight->LineStates;
+        MoveMem(States + Line + 1 + AddedCount, States + Line + 1, (OldLineCount - Line - 1) * sizeof(syntax_state));
+        SetMemory(States + Line + 1, SyntaxState_Unknown | SyntaxState_PendingFlag, AddedCount);
+    }
+    else if (LineCount < OldLineCount)
+    {
+        u64 RemovedCount = OldLineCount - LineCount;
+        syntax_state *States = Highlight->LineStates;
+        MoveMem(States + Line + 1, States + Line + 1 + RemovedCount, (LineCount - Line - 1) * sizeof(syntax_state));
+    }
+
+    u64 PendingLine = Line + 1 + AddedCount;
+    if (PendingLine < LineCount)
+    {
+        Highlight->LineStates[PendingLine] = (syntax_state)(Highlight->LineStates[PendingLine] |
+                                                            SyntaxState_PendingFlag);
+    }
+
+    Highlight->LineCount = LineCount;
+    Highlight->FirstPendingLine = Minimum(Highlight->FirstPendingLine, Line + 1);
+    Highlight->EditVersion = Panel->EditVersion;
+    ++Highlight->Version;
+}
+
+// NOTE(traian): Returns the text of a line, without its new line, but at most MaxByteCount bytes of it. A line
+// that is split by the gap is copied to the scratch memory. Returns NULL if the end of the line isn't known yet.
+internal char *
+GetTextHighlightLine(text_panel *Panel, u64 Line, memory_size MaxByteCount, memory_size *ByteCount)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    text_line_index *LineIndex = &Panel->LineIndex;
+    text_buffer *Buffer = &Panel->Buffer;
+
+    memory_offset LineEnd = Buffer->Used;
+    if (Line + 1 < LineIndex->Count)
+    {
+        LineEnd = GetBufferOffsetOfLine(LineIndex, Line + 1) - 1;
+    }
+    else if (!IsLineIndexComplete(LineIndex))
+    {
+        return NULL;
+    }
+
+    memory_offset LineStart = GetBufferOffsetOfLine(LineIndex, Line);
+    *ByteCount = Minimum(Minimum(LineEnd, Buffer->Used) - LineStart, MaxByteCount);
+    if (LineStart < Buffer->GapOffset && LineStart + *ByteCount > Buffer->GapOffset)
+    {
+        if (Highlight->ScratchSize < *ByteCount)
+        {
+            if (Highlight->Scratch)
+            {
+                PlatformReleaseMemory({ (u8 *)Highlight->Scratch, Highlight->ScratchSize });
+            }
+
+            buffer Scratch = PlatformAllocateMemory(Maximum(*ByteCount, Kilobytes(4)));
+            Highlight->Scratch = (char *)Scratch.Data;
+            Highlight->ScratchSize = Scratch.Size;
+        }
+
+        CopyFromBuffer(Buffer, LineStart, *ByteCount, Highlight->Scratch);
+        return Highlight->Scratch;
+    }
+
+    char *Result = GetBufferAddress(Buffer, LineStart);
+    return Result;
+}
+
+// NOTE(traian): Returns the lexer at the start of the line, as it was when the line was last lexed. The delimiter
+// of a raw string that started before the line is recovered by lexing the lines from the one where it starts.
+internal syntax_lexer
+GetTextHighlightLexer(text_panel *Panel, u64 Line)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    syntax_lexer Lexer = {};
+    Lexer.State = GetTextHighlightState(Highlight, Line);
+    if (Lexer.State == SyntaxState_RawString)
+    {
+        u64 FirstLine = Line;
+        while (GetTextHighlightState(Highlight, FirstLine - 1) == SyntaxState_RawString)
+        {
+            --FirstLine;
+        }
+
+        Lexer.State = GetTextHighlightState(Highlight, FirstLine - 1);
+        for (u64 LexedLine = FirstLine - 1; LexedLine < Line && Lexer.State != SyntaxState_Unknown; ++LexedLine)
+        {
+            memory_size ByteCount;
+            char *Text = GetTextHighlightLine(Panel, LexedLine, INVALID_SIZE, &ByteCount);
+            Lexer = Text ? LexSyntaxLine(Lexer, Text, ByteCount, NULL, NULL) : Lexer;
+            Lexer.State = Text ? Lexer.State : SyntaxState_Unknown;
+        }
+    }
+    return Lexer;
+}
+
+// NOTE(traian): Lexes the lines of the job until a line ends in the state that the next line already had. The lines
+// after it are unchanged, so they keep their states up to the next pending one. The raw strings never converge,
+// since the states don't remember their delimiters.
+internal PLATFORM_WORK_QUEUE_CALLBACK(LexTextHighlightWork)
+{
+    text_highlight_job *Job = (text_highlight_job *)Data;
+    syntax_state *States = (syntax_state *)Job->States.Data;
+    char *Text = (char *)Job->Text.Data;
+
+    syntax_lexer Lexer = {};
+    Lexer.State = Job->StartState;
+    Job->ResultCount = 0;
+    Job->HasConverged = false;
+
+    memory_offset LineStart = 0;
+    u64 EndLine = Job->FirstLine + Job->LineCount;
+    for (u64 Line = Job->StartLine + 1; Line < EndLine; ++Line)
+    {
+        memory_size ByteCount = FindLiteral(Text + LineStart, Job->TextSize - LineStart, "\n", 1);
+        Lexer = LexSyntaxLine(Lexer, Text + LineStart, ByteCount, NULL, NULL);
+        LineStart += ByteCount + 1;
+        if (Line >= Job->FirstLine)
+        {
+            syntax_state *State = States + (Line - Job->FirstLine);
+            b32 HasConverged = ((*State & ~SyntaxState_PendingFlag) == Lexer.State) &&
+                               (Lexer.State != SyntaxState_RawString);
+            *State = Lexer.State;
+            Job->ResultCount = Line - Job->FirstLine + 1;
+            if (HasConverged)
+            {
+                Job->HasConverged = true;
+                break;
+            }
+        }
+    }
+
+    CompletePreviousWritesBeforeFutureWrites;
+    Job->IsDone = true;
+}
+
+// NOTE(traian): Copies the text and the states of the lines starting with the first pending one into the job.
+// Returns false if there is no pending line whose previous line is complete.
+internal b32
+PrepareTextHighlightJob(text_panel *Panel)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    text_highlight_job *Job = &Highlight->Job;
+    text_line_index *LineIndex = &Panel->LineIndex;
+    Assert(!Job->IsActive);
+
+    u64 FirstLine = FindPendingTextHighlightLine(Highlight, Highlight->FirstPendingLine);
+    Highlight->FirstPendingLine = FirstLine;
+    if (FirstLine >= Highlight->LineCount)
+    {
+        return false;
+    }
+
+    // NOTE(traian): The lexing starts at the line where the raw string that contains the first line starts.
+    Assert(FirstLine > 0);
+    u64 StartLine = FirstLine - 1;
+    while (GetTextHighlightState(Highlight, StartLine) == SyntaxState_RawString)
+    {
+        --StartLine;
+    }
+
+    memory_offset TextStart = GetBufferOffsetOfLine(LineIndex, StartLine);
+    memory_size SliceSize = Maximum(Highlight->SliceSize, TEXT_HIGHLIGHT_FIRST_SLICE_SIZE);
+    memory_offset SliceEnd = Minimum(GetBufferOffsetOfLine(LineIndex, FirstLine) + SliceSize, LineIndex->TextSize);
+    u64 EndLine = Minimum(GetLineOfBufferOffset(LineIndex, SliceEnd), Highlight->LineCount - 1);
+    memory_offset TextEnd = GetBufferOffsetOfLine(LineIndex, EndLine);
+
+    Job->TextSize = TextEnd - TextStart;
+    if (Job->Text.Size < Job->TextSize)
+    {
+        if (Job->Text.Data)
+        {
+            PlatformReleaseMemory(Job->Text);
+        }
+        Job->Text = PlatformAllocateMemory(Maximum(Job->TextSize, TEXT_HIGHLIGHT_MAX_SLICE_SIZE));
+    }
+    CopyFromBuffer(&Panel->Buffer, TextStart, Job->TextSize, (char *)Job->Text.Data);
+
+    Job->LineCount = EndLine - FirstLine + 1;
+    if (Job->States.Size < Job->LineCount * sizeof(syntax_state))
+    {
+        if (Job->States.Data)
+        {
+            PlatformReleaseMemory(Job->States);
+        }
+        Job->States = PlatformAllocateMemory(Maximum(Job->LineCount, Kilobytes(64)) * sizeof(syntax_state));
+    }
+    CopyArray((syntax_state *)Job->States.Data, Highlight->LineStates + FirstLine, Job->LineCount);
+
+    Job->Version = Highlight->Version;
+    Job->StartLine = StartLine;
+    Job->StartState = GetTextHighlightState(Highlight, StartLine);
+    Job->FirstLine = FirstLine;
+    Job->IsDone = false;
+    return true;
+}
+
+// NOTE(traian): Takes the results of the job, if it's done. The results of a job that was started before the last
+// edit are dropped. Returns true if the states changed.
+internal b32
+AbsorbTextHighlightJob(text_panel *Panel)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    text_highlight_job *Job = &Highlight->Job;
+    if (!Job->IsActive || !Job->IsDone)
+    {
+        return false;
+    }
+
+    CompletePreviousReadsBeforeFutureReads;
+    Job->IsActive = false;
+    if (Job->Version != Highlight->Version)
+    {
+        return false;
+    }
+
+    CopyArray(Highlight->LineStates + Job->FirstLine, (syntax_state *)Job->States.Data, Job->ResultCount);
+    u64 NextLine = Job->FirstLine + Job->ResultCount;
+    if (!Job->HasConverged && NextLine < Highlight->LineCount)
+    {
+        // NOTE(traian): The state of the next line depends on the lines that were lexed again.
+        Highlight->LineStates[NextLine] = (syntax_state)(Highlight->LineStates[NextLine] | SyntaxState_PendingFlag);
+    }
+    Highlight->FirstPendingLine = NextLine;
+    Highlight->SliceSize = Job->HasConverged ? TEXT_HIGHLIGHT_FIRST_SLICE_SIZE
+                                             : Minimum(2 * Maximum(Highlight->SliceSize, TEXT_HIGHLIGHT_FIRST_SLICE_SIZE),
+                                                       TEXT_HIGHLIGHT_MAX_SLICE_SIZE);
+    return true;
+}
+
+// NOTE(traian): Brings the states up to date with the text of the panel. Returns false if the text of the panel
+// isn't highlighted.
+internal b32
+SyncTextHighlight(text_panel *Panel)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    Highlight->IsEnabled = IsSyntaxHighlightedFile(Panel->FileName);
+    if (Highlight->EditVersion != Panel->EditVersion || (!Highlight->IsEnabled && Highlight->LineCount > 0))
+    {
+        ResetTextHighlight(Panel);
+    }
+    if (!Highlight->IsEnabled)
+    {
+        return false;
+    }
+
+    AddTextHighlightLines(Highlight, Panel->LineIndex.Count);
+    return true;
+}
+
+// NOTE(traian): Called periodically, and after every command. Takes the results of the job that is running and
+// starts the next one. The main thread never waits for a job, so the edits are never slowed down by the lexer.
+// Returns true if the states changed.
+internal b32
+ContinueTextHighlight(text_panel *Panel, platform_work_queue *WorkQueue)
+{
+    text_highlight *Highlight = &Panel->Highlight;
+    b32 Result = AbsorbTextHighlightJob(Panel);
+    if (SyncTextHighlight(Panel) && !Highlight->Job.IsActive && PrepareTextHighlightJob(Panel))
+    {
+        // NOTE(traian): If the queue is full, the job is prepared again by the next call.
+        Highlight->Job.IsActive = true;
+        CompletePreviousWritesBeforeFutureWrites;
+        if (!PlatformAddWorkEntry(WorkQueue, LexTextHighlightWork, &Highlight->Job))
+        {
+            Highlight->Job.IsActive = false;
+        }
+    }
+    return Result;
+}
+
+// NOTE(traian): The visible lines of a mapped file are indexed before they are drawn, so that their states are
+// computed. The renderer never waits for a file that is still loading. Returns false if the text of the panel
+// isn't highlighted.
+internal b32
+UpdateVisibleTextHighlight(text_panel *Panel, u64 LastLine)
+{
+    if (!Panel->Load.IsActive && IsSyntaxHighlightedFile(Panel->FileName))
+    {
+        EnsureLinesAreIndexed(Panel, LastLine + 1);
+    }
+
+    b32 Result = SyncTextHighlight(Panel);
+    return Result;
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT JOURNAL.
+//=========================================================================================
+
+// NOTE(traian): 32-bit FNV-1a.
+internal inline u32
+HashBytes(u32 Hash, void *Bytes, memory_size ByteCount)
+{
+    u8 *Byte = (u8 *)Bytes;
+    for (memory_size Index = 0; Index < ByteCount; ++Index)
+    {
+        Hash = (Hash ^ Byte[Index]) * 16777619u;
+    }
+
+    return Hash;
+}
+
+#define HASH_BYTES_SEED 2166136261u
+
+internal inline u32
+ComputeJournalEntryChecksum(text_journal_entry Entry, char *Bytes, memory_size ByteCount, void *LineEndings)
+{
+    Entry.Checksum = 0;
+    u32 Result = HashBytes(HASH_BYTES_SEED, &Entry, sizeof(Entry));
+    Result = HashBytes(Result, Bytes, ByteCount);
+    Result = HashBytes(Result, LineEndings, Entry.LineEndingCount * sizeof(memory_offset));
+    return Result;
+}
+
+// NOTE(traian): Called when a document is opened in the panel. The journal isn't created until the
+// document is edited.
+internal void
+SetTextJournalDocument(text_journal *Journal, char *FileName)
+{
+    Assert(!Journal->IsOpen);
+    Journal->FileName[0] = 0;
+    Journal->IsUnavailable = true;
+    Journal->IsRecoveryPending = false;
+
+    memory_size FileNameLength = FileName ? StringLength(FileName) : 0;
+    memory_size ExtensionLength = sizeof(TEXT_JOURNAL_FILE_EXTENSION) - 1;
+    if (FileNameLength > 0 && FileNameLength + ExtensionLength < sizeof(Journal->FileName))
+    {
+        CopyMem(Journal->FileName, FileName, FileNameLength);
+        CopyMem(Journal->FileName + FileNameLength, TEXT_JOURNAL_FILE_EXTENSION, ExtensionLength + 1);
+        Journal->IsUnavailable = false;
+    }
+}
+
+internal inline void
+WaitForTextJournal(text_journal *Journal)
+{
+    while (Journal->IsWriting)
+    {
+        _mm_pause();
+    }
+    CompletePreviousReadsBeforeFutureReads;
+}
+
+// NOTE(traian): Writes directly to the file, on the calling thread. The file is flushed by the next sync.
+internal void
+WriteToTextJournal(text_journal *Journal, void *Data, memory_size ByteCount)
+{
+    buffer Block = { (u8 *)Data, ByteCount };
+    if (PlatformWriteFile(&Journal->File, Journal->FileOffset, Block) != ByteCount)
+    {
+        // TODO(traian): Logging.
+    }
+
+    Journal->FileOffset += ByteCount;
+    Journal->NeedsSync = true;
+}
+
+// NOTE(traian): Creates the journal file, for the version of the document that is currently on the disk.
+internal b32
+CreateTextJournal(text_journal *Journal, char *DocumentFileName)
+{
+    Journal->File = PlatformOpenFileForWriting(Journal->FileName, true);
+    if (!Journal->File.Handle)
+    {
+        // TODO(traian): Logging.
+        Journal->IsUnavailable = true;
+        return false;
+    }
+
+    if (!Journal->Pending.Data)
+    {
+        Journal->Pending = PlatformAllocateMemory(TEXT_JOURNAL_BUFFER_SIZE);
+        Journal->Writing = PlatformAllocateMemory(TEXT_JOURNAL_BUFFER_SIZE);
+    }
+
+    Journal->IsOpen = true;
+    Journal->FileOffset = 0;
+    Journal->PendingSize = 0;
+    Journal->LastSyncWallClock = PlatformGetWallClock();
+
+    text_journal_header Header = {};
+    Header.Magic = TEXT_JOURNAL_MAGIC;
+    Header.Version = TEXT_JOURNAL_VERSION;
+    Header.FileSize = PlatformGetFileSize(DocumentFileName);
+    Header.FileWriteTime = PlatformGetFileWriteTime(DocumentFileName);
+    WriteToTextJournal(Journal, &Header, sizeof(Header));
+    return true;
+}
+
+// NOTE(traian): Closes the journal and deletes its file. Called once the edits are no longer needed, either
+// because the document was saved or because it was closed.
+internal void
+CloseTextJournal(text_journal *Journal)
+{
+    if (Journal->IsOpen)
+    {
+        WaitForTextJournal(Journal);
+        PlatformCloseFile(&Journal->File);
+        PlatformDeleteFile(Journal->FileName);
+        Journal->IsOpen = false;
+        Journal->PendingSize = 0;
+        Journal->NeedsSync = false;
+    }
+}
+
+internal PLATFORM_WORK_QUEUE_CALLBACK(SyncTextJournalWork)
+{
+    text_journal *Journal = (text_journal *)Data;
+
+    if (Journal->WritingSize > 0)
+    {
+        buffer Batch = { Journal->Writing.Data, Journal->WritingSize };
+        if (PlatformWriteFile(&Journal->File, Journal->WritingOffset, Batch) != Journal->WritingSize)
+        {
+            // TODO(traian): Logging.
+        }
+    }
+    PlatformFlushFile(&Journal->File);
+
+    CompletePreviousWritesBeforeFutureWrites;
+    Journal->IsWriting = false;
+}
+
+// NOTE(traian): Hands the pending entries to a work queue thread, which writes them and flushes the file. The
+// previous batch must be written already.
+internal void
+BeginTextJournalWrite(platform_work_queue *WorkQueue, text_journal *Journal, u64 WallClock)
+{
+    Assert(!Journal->IsWriting);
+    CompletePreviousReadsBeforeFutureReads;
+    buffer Batch = Journal->Writing;
+    Journal->Writing = Journal->Pending;
+    Journal->Pending = Batch;
+    Journal->WritingSize = Journal->PendingSize;
+    Journal->WritingOffset = Journal->FileOffset;
+    Journal->FileOffset += Journal->PendingSize;
+    Journal->PendingSize = 0;
+    Journal->NeedsSync = false;
+    Journal->LastSyncWallClock = WallClock;
+
+    // NOTE(traian): If the queue is full, the batch is written on the calling thread, so the entries are still
+    // durable once the sync returns.
+    Journal->IsWriting = true;
+    CompletePreviousWritesBeforeFutureWrites;
+    if (!PlatformAddWorkEntry(WorkQueue, SyncTextJournalWork, Journal))
+    {
+        SyncTextJournalWork(WorkQueue, Journal);
+    }
+}
+
+// NOTE(traian): Called periodically. Hands the pending entries to a work queue thread, unless the journal was
+// synced less than a sync interval ago.
+internal void
+SyncTextJournal(platform_work_queue *WorkQueue, text_journal *Journal)
+{
+    if (!Journal->IsOpen || Journal->IsWriting || (Journal->PendingSize == 0 && !Journal->NeedsSync))
+    {
+        return;
+    }
+
+    u64 WallClock = PlatformGetWallClock();
+    if (PlatformGetSecondsElapsed(Journal->LastSyncWallClock, WallClock) < TEXT_JOURNAL_SYNC_INTERVAL_SECONDS)
+    {
+        return;
+    }
+
+    BeginTextJournalWrite(WorkQueue, Journal, WallClock);
+}
+
+internal void
+AppendToTextJournal(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                    memory_size ByteCount, memory_offset *LineEndings, u64 LineEndingCount)
+{
+    text_journal *Journal = &Panel->Journal;
+    if (!Journal->IsOpen && (Journal->IsUnavailable || !CreateTextJournal(Journal, Panel->FileName)))
+    {
+        return;
+    }
+
+    // NOTE(traian): Replaying a removal doesn't need the removed bytes, nor the line endings it drops.
+    b32 IsInsert = (Kind == TextEditKind_Insert);
+    memory_size PayloadSize = IsInsert ? ByteCount : 0;
+    memory_size LineEndingSize = IsInsert ? (LineEndingCount * sizeof(memory_offset)) : 0;
+
+    text_journal_entry Entry;
+    Entry.Offset = Offset;
+    Entry.ByteCount = ByteCount;
+    Entry.LineEndingCount = IsInsert ? LineEndingCount : 0;
+    Entry.Kind = Kind;
+    Entry.Checksum = ComputeJournalEntryChecksum(Entry, Characters, PayloadSize, LineEndings);
+
+    memory_size EntrySize = sizeof(Entry) + PayloadSize + LineEndingSize;
+    if (Journal->PendingSize + EntrySize > Journal->Pending.Size)
+    {
+        // NOTE(traian): A full batch is written in the background right away. If the previous batch is still being
+        // written, or the entry is larger than a batch, the pending memory grows instead, so that an edit never
+        // waits for the disk.
+        if (Journal->WorkQueue && !Journal->IsWriting && Journal->PendingSize > 0)
+        {
+            BeginTextJournalWrite(Journal->WorkQueue, Journal, PlatformGetWallClock());
+        }
+
+        if (Journal->PendingSize + EntrySize > Journal->Pending.Size)
+        {
+            memory_size NewSize = Maximum(2 * Journal->Pending.Size, Journal->PendingSize + EntrySize);
+            buffer NewPending = PlatformAllocateMemory(NewSize);
+            CopyMem(NewPending.Data, Journal->Pending.Data, Journal->PendingSize);
+            PlatformReleaseMemory(Journal->Pending);
+            Journal->Pending = NewPending;
+        }
+    }
+
+    u8 *Destination = Journal->Pending.Data + Journal->PendingSize;
+    CopyMem(Destination, &Entry, sizeof(Entry));
+    CopyMem(Destination + sizeof(Entry), Characters, PayloadSize);
+    CopyMem(Destination + sizeof(Entry) + PayloadSize, LineEndings, LineEndingSize);
+    Journal->PendingSize += EntrySize;
+}
+
+// NOTE(traian): Called at startup for the documents that are opened, so that the journals left behind by the
+// previous session are replayed once the documents are loaded.
+internal void
+BeginTextJournalRecovery(text_journal *Journal)
+{
+    Journal->IsRecoveryPending = !Journal->IsUnavailable && (PlatformGetFileSize(Journal->FileName) != INVALID_SIZE);
+}
+
+// NOTE(traian): Moves the cursor to the piece that contains the offset, or past the last piece if the offset is
+// the end of the text.
+internal void
+SeekTextJournalPiece(text_journal_replay *Replay, memory_offset Offset)
+{
+    text_journal_piece *Pieces = Replay->Pieces;
+    while (Replay->CursorIndex > 0 && Offset < Replay->CursorOffset)
+    {
+        --Replay->CursorIndex;
+        Replay->CursorOffset -= Pieces[Replay->CursorIndex].Size;
+    }
+    while (Replay->CursorIndex < Replay->PieceCount &&
+           Offset >= Replay->CursorOffset + Pieces[Replay->CursorIndex].Size)
+    {
+        Replay->CursorOffset += Pieces[Replay->CursorIndex].Size;
+        ++Replay->CursorIndex;
+    }
+}
+
+// NOTE(traian): Splits the piece that contains the offset, so that a piece starts at it. Returns the index of
+// that piece, which is also where the cursor is left.
+internal u64
+SplitTextJournalPiece(text_journal_replay *Replay, memory_offset Offset)
+{
+    SeekTextJournalPiece(Replay, Offset);
+    if (Offset > Replay->CursorOffset)
+    {
+        text_journal_piece *Piece = Replay->Pieces + Replay->CursorIndex;
+        MoveMem(Piece + 1, Piece, (Replay->PieceCount - Replay->CursorIndex) * sizeof(text_journal_piece));
+        ++Replay->PieceCount;
+
+        memory_size HeadSize = Offset - Replay->CursorOffset;
+        Piece[0].Size = HeadSize;
+        Piece[1].Offset += HeadSize;
+        Piece[1].Size -= HeadSize;
+        ++Replay->CursorIndex;
+        Replay->CursorOffset = Offset;
+    }
+
+    return Replay->CursorIndex;
+}
+
+// NOTE(traian): Bytes that are typed one after the other extend the piece of the previous insertion, so the
+// number of pieces only grows with the places that were edited.
+internal void
+ReplayTextJournalInsertion(text_journal_replay *Replay, memory_offset Offset, char *Bytes, memory_size ByteCount,
+                           memory_offset *LineEndings, u64 LineEndingCount)
+{
+    u64 Index = SplitTextJournalPiece(Replay, Offset);
+    text_journal_piece *Previous = (Index > 0) ? Replay->Pieces + Index - 1 : NULL;
+    if (Previous && Previous->IsInserted && Previous->Offset + Previous->Size == Replay->InsertedSize)
+    {
+        Previous->Size += ByteCount;
+    }
+    else
+    {
+        text_journal_piece *Piece = Replay->Pieces + Index;
+        MoveMem(Piece + 1, Piece, (Replay->PieceCount - Index) * sizeof(text_journal_piece));
+        ++Replay->PieceCount;
+
+        Piece->Offset = Replay->InsertedSize;
+        Piece->Size = ByteCount;
+        Piece->IsInserted = true;
+        ++Replay->CursorIndex;
+    }
+
+    Replay->CursorOffset += ByteCount;
+    Replay->TextSize += ByteCount;
+
+    text_line_endings *InsertedLineEndings = &Replay->InsertedLineEndings;
+    for (u64 LineEnding = 0; LineEnding < LineEndingCount; ++LineEnding)
+    {
+        InsertedLineEndings->Offsets[InsertedLineEndings->Count++] = Replay->InsertedSize + LineEndings[LineEnding];
+    }
+    CopyMem(Replay->Inserted + Replay->InsertedSize, Bytes, ByteCount);
+    Replay->InsertedSize += ByteCount;
+}
+
+// NOTE(traian): A removal at either end of a piece only trims it. A backspace right after typing also takes back
+// the bytes at the end of the inserted bytes, so that the typing that follows still extends the same piece.
+internal void
+ReplayTextJournalRemoval(text_journal_replay *Replay, memory_offset Offset, memory_size ByteCount)
+{
+    Replay->TextSize -= ByteCount;
+    SeekTextJournalPiece(Replay, Offset);
+    text_journal_piece *Piece = Replay->Pieces + Replay->CursorIndex;
+    memory_offset PieceEnd = Replay->CursorOffset + Piece->Size;
+    if (ByteCount > 0 && Replay->CursorIndex < Replay->PieceCount && Offset + ByteCount == PieceEnd &&
+        Offset > Replay->CursorOffset)
+    {
+        Piece->Size -= ByteCount;
+        if (Piece->IsInserted && Piece->Offset + Piece->Size + ByteCount == Replay->InsertedSize)
+        {
+            Replay->InsertedSize -= ByteCount;
+            text_line_endings *InsertedLineEndings = &Replay->InsertedLineEndings;
+            while (InsertedLineEndings->Count > 0 &&
+                   InsertedLineEndings->Offsets[InsertedLineEndings->Count - 1] >= Replay->InsertedSize)
+            {
+                --InsertedLineEndings->Count;
+            }
+        }
+        return;
+    }
+    if (Replay->CursorIndex < Replay->PieceCount && Offset == Replay->CursorOffset && Offset + ByteCount < PieceEnd)
+    {
+        Piece->Offset += ByteCount;
+        Piece->Size -= ByteCount;
+        return;
+    }
+
+    u64 First = SplitTextJournalPiece(Replay, Offset);
+    u64 Last = SplitTextJournalPiece(Replay, Offset + ByteCount);
+    text_journal_piece *Pieces = Replay->Pieces;
+    MoveMem(Pieces + First, Pieces + Last, (Replay->PieceCount - Last) * sizeof(text_journal_piece));
+    Replay->PieceCount -= Last - First;
+    Replay->CursorIndex = First;
+    Replay->CursorOffset = Offset;
+}
+
+// NOTE(traian): Replays the journal that was left behind by a previous session onto the document, if the journal
+// was written for the version of the document that is on the disk. The document has to be loaded. The entries
+// only edit the list of pieces, and the text, its line endings and its line index are built once at the end, in
+// a single pass, so recovering thousands of edits doesn't move the text around for each of them. The journal is
+// kept and new edits are appended to it. Returns true if any edit was recovered.
+internal b32
+RecoverTextJournal(text_panel *Panel)
+{
+    text_journal *Journal = &Panel->Journal;
+    Journal->IsRecoveryPending = false;
+    if (Journal->IsUnavailable || PlatformGetFileSize(Journal->FileName) == INVALID_SIZE)
+    {
+        return false;
+    }
+
+    platform_file File = PlatformOpenFileForWriting(Journal->FileName, false);
+    if (!File.Handle)
+    {
+        // TODO(traian): Logging.
+        return false;
+    }
+
+    buffer Contents = PlatformAllocateMemory(File.Size);
+    text_journal_header *Header = (text_journal_header *)Contents.Data;
+    b32 IsValid = (File.Size >= sizeof(text_journal_header)) &&
+                  (PlatformReadFile(&File, 0, Contents) == File.Size) &&
+                  (Header->Magic == TEXT_JOURNAL_MAGIC) &&
+                  (Header->Version == TEXT_JOURNAL_VERSION) &&
+                  (Header->FileSize == PlatformGetFileSize(Panel->FileName)) &&
+                  (Header->FileWriteTime == PlatformGetFileWriteTime(Panel->FileName));
+
+    if (!IsValid)
+    {
+        // NOTE(traian): The document changed since the journal was written, so the edits no longer apply.
+        PlatformReleaseMemory(Contents);
+        PlatformCloseFile(&File);
+        PlatformDeleteFile(Journal->FileName);
+        return false;
+    }
+
+    Assert(!Panel->Load.IsActive);
+    if (Panel->HasLoadFailed)
+    {
+        // NOTE(traian): The journal still applies to the document on the disk, so it's kept for the next open.
+        PlatformReleaseMemory(Contents);
+        PlatformCloseFile(&File);
+        return false;
+    }
+
+    // NOTE(traian): Every entry adds at most two pieces, and what it inserts is part of the journal, so the size
+    // of the journal bounds the memory of the replay.
+    text_buffer *Buffer = &Panel->Buffer;
+    u64 MaxPieceCount = 2 * (Contents.Size / sizeof(text_journal_entry)) + 1;
+    memory_size PiecesSize = MaxPieceCount * sizeof(text_journal_piece);
+    buffer ReplayMemory = PlatformAllocateMemory(PiecesSize + 2 * Contents.Size);
+
+    text_journal_replay Replay = {};
+    Replay.Pieces = (text_journal_piece *)ReplayMemory.Data;
+    Replay.InsertedLineEndings.Offsets = (memory_offset *)(ReplayMemory.Data + PiecesSize);
+    Replay.Inserted = (char *)ReplayMemory.Data + PiecesSize + Contents.Size;
+    Replay.TextSize = Buffer->Used;
+    if (Buffer->Used > 0)
+    {
+        Replay.Pieces[0] = { 0, Buffer->Used, false };
+        Replay.PieceCount = 1;
+    }
+
+    u32 EntryCount = 0;
+    memory_offset ReadOffset = sizeof(text_journal_header);
+    while (ReadOffset + sizeof(text_journal_entry) <= Contents.Size)
+    {
+        text_journal_entry Entry;
+        CopyMem(&Entry, Contents.Data + ReadOffset, sizeof(Entry));
+        char *Bytes = (char *)Contents.Data + ReadOffset + sizeof(Entry);
+
+        // NOTE(traian): Replaying stops at the first entry that wasn't completely written. Every line ending
+        // belongs to a new line of the inserted bytes, so there can't be more of them than bytes.
+        memory_size PayloadSize = (Entry.Kind == TextEditKind_Insert) ? Entry.ByteCount : 0;
+        memory_size RemainingSize = Contents.Size - ReadOffset - sizeof(Entry);
+        if (Entry.Kind > TextEditKind_Remove || PayloadSize > RemainingSize ||
+            Entry.LineEndingCount > PayloadSize ||
+            Entry.LineEndingCount * sizeof(memory_offset) > RemainingSize - PayloadSize)
+        {
+            break;
+        }
+
+        memory_offset *LineEndings = (memory_offset *)(Bytes + PayloadSize);
+        if (Entry.Checksum != ComputeJournalEntryChecksum(Entry, Bytes, PayloadSize, LineEndings))
+        {
+            break;
+        }
+
+        if (Entry.Kind == TextEditKind_Insert && Entry.Offset <= Replay.TextSize)
+        {
+            ReplayTextJournalInsertion(&Replay, Entry.Offset, Bytes, Entry.ByteCount, LineEndings,
+                                       Entry.LineEndingCount);
+        }
+        else if (Entry.Kind == TextEditKind_Remove && Entry.ByteCount <= Replay.TextSize &&
+                 Entry.Offset <= Replay.TextSize - Entry.ByteCount)
+        {
+            ReplayTextJournalRemoval(&Replay, Entry.Offset, Entry.ByteCount);
+        }
+        else
+        {
+            break;
+        }
+
+        Panel->UnmodifiedSize = Minimum(Panel->UnmodifiedSize, Entry.Offset);
+        ReadOffset += sizeof(Entry) + PayloadSize + Entry.LineEndingCount * sizeof(memory_offset);
+        ++EntryCount;
+    }
+
+    PlatformReleaseMemory(Contents);
+
+    if (EntryCount > 0)
+    {
+        // NOTE(traian): The pieces are copied in order, and so are their line endings.
+        u64 LineEndingCount = 0;
+        for (u64 Index = 0; Index < Replay.PieceCount; ++Index)
+        {
+            text_journal_piece *Piece = Replay.Pieces + Index;
+            u64 PieceLineEndingCount;
+            FindTextLineEndingsInRange(Piece->IsInserted ? &Replay.InsertedLineEndings : &Panel->LineEndings,
+                                       Piece->Offset, Piece->Size, &PieceLineEndingCount);
+            LineEndingCount += PieceLineEndingCount;
+        }
+
+        text_line_endings NewLineEndings = {};
+        ReserveTextLineEndings(&NewLineEndings, LineEndingCount);
+        buffer NewText = PlatformAllocateMemory(Replay.TextSize + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+        memory_offset WriteOffset = 0;
+        for (u64 Index = 0; Index < Replay.PieceCount; ++Index)
+        {
+            text_journal_piece *Piece = Replay.Pieces + Index;
+            text_line_endings *LineEndings = Piece->IsInserted ? &Replay.InsertedLineEndings : &Panel->LineEndings;
+            u64 PieceLineEndingCount;
+            u64 First = FindTextLineEndingsInRange(LineEndings, Piece->Offset, Piece->Size, &PieceLineEndingCount);
+            for (u64 LineEnding = First; LineEnding < First + PieceLineEndingCount; ++LineEnding)
+            {
+                NewLineEndings.Offsets[NewLineEndings.Count++] = LineEndings->Offsets[LineEnding] - Piece->Offset +
+                                                                 WriteOffset;
+            }
+
+            if (Piece->IsInserted)
+            {
+                CopyMem(NewText.Data + WriteOffset, Replay.Inserted + Piece->Offset, Piece->Size);
+            }
+            else
+            {
+                CopyFromBuffer(Buffer, Piece->Offset, Piece->Size, (char *)NewText.Data + WriteOffset);
+            }
+            WriteOffset += Piece->Size;
+        }
+
+        HashMappedText(Panel);
+        ReleaseBufferMemory(Buffer);
+        Buffer->Base = (char *)NewText.Data;
+        Buffer->Size = NewText.Size;
+        Buffer->Used = Replay.TextSize;
+        Buffer->GapOffset = Replay.TextSize;
+
+        if (Panel->LineEndings.Memory.Data)
+        {
+            PlatformReleaseMemory(Panel->LineEndings.Memory);
+        }
+        Panel->LineEndings = NewLineEndings;
+
+        BuildLineIndex(&Panel->LineIndex, Buffer);
+        Panel->LineCount = Panel->LineIndex.Count - 1;
+        Panel->IsSaveDirty = true;
+        ++Panel->EditVersion;
+        InvalidateTextColumnMaps(Panel);
+        ResetTextHighlight(Panel);
+    }
+    PlatformReleaseMemory(ReplayMemory);
+
+    // NOTE(traian): The entries that follow the last valid one are discarded, and the next edits are appended
+    // right after it.
+    PlatformSetFileSize(&File, ReadOffset);
+    if (!Journal->Pending.Data)
+    {
+        Journal->Pending = PlatformAllocateMemory(TEXT_JOURNAL_BUFFER_SIZE);
+        Journal->Writing = PlatformAllocateMemory(TEXT_JOURNAL_BUFFER_SIZE);
+    }
+
+    Journal->File = File;
+    Journal->IsOpen = true;
+    Journal->FileOffset = ReadOffset;
+    Journal->PendingSize = 0;
+    Journal->NeedsSync = true;
+    Journal->LastSyncWallClock = PlatformGetWallClock();
+    return (EntryCount > 0);
+}
+
+// NOTE(traian): Writes the pending entries and flushes the file, on the calling thread.
+internal void
+FlushTextJournal(text_journal *Journal)
+{
+    if (Journal->IsOpen)
+    {
+        WaitForTextJournal(Journal);
+        WriteToTextJournal(Journal, Journal->Pending.Data, Journal->PendingSize);
+        Journal->PendingSize = 0;
+        PlatformFlushFile(&Journal->File);
+        Journal->NeedsSync = false;
+    }
+}
+
+// NOTE(traian): Called once the document was saved. The entries before KeepOffset are part of the saved
+// document, so they are dropped, while the entries that follow are moved into a new journal, for the version
+// of the document that was just saved.
+internal void
+RebaseTextJournal(text_journal *Journal, char *DocumentFileName, memory_offset KeepOffset)
+{
+    if (!Journal->IsOpen)
+    {
+        return;
+    }
+
+    WaitForTextJournal(Journal);
+    memory_offset EndOffset = Journal->FileOffset + Journal->PendingSize;
+    if (KeepOffset >= EndOffset)
+    {
+        CloseTextJournal(Journal);
+        return;
+    }
+
+    WriteToTextJournal(Journal, Journal->Pending.Data, Journal->PendingSize);
+    Journal->PendingSize = 0;
+
+    buffer KeptEntries = PlatformAllocateMemory(EndOffset - KeepOffset);
+    PlatformReadFile(&Journal->File, KeepOffset, KeptEntries);
+    CloseTextJournal(Journal);
+
+    if (CreateTextJournal(Journal, DocumentFileName))
+    {
+        WriteToTextJournal(Journal, KeptEntries.Data, KeptEntries.Size);
+    }
+    PlatformReleaseMemory(KeptEntries);
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT SAVE.
+//=========================================================================================
+
+// NOTE(traian): Writes the chunk at the given offset of the text with the line endings of the document, which
+// can take twice as many bytes. LineEndingIndex is the index of the first line ending at or after the offset.
+internal memory_size
+RestoreLineEndings(text_file_format Format, text_line_endings *LineEndings, u64 *LineEndingIndex,
+                   u8 *Chunk, memory_offset Offset, memory_size Count, u8 *Destination)
+{
+    b32 IsCRLF = (Format.NewLineEnding == LineEnding_CRLF);
+    memory_size WrittenCount = 0;
+    memory_offset Index = 0;
+    while (Index < Count)
+    {
+        u64 LineEnding = *LineEndingIndex;
+        b32 HasLineEnding = (LineEnding < LineEndings->Count) && (LineEndings->Offsets[LineEnding] < Offset + Count);
+        memory_offset End = HasLineEnding ? (LineEndings->Offsets[LineEnding] - Offset) : Count;
+        if (IsCRLF)
+        {
+            WrittenCount += ExpandLineEndings(Chunk + Index, End - Index, Destination + WrittenCount);
+        }
+        else
+        {
+            CopyMem(Destination + WrittenCount, Chunk + Index, End - Index);
+            WrittenCount += End - Index;
+        }
+        Index = End;
+
+        // NOTE(traian): The new line that ends differently from the document.
+        if (HasLineEnding)
+        {
+            if (!IsCRLF)
+            {
+                Destination[WrittenCount++] = '\r';
+            }
+            Destination[WrittenCount++] = '\n';
+            ++Index;
+            ++*LineEndingIndex;
+        }
+    }
+
+    return WrittenCount;
+}
+
+// NOTE(traian): Starts producing the document from the UTF-8 snapshot of the save. The snapshot is only copied
+// when its bytes differ from the document.
+internal void
+BeginTextSaveEncoder(text_save_encoder *Encoder, text_save *Save, memory_size TextSize)
+{
+    *Encoder = {};
+    Encoder->Format = Save->Format;
+    Encoder->LineEndings = &Save->LineEndings;
+    Encoder->Text = Save->Snapshot.Data;
+    Encoder->TextSize = TextSize;
+
+    text_file_format Format = Save->Format;
+    memory_size MarkSize = GetByteOrderMarkSize(Format);
+    b32 IsCRLF = (Format.NewLineEnding == LineEnding_CRLF);
+    if (Format.Encoding == TextEncoding_UTF8 && MarkSize == 0 && !IsCRLF && Save->LineEndings.Count == 0)
+    {
+        return;
+    }
+
+    // NOTE(traian): When line endings are restored, the chunks are expanded into the staging memory, after the
+    // bytes that the encoder didn't consume from the previous chunk. The output is encoded from one chunk of
+    // the text, on top of less than a chunk of the document that is left from the last call.
+    Encoder->IsTranscoded = true;
+    if (IsCRLF || Save->LineEndings.Count > 0)
+    {
+        Encoder->Staging = PlatformAllocateMemory(2 * TEXT_SAVE_CHUNK_SIZE + sizeof(u32));
+    }
+    memory_size MaxEncodedSize = GetMaxEncodedSize(Format.Encoding, 2 * TEXT_SAVE_CHUNK_SIZE + sizeof(u32));
+    Encoder->Output = PlatformAllocateMemory(TEXT_SAVE_CHUNK_SIZE + MaxEncodedSize);
+    CopyMem(Encoder->Output.Data, GetByteOrderMark(Format), MarkSize);
+    Encoder->OutputCount = MarkSize;
+}
+
+internal void
+EndTextSaveEncoder(text_save_encoder *Encoder)
+{
+    if (Encoder->Staging.Data)
+    {
+        PlatformReleaseMemory(Encoder->Staging);
+    }
+    if (Encoder->Output.Data)
+    {
+        PlatformReleaseMemory(Encoder->Output);
+    }
+    *Encoder = {};
+}
+
+// NOTE(traian): Returns the next chunk of the document, restoring the line endings and transcoding the text on
+// the way. Every chunk but the last one is TEXT_SAVE_CHUNK_SIZE bytes long, and the chunk after the last one is
+// empty. The chunk is only valid until the next call.
+internal buffer
+NextTextSaveChunk(text_save_encoder *Encoder)
+{
+    buffer Result = {};
+    if (!Encoder->IsTranscoded)
+    {
+        Result.Data = Encoder->Text + Encoder->TextOffset;
+        Result.Size = Minimum(TEXT_SAVE_CHUNK_SIZE, Encoder->TextSize - Encoder->TextOffset);
+        Encoder->TextOffset += Result.Size;
+        return Result;
+    }
+
+    u8 *Output = Encoder->Output.Data;
+    Encoder->OutputCount -= Encoder->ReturnedCount;
+    MoveMem(Output, Output + Encoder->ReturnedCount, Encoder->OutputCount);
+
+    text_file_format Format = Encoder->Format;
+    while (Encoder->OutputCount < TEXT_SAVE_CHUNK_SIZE && Encoder->TextOffset < Encoder->TextSize)
+    {
+        memory_offset Offset = Encoder->TextOffset;
+        memory_size ChunkSize = Minimum(TEXT_SAVE_CHUNK_SIZE, Encoder->TextSize - Offset);
+        b32 IsFinal = (Offset + ChunkSize == Encoder->TextSize);
+        u8 *Chunk = Encoder->Text + Offset;
+
+        transcode_result Transcoded;
+        if (Encoder->Staging.Data)
+        {
+            u8 *Staging = Encoder->Staging.Data;
+            memory_size ExpandedCount = RestoreLineEndings(Format, Encoder->LineEndings, &Encoder->LineEndingIndex,
+                                                           Chunk, Offset, ChunkSize, Staging + Encoder->StagingCount);
+            memory_size SourceCount = Encoder->StagingCount + ExpandedCount;
+
+            Transcoded = EncodeText(Format.Encoding, Staging, SourceCount, Output + Encoder->OutputCount, IsFinal);
+            Encoder->StagingCount = SourceCount - Transcoded.ReadCount;
+            MoveMem(Staging, Staging + Transcoded.ReadCount, Encoder->StagingCount);
+            Encoder->TextOffset += ChunkSize;
+        }
+        else
+        {
+            Transcoded = EncodeText(Format.Encoding, Chunk, ChunkSize, Output + Encoder->OutputCount, IsFinal);
+            Encoder->TextOffset += Transcoded.ReadCount;
+        }
+
+        Encoder->OutputCount += Transcoded.WrittenCount;
+        Encoder->ReplacedCount += Transcoded.ReplacedCount;
+    }
+
+    Encoder->ReturnedCount = Minimum(Encoder->OutputCount, TEXT_SAVE_CHUNK_SIZE);
+    Result.Data = Output;
+    Result.Size = Encoder->ReturnedCount;
+    return Result;
+}
+
+// NOTE(traian): Hashes the chunks of the document that start at or after HashOffset, which is at the start of a
+// chunk. Returns the size of the document.
+internal memory_size
+HashTextSaveDocument(text_save *Save, memory_size SnapshotSize, u64 *ChunkHashes, memory_offset HashOffset,
+                     u64 *ReplacedCount)
+{
+    text_save_encoder Encoder;
+    BeginTextSaveEncoder(&Encoder, Save, SnapshotSize);
+
+    memory_size TextSize = 0;
+    for (buffer Chunk = NextTextSaveChunk(&Encoder); Chunk.Size > 0; Chunk = NextTextSaveChunk(&Encoder))
+    {
+        // NOTE(traian): Only the last chunk of the document ends in the middle of a hashed chunk.
+        memory_offset ChunkEnd = TextSize + Chunk.Size;
+        if (ChunkEnd > HashOffset)
+        {
+            memory_offset Offset = Maximum(TextSize, HashOffset);
+            HashTextChunks(ChunkHashes, ChunkEnd, Chunk.Data + (Offset - TextSize), Offset, ChunkEnd - Offset);
+        }
+        TextSize = ChunkEnd;
+    }
+
+    *ReplacedCount = Encoder.ReplacedCount;
+    EndTextSaveEncoder(&Encoder);
+    return TextSize;
+}
+
+// NOTE(traian): Writes the whole document into the temporary file, encoding it again from the start, and
+// replaces the document with it once the new version is completely on the disk. An interrupted save leaves
+// the document as it was.
+internal b32
+WriteTextSaveFile(text_save *Save, memory_size SnapshotSize, memory_size TextSize)
+{
+    platform_file File = PlatformOpenFileForWriting(Save->TemporaryFileName, true);
+    if (!File.Handle)
+    {
+        return false;
+    }
+
+    text_save_encoder Encoder;
+    BeginTextSaveEncoder(&Encoder, Save, SnapshotSize);
+
+    memory_offset FileOffset = 0;
+    for (buffer Chunk = NextTextSaveChunk(&Encoder); Chunk.Size > 0; Chunk = NextTextSaveChunk(&Encoder))
+    {
+        if (PlatformWriteFile(&File, FileOffset, Chunk) != Chunk.Size)
+        {
+            // TODO(traian): Logging.
+            break;
+        }
+
+        FileOffset += Chunk.Size;
+        Save->BytesWritten = FileOffset;
+    }
+    EndTextSaveEncoder(&Encoder);
+
+    b32 HasSucceeded = (FileOffset == TextSize);
+    if (HasSucceeded)
+    {
+        PlatformFlushFile(&File);
+    }
+    PlatformCloseFile(&File);
+
+    HasSucceeded = HasSucceeded && PlatformMoveFile(Save->TemporaryFileName, Save->FileName);
+    if (!HasSucceeded)
+    {
+        PlatformDeleteFile(Save->TemporaryFileName);
+    }
+
+    return HasSucceeded;
+}
+
+internal PLATFORM_WORK_QUEUE_CALLBACK(SaveTextPanelWork)
+{
+    text_save *Save = (text_save *)Data;
+    memory_size SnapshotSize = Save->SnapshotSize;
+
+    // NOTE(traian): The offset of the first edit is only known in the document if the text isn't transcoded and
+    // its line endings before the edit weren't normalized.
+    memory_size UnmodifiedSize = 0;
+    if (Save->Format.Encoding == TextEncoding_UTF8 && Save->Format.NewLineEnding == LineEnding_LF)
+    {
+        UnmodifiedSize = Minimum(Save->UnmodifiedSize, SnapshotSize);
+        if (Save->LineEndings.Count > 0)
+        {
+            UnmodifiedSize = Minimum(UnmodifiedSize, Save->LineEndings.Offsets[0]);
+        }
+        UnmodifiedSize += GetByteOrderMarkSize(Save->Format);
+    }
+
+    // NOTE(traian): The hashes can only be trusted if the document on the disk wasn't changed by someone else.
+    // They only decide whether the document has to be written at all, since it's always replaced as a whole.
+    text_disk_hashes *DiskHashes = Save->DiskHashes;
+    b32 CanCompare = DiskHashes->IsValid &&
+                     (DiskHashes->FileSize == PlatformGetFileSize(Save->FileName)) &&
+                     (DiskHashes->FileWriteTime == PlatformGetFileWriteTime(Save->FileName));
+
+    // NOTE(traian): The document is encoded twice, once to hash it and once to write it, so it's never held in
+    // memory. It can't be larger than the text with every new line expanded.
+    memory_size MaxTextSize = GetByteOrderMarkSize(Save->Format) +
+                              GetMaxEncodedSize(Save->Format.Encoding, 2 * SnapshotSize);
+    buffer NewHashes = PlatformAllocateMemory(Maximum(GetTextChunkCount(MaxTextSize), 1) * sizeof(u64));
+    u64 *NewChunkHashes = (u64 *)NewHashes.Data;
+
+    // NOTE(traian): The chunks that end before the first edit are the same as on the disk.
+    u64 FirstChunk = CanCompare ? (UnmodifiedSize / TEXT_DISK_HASH_CHUNK_SIZE) : 0;
+    memory_size TextSize = HashTextSaveDocument(Save, SnapshotSize, NewChunkHashes,
+                                                FirstChunk * TEXT_DISK_HASH_CHUNK_SIZE, &Save->UnencodableCount);
+
+    // NOTE(traian): The document isn't written if its encoding can't represent some of the characters, rather than
+    // losing them. The user has to choose to save it as UTF-8 instead.
+    u64 ChunkCount = GetTextChunkCount(TextSize);
+    b32 IsUnchanged = CanCompare && (Save->UnencodableCount == 0) && (TextSize == DiskHashes->FileSize);
+    if (IsUnchanged)
+    {
+        CopyArray(NewChunkHashes, DiskHashes->ChunkHashes, FirstChunk);
+        for (u64 ChunkIndex = FirstChunk; IsUnchanged && ChunkIndex < ChunkCount; ++ChunkIndex)
+        {
+            IsUnchanged = (NewChunkHashes[ChunkIndex] == DiskHashes->ChunkHashes[ChunkIndex]);
+        }
+    }
+
+    // NOTE(traian): The document on the disk already contains the text when none of the chunks changed.
+    b32 HasSucceeded = IsUnchanged;
+    if (!IsUnchanged && Save->UnencodableCount == 0)
+    {
+        HasSucceeded = WriteTextSaveFile(Save, SnapshotSize, TextSize);
+        if (HasSucceeded)
+        {
+            DiskHashes->FileWriteTime = PlatformGetFileWriteTime(Save->FileName);
+        }
+    }
+
+    if (HasSucceeded)
+    {
+        buffer OldHashes = DiskHashes->Memory;
+        DiskHashes->Memory = NewHashes;
+        DiskHashes->ChunkHashes = NewChunkHashes;
+        DiskHashes->ChunkCount = ChunkCount;
+        DiskHashes->FileSize = TextSize;
+        DiskHashes->IsValid = true;
+        NewHashes = OldHashes;
+    }
+
+    if (NewHashes.Data)
+    {
+        PlatformReleaseMemory(NewHashes);
+    }
+    PlatformReleaseMemory(Save->Snapshot);
+    Save->Snapshot = {};
+    if (Save->LineEndings.Memory.Data)
+    {
+        PlatformReleaseMemory(Save->LineEndings.Memory);
+        Save->LineEndings = {};
+    }
+
+    Save->HasSucceeded = HasSucceeded;
+    CompletePreviousWritesBeforeFutureWrites;
+    Save->IsDone = true;
+}
+
+// NOTE(traian): Finalizes the save of the panel, if it's done. Returns true if the panel changed.
+internal b32
+CompleteTextSave(text_panel *Panel)
+{
+    text_save *Save = &Panel->Save;
+    if (!Save->IsActive || !Save->IsDone)
+    {
+        return false;
+    }
+
+    CompletePreviousReadsBeforeFutureReads;
+    Save->IsActive = false;
+
+    if (Save->HasSucceeded)
+    {
+        // NOTE(traian): The edits that were made while saving aren't part of the saved document.
+        Panel->IsSaveDirty = (Panel->EditVersion != Save->EditVersion);
+        RebaseTextJournal(&Panel->Journal, Save->FileName, Save->JournalOffset);
+
+        text_save_stats *Stats = &Save->Stats;
+        ++Stats->SaveCount;
+        Stats->SkippedCount += (Save->BytesWritten == 0);
+        Stats->LastWrittenSize = Save->BytesWritten;
+        Stats->TotalWrittenSize += Save->BytesWritten;
+        Stats->UnencodableCount = 0;
+    }
+    else
+    {
+        // TODO(traian): Logging.
+        // NOTE(traian): The document on the disk wasn't changed, so the edits before the save still have to
+        // be written by the next save.
+        Panel->UnmodifiedSize = Minimum(Panel->UnmodifiedSize, Save->UnmodifiedSize);
+        Save->Stats.UnencodableCount = Save->UnencodableCount;
+        Save->Stats.UnencodableEncoding = Save->Format.Encoding;
+    }
+
+    return true;
+}
+
+// NOTE(traian): Waits for the save of the panel to complete.
+internal void
+FinishTextSave(text_panel *Panel)
+{
+    while (Panel->Save.IsActive)
+    {
+        if (!CompleteTextSave(Panel))
+        {
+            _mm_pause();
+        }
+    }
+}
+
+// NOTE(traian): Starts saving the text of the panel to its file, on a work queue thread. The whole file must
+// be loaded and the buffer must not be mapped.
+internal void
+BeginTextSave(platform_work_queue *WorkQueue, text_panel *Panel)
+{
+    Assert(Panel->FileName && !Panel->Load.IsActive && !Panel->Buffer.IsMapped);
+    FinishTextSave(Panel);
+
+    text_save *Save = &Panel->Save;
+    memory_size FileNameLength = StringLength(Panel->FileName);
+    memory_size ExtensionLength = sizeof(TEXT_SAVE_FILE_EXTENSION) - 1;
+    if (FileNameLength + ExtensionLength >= sizeof(Save->TemporaryFileName))
+    {
+        // TODO(traian): Logging.
+        return;
+    }
+
+    CopyMem(Save->FileName, Panel->FileName, FileNameLength + 1);
+    CopyMem(Save->TemporaryFileName, Panel->FileName, FileNameLength);
+    CopyMem(Save->TemporaryFileName + FileNameLength, TEXT_SAVE_FILE_EXTENSION, ExtensionLength + 1);
+
+    // NOTE(traian): The snapshot is copied here rather than by the thread, so the next edit never waits for a
+    // save that didn't start yet. Copying is much faster than encoding and writing the text.
+    text_buffer_spans TextSpans = GetBufferSpans(&Panel->Buffer);
+    Save->Snapshot = PlatformAllocateMemory(Panel->Buffer.Used);
+    Save->SnapshotSize = Panel->Buffer.Used;
+    CopyMem(Save->Snapshot.Data, TextSpans.Spans[0].Data, TextSpans.Spans[0].Size);
+    CopyMem(Save->Snapshot.Data + TextSpans.Spans[0].Size, TextSpans.Spans[1].Data, TextSpans.Spans[1].Size);
+    Save->EditVersion = Panel->EditVersion;
+    Save->Format = Panel->Format;
+    Save->UnencodableCount = 0;
+    Save->LineEndings = {};
+    if (Panel->LineEndings.Count > 0)
+    {
+        text_line_endings *LineEndings = &Save->LineEndings;
+        LineEndings->Memory = PlatformAllocateMemory(Panel->LineEndings.Count * sizeof(memory_offset));
+        LineEndings->Offsets = (memory_offset *)LineEndings->Memory.Data;
+        LineEndings->Count = Panel->LineEndings.Count;
+        CopyArray(LineEndings->Offsets, Panel->LineEndings.Offsets, LineEndings->Count);
+    }
+    Save->DiskHashes = &Panel->DiskHashes;
+    Save->UnmodifiedSize = Panel->UnmodifiedSize;
+    Panel->UnmodifiedSize = INVALID_SIZE;
+
+    text_journal *Journal = &Panel->Journal;
+    Save->JournalOffset = Journal->IsOpen ? (Journal->FileOffset + Journal->PendingSize)
+                                          : sizeof(text_journal_header);
+
+    Save->IsDone = false;
+    Save->HasSucceeded = false;
+    Save->BytesWritten = 0;
+    Save->IsActive = true;
+    CompletePreviousWritesBeforeFutureWrites;
+    if (!PlatformAddWorkEntry(WorkQueue, SaveTextPanelWork, Save))
+    {
+        // TODO(traian): Logging.
+        // NOTE(traian): A save that couldn't be queued fails like one that couldn't write the file.
+        PlatformReleaseMemory(Save->Snapshot);
+        Save->Snapshot = {};
+        if (Save->LineEndings.Memory.Data)
+        {
+            PlatformReleaseMemory(Save->LineEndings.Memory);
+            Save->LineEndings = {};
+        }
+        Save->IsDone = true;
+    }
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT HISTORY.
+//=========================================================================================
+
+internal inline text_view_state
+GetTextViewState(text_panel *Panel)
+{
+    text_view_state Result;
+    Result.Caret = Panel->Caret;
+    Result.FirstLineIndex = Panel->FirstLineIndex;
+    Result.FirstColumnIndex = Panel->FirstColumnIndex;
+    Result.BufferOffset = Panel->BufferOffset;
+    return Result;
+}
+
+internal inline void
+SetTextViewState(text_panel *Panel, text_view_state *State)
+{
+    Panel->Caret = State->Caret;
+    Panel->FirstLineIndex = State->FirstLineIndex;
+    Panel->FirstColumnIndex = State->FirstColumnIndex;
+    Panel->BufferOffset = State->BufferOffset;
+}
+
+internal inline memory_size
+GetTextEditRecordSize(memory_size ByteCount, u64 LineEndingCount)
+{
+    memory_size Result = sizeof(text_edit_record) + AlignForward(ByteCount, 8) +
+                         LineEndingCount * sizeof(memory_offset) + sizeof(memory_size);
+    return Result;
+}
+
+internal inline memory_size
+GetTextEditRecordSize(text_edit_record *Record)
+{
+    memory_size Result = GetTextEditRecordSize(Record->ByteCount, Record->LineEndingCount);
+    return Result;
+}
+
+internal inline char *
+GetTextEditRecordBytes(text_edit_record *Record)
+{
+    char *Result = (char *)(Record + 1);
+    return Result;
+}
+
+internal inline memory_offset *
+GetTextEditRecordLineEndings(text_edit_record *Record)
+{
+    memory_offset *Result = (memory_offset *)(GetTextEditRecordBytes(Record) + AlignForward(Record->ByteCount, 8));
+    return Result;
+}
+
+// NOTE(traian): Returns the record that ends at the given offset of the history arena.
+internal inline text_edit_record *
+GetTextEditRecordBefore(text_history *History, memory_offset EndOffset)
+{
+    Assert(EndOffset > 0);
+    memory_size RecordSize = *(memory_size *)(History->Arena.Base + EndOffset - sizeof(memory_size));
+    text_edit_record *Result = (text_edit_record *)(History->Arena.Base + EndOffset - RecordSize);
+    return Result;
+}
+
+internal inline void
+StoreTextEditRecordSize(text_edit_record *Record)
+{
+    memory_size RecordSize = GetTextEditRecordSize(Record);
+    *(memory_size *)((u8 *)Record + RecordSize - sizeof(memory_size)) = RecordSize;
+}
+
+// NOTE(traian): Forgets all of the records, but keeps the memory of the history around.
+internal inline void
+ResetTextHistory(text_history *History)
+{
+    History->Arena.Offset = 0;
+    History->UndoOffset = 0;
+    History->CanCoalesce = false;
+}
+
+// NOTE(traian): Discards the oldest records until at least RequiredSize bytes are free. A quarter of the
+// budget is freed at once, so that the remaining records aren't moved on every edit. The records from KeepOffset
+// on are never discarded. Returns false if the required size can't be freed.
+internal b32
+DiscardOldestTextEdits(text_history *History, memory_size RequiredSize, memory_offset KeepOffset)
+{
+    memory_arena *Arena = &History->Arena;
+    memory_size TargetFreeSize = Maximum(RequiredSize, Arena->Size / 4);
+
+    // NOTE(traian): KeepOffset is the start of a group, so stopping there never splits a chain.
+    memory_offset DiscardOffset = 0;
+    while (DiscardOffset < KeepOffset)
+    {
+        text_edit_record *Record = (text_edit_record *)(Arena->Base + DiscardOffset);
+
+        // NOTE(traian): A chain of records is always discarded as a whole.
+        b32 IsFreeEnough = (Arena->Size - Arena->Offset + DiscardOffset) >= TargetFreeSize;
+        if (IsFreeEnough && !Record->IsChained)
+        {
+            break;
+        }
+
+        DiscardOffset += GetTextEditRecordSize(Record);
+    }
+
+    Assert(DiscardOffset <= History->UndoOffset);
+    MoveMem(Arena->Base, Arena->Base + DiscardOffset, Arena->Offset - DiscardOffset);
+    Arena->Offset -= DiscardOffset;
+    History->UndoOffset -= DiscardOffset;
+    History->GroupOffset -= Minimum(DiscardOffset, History->GroupOffset);
+
+    // NOTE(traian): Undo stops at the first record that isn't chained, so the oldest record must never be chained.
+    if (Arena->Offset > 0)
+    {
+        ((text_edit_record *)Arena->Base)->IsChained = false;
+    }
+
+    b32 Result = (Arena->Size - Arena->Offset) >= RequiredSize;
+    return Result;
+}
+
+// NOTE(traian): Tries to extend the last record with the given edit, which is how a run of typed (or
+// deleted) characters becomes a single undo step. Returns NULL if the edit can't be coalesced.
+internal text_edit_record *
+CoalesceTextEdit(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                 memory_size ByteCount)
+{
+    text_history *History = &Panel->History;
+    memory_arena *Arena = &History->Arena;
+    if (!History->CanCoalesce || History->UndoOffset == 0 || ByteCount > TEXT_HISTORY_COALESCE_EDIT_SIZE)
+    {
+        return NULL;
+    }
+
+    // NOTE(traian): The records with line endings are never extended, so the line endings always follow the bytes.
+    text_edit_record *Record = GetTextEditRecordBefore(History, History->UndoOffset);
+    memory_size NewByteCount = Record->ByteCount + ByteCount;
+    if (Record->Kind != Kind || NewByteCount > TEXT_HISTORY_COALESCE_MAX_SIZE || Record->LineEndingCount > 0)
+    {
+        return NULL;
+    }
+
+    memory_size GrowSize = GetTextEditRecordSize(NewByteCount, 0) - GetTextEditRecordSize(Record);
+    if (Arena->Offset + GrowSize > Arena->Size)
+    {
+        return NULL;
+    }
+
+    char *Bytes = GetTextEditRecordBytes(Record);
+    b32 IsAppended = (Offset == Record->Offset + Record->ByteCount);
+    if (Kind == TextEditKind_Insert)
+    {
+        // NOTE(traian): Each typed line is a separate undo step.
+        if (!IsAppended || Bytes[Record->ByteCount - 1] == '\n')
+        {
+            return NULL;
+        }
+
+        CopyMem(Bytes + Record->ByteCount, Characters, ByteCount);
+    }
+    else if (Offset == Record->Offset)
+    {
+        // NOTE(traian): Deleting to the right of the caret, the removed bytes follow the recorded ones.
+        CopyFromBuffer(&Panel->Buffer, Offset, ByteCount, Bytes + Record->ByteCount);
+    }
+    else if (Offset + ByteCount == Record->Offset)
+    {
+        // NOTE(traian): Deleting to the left of the caret, the removed bytes precede the recorded ones.
+        MoveMem(Bytes + ByteCount, Bytes, Record->ByteCount);
+        CopyFromBuffer(&Panel->Buffer, Offset, ByteCount, Bytes);
+        Record->Offset = Offset;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    Record->ByteCount = NewByteCount;
+    StoreTextEditRecordSize(Record);
+    Arena->Offset += GrowSize;
+    History->UndoOffset = Arena->Offset;
+    return Record;
+}
+
+// NOTE(traian): Records an edit that is about to be made to the text of the panel. The inserted bytes are
+// given by Characters, while the removed bytes are copied from the text, so the record must be made before
+// the text is modified. The line endings in [Offset, Offset + ByteCount) of LineEndings are recorded with
+// the bytes, if LineEndings isn't NULL. The caller fills in the view state that follows the edit. Returns NULL
+// if the edit doesn't fit in the budget of the history, in which case the whole history is forgotten.
+internal text_edit_record *
+RecordTextEditWithLineEndings(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                              memory_size ByteCount, text_line_endings *LineEndings, text_view_state *Before)
+{
+    text_history *History = &Panel->History;
+    memory_arena *Arena = &History->Arena;
+
+    // NOTE(traian): The records that were undone can't be redone once the text is modified.
+    Arena->Offset = History->UndoOffset;
+    if (History->GroupDepth > 0 && History->IsGroupDiscarded)
+    {
+        return NULL;
+    }
+
+    b32 IsChained = (History->GroupDepth > 0) && !History->IsGroupEmpty;
+    if (History->GroupDepth > 0 && History->IsGroupEmpty)
+    {
+        Before = &History->GroupBefore;
+    }
+    History->IsGroupEmpty = false;
+
+    u64 FirstLineEnding = 0;
+    u64 LineEndingCount = 0;
+    if (LineEndings)
+    {
+        FirstLineEnding = FindTextLineEndingsInRange(LineEndings, Offset, ByteCount, &LineEndingCount);
+    }
+
+    text_edit_record *Record = NULL;
+    if (!IsChained && LineEndingCount == 0)
+    {
+        Record = CoalesceTextEdit(Panel, Kind, Offset, Characters, ByteCount);
+    }
+
+    if (!Record)
+    {
+        memory_size RecordSize = GetTextEditRecordSize(ByteCount, LineEndingCount);
+        if (!Arena->Base)
+        {
+            buffer Memory = PlatformAllocateMemory(TEXT_HISTORY_BUDGET_SIZE);
+            InitializeArena(Arena, Memory.Data, Memory.Size);
+        }
+
+        // NOTE(traian): The open group is kept, since its first record is what the rest of it is chained to.
+        memory_offset KeepOffset = IsChained ? History->GroupOffset : Arena->Offset;
+        b32 IsFitting = (RecordSize <= Arena->Size);
+        if (IsFitting && Arena->Offset + RecordSize > Arena->Size)
+        {
+            IsFitting = DiscardOldestTextEdits(History, RecordSize, KeepOffset);
+        }
+
+        if (!IsFitting)
+        {
+            // TODO(traian): Logging.
+            ResetTextHistory(History);
+            History->IsGroupDiscarded = (History->GroupDepth > 0);
+            return NULL;
+        }
+
+        Record = (text_edit_record *)PushSize(Arena, RecordSize);
+        Record->Offset = Offset;
+        Record->ByteCount = ByteCount;
+        Record->LineEndingCount = LineEndingCount;
+        Record->Kind = Kind;
+        Record->IsChained = IsChained;
+        Record->Before = *Before;
+        Record->After = *Before;
+        StoreTextEditRecordSize(Record);
+
+        if (Kind == TextEditKind_Insert)
+        {
+            CopyMem(GetTextEditRecordBytes(Record), Characters, ByteCount);
+        }
+        else
+        {
+            CopyFromBuffer(&Panel->Buffer, Offset, ByteCount, GetTextEditRecordBytes(Record));
+        }
+
+        memory_offset *RecordLineEndings = GetTextEditRecordLineEndings(Record);
+        for (u64 Index = 0; Index < LineEndingCount; ++Index)
+        {
+            RecordLineEndings[Index] = LineEndings->Offsets[FirstLineEnding + Index] - Offset;
+        }
+
+        History->UndoOffset = Arena->Offset;
+    }
+
+    if (History->GroupDepth > 0 && !IsChained)
+    {
+        History->GroupOffset = (u8 *)Record - Arena->Base;
+    }
+
+    History->CanCoalesce = true;
+    return Record;
+}
+
+// NOTE(traian): A removal records the line endings that it's about to drop, while the text that is typed or
+// pasted has none of its own.
+internal inline text_edit_record *
+RecordTextEdit(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+               memory_size ByteCount, text_view_state *Before)
+{
+    text_line_endings *LineEndings = (Kind == TextEditKind_Remove) ? &Panel->LineEndings : NULL;
+    text_edit_record *Result = RecordTextEditWithLineEndings(Panel, Kind, Offset, Characters, ByteCount,
+                                                             LineEndings, Before);
+    return Result;
+}
+
+// NOTE(traian): The edits made between the two calls are undone and redone in a single step, and undoing
+// them restores the view state from the moment the outermost group was opened.
+internal inline void
+BeginTextEditGroup(text_panel *Panel)
+{
+    text_history *History = &Panel->History;
+    if (History->GroupDepth++ == 0)
+    {
+        History->IsGroupEmpty = true;
+        History->IsGroupDiscarded = false;
+        History->GroupBefore = GetTextViewState(Panel);
+    }
+}
+
+internal inline void
+EndTextEditGroup(text_panel *Panel)
+{
+    Assert(Panel->History.GroupDepth > 0);
+    --Panel->History.GroupDepth;
+}
+
+// NOTE(traian): Every modification of the text of a panel goes through here, so that it's journaled. An insertion
+// that puts back removed text also puts back its line endings, which are given relative to the offset.
+internal void
+ApplyTextEditWithLineEndings(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+                             memory_size ByteCount, memory_offset *LineEndings, u64 LineEndingCount)
+{
+    MakeTextPanelEditable(Panel);
+    u64 OldLineCount = Panel->LineIndex.Count;
+    AppendToTextJournal(Panel, Kind, Offset, Characters, ByteCount, LineEndings, LineEndingCount);
+    if (Kind == TextEditKind_Insert)
+    {
+        InsertIntoLineIndex(&Panel->LineIndex, Offset, Characters, ByteCount);
+        InsertIntoBuffer(&Panel->Buffer, Offset, Characters, ByteCount);
+    }
+    else
+    {
+        RemoveFromLineIndex(&Panel->LineIndex, Offset, ByteCount);
+        RemoveFromBuffer(&Panel->Buffer, Offset, ByteCount);
+    }
+
+    UpdateTextColumnMaps(Panel, Kind, Offset, Characters, ByteCount);
+    Panel->LineCount = Panel->LineIndex.Count - 1;
+    Panel->IsSaveDirty = true;
+    Panel->UnmodifiedSize = Minimum(Panel->UnmodifiedSize, Offset);
+    UpdateTextLineEndings(&Panel->LineEndings, Kind, Offset, ByteCount);
+    if (Kind == TextEditKind_Insert)
+    {
+        InsertTextLineEndings(&Panel->LineEndings, Offset, LineEndings, LineEndingCount);
+    }
+    ++Panel->EditVersion;
+    UpdateTextHighlight(Panel, OldLineCount, Offset);
+}
+
+internal inline void
+ApplyTextEdit(text_panel *Panel, text_edit_kind Kind, memory_offset Offset, char *Characters,
+              memory_size ByteCount)
+{
+    ApplyTextEditWithLineEndings(Panel, Kind, Offset, Characters, ByteCount, NULL, 0);
+}
+
+// NOTE(traian): Reverts the last step of the history. Returns false if there is nothing to undo.
+internal b32
+UndoTextEdit(text_panel *Panel)
+{
+    text_history *History = &Panel->History;
+    if (History->UndoOffset == 0)
+    {
+        return false;
+    }
+
+    text_edit_record *Record;
+    do
+    {
+        Record = GetTextEditRecordBefore(History, History->UndoOffset);
+        text_edit_kind InverseKind = (Record->Kind == TextEditKind_Insert) ? TextEditKind_Remove
+                                                                            : TextEditKind_Insert;
+        ApplyTextEditWithLineEndings(Panel, InverseKind, Record->Offset, GetTextEditRecordBytes(Record),
+                                     Record->ByteCount, GetTextEditRecordLineEndings(Record), Record->LineEndingCount);
+        History->UndoOffset -= GetTextEditRecordSize(Record);
+    }
+    while (Record->IsChained);
+
+    // NOTE(traian): The view state only remembers the main caret, so the extra carets are dropped.
+    SetTextViewState(Panel, &Record->Before);
+    Panel->ExtraCarets.Count = 0;
+    History->CanCoalesce = false;
+    return true;
+}
+
+// NOTE(traian): Reapplies the last undone step of the history. Returns false if there is nothing to redo.
+internal b32
+RedoTextEdit(text_panel *Panel)
+{
+    text_history *History = &Panel->History;
+    memory_arena *Arena = &History->Arena;
+    if (History->UndoOffset == Arena->Offset)
+    {
+        return false;
+    }
+
+    text_edit_record *Record;
+    do
+    {
+        Record = (text_edit_record *)(Arena->Base + History->UndoOffset);
+        ApplyTextEditWithLineEndings(Panel, Record->Kind, Record->Offset, GetTextEditRecordBytes(Record),
+                                     Record->ByteCount, GetTextEditRecordLineEndings(Record), Record->LineEndingCount);
+        History->UndoOffset += GetTextEditRecordSize(Record);
+    }
+    while (History->UndoOffset < Arena->Offset &&
+           ((text_edit_record *)(Arena->Base + History->UndoOffset))->IsChained);
+
+    SetTextViewState(Panel, &Record->After);
+    Panel->ExtraCarets.Count = 0;
+    History->CanCoalesce = false;
+    return true;
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT ITERATORS.
+//=========================================================================================
+
+struct text_iterator
+{
+    u32 Codepoint;
+    u32 Width;
+    memory_offset Offset;
+    text_buffer *Buffer;
+
+    // NOTE(traian): The bytes in [Offset, ASCIIEnd) are known to be ASCII, so the iterator can advance over
+    // them without decoding UTF-8. The run never crosses the gap of the buffer.
+    memory_offset ASCIIEnd;
+};
+
+// NOTE(traian): The maximum number of bytes that are checked at once for an ASCII run.
+#define TEXT_ITERATOR_ASCII_SCAN_SIZE 64
+
+struct get_codepoint_result
+{
+    u32 Codepoint;
+    u32 Width;
+    b32 IsValid;
+};
+
+internal inline b32
+IsUTF8ContinuationByte(u8 Byte)
+{
+    b32 Result = ((Byte & 0xC0) == 0x80);
+    return Result;
+}
+
+// NOTE(traian): Decodes the UTF-8 sequence that starts at the given offset. A byte that doesn't start a
+// well-formed sequence (including overlong encodings and surrogates) is decoded on its own, as the replacement
+// character, so malformed text can still be iterated and edited one byte at a time.
+internal inline get_codepoint_result
+GetCodepoint(text_buffer *Buffer, memory_offset Offset)
+{
+    Assert(Offset <= Buffer->Used);
+    get_codepoint_result Result = {};
+    Result.IsValid = true;
+
+    if (Offset >= Buffer->Used)
+    {
+        return Result;
+    }
+
+    u8 Lead = (u8)GetBufferCharacter(Buffer, Offset);
+    if (Lead < 0x80)
+    {
+        Result.Codepoint = Lead;
+        Result.Width = 1;
+        return Result;
+    }
+
+    Result.Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+    Result.Width = 1;
+
+    u32 Width = 0;
+    u32 Codepoint = 0;
+    u32 MinCodepoint = 0;
+    if ((Lead & 0xE0) == 0xC0)
+    {
+        Width = 2;
+        Codepoint = Lead & 0x1F;
+        MinCodepoint = 0x80;
+    }
+    else if ((Lead & 0xF0) == 0xE0)
+    {
+        Width = 3;
+        Codepoint = Lead & 0x0F;
+        MinCodepoint = 0x800;
+    }
+    else if ((Lead & 0xF8) == 0xF0)
+    {
+        Width = 4;
+        Codepoint = Lead & 0x07;
+        MinCodepoint = 0x10000;
+    }
+
+    if (Width == 0 || Offset + Width > Buffer->Used)
+    {
+        return Result;
+    }
+
+    for (u32 ByteIndex = 1; ByteIndex < Width; ++ByteIndex)
+    {
+        u8 Byte = (u8)GetBufferCharacter(Buffer, Offset + ByteIndex);
+        if (!IsUTF8ContinuationByte(Byte))
+        {
+            return Result;
+        }
+        Codepoint = (Codepoint << 6) | (Byte & 0x3F);
+    }
+
+    b32 IsSurrogate = (0xD800 <= Codepoint) && (Codepoint <= 0xDFFF);
+    if (Codepoint >= MinCodepoint && Codepoint <= 0x10FFFF && !IsSurrogate)
+    {
+        Result.Codepoint = Codepoint;
+        Result.Width = Width;
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+NewTextIterator(text_buffer *Buffer, memory_offset Offset)
+{
+    text_iterator Result = {};
+
+    get_codepoint_result Codepoint = GetCodepoint(Buffer, Offset);
+    if (Codepoint.IsValid)
+    {
+        Result.Codepoint = Codepoint.Codepoint;
+        Result.Width = Codepoint.Width;
+        Result.Offset = Offset;
+        Result.Buffer = Buffer;
+
+        // NOTE(traian): Only look for an ASCII run if the text at the offset is ASCII, so that text which
+        // is mostly made of multi-byte sequences doesn't pay for the scan.
+        if (Offset < Buffer->Used && Codepoint.Codepoint < 0x80)
+        {
+            memory_offset SpanEnd = (Offset < Buffer->GapOffset) ? Buffer->GapOffset : Buffer->Used;
+            memory_size ScanSize = Minimum(TEXT_ITERATOR_ASCII_SCAN_SIZE, SpanEnd - Offset);
+            Result.ASCIIEnd = Offset + CountLeadingASCII(GetBufferAddress(Buffer, Offset), ScanSize);
+        }
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+AdvanceIterator(text_iterator Iterator)
+{
+    text_iterator Result = {};
+    memory_offset NewOffset = Iterator.Offset + Iterator.Width;
+
+    // NOTE(traian): Inside an ASCII run, each byte is a codepoint. The line endings were normalized when the
+    // text was loaded, so a new line is always a single '\n'.
+    if (NewOffset < Iterator.ASCIIEnd)
+    {
+        Result = Iterator;
+        Result.Codepoint = (u32)*GetBufferAddress(Iterator.Buffer, NewOffset);
+        Result.Width = 1;
+        Result.Offset = NewOffset;
+        return Result;
+    }
+
+    if (NewOffset < Iterator.Buffer->Used)
+    {
+        Result = NewTextIterator(Iterator.Buffer, NewOffset);
+    }
+
+    return Result;
+}
+
+// NOTE(traian): Finds the codepoint that ends right before the offset. The lead byte is at most three
+// continuation bytes behind; if the sequence that starts there doesn't end at the offset, the last byte is
+// malformed and is decoded on its own, just like when iterating forward.
+internal inline get_codepoint_result
+GetPreviousCodepoint(text_buffer *Buffer, memory_offset Offset)
+{
+    Assert(Offset > 0 && Offset <= Buffer->Used);
+    memory_offset LeadOffset = Offset - 1;
+    for (u32 BackCount = 0; BackCount < 3 && LeadOffset > 0; ++BackCount)
+    {
+        if (!IsUTF8ContinuationByte((u8)GetBufferCharacter(Buffer, LeadOffset)))
+        {
+            break;
+        }
+        --LeadOffset;
+    }
+
+    get_codepoint_result Result = GetCodepoint(Buffer, LeadOffset);
+    if (LeadOffset + Result.Width != Offset)
+    {
+        Result = GetCodepoint(Buffer, Offset - 1);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+DevanceIterator(text_iterator Iterator)
+{
+    text_iterator Result = {};
+
+    memory_offset Offset = Iterator.Offset;
+    if (Offset)
+    {
+        // NOTE(traian): An ASCII byte is always a codepoint of its own, so it doesn't have to be decoded.
+        u8 PreviousByte = (u8)GetBufferCharacter(Iterator.Buffer, Offset - 1);
+        get_codepoint_result Codepoint = {};
+        if (PreviousByte < 0x80)
+        {
+            Codepoint.Codepoint = PreviousByte;
+            Codepoint.Width = 1;
+        }
+        else
+        {
+            Codepoint = GetPreviousCodepoint(Iterator.Buffer, Offset);
+        }
+        Offset -= Codepoint.Width;
+
+        Result.Codepoint = Codepoint.Codepoint;
+        Result.Width = Codepoint.Width;
+        Result.Offset = Offset;
+        Result.Buffer = Iterator.Buffer;
+    }
+
+    return Result;
+}
+
+internal inline b32
+IsValid(text_iterator Iterator)
+{
+    b32 Result = (Iterator.Width > 0);
+    return Result;
+}
+
+internal inline b32
+IsDrawableCodepoint(u32 Codepoint)
+{
+    b32 Result = (FONT_ASCII_OFFSET <= Codepoint) && (Codepoint <= FONT_ASCII_OFFSET + FONT_ASCII_COUNT);
+    return Result;
+}
+
+internal inline b32
+IsValidAndNotNewLine(text_iterator Iterator)
+{
+    b32 Result = IsValid(Iterator) && (Iterator.Codepoint != '\n');
+    return Result;
+}
+
+// NOTE(traian): Builds the map of a line from scratch. The ASCII runs are scanned for tabs and new lines
+// one byte at a time, without decoding them.
+internal void
+BuildTextColumnMap(text_column_map *Map, text_panel *Panel, editor_settings *Settings, u64 Line)
+{
+    text_buffer *Buffer = &Panel->Buffer;
+    Map->Line = Line;
+    Map->LineOffset = GetBufferOffsetOfLine(Panel, Line);
+    Map->TabWidth = Settings->TabWidth;
+    Map->StopCount = 0;
+    Map->IsValid = true;
+
+    u64 Column = 0;
+    memory_offset Offset = Map->LineOffset;
+    while (Offset < Buffer->Used)
+    {
+        memory_offset SpanEnd = (Offset < Buffer->GapOffset) ? Buffer->GapOffset : Buffer->Used;
+        char *Run = GetBufferAddress(Buffer, Offset);
+        memory_size RunCount = CountLeadingASCII(Run, Minimum(SpanEnd - Offset, TEXT_COLUMN_MAP_SCAN_SIZE));
+        memory_size RunIndex = 0;
+        for (; RunIndex < RunCount && Run[RunIndex] != '\n'; ++RunIndex)
+        {
+            if (Run[RunIndex] == '\t')
+            {
+                u32 ColumnCount = GetCodepointColumnCount(Settings, '\t', Column);
+                AddColumnStop(Map, Offset + RunIndex - Map->LineOffset, 1, Column, ColumnCount);
+                Column += ColumnCount;
+            }
+            else
+            {
+                ++Column;
+            }
+        }
+
+        Offset += RunIndex;
+        if (RunIndex < RunCount)
+        {
+            break;
+        }
+
+        if (RunCount == 0)
+        {
+            // NOTE(traian): A sequence can be split by the gap, so its bytes are gathered first.
+            u8 Bytes[4];
+            memory_size ByteCount = Minimum(ArrayCount(Bytes), Buffer->Used - Offset);
+            for (u32 ByteIndex = 0; ByteIndex < ByteCount; ++ByteIndex)
+            {
+                Bytes[ByteIndex] = (u8)GetBufferCharacter(Buffer, Offset + ByteIndex);
+            }
+
+            u32 Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+            u32 Width = DecodeUTF8(Bytes, ByteCount, &Codepoint);
+            if (Width == 0)
+            {
+                Codepoint = UNICODE_REPLACEMENT_CHARACTER;
+                Width = 1;
+            }
+
+            u32 ColumnCount = GetCodepointColumnCount(Settings, Codepoint, Column);
+            if (Width > 1 || ColumnCount > 1)
+            {
+                AddColumnStop(Map, Offset - Map->LineOffset, Width, Column, ColumnCount);
+            }
+
+            Column += ColumnCount;
+            Offset += Width;
+        }
+    }
+
+    Map->ByteCount = Offset - Map->LineOffset;
+    Map->ColumnCount = Column;
+}
+
+// NOTE(traian): Returns the map of the line, building it if none of the maps of the panel is for the line.
+// The least recently used map is replaced.
+internal text_column_map *
+GetTextColumnMap(text_panel *Panel, editor_settings *Settings, u64 Line)
+{
+    text_buffer *Buffer = &Panel->Buffer;
+    text_column_map *Result = Panel->ColumnMaps;
+    for (u32 MapIndex = 0; MapIndex < TEXT_COLUMN_MAP_COUNT; ++MapIndex)
+    {
+        text_column_map *Map = Panel->ColumnMaps + MapIndex;
+
+        // NOTE(traian): A line at the end of a file that is still loading can grow.
+        memory_offset LineEnd = Map->LineOffset + Map->ByteCount;
+        if (Map->IsValid && Map->Line == Line && Map->TabWidth == Settings->TabWidth &&
+            (LineEnd == Buffer->Used || GetBufferCharacter(Buffer, LineEnd) == '\n'))
+        {
+            Map->LastUseTime = ++Panel->ColumnMapClock;
+            return Map;
+        }
+
+        if (!Map->IsValid || (Result->IsValid && Map->LastUseTime < Result->LastUseTime))
+        {
+            Result = Map;
+        }
+    }
+
+    BuildTextColumnMap(Result, Panel, Settings, Line);
+    Result->LastUseTime = ++Panel->ColumnMapClock;
+    return Result;
+}
+
+// NOTE(traian): Converts an offset in the line, which must be the start of a codepoint, into its column.
+internal inline u64
+GetColumnOfLineOffset(text_column_map *Map, memory_offset Offset)
+{
+    Assert(Offset <= Map->ByteCount);
+    u64 StopIndex = FindColumnStop(Map, Offset);
+    if (StopIndex == 0)
+    {
+        return Offset;
+    }
+
+    text_column_stop *Stop = Map->Stops + StopIndex - 1;
+    memory_offset StopEnd = Stop->Offset + Stop->Width;
+    Assert(StopEnd <= Offset);
+
+    u64 Result = Stop->Column + Stop->ColumnCount + (Offset - StopEnd);
+    return Result;
+}
+
+// NOTE(traian): Finds the first codepoint boundary of the line that is at or after the column, or the end of
+// the line if the line is shorter. The column of the boundary is returned through ResultColumn.
+internal inline memory_offset
+GetLineOffsetOfColumn(text_column_map *Map, u64 Column, u64 *ResultColumn)
+{
+    if (Column >= Map->ColumnCount)
+    {
+        *ResultColumn = Map->ColumnCount;
+        return Map->ByteCount;
+    }
+
+    u64 Low = 0;
+    u64 High = Map->StopCount;
+    while (Low < High)
+    {
+        u64 Middle = Low + (High - Low) / 2;
+        if (Map->Stops[Middle].Column < Column)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    if (Low == 0)
+    {
+        *ResultColumn = Column;
+        return Column;
+    }
+
+    text_column_stop *Stop = Map->Stops + Low - 1;
+    u64 StopEndColumn = Stop->Column + Stop->ColumnCount;
+    memory_offset StopEnd = Stop->Offset + Stop->Width;
+    if (Column <= StopEndColumn)
+    {
+        *ResultColumn = StopEndColumn;
+        return StopEnd;
+    }
+
+    *ResultColumn = Column;
+    return StopEnd + (Column - StopEndColumn);
+}
+
+internal inline memory_size
+GetBufferOffset(text_panel *Panel, editor_settings *Settings, u64 Line, u64 Column)
+{
+    text_column_map *Map = GetTextColumnMap(Panel, Settings, Line);
+
+    u64 FoundColumn;
+    memory_size Result = Map->LineOffset + GetLineOffsetOfColumn(Map, Column, &FoundColumn);
+    Assert(FoundColumn == Column);
+    return Result;
+}
+
+internal inline text_iterator
+GetCurrentLineFirstIterator(text_iterator Iterator)
+{
+    text_iterator Result = DevanceIterator(Iterator);
+    while (IsValidAndNotNewLine(Result))
+    {
+        Result = DevanceIterator(Result);
+    }
+
+    if (!IsValid(Result))
+    {
+        Result = NewTextIterator(Iterator.Buffer, 0);
+    }
+    else
+    {
+        Result = AdvanceIterator(Result);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+GetCurrentLineLastIterator(text_iterator Iterator)
+{
+    text_iterator Result = Iterator;
+    while (IsValidAndNotNewLine(Result))
+    {
+        Result = AdvanceIterator(Result);
+    }
+
+    if (!IsValid(Iterator) && Iterator.Buffer->Used > 0)
+    {
+        Result = NewTextIterator(Iterator.Buffer, Iterator.Buffer->Used - 1);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+GetPreviousLineLastIterator(text_iterator Iterator)
+{
+    text_iterator Result = DevanceIterator(Iterator);
+    while (IsValid(Result) && Result.Codepoint != '\n')
+    {
+        Result = DevanceIterator(Result);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+GetPreviousLineFirstIterator(text_iterator Iterator)
+{
+    text_iterator Result = GetPreviousLineLastIterator(Iterator);
+    if (IsValid(Result))
+    {
+        Result = GetCurrentLineFirstIterator(Result);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+GetNextLineFirstIterator(text_iterator Iterator)
+{
+    text_iterator Result = Iterator;
+    while (IsValid(Result) && Result.Codepoint != '\n')
+    {
+        Result = AdvanceIterator(Result);
+    }
+
+    if (IsValid(Result))
+    {
+        Result = AdvanceIterator(Result);
+    }
+
+    return Result;
+}
+
+internal inline text_iterator
+GetLastCharacterIterator(text_buffer *Buffer)
+{
+    text_iterator Result = {};
+    
+    if (Buffer->Used > 0)
+    {
+        Result.Offset = Buffer->Used - 1;
+        Result.Buffer = Buffer;
+        Result = DevanceIterator(Result);
+    }
+
+    return Result;
+}
+
+// NOTE(traian): Returns the number of bytes starting at the offset that belong to the token class. The bytes
+// are classified in bulk, one span of the gap buffer at a time.
+internal memory_size
+GetTokenRunSizeAfter(text_buffer *Buffer, memory_offset Offset, token_class Class)
+{
+    memory_size Result = 0;
+    while (Offset + Result < Buffer->Used)
+    {
+        memory_offset RunOffset = Offset + Result;
+        memory_offset SpanEnd = (RunOffset < Buffer->GapOffset) ? Buffer->GapOffset : Buffer->Used;
+        memory_size SpanCount = SpanEnd - RunOffset;
+
+        memory_size RunCount = CountLeadingTokenBytes(GetBufferAddress(Buffer, RunOffset), SpanCount, Class);
+        Result += RunCount;
+        if (RunCount < SpanCount)
+        {
+            break;
+        }
+    }
+
+    return Result;
+}
+
+// NOTE(traian): Returns the number of bytes ending at the offset that belong to the token class.
+internal memory_size
+GetTokenRunSizeBefore(text_buffer *Buffer, memory_offset Offset, token_class Class)
+{
+    memory_size Result = 0;
+    while (Result < Offset)
+    {
+        memory_offset RunEnd = Offset - Result;
+        memory_offset SpanStart = (RunEnd > Buffer->GapOffset) ? Buffer->GapOffset : 0;
+        memory_size SpanCount = RunEnd - SpanStart;
+
+        memory_size RunCount = CountTrailingTokenBytes(GetBufferAddress(Buffer, SpanStart), SpanCount, Class);
+        Result += RunCount;
+        if (RunCount < SpanCount)
+        {
+            break;
+        }
+    }
+
+    return Result;
+}
+
+// NOTE(traian): Finds where the caret lands when it jumps to the next token: after the run of contiguous
+// characters and the whitespace that follows it, or after the whitespace alone. Returns the offset unchanged when
+// the character at the offset belongs to neither class, in which case the caret only steps over that character.
+// Neither class contains new lines, so the boundary is always on the line of the offset.
+internal memory_offset
+FindNextTokenBoundary(text_buffer *Buffer, memory_offset Offset)
+{
+    memory_offset Result = Offset;
+    Result += GetTokenRunSizeAfter(Buffer, Result, TokenClass_Contiguous);
+    Result += GetTokenRunSizeAfter(Buffer, Result, TokenClass_Ignored);
+    return Result;
+}
+
+// NOTE(traian): The backward counterpart of FindNextTokenBoundary. When a contiguous run is preceded by the
+// indentation of its line, the caret stops at the start of the run, instead of jumping over the indentation.
+internal memory_offset
+FindPreviousTokenBoundary(text_buffer *Buffer, memory_offset Offset)
+{
+    memory_offset TokenOffset = Offset - GetTokenRunSizeBefore(Buffer, Offset, TokenClass_Contiguous);
+    memory_offset Result = TokenOffset - GetTokenRunSizeBefore(Buffer, TokenOffset, TokenClass_Ignored);
+
+    if (TokenOffset != Offset && Result > 0 && GetBufferCharacter(Buffer, Result - 1) == '\n')
+    {
+        Result = TokenOffset;
+    }
+
+    return Result;
+}
+
+internal inline u32
+GetCodepointToggledCapital(u32 Codepoint)
+{
+    if ('A' <= Codepoint && Codepoint <= 'Z')
+    {
+        u32 Result = Codepoint + ('a' - 'A');
+        return Result;
+    }
+    if ('a' <= Codepoint && Codepoint <= 'z')
+    {
+        u32 Result = Codepoint - ('a' - 'A');
+        return Result;
+    }
+
+    return Codepoint;
+}
+
+internal inline u32
+GetCodepointShiftCorrespondant(u32 Codepoint)
+{
+    u32 Result = GetCodepointToggledCapital(Codepoint);
+    if (Result != Codepoint)
+    {
+        return Result;
+    }
+
+    switch (Codepoint)
+    {
+        case '0':  return ')';
+        case '1':  return '!';
+        case '2':  return '@';
+        case '3':  return '#';
+        case '4':  return '$';
+        case '5':  return '%';
+        case '6':  return '^';
+        case '7':  return '&';
+        case '8':  return '*';
+        case '9':  return '(';
+
+        case ';':  return ':';
+        case ',':  return '<';
+        case '.':  return '>';
+        case '=':  return '+';
+        case '-':  return '_';
+        case '\'': return '"';
+        case '`':  return '~';
+        case '/':  return '?';
+        case '\\': return '|';
+        case '[':  return '{';
+        case ']':  return '}';
+    }
+
+    return Result;
+}
+
+internal inline u32
+GetCodepointFromKeyCode(key_code KeyCode)
+{
+    if (KeyCode_AlphabetKeyFirst <= KeyCode && KeyCode <= KeyCode_AlphabetKeyLast)
+    {
+        u32 Codepoint = 'a' + (KeyCode - KeyCode_AlphabetKeyFirst);
+        return Codepoint;
+    }
+    if (KeyCode_Zero <= KeyCode && KeyCode <= KeyCode_Nine)
+    {
+        u32 Codepoint = '0' + (KeyCode - KeyCode_Zero);
+        return Codepoint;
+    }
+
+    switch (KeyCode)
+    {
+        case KeyCode_Space:        return ' ';
+        case KeyCode_Enter:        return '\n';
+        case KeyCode_Tab:          return '\t';
+
+        case KeyCode_Semicolon:    return ';';
+        case KeyCode_Comma:        return ',';
+        case KeyCode_Period:       return '.';
+        case KeyCode_Equals:       return '=';
+        case KeyCode_Minus:        return '-';
+        case KeyCode_Apostrophe:   return '\'';
+        case KeyCode_Backtick:     return '`';
+        case KeyCode_Slash:        return '/';
+        case KeyCode_Backslash:    return '\\';
+        case KeyCode_LeftBracket:  return '[';
+        case KeyCode_RightBracket: return ']';
+    }
+
+    InvalidCodePath;
+    return 0;
+}
+
+//=========================================================================================
+// NOTE(traian): MULTIPLE CARETS.
+//=========================================================================================
+
+internal inline memory_offset
+GetCaretStartOffset(text_caret *Caret)
+{
+    memory_offset Result = Caret->Position.Offset;
+    if (Caret->IsSelecting)
+    {
+        Result = Minimum(Result, Caret->Selection.Offset);
+    }
+    return Result;
+}
+
+internal inline memory_offset
+GetCaretEndOffset(text_caret *Caret)
+{
+    memory_offset Result = Caret->Position.Offset;
+    if (Caret->IsSelecting)
+    {
+        Result = Maximum(Result, Caret->Selection.Offset);
+    }
+    return Result;
+}
+
+// NOTE(traian): Carets overlap if their selections touch, which means that a caret at the end of the selection of
+// another caret also overlaps it.
+internal inline b32
+DoTextCaretsOverlap(text_caret *A, text_caret *B)
+{
+    b32 Result = (GetCaretStartOffset(A) <= GetCaretEndOffset(B)) && (GetCaretStartOffset(B) <= GetCaretEndOffset(A));
+    return Result;
+}
+
+internal inline void
+ReserveTextCarets(text_caret_list *List, u64 Count)
+{
+    if (List->Capacity < Count)
+    {
+        u64 NewCapacity = Maximum(Count, Maximum(2 * List->Capacity, 64));
+        buffer OldCarets = { (u8 *)List->Carets, List->Capacity * sizeof(text_caret) };
+        buffer NewCarets = PlatformAllocateMemory(NewCapacity * sizeof(text_caret));
+        if (List->Carets)
+        {
+            CopyArray((text_caret *)NewCarets.Data, List->Carets, List->Count);
+            PlatformReleaseMemory(OldCarets);
+        }
+
+        List->Carets = (text_caret *)NewCarets.Data;
+        List->Capacity = NewCapacity;
+    }
+}
+
+// NOTE(traian): Returns the index of the first caret that starts at or after the offset.
+internal inline u64
+FindTextCaretIndex(text_caret_list *List, memory_offset Offset)
+{
+    u64 First = 0;
+    u64 Last = List->Count;
+    while (First < Last)
+    {
+        u64 Middle = First + (Last - First) / 2;
+        if (GetCaretStartOffset(List->Carets + Middle) < Offset)
+        {
+            First = Middle + 1;
+        }
+        else
+        {
+            Last = Middle;
+        }
+    }
+
+    return First;
+}
+
+internal inline void
+InsertTextCaret(text_caret_list *List, u64 Index, text_caret *Caret)
+{
+    ReserveTextCarets(List, List->Count + 1);
+    MoveMem(List->Carets + Index + 1, List->Carets + Index, (List->Count - Index) * sizeof(text_caret));
+    List->Carets[Index] = *Caret;
+    ++List->Count;
+}
+
+internal inline void
+RemoveTextCaret(text_caret_list *List, u64 Index)
+{
+    Assert(Index < List->Count);
+    MoveMem(List->Carets + Index, List->Carets + Index + 1, (List->Count - Index - 1) * sizeof(text_caret));
+    --List->Count;
+}
+
+// NOTE(traian): Adds an extra caret to the panel. Returns false if it overlaps one of the existing carets.
+internal b32
+AddTextCaret(text_panel *Panel, text_caret *Caret)
+{
+    text_caret_list *List = &Panel->ExtraCarets;
+    if (DoTextCaretsOverlap(&Panel->Caret, Caret))
+    {
+        return false;
+    }
+
+    u64 Index = FindTextCaretIndex(List, GetCaretStartOffset(Caret));
+    if ((Index > 0 && DoTextCaretsOverlap(List->Carets + Index - 1, Caret)) ||
+        (Index < List->Count && DoTextCaretsOverlap(List->Carets + Index, Caret)))
+    {
+        return false;
+    }
+
+    InsertTextCaret(List, Index, Caret);
+    return true;
+}
+
+// NOTE(traian): Restores the order of the extra carets after they were moved and drops the ones that ended up
+// overlapping another caret. The carets move in the same direction, so they are almost always still sorted.
+internal void
+MergeTextCarets(text_panel *Panel)
+{
+    text_caret_list *List = &Panel->ExtraCarets;
+    for (u64 Index = 1; Index < List->Count; ++Index)
+    {
+        text_caret Caret = List->Carets[Index];
+        u64 InsertIndex = Index;
+        while (InsertIndex > 0 && GetCaretStartOffset(List->Carets + InsertIndex - 1) > GetCaretStartOffset(&Caret))
+        {
+            List->Carets[InsertIndex] = List->Carets[InsertIndex - 1];
+            --InsertIndex;
+        }
+        List->Carets[InsertIndex] = Caret;
+    }
+
+    u64 WriteIndex = 0;
+    for (u64 ReadIndex = 0; ReadIndex < List->Count; ++ReadIndex)
+    {
+        text_caret *Caret = List->Carets + ReadIndex;
+        if (DoTextCaretsOverlap(&Panel->Caret, Caret) ||
+            (WriteIndex > 0 && DoTextCaretsOverlap(List->Carets + WriteIndex - 1, Caret)))
+        {
+            continue;
+        }
+
+        List->Carets[WriteIndex++] = *Caret;
+    }
+
+    List->Count = WriteIndex;
+}
+
+// NOTE(traian): The edits at multiple carets are made on a single sorted list of carets, so the main caret is
+// moved into the list of extra carets for the duration of the edit. Returns its index in the list.
+internal u64
+GatherTextCarets(text_panel *Panel)
+{
+    text_caret_list *List = &Panel->ExtraCarets;
+    u64 MainIndex = FindTextCaretIndex(List, GetCaretStartOffset(&Panel->Caret));
+    InsertTextCaret(List, MainIndex, &Panel->Caret);
+    return MainIndex;
+}
+
+internal void
+ScatterTextCarets(text_panel *Panel, u64 MainIndex)
+{
+    text_caret_list *List = &Panel->ExtraCarets;
+    Panel->Caret = List->Carets[MainIndex];
+    RemoveTextCaret(List, MainIndex);
+    MergeTextCarets(Panel);
+}
+
+// NOTE(traian): Returns the column that follows the text, which starts at the given column.
+internal u64
+AdvanceColumnOverText(editor_settings *Settings, char *Characters, memory_size ByteCount, u64 Column)
+{
+    text_buffer TextBuffer = {};
+    TextBuffer.Base = Characters;
+    TextBuffer.Size = ByteCount;
+    TextBuffer.Used = ByteCount;
+    TextBuffer.GapOffset = ByteCount;
+
+    for (text_iterator Iterator = NewTextIterator(&TextBuffer, 0); IsValid(Iterator); Iterator = AdvanceIterator(Iterator))
+    {
+        Column += GetCodepointColumnCount(Settings, Iterator.Codepoint, Column);
+    }
+
+    return Column;
+}
+
+internal inline void
+SetCaretFromTextOffset(text_panel *Panel, editor_settings *Settings, text_caret *Caret, memory_offset Offset)
+{
+    u64 Line = GetLineOfBufferOffset(&Panel->LineIndex, Offset);
+    text_column_map *Map = GetTextColumnMap(Panel, Settings, Line);
+
+    Caret->Position.Offset = Offset;
+    Caret->Position.Line = Line;
+    Caret->Position.Column = GetColumnOfLineOffset(Map, Offset - Map->LineOffset);
+    Caret->TargetColumn = Caret->Position.Column;
+}
+
+typedef enum text_caret_removal_enum : u8
+{
+    CaretRemoval_Selection,
+    CaretRemoval_PreviousCharacter,
+    CaretRemoval_NextCharacter,
+    CaretRemoval_PreviousToken,
+    CaretRemoval_NextToken,
+}
+text_caret_removal;
+
+//
+// NOTE(traian): Batched edits. The carets are visited from left to right, so the gaps of the text buffer and of
+// the line index only ever move forward and every byte between the first and the last caret is shifted once,
+// instead of once per caret. Each caret is recorded as a separate edit of the current history group. The
+// returned record is the last one that was made, so that the caller can store the view state that follows.
+//
+
+// NOTE(traian): Removes the selection of each caret or, for the carets that don't select anything, the range
+// given by the kind of the removal. A range never extends past the neighbouring carets.
+internal text_edit_record *
+RemoveAtTextCarets(text_panel *Panel, editor_settings *Settings, text_caret_removal Removal)
+{
+    text_view_state Before = GetTextViewState(Panel);
+    text_buffer *Buffer = &Panel->Buffer;
+    MakeTextPanelEditable(Panel);
+
+    u64 MainIndex = GatherTextCarets(Panel);
+    text_caret_list *List = &Panel->ExtraCarets;
+    Panel->History.CanCoalesce = false;
+
+    text_edit_record *LastRecord = NULL;
+    memory_size OffsetShift = 0;
+    memory_offset Floor = 0;
+    for (u64 Index = 0; Index < List->Count; ++Index)
+    {
+        text_caret *Caret = List->Carets + Index;
+        memory_offset Start = GetCaretStartOffset(Caret) - OffsetShift;
+        memory_offset End = GetCaretEndOffset(Caret) - OffsetShift;
+
+        if (!Caret->IsSelecting)
+        {
+            switch (Removal)
+            {
+                case CaretRemoval_PreviousToken:
+                {
+                    if (Start > 0)
+                    {
+                        memory_offset TokenOffset = FindPreviousTokenBoundary(Buffer, Start);
+                        Start = (TokenOffset != Start) ? TokenOffset : DevanceIterator(NewTextIterator(Buffer, Start)).Offset;
+                    }
+                } break;
+
+                case CaretRemoval_PreviousCharacter:
+                {
+                    if (Start > 0)
+                    {
+                        Start = DevanceIterator(NewTextIterator(Buffer, Start)).Offset;
+                    }
+                } break;
+
+                case CaretRemoval_NextToken:
+                {
+                    if (End < Buffer->Used)
+                    {
+                        memory_offset TokenOffset = FindNextTokenBoundary(Buffer, End);
+                        End = (TokenOffset != End) ? TokenOffset : End + NewTextIterator(Buffer, End).Width;
+                    }
+                } break;
+
+                case CaretRemoval_NextCharacter:
+                {
+                    if (End < Buffer->Used)
+                    {
+                        End += NewTextIterator(Buffer, End).Width;
+                    }
+                } break;
+
+                case CaretRemoval_Selection: break;
+            }
+        }
+
+        memory_offset Ceiling = Buffer->Used;
+        if (Index + 1 < List->Count)
+        {
+            Ceiling = GetCaretStartOffset(List->Carets + Index + 1) - OffsetShift;
+        }
+        Start = Maximum(Start, Floor);
+        End = Minimum(End, Ceiling);
+
+        memory_size ByteCount = End - Start;
+        if (ByteCount > 0)
+        {
+            text_edit_record *Record = RecordTextEdit(Panel, TextEditKind_Remove, Start, NULL, ByteCount, &Before);
+            ApplyTextEdit(Panel, TextEditKind_Remove, Start, NULL, ByteCount);
+            OffsetShift += ByteCount;
+            LastRecord = Record ? Record : LastRecord;
+        }
+
+        // NOTE(traian): The removed range may have spanned multiple lines, so the line of the caret is looked up
+        // in the line index, which is already up to date with the edits on its left.
+        Caret->IsSelecting = false;
+        Caret->Selection = {};
+        SetCaretFromTextOffset(Panel, Settings, Caret, Start);
+        Floor = Start;
+    }
+
+    ScatterTextCarets(Panel, MainIndex);
+    Panel->History.CanCoalesce = false;
+    return LastRecord;
+}
+
+// NOTE(traian): Inserts the text at each caret. The carets must not select anything. A tab that is replaced
+// with spaces is expanded separately for each caret, up to its next tab stop.
+internal text_edit_record *
+InsertAtTextCarets(text_panel *Panel, editor_settings *Settings, char *Characters, memory_size ByteCount)
+{
+    text_view_state Before = GetTextViewState(Panel);
+    MakeTextPanelEditable(Panel);
+
+    u64 MainIndex = GatherTextCarets(Panel);
+    text_caret_list *List = &Panel->ExtraCarets;
+    Panel->History.CanCoalesce = false;
+
+    char Spaces[64];
+    b32 IsTabStop = (ByteCount == 1 && Characters[0] == '\t' && Settings->ReplaceTabWithSpaces);
+    memory_size MaxByteCount = ByteCount;
+    if (IsTabStop)
+    {
+        MaxByteCount = Minimum(Settings->TabWidth, sizeof(Spaces));
+        SetMemory(Spaces, ' ', MaxByteCount);
+    }
+
+    // NOTE(traian): The inserted text is the same at every caret, so the line and the column that follow it
+    // are computed once. Only the carets that share a line with a caret on their left have to look up their column.
+    u64 NewLineCount = IsTabStop ? 0 : GetNumberOfLines(Characters, ByteCount);
+    memory_offset LastLineOffset = ByteCount;
+    while (LastLineOffset > 0 && Characters[LastLineOffset - 1] != '\n')
+    {
+        --LastLineOffset;
+    }
+    u64 LastLineColumn = AdvanceColumnOverText(Settings, Characters + LastLineOffset, ByteCount - LastLineOffset, 0);
+
+    ReserveBufferGap(&Panel->Buffer, List->Count * MaxByteCount);
+    ReserveLineIndexGap(&Panel->LineIndex, List->Count * NewLineCount);
+
+    text_edit_record *LastRecord = NULL;
+    memory_size OffsetShift = 0;
+    u64 LineShift = 0;
+    for (u64 Index = 0; Index < List->Count; ++Index)
+    {
+        text_caret *Caret = List->Carets + Index;
+        Assert(!Caret->IsSelecting);
+
+        memory_offset Offset = Caret->Position.Offset + OffsetShift;
+        u64 Line = Caret->Position.Line + LineShift;
+        u64 Column = Caret->Position.Column;
+        if (Index > 0 && List->Carets[Index - 1].Position.Line == Line)
+        {
+            text_column_map *Map = GetTextColumnMap(Panel, Settings, Line);
+            Column = GetColumnOfLineOffset(Map, Offset - Map->LineOffset);
+        }
+
+        char *Text = Characters;
+        memory_size TextSize = ByteCount;
+        if (IsTabStop)
+        {
+            Text = Spaces;
+            TextSize = Minimum(GetCodepointColumnCount(Settings, '\t', Column), MaxByteCount);
+        }
+
+        text_edit_record *Record = RecordTextEdit(Panel, TextEditKind_Insert, Offset, Text, TextSize, &Before);
+        ApplyTextEdit(Panel, TextEditKind_Insert, Offset, Text, TextSize);
+        LastRecord = Record ? Record : LastRecord;
+
+        Caret->Position.Offset = Offset + TextSize;
+        Caret->Position.Line = Line + NewLineCount;
+        Caret->Position.Column = (NewLineCount > 0) ? LastLineColumn
+                                                    : AdvanceColumnOverText(Settings, Text, TextSize, Column);
+        Caret->TargetColumn = Caret->Position.Column;
+
+        OffsetShift += TextSize;
+        LineShift += NewLineCount;
+    }
+
+    ScatterTextCarets(Panel, MainIndex);
+    Panel->History.CanCoalesce = false;
+    return LastRecord;
+}
+
+//=========================================================================================
+// NOTE(traian): TEXT FIND.
+//=========================================================================================
+
+// NOTE(traian): Returns the offset of the first occurrence of the query that lies entirely in [Offset, End),
+// or INVALID_SIZE if there is none. The spans around the gap are searched directly, while the occurrences that
+// straddle the gap are searched in a copy of the few bytes around it.
+internal memory_offset
+FindTextInBuffer(text_buffer *Buffer, memory_offset Offset, memory_offset End, char *Query, memory_size QueryLength)
+{
+    Assert(End <= Buffer->Used);
+    Assert(QueryLength <= TEXT_FIND_QUERY_CAPACITY);
+    if (QueryLength == 0 || Offset >= End || End - Offset < QueryLength)
+    {
+        return INVALID_SIZE;
+    }
+
+    memory_offset GapOffset = Buffer->GapOffset;
+    if (Offset < GapOffset)
+    {
+        memory_size Count = Minimum(GapOffset, End) - Offset;
+        memory_size Index = FindLiteral(Buffer->Base + Offset, Count, Query, QueryLength);
+        if (Index < Count)
+        {
+            return Offset + Index;
+        }
+
+        if (End <= GapOffset)
+        {
+            return INVALID_SIZE;
+        }
+
+        if (QueryLength > 1)
+        {
+            memory_offset WindowOffset = GapOffset - Minimum(QueryLength - 1, GapOffset - Offset);
+            memory_offset WindowEnd = Minimum(GapOffset + QueryLength - 1, End);
+            memory_size WindowCount = WindowEnd - WindowOffset;
+
+            char Window[2 * TEXT_FIND_QUERY_CAPACITY];
+            CopyFromBuffer(Buffer, WindowOffset, WindowCount, Window);
+            Index = FindLiteral(Window, WindowCount, Query, QueryLength);
+            if (Index < WindowCount)
+            {
+                return WindowOffset + Index;
+            }
+        }
+
+        Offset = GapOffset;
+    }
+
+    memory_size Count = End - Offset;
+    memory_size Index = FindLiteral(GetBufferAddress(Buffer, Offset), Count, Query, QueryLength);
+    if (Index < Count)
+    {
+        return Offset + Index;
+    }
+    return INVALID_SIZE;
+}
+
+// NOTE(traian): Finds the leftmost match of the regex that lies entirely in [Offset, End). The forward DFA is run
+// over the spans around the gap until it finds where the match ends, and the reverse DFA is run backwards from
+// there to find where it starts. The bytes around the range are only looked at by the line anchors.
+internal b32
+FindRegexInBuffer(regex *Regex, text_buffer *Buffer, memory_offset Offset, memory_offset End, text_find_match *Match)
+{
+    Assert(Regex->IsValid && End <= Buffer->Used);
+    if (Offset > End)
+    {
+        return false;
+    }
+
+    regex_dfa *ForwardDFA = &Regex->ForwardDFA;
+    b32 PreviousIsNewLine = (Offset == 0) || (GetBufferCharacter(Buffer, Offset - 1) == '\n');
+    u32 State = GetRegexStartState(ForwardDFA, PreviousIsNewLine);
+    memory_offset MatchEnd = INVALID_SIZE;
+
+    memory_offset At = Offset;
+    while (At < End && State != REGEX_DEAD_STATE)
+    {
+        memory_size Count = (At < Buffer->GapOffset) ? Minimum(Buffer->GapOffset, End) - At : End - At;
+        At += ScanRegexForward(Regex, &State, (u8 *)GetBufferAddress(Buffer, At), Count, At, &MatchEnd);
+    }
+
+    s32 NextByte = (End < Buffer->Used) ? (u8)GetBufferCharacter(Buffer, End) : -1;
+    if (IsRegexMatchAtBoundary(Regex, ForwardDFA, State, NextByte))
+    {
+        MatchEnd = End;
+    }
+    if (MatchEnd == INVALID_SIZE)
+    {
+        return false;
+    }
+
+    regex_dfa *ReverseDFA = &Regex->ReverseDFA;
+    b32 NextIsNewLine = (MatchEnd == Buffer->Used) || (GetBufferCharacter(Buffer, MatchEnd) == '\n');
+    State = GetRegexStartState(ReverseDFA, NextIsNewLine);
+    memory_offset MatchStart = INVALID_SIZE;
+
+    At = MatchEnd;
+    while (At > Offset && State != REGEX_DEAD_STATE)
+    {
+        memory_offset SpanOffset = (At > Buffer->GapOffset) ? Maximum(Buffer->GapOffset, Offset) : Offset;
+        At -= ScanRegexBackward(Regex, &State, (u8 *)GetBufferAddress(Buffer, SpanOffset), At - SpanOffset,
+                                SpanOffset, &MatchStart);
+    }
+
+    s32 PreviousByte = (Offset > 0) ? (u8)GetBufferCharacter(Buffer, Offset - 1) : -1;
+    if (IsRegexMatchAtBoundary(Regex, ReverseDFA, State, PreviousByte))
+    {
+        MatchStart = Offset;
+    }
+
+    Assert(MatchStart != INVALID_SIZE && MatchStart <= MatchEnd);
+    Match->Offset = MatchStart;
+    Match->Size = MatchEnd - MatchStart;
+    return true;
+}
+
+// NOTE(traian): Finds the first match of the query that lies entirely in [Offset, End). The empty matches of a
+// regex are skipped, since there is nothing to select or highlight.
+internal b32
+FindTextMatch(text_find *Find, text_buffer *Buffer, memory_offset Offset, memory_offset End, text_find_match *Match)
+{
+    if (!Find->IsQueryValid)
+    {
+        return false;
+    }
+
+    if (!Find->IsRegex)
+    {
+        Match->Offset = FindTextInBuffer(Buffer, Offset, End, Find->Query, Find->QueryLength);
+        Match->Size = Find->QueryLength;
+        return Match->Offset != INVALID_SIZE;
+    }
+
+    while (FindRegexInBuffer(&Find->Regex, Buffer, Offset, End, Match))
+    {
+        if (Match->Size > 0)
+        {
+            return true;
+        }
+        Offset = Match->Offset + 1;
+    }
+    return false;
+}
+
+internal inline void
+ReserveTextFindMatches(text_find *Find, u64 Count)
+{
+    if (Find->MatchCapacity < Count)
+    {
+        u64 NewCapacity = Maximum(Count, Maximum(2 * Find->MatchCapacity, 1024));
+        buffer OldMatches = { (u8 *)Find->Matches, Find->MatchCapacity * sizeof(text_find_match) };
+        buffer NewMatches = PlatformAllocateMemory(NewCapacity * sizeof(text_find_match));
+        if (Find->Matches)
+        {
+            CopyArray((text_find_match *)NewMatches.Data, Find->Matches, Find->MatchCount);
+            PlatformReleaseMemory(OldMatches);
+        }
+
+        Find->Matches = (text_find_match *)NewMatches.Data;
+        Find->MatchCapacity = NewCapacity;
+    }
+}
+
+// NOTE(traian): Discards the matches, so that the text is searched again from its start.
+internal inline void
+RestartTextFind(text_panel *Panel)
+{
+    text_find *Find = &Panel->Find;
+    Find->MatchCount = 0;
+    Find->ScanOffset = 0;
+    Find->EditVersion = Panel->EditVersion;
+}
+
+// NOTE(traian): Compiles the query after it was changed, and discards the matches of the old query.
+internal void
+UpdateTextFindQuery(text_panel *Panel)
+{
+    text_find *Find = &Panel->Find;
+    Find->IsQueryValid = (Find->QueryLength > 0);
+    if (Find->IsQueryValid && Find->IsRegex)
+    {
+        Find->IsQueryValid = CompileRegex(&Find->Regex, Find->Query, Find->QueryLength);
+    }
+    Find->IsReplaceAllPending = false;
+    RestartTextFind(Panel);
+}
+
+internal inline void
+ResetTextFind(text_panel *Panel)
+{
+    Panel->Find.IsActive = false;
+    Panel->Find.IsEditingReplacement = false;
+    Panel->Find.QueryLength = 0;
+    UpdateTextFindQuery(Panel);
+}
+
+internal inline b32
+AreTextFindMatchesCurrent(text_panel *Panel)
+{
+    b32 Result = (Panel->Find.EditVersion == Panel->EditVersion);
+    return Result;
+}
+
+internal inline b32
+IsTextFindComplete(text_panel *Panel)
+{
+    text_find *Find = &Panel->Find;
+    b32 Result = !Find->IsQueryValid ||
+                 (AreTextFindMatchesCurrent(Panel) && !Panel->Load.IsActive && Find->ScanOffset >= Panel->Buffer.Used);
+    return Result;
+}
+
+// NOTE(traian): Searches the next slice of the text that wasn't scanned yet. Returns false if there was nothing
+// left to search. The text that is still loading is only searched up to the point where a match can't continue
+// into the text that isn't loaded yet.
+internal b32
+ContinueTextFind(text_panel *Panel, memory_size SliceSize)
+{
+    text_find *Find = &Panel->Find;
+    text_buffer *Buffer = &Panel->Buffer;
+    if (!Find->IsQueryValid)
+    {
+        return false;
+    }
+
+    if (!AreTextFindMatchesCurrent(Panel))
+    {
+        RestartTextFind(Panel);
+    }
+
+    // NOTE(traian): A regex match never contains a new line, so it can't continue past the last complete line.
+    memory_size ScanEnd = Buffer->Used;
+    if (Panel->Load.IsActive && Find->IsRegex)
+    {
+        u64 LastLine = Panel->LineIndex.Count;
+        ScanEnd = (LastLine > 0) ? GetBufferOffsetOfLine(&Panel->LineIndex, LastLine - 1) : 0;
+    }
+    else if (Panel->Load.IsActive)
+    {
+        ScanEnd = (ScanEnd >= Find->QueryLength) ? ScanEnd - Find->QueryLength + 1 : 0;
+    }
+    if (Find->ScanOffset >= ScanEnd)
+    {
+        return false;
+    }
+
+    // NOTE(traian): Only the matches that start inside the slice are added, but they can end after it. The slice
+    // of a regex is extended to the end of its line instead, so that no match crosses it.
+    memory_offset SliceEnd = Minimum(Find->ScanOffset + SliceSize, ScanEnd);
+    memory_offset SearchEnd = Minimum(SliceEnd + Find->QueryLength - 1, Buffer->Used);
+    if (Find->IsRegex)
+    {
+        char NewLine = '\n';
+        memory_offset LineEnd = FindTextInBuffer(Buffer, SliceEnd, ScanEnd, &NewLine, 1);
+        SliceEnd = (LineEnd != INVALID_SIZE) ? LineEnd + 1 : ScanEnd;
+        SearchEnd = SliceEnd;
+    }
+
+    text_find_match Match;
+    while (FindTextMatch(Find, Buffer, Find->ScanOffset, SearchEnd, &Match))
+    {
+        ReserveTextFindMatches(Find, Find->MatchCount + 1);
+        Find->Matches[Find->MatchCount++] = Match;
+        Find->ScanOffset = Match.Offset + Match.Size;
+    }
+
+    Find->ScanOffset = Maximum(Find->ScanOffset, SliceEnd);
+    return true;
+}
+
+// NOTE(traian): Searches slices of the text until the time is up. Returns false if there was nothing left to
+// search.
+internal b32
+ContinueTextFindForSeconds(text_panel *Panel, f64 Seconds)
+{
+    u64 StartClock = PlatformGetWallClock();
+    b32 Result = false;
+    while (ContinueTextFind(Panel, TEXT_FIND_SLICE_SIZE))
+    {
+        Result = true;
+        if (PlatformGetSecondsElapsed(StartClock, PlatformGetWallClock()) >= Seconds)
+        {
+            break;
+        }
+    }
+    return Result;
+}
+
+// NOTE(traian): Searches the rest of the text at once, for the callers that can wait for it.
+internal void
+CompleteTextFind(text_panel *Panel)
+{
+    while (ContinueTextFind(Panel, TEXT_FIND_SLICE_SIZE))
+    {
+    }
+}
+
+// NOTE(traian): Returns the index of the first match that starts at or after the offset.
+internal inline u64
+FindTextMatchIndex(text_find *Find, memory_offset Offset)
+{
+    u64 First = 0;
+    u64 Last = Find->MatchCount;
+    while (First < Last)
+    {
+        u64 Middle = First + (Last - First) / 2;
+        if (Find->Matches[Middle].Offset < Offset)
+        {
+            First = Middle + 1;
+        }
+        else
+        {
+            Last = Middle;
+        }
+    }
+
+    return First;
+}
+
+// NOTE(traian): Finds the first match that starts at or after the offset, wrapping around to the start of the
+// text. The text is searched directly, so the result doesn't depend on the progress of the scan.
+internal b32
+FindNextTextMatch(text_panel *Panel, memory_offset Offset, text_find_match *Match)
+{
+    text_find *Find = &Panel->Find;
+    text_buffer *Buffer = &Panel->Buffer;
+
+    b32 Result = FindTextMatch(Find, Buffer, Offset, Buffer->Used, Match);
+    if (!Result)
+    {
+        memory_offset WrapEnd = Find->IsRegex ? Buffer->Used : Minimum(Offset + Find->QueryLength - 1, Buffer->Used);
+        Result = FindTextMatch(Find, Buffer, 0, WrapEnd, Match);
+    }
+    return Result;
+}
+
+// NOTE(traian): Returns the start of the line that contains the offset.
+internal inline memory_offset
+FindTextLineStart(text_buffer *Buffer, memory_offset Offset)
+{
+    while (Offset > 0 && GetBufferCharacter(Buffer, Offset - 1) != '\n')
+    {
+        --Offset;
+    }
+    return Offset;
+}
+
+// NOTE(traian): Finds the last match that starts in [Start, End). The text is searched forward from the start,
+// which has to be at the start of a line for a regex, since its matches depend on where the search begins. A
+// match can end after the end, up to the end of the line for a regex. The matches of a literal can overlap, like
+// the ones that are found when searching forward from any offset.
+internal b32
+FindLastTextMatchInRange(text_find *Find, text_buffer *Buffer, memory_offset Start, memory_offset End,
+                         text_find_match *Match)
+{
+    memory_offset SearchEnd = Minimum(End + Find->QueryLength - 1, Buffer->Used);
+    if (Find->IsRegex)
+    {
+        char NewLine = '\n';
+        memory_offset LineEnd = FindTextInBuffer(Buffer, End, Buffer->Used, &NewLine, 1);
+        SearchEnd = (LineEnd != INVALID_SIZE) ? LineEnd + 1 : Buffer->Used;
+    }
+
+    b32 Result = false;
+    text_find_match Candidate;
+    memory_offset Offset = Start;
+    while (Offset < End && FindTextMatch(Find, Buffer, Offset, SearchEnd, &Candidate) && Candidate.Offset < End)
+    {
+        *Match = Candidate;
+        Result = true;
+        Offset = Find->IsRegex ? Candidate.Offset + Candidate.Size : Candidate.Offset + 1;
+    }
+    return Result;
+}
+
+// NOTE(traian): Finds the last match that starts before the offset, wrapping around to the end of the text. The
+// matches of the scan are used if it already got past the offset. Otherwise the text is searched backwards in
+// slices, so only the text between the offset and the match is searched, like when searching forward.
+internal b32
+FindPreviousTextMatch(text_panel *Panel, memory_offset Offset, text_find_match *Match)
+{
+    text_find *Find = &Panel->Find;
+    text_buffer *Buffer = &Panel->Buffer;
+    if (!Find->IsQueryValid)
+    {
+        return false;
+    }
+
+    if (AreTextFindMatchesCurrent(Panel) && Find->ScanOffset >= Offset)
+    {
+        u64 Index = FindTextMatchIndex(Find, Offset);
+        if (Index > 0)
+        {
+            *Match = Find->Matches[Index - 1];
+            return true;
+        }
+    }
+
+    // NOTE(traian): The slices before the offset are searched first, then the ones after it, from the end. The
+    // slice of a regex starts at the start of its line, so the last one after the offset can start before it, where
+    // the first pass found no matches.
+    memory_offset End = Offset;
+    memory_offset Bound = 0;
+    for (u32 Pass = 0; Pass < 2; ++Pass)
+    {
+        while (End > Bound)
+        {
+            memory_offset Start = (End - Bound > TEXT_FIND_SLICE_SIZE) ? End - TEXT_FIND_SLICE_SIZE : Bound;
+            if (Find->IsRegex)
+            {
+                Start = FindTextLineStart(Buffer, Start);
+            }
+
+            if (FindLastTextMatchInRange(Find, Buffer, Start, End, Match))
+            {
+                return true;
+            }
+            End = Start;
+        }
+
+        End = Buffer->Used;
+        Bound = Offset;
+    }
+    return false;
+}
+
+// NOTE(traian): Returns where the offset ends up once every match is replaced. An offset inside of a match moves
+// to the end of its replacement.
+internal memory_offset
+GetReplacedTextOffset(text_find *Find, memory_size ReplacementLength, memory_offset Offset)
+{
+    memory_offset Result = Offset;
+    for (u64 Index = 0; Index < Find->MatchCount && Find->Matches[Index].Offset < Offset; ++Index)
+    {
+        text_find_match *Match = Find->Matches + Index;
+        if (Offset < Match->Offset + Match->Size)
+        {
+            Result = Result - (Offset - Match->Offset) + ReplacementLength;
+            break;
+        }
+        Result = Result + ReplacementLength - Match->Size;
+    }
+
+    return Result;
+}
+
+// NOTE(traian): Moves the line endings to where their new lines end up once every match is replaced, in a single
+// pass over both lists. Only the line endings of the new lines inside of a match are dropped.
+internal void
+ReplaceTextLineEndingsOfMatches(text_line_endings *LineEndings, text_find *Find, memory_size ReplacementLength)
+{
+    memory_offset *Offsets = LineEndings->Offsets;
+    u64 WriteIndex = 0;
+    u64 MatchIndex = 0;
+    memory_size RemovedSize = 0;
+    memory_size InsertedSize = 0;
+    for (u64 Index = 0; Index < LineEndings->Count; ++Index)
+    {
+        memory_offset Offset = Offsets[Index];
+        while (MatchIndex < Find->MatchCount &&
+               Find->Matches[MatchIndex].Offset + Find->Matches[MatchIndex].Size <= Offset)
+        {
+            RemovedSize += Find->Matches[MatchIndex].Size;
+            InsertedSize += ReplacementLength;
+            ++MatchIndex;
+        }
+
+        if (MatchIndex == Find->MatchCount || Offset < Find->Matches[MatchIndex].Offset)
+        {
+            Offsets[WriteIndex++] = Offset - RemovedSize + InsertedSize;
+        }
+    }
+    LineEndings->Count = WriteIndex;
+}
+
+// NOTE(traian): Replaces every match of the find. The matches are collected first, so the size of the new text is
+// known up front and the text is copied once into a new buffer, instead of moving the rest of the text at every
+// match. The text from the first to the last match is recorded as one removal and one insertion, which are undone
+// together and journaled as two entries. The caret follows its text, and the extra carets are dropped. The scan
+// has to be complete, which also means that the file is loaded.
+internal text_edit_record *
+ReplaceAllTextMatches(text_panel *Panel, editor_settings *Settings, char *Replacement, memory_size ReplacementLength,
+                      text_view_state *Before)
+{
+    text_find *Find = &Panel->Find;
+    text_buffer *Buffer = &Panel->Buffer;
+
+    Assert(IsTextFindComplete(Panel));
+    Find->IsReplaceAllPending = false;
+    MakeTextPanelEditable(Panel);
+    if (Find->MatchCount == 0)
+    {
+        return NULL;
+    }
+
+    memory_size MatchedSize = 0;
+    for (u64 Index = 0; Index < Find->MatchCount; ++Index)
+    {
+        MatchedSize += Find->Matches[Index].Size;
+    }
+
+    text_find_match *LastMatch = Find->Matches + Find->MatchCount - 1;
+    memory_offset SpanOffset = Find->Matches[0].Offset;
+    memory_offset SpanEnd = LastMatch->Offset + LastMatch->Size;
+    memory_size ReplacedSize = Find->MatchCount * ReplacementLength;
+    memory_size NewSpanSize = (SpanEnd - SpanOffset) - MatchedSize + ReplacedSize;
+    memory_size NewSize = Buffer->Used - MatchedSize + ReplacedSize;
+
+    // NOTE(traian): The removal and the insertion are undone together, so they're only recorded if both of them
+    // fit in the history. Otherwise the history is forgotten, since the text before the replacement is lost. The
+    // new span can only have fewer line endings than the old one.
+    u64 LineEndingCount = 0;
+    FindTextLineEndingsInRange(&Panel->LineEndings, SpanOffset, SpanEnd - SpanOffset, &LineEndingCount);
+    memory_size GroupSize = GetTextEditRecordSize(SpanEnd - SpanOffset, LineEndingCount) +
+                            GetTextEditRecordSize(NewSpanSize, LineEndingCount);
+    Panel->History.CanCoalesce = false;
+    BeginTextEditGroup(Panel);
+    text_edit_record *Record = NULL;
+    if (GroupSize <= TEXT_HISTORY_BUDGET_SIZE)
+    {
+        Record = RecordTextEdit(Panel, TextEditKind_Remove, SpanOffset, NULL, SpanEnd - SpanOffset, Before);
+    }
+    else
+    {
+        // TODO(traian): Logging.
+        ResetTextHistory(&Panel->History);
+    }
+    AppendToTextJournal(Panel, TextEditKind_Remove, SpanOffset, NULL, SpanEnd - SpanOffset, NULL, 0);
+
+    // NOTE(traian): The gap is placed right after the last replacement, so the new span is contiguous in memory.
+    buffer NewText = PlatformAllocateMemory(NewSize + TEXT_BUFFER_DEFAULT_GAP_SIZE);
+    char *Destination = (char *)NewText.Data;
+    memory_offset ReadOffset = 0;
+    for (u64 Index = 0; Index < Find->MatchCount; ++Index)
+    {
+        text_find_match *Match = Find->Matches + Index;
+        CopyFromBuffer(Buffer, ReadOffset, Match->Offset - ReadOffset, Destination);
+        Destination += Match->Offset - ReadOffset;
+        CopyMem(Destination, Replacement, ReplacementLength);
+        Destination += ReplacementLength;
+        ReadOffset = Match->Offset + Match->Size;
+    }
+
+    memory_size TailSize = Buffer->Used - ReadOffset;
+    CopyFromBuffer(Buffer, ReadOffset, TailSize, (char *)NewText.Data + NewText.Size - TailSize);
+
+    ReleaseBufferMemory(Buffer);
+    Buffer->Base = (char *)NewText.Data;
+    Buffer->Size = NewText.Size;
+    Buffer->Used = NewSize;
+    Buffer->GapOffset = SpanOffset + NewSpanSize;
+
+    // NOTE(traian): The insertion puts back the line endings of the lines between the matches, so they're
+    // moved before it's recorded.
+    ReplaceTextLineEndingsOfMatches(&Panel->LineEndings, Find, ReplacementLength);
+    u64 FirstLineEnding = FindTextLineEndingsInRange(&Panel->LineEndings, SpanOffset, NewSpanSize, &LineEndingCount);
+    buffer LineEndings = {};
+    if (LineEndingCount > 0)
+    {
+        LineEndings = PlatformAllocateMemory(LineEndingCount * sizeof(memory_offset));
+        memory_offset *Offsets = Panel->LineEndings.Offsets + FirstLineEnding;
+        for (u64 Index = 0; Index < LineEndingCount; ++Index)
+        {
+            ((memory_offset *)LineEndings.Data)[Index] = Offsets[Index] - SpanOffset;
+        }
+    }
+
+    char *NewSpan = Buffer->Base + SpanOffset;
+    if (Record)
+    {
+        Record = RecordTextEditWithLineEndings(Panel, TextEditKind_Insert, SpanOffset, NewSpan, NewSpanSize,
+                                               &Panel->LineEndings, Before);
+    }
+    AppendToTextJournal(Panel, TextEditKind_Insert, SpanOffset, NewSpan, NewSpanSize,
+                        (memory_offset *)LineEndings.Data, LineEndingCount);
+    if (LineEndings.Data)
+    {
+        PlatformReleaseMemory(LineEndings);
+    }
+    EndTextEditGroup(Panel);
+    Panel->History.CanCoalesce = false;
+
+    BuildLineIndex(&Panel->LineIndex, Buffer);
+    InvalidateTextColumnMaps(Panel);
+    Panel->LineCount = Panel->LineIndex.Count - 1;
+    Panel->IsSaveDirty = true;
+    Panel->UnmodifiedSize = Minimum(Panel->UnmodifiedSize, SpanOffset);
+    ++Panel->EditVersion;
+
+    // NOTE(traian): The matches are still around until the find is restarted, so they map the caret.
+    text_caret *Caret = &Panel->Caret;
+    memory_offset CaretOffset = GetReplacedTextOffset(Find, ReplacementLength, Caret->Position.Offset);
+    SetCaretFromTextOffset(Panel, Settings, Caret, CaretOffset);
+    Caret->IsSelecting = false;
+    Panel->ExtraCarets.Count = 0;
+
+    Panel->FirstLineIndex = Minimum(Panel->FirstLineIndex, Panel->LineCount);
+    Panel->BufferOffset = GetBufferOffsetOfLine(&Panel->LineIndex, Panel->FirstLineIndex);
+
+    RestartTextFind(Panel);
+    return Record;
 }
 
 #define OCEAN_TEXT_H
@@ -0,0 +1,644 @@
+/*  =====================================================================
+    $File:   ocean_trigram_index.h $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+#ifndef OCEAN_TRIGRAM_INDEX_H
+
+#include "ocean.h"
+
+//=========================================================================================
+// NOTE(traian): VARINTS.
+//=========================================================================================
+
+internal inline memory_size
+EncodeTrigramIndexVarint(u8 *Output, u32 Value)
+{
+    memory_size Size = 0;
+    while (Value >= 0x80)
+    {
+        Output[Size++] = (u8)(Value | 0x80);
+        Value >>= 7;
+    }
+    Output[Size++] = (u8)Value;
+    return Size;
+}
+
+internal inline memory_size
+GetTrigramIndexVarintSize(u32 Value)
+{
+    memory_size Size = 1;
+    while (Value >= 0x80)
+    {
+        Value >>= 7;
+        ++Size;
+    }
+    return Size;
+}
+
+// NOTE(traian): Returns the offset after the value. A value that is cut off by the end of the list is
+// decoded from the bytes before the end.
+internal inline memory_offset
+DecodeTrigramIndexVarint(u8 *Bytes, memory_offset Offset, memory_size Size, u32 *Value)
+{
+    u32 Result = 0;
+    u32 Shift = 0;
+    while (Offset < Size && Shift < 32)
+    {
+        u8 Byte = Bytes[Offset++];
+        Result |= (u32)(Byte & 0x7F) << Shift;
+        if (!(Byte & 0x80))
+        {
+            break;
+        }
+        Shift += 7;
+    }
+
+    *Value = Result;
+    return Offset;
+}
+
+//=========================================================================================
+// NOTE(traian): TRIGRAMS.
+//=========================================================================================
+
+// NOTE(traian): Lists every distinct trigram of the bytes, in the order they are first seen. The bits must be
+// clear, and are cleared again before returning. The trigrams must fit the byte count minus two, but never more
+// than TRIGRAM_INDEX_TRIGRAM_CAPACITY.
+internal memory_size
+CollectTrigrams(u8 *Bytes, memory_size Count, u64 *Bits, u32 *Trigrams)
+{
+    if (Count < 3)
+    {
+        return 0;
+    }
+
+    memory_size TrigramCount = 0;
+    u32 Trigram = ((u32)Bytes[0] << 8) | Bytes[1];
+    for (memory_offset Index = 2; Index < Count; ++Index)
+    {
+        Trigram = ((Trigram << 8) | Bytes[Index]) & (TRIGRAM_INDEX_TRIGRAM_CAPACITY - 1);
+        u64 *Word = Bits + (Trigram >> 6);
+        u64 Mask = 1ull << (Trigram & 63);
+        if (!(*Word & Mask))
+        {
+            *Word |= Mask;
+            Trigrams[TrigramCount++] = Trigram;
+        }
+    }
+
+    for (memory_offset Index = 0; Index < TrigramCount; ++Index)
+    {
+        Bits[Trigrams[Index] >> 6] = 0;
+    }
+    return TrigramCount;
+}
+
+// NOTE(traian): Least significant digit radix sort, one byte of the trigram per pass. Returns the array that holds
+// the sorted trigrams, which is either of the two.
+internal u32 *
+SortTrigrams(u32 *Trigrams, u32 *Scratch, memory_size Count)
+{
+    if (Count < 64)
+    {
+        for (memory_offset Index = 1; Index < Count; ++Index)
+        {
+            u32 Trigram = Trigrams[Index];
+            memory_offset Slot = Index;
+            for (; Slot > 0 && Trigrams[Slot - 1] > Trigram; --Slot)
+            {
+                Trigrams[Slot] = Trigrams[Slot - 1];
+            }
+            Trigrams[Slot] = Trigram;
+        }
+        return Trigrams;
+    }
+
+    u32 *Source = Trigrams;
+    u32 *Destination = Scratch;
+    for (u32 Shift = 0; Shift < 24; Shift += 8)
+    {
+        memory_size Offsets[256] = {};
+        for (memory_offset Index = 0; Index < Count; ++Index)
+        {
+            ++Offsets[(Source[Index] >> Shift) & 0xFF];
+        }
+
+        memory_size Total = 0;
+        for (u32 Digit = 0; Digit < 256; ++Digit)
+        {
+            memory_size DigitCount = Offsets[Digit];
+            Offsets[Digit] = Total;
+            Total += DigitCount;
+        }
+
+        for (memory_offset Index = 0; Index < Count; ++Index)
+        {
+            Destination[Offsets[(Source[Index] >> Shift) & 0xFF]++] = Source[Index];
+        }
+
+        u32 *Swap = Source;
+        Source = Destination;
+        Destination = Swap;
+    }
+
+    return Source;
+}
+
+// NOTE(traian): The output must fit four bytes per trigram. Returns the size of the forward list.
+internal memory_size
+EncodeTrigramForwardList(u32 *SortedTrigrams, memory_size Count, u8 *Output)
+{
+    memory_size Size = 0;
+    u32 Previous = 0;
+    for (memory_offset Index = 0; Index < Count; ++Index)
+    {
+        Size += EncodeTrigramIndexVarint(Output + Size, SortedTrigrams[Index] - Previous);
+        Previous = SortedTrigrams[Index];
+    }
+    return Size;
+}
+
+//=========================================================================================
+// NOTE(traian): INDEX FILE.
+//=========================================================================================
+
+// NOTE(traian): Returns false if the file name doesn't fit.
+internal b32
+GetTrigramIndexFileName(char *Directory, memory_size DirectoryLength, char *Name, char *FileName)
+{
+    memory_size NameLength = StringLength(Name);
+    if (DirectoryLength + 1 + NameLength >= PLATFORM_PATH_CAPACITY)
+    {
+        return false;
+    }
+
+    CopyMem(FileName, Directory, DirectoryLength);
+    FileName[DirectoryLength] = '/';
+    CopyMem(FileName + DirectoryLength + 1, Name, NameLength + 1);
+    return true;
+}
+
+// NOTE(traian): Returns NULL if the index isn't valid. Only the sections are checked here, while the entries of
+// the tables are checked when they are read, so that a query doesn't touch the whole index.
+internal trigram_index_header *
+GetTrigramIndexHeader(buffer Index)
+{
+    if (!Index.Data || Index.Size < sizeof(trigram_index_header))
+    {
+        return NULL;
+    }
+
+    trigram_index_header *Header = (trigram_index_header *)Index.Data;
+    b32 IsValid = (Header->Magic == TRIGRAM_INDEX_MAGIC) && (Header->Version == TRIGRAM_INDEX_VERSION) &&
+                  (Header->Size == Index.Size) && (Header->TrigramCount <= TRIGRAM_INDEX_TRIGRAM_CAPACITY);
+    IsValid = IsValid &&
+              (Header->FileTableOffset <= Index.Size) &&
+              ((u64)Header->FileCount * sizeof(trigram_index_file) <= Index.Size - Header->FileTableOffset) &&
+              (Header->TrigramTableOffset <= Index.Size) &&
+              (Header->TrigramCount * sizeof(trigram_index_trigram) <= Index.Size - Header->TrigramTableOffset) &&
+              (Header->PostingsOffset <= Index.Size) &&
+              (Header->PostingsSize <= Index.Size - Header->PostingsOffset) &&
+              (Header->ForwardListsOffset <= Index.Size) &&
+              (Header->ForwardListsSize <= Index.Size - Header->ForwardListsOffset) &&
+              (Header->PathsOffset <= Index.Size) &&
+              (Header->PathsSize <= Index.Size - Header->PathsOffset);
+
+    return IsValid ? Header : NULL;
+}
+
+internal inline trigram_index_file *
+GetTrigramIndexFiles(buffer Index, trigram_index_header *Header)
+{
+    trigram_index_file *Result = (trigram_index_file *)(Index.Data + Header->FileTableOffset);
+    return Result;
+}
+
+// NOTE(traian): Returns NULL if the path isn't inside the index.
+internal inline char *
+GetTrigramIndexFilePath(buffer Index, trigram_index_header *Header, trigram_index_file *File)
+{
+    if (File->PathOffset > Header->PathsSize || File->PathLength >= Header->PathsSize - File->PathOffset)
+    {
+        return NULL;
+    }
+
+    char *Result = (char *)Index.Data + Header->PathsOffset + File->PathOffset;
+    return Result[File->PathLength] == 0 ? Result : NULL;
+}
+
+// NOTE(traian): Returns NULL if the forward list isn't inside the index.
+internal inline u8 *
+GetTrigramIndexForwardList(buffer Index, trigram_index_header *Header, trigram_index_file *File)
+{
+    if (File->ForwardListOffset > Header->ForwardListsSize ||
+        File->ForwardListSize > Header->ForwardListsSize - File->ForwardListOffset)
+    {
+        return NULL;
+    }
+
+    u8 *Result = Index.Data + Header->ForwardListsOffset + File->ForwardListOffset;
+    return Result;
+}
+
+internal inline s32
+CompareTrigramIndexPaths(char *A, memory_size ALength, char *B, memory_size BLength)
+{
+    memory_size Length = Minimum(ALength, BLength);
+    for (memory_offset Index = 0; Index < Length; ++Index)
+    {
+        if (A[Index] != B[Index])
+        {
+            return (u8)A[Index] < (u8)B[Index] ? -1 : 1;
+        }
+    }
+
+    if (ALength == BLength)
+    {
+        return 0;
+    }
+    return ALength < BLength ? -1 : 1;
+}
+
+// NOTE(traian): The file table is sorted by path, so the file is found by a binary search. Returns NULL if the
+// index doesn't have the file.
+internal trigram_index_file *
+FindTrigramIndexFile(buffer Index, trigram_index_header *Header, char *Path, memory_size PathLength)
+{
+    trigram_index_file *Files = GetTrigramIndexFiles(Index, Header);
+    u32 Low = 0;
+    u32 High = Header->FileCount;
+    while (Low < High)
+    {
+        u32 Middle = Low + (High - Low) / 2;
+        char *MiddlePath = GetTrigramIndexFilePath(Index, Header, Files + Middle);
+        if (!MiddlePath)
+        {
+            return NULL;
+        }
+
+        s32 Comparison = CompareTrigramIndexPaths(MiddlePath, Files[Middle].PathLength, Path, PathLength);
+        if (Comparison == 0)
+        {
+            return Files + Middle;
+        }
+
+        if (Comparison < 0)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return NULL;
+}
+
+//=========================================================================================
+// NOTE(traian): INDEX BUILD.
+//=========================================================================================
+
+// NOTE(traian): Bottom up merge sort of the entries by path. Returns the array that holds the sorted order, which
+// is either of the two.
+internal u32 *
+SortTrigramIndexEntries(trigram_index_entry *Entries, u32 *Order, u32 *Scratch, u32 Count)
+{
+    u32 *Source = Order;
+    u32 *Destination = Scratch;
+    for (u32 Width = 1; Width < Count; Width *= 2)
+    {
+        for (u32 Start = 0; Start < Count; Start += 2 * Width)
+        {
+            u32 Middle = Minimum(Start + Width, Count);
+            u32 End = Minimum(Start + 2 * Width, Count);
+            u32 Left = Start;
+            u32 Right = Middle;
+            for (u32 Index = Start; Index < End; ++Index)
+            {
+                b32 TakeLeft = (Right >= End);
+                if (Left < Middle && Right < End)
+                {
+                    trigram_index_entry *LeftEntry = Entries + Source[Left];
+                    trigram_index_entry *RightEntry = Entries + Source[Right];
+                    TakeLeft = CompareTrigramIndexPaths(LeftEntry->Path, LeftEntry->PathLength,
+                                                        RightEntry->Path, RightEntry->PathLength) <= 0;
+                }
+                Destination[Index] = TakeLeft ? Source[Left++] : Source[Right++];
+            }
+        }
+
+        u32 *Swap = Source;
+        Source = Destination;
+        Destination = Swap;
+    }
+
+    return Source;
+}
+
+// NOTE(traian): Lays out the index of the entries that are indexed. The files get their indices from their order
+// by path, and the posting lists are inverted from the forward lists in two passes: the first one measures every
+// list and the second one writes it in place. The index of a stopped build only has the files and their forward
+// lists. Returns the contents of the index file.
+internal buffer
+BuildTrigramIndex(trigram_index_entry *Entries, u32 EntryCount, b32 IsComplete)
+{
+    buffer OrderMemory = PlatformAllocateMemory(2 * (memory_size)Maximum(EntryCount, 1) * sizeof(u32));
+    u32 *Order = (u32 *)OrderMemory.Data;
+    u32 *Scratch = Order + Maximum(EntryCount, 1);
+    u32 FileCount = 0;
+    for (u32 EntryIndex = 0; EntryIndex < EntryCount; ++EntryIndex)
+    {
+        if (Entries[EntryIndex].IsIndexed)
+        {
+            Order[FileCount++] = EntryIndex;
+        }
+    }
+    Order = SortTrigramIndexEntries(Entries, Order, Scratch, FileCount);
+
+    memory_size PathsSize = 0;
+    memory_size ForwardListsSize = 0;
+    for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+    {
+        trigram_index_entry *Entry = Entries + Order[FileIndex];
+        PathsSize += Entry->PathLength + 1;
+        ForwardListsSize += Entry->ForwardListSize;
+    }
+
+    // NOTE(traian): The last file that was seen for every trigram, plus one, and the size of its posting list.
+    buffer TrigramMemory = {};
+    u32 *LastFiles = NULL;
+    u32 *PostingSizes = NULL;
+    u64 TrigramCount = 0;
+    memory_size PostingsSize = 0;
+    if (IsComplete)
+    {
+        TrigramMemory = PlatformAllocateMemory(2 * TRIGRAM_INDEX_TRIGRAM_CAPACITY * sizeof(u32));
+        LastFiles = (u32 *)TrigramMemory.Data;
+        PostingSizes = LastFiles + TRIGRAM_INDEX_TRIGRAM_CAPACITY;
+
+        for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+        {
+            trigram_index_entry *Entry = Entries + Order[FileIndex];
+            u32 Trigram = 0;
+            memory_offset Offset = 0;
+            while (Offset < Entry->ForwardListSize)
+            {
+                u32 Delta;
+                Offset = DecodeTrigramIndexVarint(Entry->ForwardList, Offset, Entry->ForwardListSize, &Delta);
+                Trigram = (Trigram + Delta) & (TRIGRAM_INDEX_TRIGRAM_CAPACITY - 1);
+                if (LastFiles[Trigram] != FileIndex + 1)
+                {
+                    PostingSizes[Trigram] += (u32)GetTrigramIndexVarintSize(FileIndex + 1 - LastFiles[Trigram]);
+                    LastFiles[Trigram] = FileIndex + 1;
+                }
+            }
+        }
+
+        for (u32 Trigram = 0; Trigram < TRIGRAM_INDEX_TRIGRAM_CAPACITY; ++Trigram)
+        {
+            if (PostingSizes[Trigram])
+            {
+                ++TrigramCount;
+                PostingsSize += PostingSizes[Trigram];
+            }
+        }
+    }
+
+    trigram_index_header Header = {};
+    Header.Magic = TRIGRAM_INDEX_MAGIC;
+    Header.Version = TRIGRAM_INDEX_VERSION;
+    Header.IsComplete = IsComplete;
+    Header.FileCount = FileCount;
+    Header.TrigramCount = TrigramCount;
+    Header.FileTableOffset = sizeof(trigram_index_header);
+    Header.TrigramTableOffset = Header.FileTableOffset + FileCount * sizeof(trigram_index_file);
+    Header.PostingsOffset = Header.TrigramTableOffset + TrigramCount * sizeof(trigram_index_trigram);
+    Header.PostingsSize = PostingsSize;
+    Header.ForwardListsOffset = Header.PostingsOffset + PostingsSize;
+    Header.ForwardListsSize = ForwardListsSize;
+    Header.PathsOffset = Header.ForwardListsOffset + ForwardListsSize;
+    Header.PathsSize = PathsSize;
+    Header.Size = Header.PathsOffset + PathsSize;
+
+    buffer Index = PlatformAllocateMemory(Header.Size);
+    CopyMem(Index.Data, &Header, sizeof(Header));
+    trigram_index_file *Files = (trigram_index_file *)(Index.Data + Header.FileTableOffset);
+    trigram_index_trigram *Trigrams = (trigram_index_trigram *)(Index.Data + Header.TrigramTableOffset);
+    u8 *Postings = Index.Data + Header.PostingsOffset;
+
+    memory_offset PathOffset = 0;
+    memory_offset ForwardListOffset = 0;
+    for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+    {
+        trigram_index_entry *Entry = Entries + Order[FileIndex];
+        trigram_index_file *File = Files + FileIndex;
+        File->WriteTime = Entry->WriteTime;
+        File->ForwardListOffset = ForwardListOffset;
+        File->ForwardListSize = Entry->ForwardListSize;
+        File->PathOffset = PathOffset;
+        File->PathLength = Entry->PathLength;
+
+        CopyMem(Index.Data + Header.ForwardListsOffset + ForwardListOffset, Entry->ForwardList, Entry->ForwardListSize);
+        CopyMem(Index.Data + Header.PathsOffset + PathOffset, Entry->Path, Entry->PathLength);
+        ForwardListOffset += Entry->ForwardListSize;
+        PathOffset += Entry->PathLength + 1;
+    }
+
+    if (IsComplete)
+    {
+        // NOTE(traian): The size of a posting list isn't needed anymore once its offset is known, so its slot
+        // holds the index of the trigram in the table instead.
+        u32 *TrigramIndices = PostingSizes;
+        memory_offset PostingOffset = 0;
+        u32 TableIndex = 0;
+        for (u32 Trigram = 0; Trigram < TRIGRAM_INDEX_TRIGRAM_CAPACITY; ++Trigram)
+        {
+            if (PostingSizes[Trigram])
+            {
+                trigram_index_trigram *Entry = Trigrams + TableIndex;
+                Entry->Trigram = Trigram;
+                Entry->PostingOffset = PostingOffset;
+                PostingOffset += PostingSizes[Trigram];
+                TrigramIndices[Trigram] = TableIndex++;
+            }
+        }
+        SetMemoryToZero(LastFiles, TRIGRAM_INDEX_TRIGRAM_CAPACITY * sizeof(u32));
+
+        for (u32 FileIndex = 0; FileIndex < FileCount; ++FileIndex)
+        {
+            trigram_index_entry *Entry = Entries + Order[FileIndex];
+            u32 Trigram = 0;
+            memory_offset Offset = 0;
+            while (Offset < Entry->ForwardListSize)
+            {
+                u32 Delta;
+                Offset = DecodeTrigramIndexVarint(Entry->ForwardList, Offset, Entry->ForwardListSize, &Delta);
+                Trigram = (Trigram + Delta) & (TRIGRAM_INDEX_TRIGRAM_CAPACITY - 1);
+                if (LastFiles[Trigram] != FileIndex + 1)
+                {
+                    trigram_index_trigram *TableEntry = Trigrams + TrigramIndices[Trigram];
+                    u8 *Output = Postings + TableEntry->PostingOffset + TableEntry->PostingSize;
+                    TableEntry->PostingSize += EncodeTrigramIndexVarint(Output, FileIndex + 1 - LastFiles[Trigram]);
+                    ++TableEntry->FileCount;
+                    LastFiles[Trigram] = FileIndex + 1;
+                }
+            }
+        }
+
+        PlatformReleaseMemory(TrigramMemory);
+    }
+
+    PlatformReleaseMemory(OrderMemory);
+    return Index;
+}
+
+//=========================================================================================
+// NOTE(traian): INDEX QUERY.
+//=========================================================================================
+
+// NOTE(traian): Returns NULL if the index doesn't have the trigram.
+internal trigram_index_trigram *
+FindTrigramIndexTrigram(buffer Index, trigram_index_header *Header, u32 Trigram)
+{
+    trigram_index_trigram *Trigrams = (trigram_index_trigram *)(Index.Data + Header->TrigramTableOffset);
+    u64 Low = 0;
+    u64 High = Header->TrigramCount;
+    while (Low < High)
+    {
+        u64 Middle = Low + (High - Low) / 2;
+        if (Trigrams[Middle].Trigram == Trigram)
+        {
+            return Trigrams + Middle;
+        }
+
+        if (Trigrams[Middle].Trigram < Trigram)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    return NULL;
+}
+
+// NOTE(traian): Lists the indices of the files that contain every trigram of the literal, in increasing order.
+// The shortest posting list is decoded first and the others only filter it, so the cost follows the rarest
+// trigram. Every file is listed if the literal is shorter than a trigram, or if the index is damaged. The
+// candidates must fit all of the files of the index, which has to be complete.
+internal u32
+FindTrigramIndexCandidates(buffer Index, trigram_index_header *Header, char *Literal, memory_size LiteralLength,
+                           u32 *Candidates)
+{
+    Assert(Header->IsComplete);
+    u8 *Postings = Index.Data + Header->PostingsOffset;
+
+    trigram_index_trigram *Lists[REGEX_PATTERN_CAPACITY];
+    u32 ListCount = 0;
+    b32 IsDamaged = false;
+    for (memory_offset LiteralIndex = 2; LiteralIndex < LiteralLength && ListCount < ArrayCount(Lists); ++LiteralIndex)
+    {
+        u32 Trigram = ((u32)(u8)Literal[LiteralIndex - 2] << 16) | ((u32)(u8)Literal[LiteralIndex - 1] << 8) |
+                      (u8)Literal[LiteralIndex];
+        trigram_index_trigram *List = FindTrigramIndexTrigram(Index, Header, Trigram);
+        if (!List)
+        {
+            return 0;
+        }
+
+        if (List->PostingOffset > Header->PostingsSize || List->PostingSize > Header->PostingsSize - List->PostingOffset)
+        {
+            IsDamaged = true;
+            break;
+        }
+
+        // NOTE(traian): The lists are kept sorted by size, and a trigram that repeats is only listed once.
+        u32 Slot = ListCount;
+        for (; Slot > 0 && Lists[Slot - 1]->PostingSize > List->PostingSize; --Slot)
+        {
+        }
+
+        b32 IsDuplicate = false;
+        for (u32 Other = 0; Other < ListCount; ++Other)
+        {
+            IsDuplicate = IsDuplicate || (Lists[Other] == List);
+        }
+        if (!IsDuplicate)
+        {
+            MoveMem(Lists + Slot + 1, Lists + Slot, (ListCount - Slot) * sizeof(Lists[0]));
+            Lists[Slot] = List;
+            ++ListCount;
+        }
+    }
+
+    if (ListCount == 0 || IsDamaged)
+    {
+        for (u32 FileIndex = 0; FileIndex < Header->FileCount; ++FileIndex)
+        {
+            Candidates[FileIndex] = FileIndex;
+        }
+        return Header->FileCount;
+    }
+
+    u32 CandidateCount = 0;
+    for (u32 ListIndex = 0; ListIndex < ListCount; ++ListIndex)
+    {
+        trigram_index_trigram *List = Lists[ListIndex];
+        u8 *Posting = Postings + List->PostingOffset;
+        u32 KeptCount = 0;
+        u32 CandidateIndex = 0;
+        u32 File = 0;
+        memory_offset Offset = 0;
+        while (Offset < List->PostingSize)
+        {
+            u32 Delta;
+            Offset = DecodeTrigramIndexVarint(Posting, Offset, List->PostingSize, &Delta);
+            File += Delta;
+            if (File == 0 || File > Header->FileCount)
+            {
+                continue;
+            }
+
+            // NOTE(traian): The file indices are stored plus one.
+            u32 FileIndex = File - 1;
+            if (ListIndex == 0)
+            {
+                if (KeptCount == 0 || Candidates[KeptCount - 1] != FileIndex)
+                {
+                    Candidates[KeptCount++] = FileIndex;
+                }
+                continue;
+            }
+
+            while (CandidateIndex < CandidateCount && Candidates[CandidateIndex] < FileIndex)
+            {
+                ++CandidateIndex;
+            }
+            if (CandidateIndex == CandidateCount)
+            {
+                break;
+            }
+            if (Candidates[CandidateIndex] == FileIndex)
+            {
+                Candidates[KeptCount++] = FileIndex;
+                ++CandidateIndex;
+            }
+        }
+
+        CandidateCount = KeptCount;
+        if (CandidateCount == 0)
+        {
+            break;
+        }
+    }
+
+    return CandidateCount;
+}
+
+#define OCEAN_TRIGRAM_INDEX_H
+#endif // OCEAN_TRIGRAM_INDEX_H
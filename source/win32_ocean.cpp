@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <debugapi.h>
+#include <intrin.h>
 
 typedef unsigned char u8;
 typedef unsigned short u16;
@@ -34,6 +35,10 @@ typedef u64 memory_offset;
 typedef u64 usize;
 typedef u64 flat_ptr;
 
+#ifndef OCEAN_BENCHMARK
+    #define OCEAN_BENCHMARK 0
+#endif // OCEAN_BENCHMARK
+
 #include "ocean.cpp"
 
 struct win32_offscreen_bitmap
@@ -113,6 +118,128 @@ Win32ToggleFullscreen(HWND WindowHandle)
 global editor_memory GlobalEditorMemory;
 global editor_state *GlobalEditorState;
 global HWND GlobalWindowHandle;
+global s64 GlobalPerformanceFrequency;
+
+//=========================================================================================
+// NOTE(traian): WORK QUEUE.
+//=========================================================================================
+
+struct platform_work_queue_entry
+{
+    platform_work_queue_callback *Callback;
+    void *Data;
+};
+
+struct platform_work_queue
+{
+    u32 volatile CompletionGoal;
+    u32 volatile CompletionCount;
+
+    u32 volatile NextEntryToWrite;
+    u32 volatile NextEntryToRead;
+    HANDLE SemaphoreHandle;
+
+    platform_work_queue_entry Entries[256];
+};
+
+global platform_work_queue GlobalWorkQueue;
+global platform_work_queue GlobalFileQueue;
+global platform_work_queue GlobalSearchQueue;
+global platform_work_queue GlobalIndexQueue;
+
+b32
+PlatformAddWorkEntry(platform_work_queue *Queue, platform_work_queue_callback *Callback, void *Data)
+{
+    u32 NewNextEntryToWrite = (Queue->NextEntryToWrite + 1) % ArrayCount(Queue->Entries);
+    if (NewNextEntryToWrite == Queue->NextEntryToRead)
+    {
+        return false;
+    }
+
+    platform_work_queue_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
+    Entry->Callback = Callback;
+    Entry->Data = Data;
+    ++Queue->CompletionGoal;
+
+    // NOTE(traian): The entry must be visible before the worker threads can see the new write index.
+    CompletePreviousWritesBeforeFutureWrites;
+    Queue->NextEntryToWrite = NewNextEntryToWrite;
+    ReleaseSemaphore(Queue->SemaphoreHandle, 1, NULL);
+    return true;
+}
+
+// NOTE(traian): Returns true if there was no work entry to execute.
+internal b32
+Win32DoNextWorkQueueEntry(platform_work_queue *Queue)
+{
+    b32 ShouldSleep = false;
+
+    u32 OriginalNextEntryToRead = Queue->NextEntryToRead;
+    u32 NewNextEntryToRead = (OriginalNextEntryToRead + 1) % ArrayCount(Queue->Entries);
+    if (OriginalNextEntryToRead != Queue->NextEntryToWrite)
+    {
+        u32 Index = InterlockedCompareExchange((LONG volatile *)&Queue->NextEntryToRead,
+                                               NewNextEntryToRead, OriginalNextEntryToRead);
+        if (Index == OriginalNextEntryToRead)
+        {
+            platform_work_queue_entry Entry = Queue->Entries[Index];
+            Entry.Callback(Queue, Entry.Data);
+            InterlockedIncrement((LONG volatile *)&Queue->CompletionCount);
+        }
+    }
+    else
+    {
+        ShouldSleep = true;
+    }
+
+    return ShouldSleep;
+}
+
+void
+PlatformCompleteAllWork(platform_work_queue *Queue)
+{
+    while (Queue->CompletionGoal != Queue->CompletionCount)
+    {
+        Win32DoNextWorkQueueEntry(Queue);
+    }
+
+    Queue->CompletionGoal = 0;
+    Queue->CompletionCount = 0;
+}
+
+internal DWORD WINAPI
+Win32WorkQueueThreadProcedure(LPVOID Parameter)
+{
+    platform_work_queue *Queue = (platform_work_queue *)Parameter;
+    for (;;)
+    {
+        if (Win32DoNextWorkQueueEntry(Queue))
+        {
+            WaitForSingleObjectEx(Queue->SemaphoreHandle, INFINITE, FALSE);
+        }
+    }
+}
+
+internal void
+Win32InitializeWorkQueue(platform_work_queue *Queue, u32 ThreadCount)
+{
+    Queue->CompletionGoal = 0;
+    Queue->CompletionCount = 0;
+    Queue->NextEntryToWrite = 0;
+    Queue->NextEntryToRead = 0;
+    Queue->SemaphoreHandle = CreateSemaphoreA(NULL, 0, ThreadCount, NULL);
+
+    for (u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        DWORD ThreadID;
+        HANDLE ThreadHandle = CreateThread(NULL, 0, Win32WorkQueueThreadProcedure, Queue, 0, &ThreadID);
+        CloseHandle(ThreadHandle);
+    }
+}
+
+// NOTE(traian): The editor is redrawn by the timer only if the background work changed something.
+#define WIN32_TIMER_ID 1
+#define WIN32_TIMER_INTERVAL_MS 30
 
 internal key_code
 Win32TranslateKeyCode(WPARAM WParam)
@@ -140,6 +267,7 @@ Win32TranslateKeyCode(WPARAM WParam)
         case VK_NEXT:       return KeyCode_PageDown;
         case VK_BACK:       return KeyCode_Backspace;
         case VK_DELETE:     return KeyCode_Delete;
+        case VK_ESCAPE:     return KeyCode_Escape;
         case VK_SPACE:      return KeyCode_Space;
         case VK_RETURN:     return KeyCode_Enter;
         case VK_TAB:        return KeyCode_Tab;
@@ -225,6 +353,16 @@ WindowProcedure(HWND WindowHandle, UINT MessageID, WPARAM WParam, LPARAM LParam)
             return 0;
         }
 
+        case WM_TIMER:
+        {
+            if (GlobalEditorState && EditorEventTimerTick(GlobalEditorState))
+            {
+                UpdateEditor(WindowHandle);
+            }
+
+            return 0;
+        }
+
         case WM_KEYUP:
         case WM_SYSKEYUP:
         {
@@ -245,6 +383,7 @@ WindowProcedure(HWND WindowHandle, UINT MessageID, WPARAM WParam, LPARAM LParam)
     return DefWindowProcA(WindowHandle, MessageID, WParam, LParam);
 }
 
+#if !OCEAN_BENCHMARK
 INT
 WinMain(HINSTANCE Instance,
         HINSTANCE PrevInstance,
@@ -275,6 +414,28 @@ WinMain(HINSTANCE Instance,
         InitializeArena(&GlobalEditorMemory.PermanentArena,
                         GlobalEditorMemory.PermanentStorage, GlobalEditorMemory.PermanentStorageSize);
 
+        // NOTE(traian): One processor is left for the main thread.
+        SYSTEM_INFO SystemInfo;
+        GetSystemInfo(&SystemInfo);
+        u32 WorkerThreadCount = Maximum(SystemInfo.dwNumberOfProcessors, 2) - 1;
+        Win32InitializeWorkQueue(&GlobalWorkQueue, WorkerThreadCount);
+        GlobalEditorMemory.WorkQueue = &GlobalWorkQueue;
+
+        // NOTE(traian): Every panel has its own file thread, so a load or a save starts as soon as it's queued.
+        // The searches and the index builds have their own threads too, so that they never hold the threads that
+        // the main thread or each other wait for. Half of the threads are enough for a build, which runs in the
+        // background while the searches are waited for.
+        Win32InitializeWorkQueue(&GlobalFileQueue, (u32)ArrayCount(GlobalEditorState->TextPanels));
+        GlobalEditorMemory.FileQueue = &GlobalFileQueue;
+        u32 SearchThreadCount = Minimum(WorkerThreadCount, FIND_IN_FILES_WORKER_CAPACITY);
+        Win32InitializeWorkQueue(&GlobalSearchQueue, SearchThreadCount);
+        GlobalEditorMemory.SearchQueue = &GlobalSearchQueue;
+        GlobalEditorMemory.SearchThreadCount = SearchThreadCount;
+        u32 IndexThreadCount = Maximum(SearchThreadCount / 2, 1);
+        Win32InitializeWorkQueue(&GlobalIndexQueue, IndexThreadCount);
+        GlobalEditorMemory.IndexQueue = &GlobalIndexQueue;
+        GlobalEditorMemory.IndexThreadCount = IndexThreadCount;
+
         GlobalEditorState = PushStruct(&GlobalEditorMemory.PermanentArena, editor_state);
 
         RECT WindowClientRect;
@@ -287,6 +448,7 @@ WinMain(HINSTANCE Instance,
 
         InitializeEditor(GlobalEditorState, &GlobalEditorMemory);
         UpdateEditor(WindowHandle);
+        SetTimer(WindowHandle, WIN32_TIMER_ID, WIN32_TIMER_INTERVAL_MS, NULL);
 
         MSG Message;
         while (GetMessageA(&Message, NULL, 0, 0) > 0)
@@ -294,6 +456,8 @@ WinMain(HINSTANCE Instance,
             TranslateMessage(&Message);
             DispatchMessageA(&Message);
         }
+
+        EditorEventShutdown(GlobalEditorState);
     }
     else
     {
@@ -303,6 +467,7 @@ WinMain(HINSTANCE Instance,
 
     return 0;
 }
+#endif // !OCEAN_BENCHMARK
 
 buffer
 PlatformAllocateMemory(memory_size Size)
@@ -324,7 +489,7 @@ PlatformReleaseMemory(buffer Block)
 {
     if (Block.Data != NULL && Block.Size > 0)
     {
-        VirtualFree(Block.Data, Block.Size, MEM_RELEASE);
+        VirtualFree(Block.Data, 0, MEM_RELEASE);
     }
 }
 
@@ -355,15 +520,31 @@ Win32OpenFileForReading(char *FileName)
     return FileHandle;
 }
 
+// NOTE(traian): ReadFile and WriteFile take a DWORD byte count, so bigger transfers are split into chunks.
+#define WIN32_FILE_IO_CHUNK_SIZE Gigabytes(1)
+
 internal memory_size
 Win32ReadFileToBuffer(HANDLE FileHandle, buffer Buffer)
 {
-    DWORD BytesRead;
-    if (!ReadFile(FileHandle, Buffer.Data, Buffer.Size, &BytesRead, NULL))
+    memory_size TotalBytesRead = 0;
+    while (TotalBytesRead < Buffer.Size)
     {
-        return INVALID_SIZE;
+        DWORD ChunkSize = (DWORD)Minimum(Buffer.Size - TotalBytesRead, (memory_size)WIN32_FILE_IO_CHUNK_SIZE);
+        DWORD BytesRead;
+        if (!ReadFile(FileHandle, Buffer.Data + TotalBytesRead, ChunkSize, &BytesRead, NULL))
+        {
+            return INVALID_SIZE;
+        }
+
+        TotalBytesRead += BytesRead;
+        if (BytesRead < ChunkSize)
+        {
+            // NOTE(traian): Reached the end of the file.
+            break;
+        }
     }
-    return BytesRead;
+
+    return TotalBytesRead;
 }
 
 memory_size
@@ -414,16 +595,347 @@ PlatformReadEntireFile(char *FileName, memory_arena *Arena)
     return FileBuffer;
 }
 
+platform_file
+PlatformOpenFile(char *FileName)
+{
+    platform_file Result = {};
+
+    HANDLE FileHandle = Win32OpenFileForReading(FileName);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        // TODO(traian): Logging.
+        return Result;
+    }
+
+    LARGE_INTEGER FileSize;
+    BOOL Success = GetFileSizeEx(FileHandle, &FileSize);
+    Assert(Success);
+
+    Result.Handle = FileHandle;
+    Result.Size = FileSize.QuadPart;
+    return Result;
+}
+
+memory_size
+PlatformReadFile(platform_file *File, memory_offset FileOffset, buffer Buffer)
+{
+    Assert(File->Handle);
+
+    memory_size TotalBytesRead = 0;
+    while (TotalBytesRead < Buffer.Size)
+    {
+        // NOTE(traian): The read offset is specified through the overlapped structure, so the file
+        // pointer of the handle is never used.
+        memory_offset ChunkOffset = FileOffset + TotalBytesRead;
+        OVERLAPPED Overlapped = {};
+        Overlapped.Offset = (DWORD)(ChunkOffset & 0xFFFFFFFF);
+        Overlapped.OffsetHigh = (DWORD)(ChunkOffset >> 32);
+
+        DWORD ChunkSize = (DWORD)Minimum(Buffer.Size - TotalBytesRead, (memory_size)WIN32_FILE_IO_CHUNK_SIZE);
+        DWORD BytesRead;
+        if (!ReadFile((HANDLE)File->Handle, Buffer.Data + TotalBytesRead, ChunkSize, &BytesRead, &Overlapped))
+        {
+            // TODO(traian): Logging.
+            return INVALID_SIZE;
+        }
+
+        TotalBytesRead += BytesRead;
+        if (BytesRead < ChunkSize)
+        {
+            // NOTE(traian): Reached the end of the file.
+            break;
+        }
+    }
+
+    return TotalBytesRead;
+}
+
+void
+PlatformCloseFile(platform_file *File)
+{
+    if (File->Handle)
+    {
+        CloseHandle((HANDLE)File->Handle);
+        File->Handle = NULL;
+        File->Size = 0;
+    }
+}
+
+platform_file
+PlatformOpenFileForWriting(char *FileName, b32 Truncate)
+{
+    platform_file Result = {};
+
+    HANDLE FileHandle = CreateFileA(FileName, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                                    Truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        // TODO(traian): Logging.
+        return Result;
+    }
+
+    LARGE_INTEGER FileSize;
+    BOOL Success = GetFileSizeEx(FileHandle, &FileSize);
+    Assert(Success);
+
+    Result.Handle = FileHandle;
+    Result.Size = FileSize.QuadPart;
+    return Result;
+}
+
+memory_size
+PlatformWriteFile(platform_file *File, memory_offset FileOffset, buffer Buffer)
+{
+    Assert(File->Handle);
+
+    memory_size TotalBytesWritten = 0;
+    while (TotalBytesWritten < Buffer.Size)
+    {
+        // NOTE(traian): See PlatformReadFile.
+        memory_offset ChunkOffset = FileOffset + TotalBytesWritten;
+        OVERLAPPED Overlapped = {};
+        Overlapped.Offset = (DWORD)(ChunkOffset & 0xFFFFFFFF);
+        Overlapped.OffsetHigh = (DWORD)(ChunkOffset >> 32);
+
+        DWORD ChunkSize = (DWORD)Minimum(Buffer.Size - TotalBytesWritten, (memory_size)WIN32_FILE_IO_CHUNK_SIZE);
+        // NOTE(traian): A write that succeeds without writing anything would never finish, so it's an error too.
+        DWORD BytesWritten;
+        if (!WriteFile((HANDLE)File->Handle, Buffer.Data + TotalBytesWritten, ChunkSize, &BytesWritten, &Overlapped) ||
+            BytesWritten == 0)
+        {
+            // TODO(traian): Logging.
+            return INVALID_SIZE;
+        }
+
+        TotalBytesWritten += BytesWritten;
+    }
+
+    File->Size = Maximum(File->Size, FileOffset + TotalBytesWritten);
+    return TotalBytesWritten;
+}
+
+void
+PlatformSetFileSize(platform_file *File, memory_size Size)
+{
+    Assert(File->Handle);
+
+    LARGE_INTEGER FilePointer;
+    FilePointer.QuadPart = Size;
+    if (SetFilePointerEx((HANDLE)File->Handle, FilePointer, NULL, FILE_BEGIN) &&
+        SetEndOfFile((HANDLE)File->Handle))
+    {
+        File->Size = Size;
+    }
+}
+
+void
+PlatformFlushFile(platform_file *File)
+{
+    Assert(File->Handle);
+    FlushFileBuffers((HANDLE)File->Handle);
+}
+
+void
+PlatformDeleteFile(char *FileName)
+{
+    DeleteFileA(FileName);
+}
+
+b32
+PlatformCreateDirectory(char *DirectoryName)
+{
+    b32 Result = CreateDirectoryA(DirectoryName, NULL) || (GetLastError() == ERROR_ALREADY_EXISTS);
+    return Result;
+}
+
+void
+PlatformDeleteDirectory(char *DirectoryName)
+{
+    RemoveDirectoryA(DirectoryName);
+}
+
+b32
+PlatformMoveFile(char *SourceFileName, char *DestinationFileName)
+{
+    BOOL Success = MoveFileExA(SourceFileName, DestinationFileName,
+                               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    if (!Success)
+    {
+        // TODO(traian): Logging.
+    }
+    return Success;
+}
+
+u64
+PlatformGetFileWriteTime(char *FileName)
+{
+    WIN32_FILE_ATTRIBUTE_DATA Attributes;
+    if (!GetFileAttributesExA(FileName, GetFileExInfoStandard, &Attributes))
+    {
+        return 0;
+    }
+
+    u64 Result = ((u64)Attributes.ftLastWriteTime.dwHighDateTime << 32) | Attributes.ftLastWriteTime.dwLowDateTime;
+    return Result;
+}
+
+buffer
+PlatformMapFile(char *FileName)
+{
+    buffer Result = {};
+
+    HANDLE FileHandle = Win32OpenFileForReading(FileName);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        // TODO(traian): Logging.
+        return Result;
+    }
+
+    LARGE_INTEGER FileSize;
+    if (GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0)
+    {
+        HANDLE MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (MappingHandle)
+        {
+            // NOTE(traian): The view keeps a reference to the mapping (and the file), so the handles
+            // can be closed right away.
+            void *View = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (View)
+            {
+                Result.Data = (u8 *)View;
+                Result.Size = FileSize.QuadPart;
+            }
+            CloseHandle(MappingHandle);
+        }
+    }
+
+    CloseHandle(FileHandle);
+    return Result;
+}
+
+void
+PlatformUnmapFile(buffer View)
+{
+    if (View.Data)
+    {
+        UnmapViewOfFile(View.Data);
+    }
+}
+
+// NOTE(traian): Returns false if the entry is a link to another directory.
+internal b32
+Win32CopyDirectoryEntry(platform_directory_entry *Entry, WIN32_FIND_DATAA *FindData)
+{
+    b32 IsDirectory = (FindData->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    if (IsDirectory && (FindData->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+    {
+        return false;
+    }
+
+    memory_size NameLength = Minimum(StringLength(FindData->cFileName), sizeof(Entry->Name) - 1);
+    CopyMem(Entry->Name, FindData->cFileName, NameLength);
+    Entry->Name[NameLength] = 0;
+    Entry->IsDirectory = IsDirectory;
+    Entry->WriteTime = ((u64)FindData->ftLastWriteTime.dwHighDateTime << 32) | FindData->ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+internal inline b32
+Win32IsDotDirectory(WIN32_FIND_DATAA *FindData)
+{
+    char *Name = FindData->cFileName;
+    b32 Result = (Name[0] == '.') && (Name[1] == 0 || (Name[1] == '.' && Name[2] == 0));
+    return Result;
+}
+
+platform_directory_iterator
+PlatformBeginDirectoryIteration(char *DirectoryName)
+{
+    platform_directory_iterator Result = {};
+
+    char Pattern[PLATFORM_PATH_CAPACITY];
+    memory_size DirectoryNameLength = StringLength(DirectoryName);
+    if (DirectoryNameLength + sizeof("/*") > sizeof(Pattern))
+    {
+        // TODO(traian): Logging.
+        return Result;
+    }
+    CopyMem(Pattern, DirectoryName, DirectoryNameLength);
+    CopyMem(Pattern + DirectoryNameLength, "/*", sizeof("/*"));
+
+    // NOTE(traian): The short names aren't needed, and larger fetches reduce the number of calls into the
+    // file system for large directories.
+    WIN32_FIND_DATAA FindData;
+    HANDLE FindHandle = FindFirstFileExA(Pattern, FindExInfoBasic, &FindData, FindExSearchNameMatch, NULL,
+                                         FIND_FIRST_EX_LARGE_FETCH);
+    if (FindHandle == INVALID_HANDLE_VALUE)
+    {
+        // TODO(traian): Logging.
+        return Result;
+    }
+
+    Result.Handle = FindHandle;
+    if (!Win32IsDotDirectory(&FindData))
+    {
+        Result.HasPendingEntry = Win32CopyDirectoryEntry(&Result.PendingEntry, &FindData);
+    }
+    return Result;
+}
+
+b32
+PlatformNextDirectoryEntry(platform_directory_iterator *Iterator, platform_directory_entry *Entry)
+{
+    if (!Iterator->Handle)
+    {
+        return false;
+    }
+
+    if (Iterator->HasPendingEntry)
+    {
+        *Entry = Iterator->PendingEntry;
+        Iterator->HasPendingEntry = false;
+        return true;
+    }
+
+    WIN32_FIND_DATAA FindData;
+    while (FindNextFileA((HANDLE)Iterator->Handle, &FindData))
+    {
+        if (!Win32IsDotDirectory(&FindData) && Win32CopyDirectoryEntry(Entry, &FindData))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+PlatformEndDirectoryIteration(platform_directory_iterator *Iterator)
+{
+    if (Iterator->Handle)
+    {
+        FindClose((HANDLE)Iterator->Handle);
+        Iterator->Handle = NULL;
+    }
+}
+
 memory_size
 PlatformWriteEntireFile(char *FileName, buffer Buffer)
+{
+    memory_size Result = PlatformWriteEntireFile(FileName, &Buffer, 1);
+    return Result;
+}
+
+memory_size
+PlatformWriteEntireFile(char *FileName, buffer *Buffers, u32 BufferCount)
 {
     HANDLE FileHandle = CreateFileA(FileName, GENERIC_WRITE, 0, NULL,
                                     TRUNCATE_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
     if (FileHandle == INVALID_HANDLE_VALUE)
     {
         // NOTE(traian): The file doesn't exist on disk.
-        HANDLE FileHandle = CreateFileA(FileName, GENERIC_WRITE, 0, NULL,
-                                        OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        FileHandle = CreateFileA(FileName, GENERIC_WRITE, 0, NULL,
+                                 OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
         
         if (FileHandle == INVALID_HANDLE_VALUE)
         {
@@ -432,16 +944,58 @@ PlatformWriteEntireFile(char *FileName, buffer Buffer)
         }
     }
 
-    DWORD BytesWritten;
-    WriteFile(FileHandle, Buffer.Data, Buffer.Size, &BytesWritten, NULL);
-    if (BytesWritten != Buffer.Size)
+    memory_size TotalBytesWritten = 0;
+    for (u32 BufferIndex = 0; BufferIndex < BufferCount; ++BufferIndex)
     {
-        // TODO(traian): Logging.
-        return 0;
+        buffer *Buffer = Buffers + BufferIndex;
+        if (Buffer->Size == 0)
+        {
+            continue;
+        }
+
+        memory_size BufferBytesWritten = 0;
+        while (BufferBytesWritten < Buffer->Size)
+        {
+            DWORD ChunkSize = (DWORD)Minimum(Buffer->Size - BufferBytesWritten, (memory_size)WIN32_FILE_IO_CHUNK_SIZE);
+            DWORD BytesWritten;
+            WriteFile(FileHandle, Buffer->Data + BufferBytesWritten, ChunkSize, &BytesWritten, NULL);
+            if (BytesWritten != ChunkSize)
+            {
+                // TODO(traian): Logging.
+                CloseHandle(FileHandle);
+                return 0;
+            }
+
+            BufferBytesWritten += BytesWritten;
+        }
+
+        TotalBytesWritten += BufferBytesWritten;
     }
 
     CloseHandle(FileHandle);
-    return BytesWritten;
+    return TotalBytesWritten;
+}
+
+u64
+PlatformGetWallClock()
+{
+    LARGE_INTEGER Counter;
+    QueryPerformanceCounter(&Counter);
+    return Counter.QuadPart;
+}
+
+f64
+PlatformGetSecondsElapsed(u64 StartWallClock, u64 EndWallClock)
+{
+    if (!GlobalPerformanceFrequency)
+    {
+        LARGE_INTEGER Frequency;
+        QueryPerformanceFrequency(&Frequency);
+        GlobalPerformanceFrequency = Frequency.QuadPart;
+    }
+
+    f64 Result = (f64)(EndWallClock - StartWallClock) / (f64)GlobalPerformanceFrequency;
+    return Result;
 }
 
 key_modifier
@@ -0,0 +1,20 @@
+/*  =====================================================================
+    $File:   win32_ocean_benchmark.cpp $
+    $Date:   October 16 2026 $
+    $Author: Traian Avram $
+    $Notice: Copyright (c) 2023-2023 Traian Avram. All Rights Reserved. $
+    =====================================================================  */
+
+// NOTE(traian): The benchmark executable is a console application that reuses the Win32 platform
+// layer, without creating the editor window.
+#define OCEAN_BENCHMARK 1
+#include "win32_ocean.cpp"
+
+#include "ocean_benchmark.cpp"
+
+int
+main(int ArgumentCount, char **Arguments)
+{
+    RunBenchmarks();
+    return (GlobalFailedCheckCount > 0) ? 1 : 0;
+}